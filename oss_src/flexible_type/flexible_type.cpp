@@ -6,9 +6,11 @@
  * of the BSD license. See the LICENSE file for details.
  */
 #include <string>
+#include <vector>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <flexible_type/flexible_type.hpp>
 #include <logger/assertions.hpp>
+#include <parallel/thread_local_object.hpp>
 
 // contains some of the bigger functions I do not want to inline
 namespace graphlab {
@@ -255,6 +257,96 @@ bool flexible_type::is_na() const {
 }
 
 
+namespace flexible_type_impl {
+
+namespace {
+
+/*
+ * Cells are only recycled while their value owns at most this many bytes,
+ * so that the free lists never pin large buffers.
+ */
+const size_t MAX_RECYCLED_CELL_BYTES = 64;
+
+/*
+ * The maximum number of cells in each free list of a thread.
+ */
+const size_t MAX_FREE_CELLS = 1024;
+
+struct cell_free_lists {
+  std::vector<string_cell*> strings;
+  std::vector<vec_cell*> vectors;
+  cell_free_lists() {
+    // reserved so that recycling a cell never allocates
+    strings.reserve(MAX_FREE_CELLS);
+    vectors.reserve(MAX_FREE_CELLS);
+  }
+  ~cell_free_lists() {
+    for (string_cell* cell: strings) delete cell;
+    for (vec_cell* cell: vectors) delete cell;
+  }
+};
+
+/*
+ * The free lists of the calling thread, freed when the thread exits.
+ */
+typedef thread_local_object<cell_free_lists> thread_free_lists;
+
+template <typename Cell>
+inline Cell* allocate_cell(std::vector<Cell*>& free_list) {
+  Cell* cell;
+  if (free_list.empty()) {
+    cell = new Cell;
+  } else {
+    cell = free_list.back();
+    free_list.pop_back();
+  }
+  cell->first.value = 1;
+  return cell;
+}
+
+/*
+ * Recycles into the free list of the calling thread if the thread has one;
+ * a thread which never allocated a cell just frees it.
+ */
+template <typename Cell>
+inline void release_cell(Cell* cell, std::vector<Cell*> cell_free_lists::* list,
+                         size_t bytes) {
+  cell_free_lists* free_lists = thread_free_lists::get_if_exists();
+  if (free_lists == NULL) {
+    delete cell;
+    return;
+  }
+  std::vector<Cell*>& free_list = free_lists->*list;
+  if (bytes <= MAX_RECYCLED_CELL_BYTES && free_list.size() < MAX_FREE_CELLS) {
+    cell->second.clear();
+    free_list.push_back(cell);
+  } else {
+    delete cell;
+  }
+}
+
+} // anonymous namespace
+
+string_cell* allocate_string_cell() {
+  return allocate_cell(thread_free_lists::get().strings);
+}
+
+void release_string_cell(string_cell* cell) noexcept {
+  release_cell(cell, &cell_free_lists::strings, cell->second.capacity());
+}
+
+vec_cell* allocate_vec_cell() {
+  return allocate_cell(thread_free_lists::get().vectors);
+}
+
+void release_vec_cell(vec_cell* cell) noexcept {
+  release_cell(cell, &cell_free_lists::vectors,
+               cell->second.capacity() * sizeof(flex_float));
+}
+
+} // namespace flexible_type_impl
+
+
 void flexible_type_fail(bool success) {
   if(!success) {
     log_and_throw("Invalid type conversion");
@@ -41,6 +41,29 @@ void flexible_type_fail(bool);
 
 namespace graphlab {
 
+namespace flexible_type_impl {
+/**
+ * \internal
+ * The reference counted heap cells holding flexible_type strings and
+ * vectors.
+ *
+ * Cells of small values are recycled through a per-thread free list, so
+ * that creating and destroying short strings and vectors (the common case
+ * when decoding sframe blocks) does not go through malloc and free.
+ */
+typedef std::pair<atomic<size_t>, flex_string> string_cell;
+typedef std::pair<atomic<size_t>, flex_vec> vec_cell;
+
+/// Returns a string cell holding an empty string, with a reference count of 1.
+string_cell* allocate_string_cell();
+/// Destroys or recycles a string cell whose reference count dropped to 0.
+void release_string_cell(string_cell* cell) noexcept;
+/// Returns a vector cell holding an empty vector, with a reference count of 1.
+vec_cell* allocate_vec_cell();
+/// Destroys or recycles a vector cell whose reference count dropped to 0.
+void release_vec_cell(vec_cell* cell) noexcept;
+} // namespace flexible_type_impl
+
 /**
  * \ingroup group_gl_flexible_type
  *
@@ -1220,8 +1243,8 @@ class flexible_type {
        else {
          union_type prev;
          prev = val;
-         val.strval = new std::pair<atomic<size_t>, flex_string>(*(val.strval));
-         val.strval->first.value = 1;
+         val.strval = flexible_type_impl::allocate_string_cell();
+         val.strval->second = prev.strval->second;
          decref(prev, flex_type_enum::STRING);
        }
        break;
@@ -1230,8 +1253,8 @@ class flexible_type {
        else {
          union_type prev;
          prev = val;
-         val.vecval = new std::pair<atomic<size_t>, flex_vec>(*(val.vecval));
-         val.vecval->first.value = 1;
+         val.vecval = flexible_type_impl::allocate_vec_cell();
+         val.vecval->second = prev.vecval->second;
          decref(prev, flex_type_enum::VECTOR);
        }
        break;
@@ -1275,13 +1298,13 @@ class flexible_type {
     switch(type){
      case flex_type_enum::STRING:
        if (v.strval->first.dec() == 0) {
-         delete v.strval;
+         flexible_type_impl::release_string_cell(v.strval);
          v.strval = NULL;
         }
        break;
      case flex_type_enum::VECTOR:
        if (v.vecval->first.dec() == 0) {
-         delete v.vecval;
+         flexible_type_impl::release_vec_cell(v.vecval);
          v.vecval = NULL;
        }
        break;
@@ -1679,12 +1702,10 @@ inline FLEX_ALWAYS_INLINE_FLATTEN void flexible_type::reset(flex_type_enum targe
   // construct the new type
   switch(get_type()) {
    case flex_type_enum::STRING:
-     val.strval = new std::pair<atomic<size_t>, flex_string>;
-     val.strval->first.value = 1;
+     val.strval = flexible_type_impl::allocate_string_cell();
      break;
    case flex_type_enum::VECTOR:
-     val.vecval = new std::pair<atomic<size_t>, flex_vec>;
-     val.vecval->first.value = 1;
+     val.vecval = flexible_type_impl::allocate_vec_cell();
      break;
    case flex_type_enum::LIST:
      val.recval = new std::pair<atomic<size_t>, flex_list>;
@@ -0,0 +1,153 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_MIRROR_GATHER_CACHE_HPP
+#define GRAPHLAB_MIRROR_GATHER_CACHE_HPP
+
+#include <vector>
+#include <utility>
+#include <boost/unordered_map.hpp>
+#include <logger/assertions.hpp>
+#include <parallel/pthread_tools.hpp>
+#include <rpc/dc_types.hpp>
+
+namespace graphlab {
+
+  /**
+   * \brief How a mirror's cached gather is synchronized with the master.
+   */
+  enum cache_sync_type {
+    CACHE_SET,   ///< The contribution is replaced by the value
+    CACHE_DELTA, ///< The value is added to the contribution
+    CACHE_CLEAR  ///< The contribution is dropped
+  };
+
+  /**
+   * \brief The master's copy of the cached gathers of the mirrors of one
+   * vertex, keyed by the machine holding the mirror.
+   *
+   * A vertex has few mirrors so the entries are kept in a small
+   * unordered vector. The caller is responsible for locking.
+   */
+  template<typename GatherType>
+  class mirror_gather_cache {
+   public:
+    typedef std::pair<procid_t, GatherType> entry_type;
+
+    /**
+     * Applies a change sent by the mirror on machine proc.
+     * A CACHE_DELTA must follow a CACHE_SET from the same machine.
+     */
+    void update(procid_t proc, unsigned char sync_type, const GatherType& value) {
+      size_t idx = 0;
+      while(idx < entries.size() && entries[idx].first != proc) ++idx;
+      if(sync_type == CACHE_SET) {
+        if(idx == entries.size()) entries.push_back(std::make_pair(proc, value));
+        else entries[idx].second = value;
+      } else if(sync_type == CACHE_DELTA) {
+        ASSERT_LT(idx, entries.size());
+        entries[idx].second += value;
+      } else if(idx < entries.size()) {
+        entries[idx] = entries.back();
+        entries.pop_back();
+      }
+    }
+
+    /**
+     * Adds every cached contribution to accum. If accum_is_set is false,
+     * the first contribution is assigned and accum_is_set becomes true.
+     */
+    void add_to(GatherType& accum, bool& accum_is_set) const {
+      for (size_t i = 0; i < entries.size(); ++i) {
+        if(accum_is_set) {
+          accum += entries[i].second;
+        } else {
+          accum = entries[i].second;
+          accum_is_set = true;
+        }
+      }
+    }
+
+    /// Returns the cached contribution of proc, or NULL if there is none
+    const GatherType* get(procid_t proc) const {
+      for (size_t i = 0; i < entries.size(); ++i) {
+        if(entries[i].first == proc) return &entries[i].second;
+      }
+      return NULL;
+    }
+
+    size_t size() const { return entries.size(); }
+
+    void clear() { entries.clear(); }
+
+   private:
+    std::vector<entry_type> entries;
+  };
+
+
+  /**
+   * \brief A concurrent buffer combining messages by key.
+   *
+   * The buffer is split into stripes by key, each with its own lock, so
+   * that threads adding messages for different keys rarely contend.
+   * Messages to the same key are combined with operator+=.
+   */
+  template<typename KeyType, typename MessageType>
+  class striped_message_combiner {
+   public:
+    typedef boost::unordered_map<KeyType, MessageType> map_type;
+
+    explicit striped_message_combiner(size_t nstripes = 64):
+        stripes(nstripes), locks(nstripes) { }
+
+    size_t num_stripes() const { return stripes.size(); }
+
+    /// Combines message into the buffered message for key
+    void add(const KeyType& key, const MessageType& message) {
+      const size_t stripe = key % stripes.size();
+      locks[stripe].lock();
+      typename map_type::iterator iter = stripes[stripe].find(key);
+      if (iter == stripes[stripe].end()) {
+        stripes[stripe].insert(std::make_pair(key, message));
+      } else {
+        iter->second += message;
+      }
+      locks[stripe].unlock();
+    }
+
+    /**
+     * Calls fn(key, message) on every message buffered in the stripe and
+     * empties it. Different threads may drain different stripes at once.
+     */
+    template<typename Fn>
+    void drain(size_t stripe, Fn fn) {
+      locks[stripe].lock();
+      for (typename map_type::const_iterator iter = stripes[stripe].begin();
+           iter != stripes[stripe].end(); ++iter) {
+        fn(iter->first, iter->second);
+      }
+      stripes[stripe].clear();
+      locks[stripe].unlock();
+    }
+
+    /// Drops every buffered message
+    void clear() {
+      for (size_t i = 0; i < stripes.size(); ++i) {
+        locks[i].lock();
+        stripes[i].clear();
+        locks[i].unlock();
+      }
+    }
+
+   private:
+    std::vector<map_type> stripes;
+    std::vector<simple_spinlock> locks;
+  };
+
+} // end of namespace graphlab
+
+#endif
@@ -34,6 +34,7 @@
 
 #include <deque>
 #include <boost/bind.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <graphlab/engine/iengine.hpp>
 
@@ -42,6 +43,7 @@
 #include <graphlab/vertex_program/context.hpp>
 
 #include <graphlab/engine/execution_status.hpp>
+#include <graphlab/engine/mirror_gather_cache.hpp>
 #include <graphlab/options/graphlab_options.hpp>
 
 
@@ -193,7 +195,11 @@ namespace graphlab {
    * vertices that already have a cached value.  To use caching the
    * vertex program must either clear (\ref icontext::clear_gather_cache)
    * or update (\ref icontext::post_delta) the cache values of
-   * neighboring vertices during the scatter phase.
+   * neighboring vertices during the scatter phase.  The master of each
+   * vertex also keeps the cached value of each of its mirrors, so a
+   * mirror whose cache has not changed sends nothing during the gather
+   * phase, and a mirror whose cache was updated with \ref
+   * icontext::post_delta only sends the sum of the deltas.
    *
    * \li \b snapshot_interval If set to a positive value, a snapshot
    * is taken every this number of iterations. If set to 0, a snapshot
@@ -492,6 +498,33 @@ namespace graphlab {
      */
     dense_bitset has_cache;
 
+    /**
+     * \brief For mirror vertices, a bit indicating that the master
+     * holds a cached contribution from this machine.  While the local
+     * cache is available, the master's copy equals the local cache less
+     * \ref graphlab::synchronous_engine::cache_delta.
+     */
+    dense_bitset cache_synced;
+
+    /**
+     * \brief For mirror vertices, the sum of the deltas posted to the
+     * cache since it was last sent to the master.
+     */
+    std::vector<gather_type> cache_delta;
+
+    /**
+     * \brief Bit indicating if cache_delta contains any values.
+     */
+    dense_bitset has_cache_delta;
+
+    /**
+     * \brief For master vertices, the cached contribution of each
+     * mirror (keyed by the machine holding the mirror), as last sent
+     * by that mirror.  These are added to the gather accumulator
+     * before the apply.
+     */
+    std::vector<mirror_gather_cache<gather_type> > mirror_cache;
+
     /**
      * \brief A bit (for master vertices) indicating if that vertex is active
      * (received a message on this iteration).
@@ -587,6 +620,32 @@ namespace graphlab {
      */
     message_exchange_type message_exchange;
 
+    /**
+     * \brief Messages sent with \ref icontext::signal_vid to vertices
+     * which have no instance on this machine.  Messages to the same
+     * vertex are combined here and sent to its master in the next
+     * message exchange.
+     */
+    striped_message_combiner<vertex_id_type, message_type> remote_messages;
+
+    /**
+     * \brief The pair type used to synchronize cached gathers.  The
+     * second pair holds a cache_sync_type and the value.
+     */
+    typedef std::pair<vertex_id_type, std::pair<unsigned char, gather_type> >
+        vid_cache_pair_type;
+
+    /**
+     * \brief The type of the exchange used to synchronize cached gathers
+     */
+    typedef fiber_buffered_exchange<vid_cache_pair_type> cache_exchange_type;
+
+    /**
+     * \brief The distributed exchange used to send cached gathers (and
+     * changes to them) from mirrors to masters when caching is enabled.
+     */
+    cache_exchange_type cache_exchange;
+
 
     /**
      * \brief The distributed aggregator used to manage background
@@ -942,6 +1001,32 @@ namespace graphlab {
      */
     void recv_gathers();
 
+    /**
+     * \brief Synchronize the cached gather of a mirror with its master.
+     *
+     * If the master already holds the cache only the deltas posted
+     * since are sent.
+     *
+     * @param [in] lvid the mirror vertex
+     * @param [in] from_cache true if accum was read from the cache
+     * @param [in] accum_is_set true if accum holds a value
+     * @param [in] accum the local gather value
+     */
+    void sync_cache(lvid_type lvid, bool from_cache, bool accum_is_set,
+                    const gather_type& accum);
+
+    /**
+     * \brief Receive the cached gathers of mirrors from the buffered
+     * exchange.
+     */
+    void recv_caches();
+
+    /**
+     * \brief Add the cached contributions of the mirrors of a master
+     * vertex to its gather accumulator.
+     */
+    void add_mirror_caches(lvid_type lvid);
+
     /**
      * \brief Send the accumulated message for the local vertex to its
      * master.
@@ -950,6 +1035,12 @@ namespace graphlab {
      */
     void sync_message(lvid_type lvid, const size_t thread_id);
 
+    /**
+     * \brief Send a message combined in remote_messages to the master
+     * of the vertex.
+     */
+    void send_remote_message(vertex_id_type gvid, const message_type& message);
+
     /**
      * \brief Receive the messages from the buffered exchange.
      *
@@ -1020,6 +1111,8 @@ namespace graphlab {
     vdata_exchange(dc),
     gather_exchange(dc),
     message_exchange(dc),
+    remote_messages(64),
+    cache_exchange(dc),
     aggregator(dc, graph, new context_type(*this, graph)) {
     // Process any additional options
     std::vector<std::string> keys = opts.get_engine_args().get_option_keys();
@@ -1085,6 +1178,9 @@ namespace graphlab {
     has_message.clear();
     has_gather_accum.clear();
     has_cache.clear();
+    cache_synced.clear();
+    has_cache_delta.clear();
+    for (size_t i = 0; i < mirror_cache.size(); ++i) mirror_cache[i].clear();
     active_superstep.clear();
     active_minorstep.clear();
   }
@@ -1109,6 +1205,10 @@ namespace graphlab {
     if (use_cache) {
       gather_cache.resize(graph.num_local_vertices(), gather_type());
       has_cache.resize(graph.num_local_vertices());
+      cache_synced.resize(graph.num_local_vertices());
+      cache_delta.resize(graph.num_local_vertices(), gather_type());
+      has_cache_delta.resize(graph.num_local_vertices());
+      mirror_cache.resize(graph.num_local_vertices());
     }
     // Allocate bitset to track active vertices on each bitset.
     active_superstep.resize(graph.num_local_vertices());
@@ -1197,11 +1297,12 @@ namespace graphlab {
   template<typename VertexProgram>
   void synchronous_engine<VertexProgram>::
   internal_signal_gvid(vertex_id_type gvid, const message_type& message) {
-    procid_t proc = graph.master(gvid);
-    if(proc == rmi.procid()) internal_signal_rpc(gvid, message);
-    else rmi.remote_call(proc, 
-                         &synchronous_engine<VertexProgram>::internal_signal_rpc,
-                         gvid, message);
+    if (graph.contains_vertex(gvid)) {
+      // messages to mirrors are combined and sent in exchange_messages
+      internal_signal(vertex_type(graph.l_vertex(graph.local_vid(gvid))), message);
+      return;
+    }
+    remote_messages.add(gvid, message);
   } 
 
   template<typename VertexProgram>
@@ -1226,6 +1327,15 @@ namespace graphlab {
       vlocks[lvid].lock();
       if( has_cache.get(lvid) ) {
         gather_cache[lvid] += delta;
+        // remember the change for the master's copy of the cache
+        if (cache_synced.get(lvid)) {
+          if (has_cache_delta.get(lvid)) {
+            cache_delta[lvid] += delta;
+          } else {
+            cache_delta[lvid] = delta;
+            has_cache_delta.set_bit(lvid);
+          }
+        }
       } else {
         // You cannot add a delta to an empty cache.  A complete
         // gather must have been run.
@@ -1246,6 +1356,9 @@ namespace graphlab {
       vlocks[lvid].lock();
       gather_cache[lvid] = gather_type();
       has_cache.clear_bit(lvid);
+      // the master's copy (if any) is replaced at the next gather
+      cache_delta[lvid] = gather_type();
+      has_cache_delta.clear_bit(lvid);
       vlocks[lvid].unlock();
     }
   } // end of clear_gather_cache
@@ -1467,6 +1580,12 @@ namespace graphlab {
     context_type context(*this, graph);
     const size_t TRY_RECV_MOD = 100;
     size_t vcount = 0;
+    // send the combined messages to vertices with no local instance
+    for (size_t stripe = thread_id; stripe < remote_messages.num_stripes();
+         stripe += ncpus) {
+      remote_messages.drain(stripe,
+          boost::bind(&synchronous_engine::send_remote_message, this, _1, _2));
+    }
     fixed_dense_bitset<8 * sizeof(size_t)> local_bitset; // a word-size = 64 bit
     while (1) {
       // increment by a word at a time
@@ -1595,12 +1714,14 @@ namespace graphlab {
         if (lvid >= graph.num_local_vertices()) break;
 
         bool accum_is_set = false;
+        bool from_cache = false;
         gather_type accum = gather_type();
         // if caching is enabled and we have a cache entry then use
         // that as the accum
         if( caching_enabled && has_cache.get(lvid) ) {
           accum = gather_cache[lvid];
           accum_is_set = true;
+          from_cache = true;
         } else {
           // recompute the local contribution to the gather
           const vertex_program_type& vprog = vertex_programs[lvid];
@@ -1650,24 +1771,36 @@ namespace graphlab {
           } // end of if caching enabled
         }
         // If the accum contains a value for the local gather we put
-        // that estimate in the gather exchange.
-        if(accum_is_set) sync_gather(lvid, accum, thread_id);
+        // that estimate in the gather exchange.  With caching, mirrors
+        // instead keep the master's copy of their cache up to date.
+        if(caching_enabled && !graph.l_is_master(lvid)) {
+          sync_cache(lvid, from_cache, accum_is_set, accum);
+        } else if(accum_is_set) {
+          sync_gather(lvid, accum, thread_id);
+        }
         if(!graph.l_is_master(lvid)) {
           // if this is not the master clear the vertex program
           vertex_programs[lvid] = vertex_program_type();
         }
 
         // try to recv gathers if there are any in the buffer
-        if(++vcount % TRY_RECV_MOD == 0) recv_gathers();
+        if(++vcount % TRY_RECV_MOD == 0) {
+          recv_gathers();
+          if(caching_enabled) recv_caches();
+        }
       }
     } // end of loop over vertices to compute gather accumulators
     per_thread_compute_time[thread_id] += ti.current_time();
     gather_exchange.partial_flush();
+    cache_exchange.partial_flush();
       // Finish sending and receiving all gather operations
     thread_barrier.wait();
-    if(thread_id == 0) gather_exchange.flush();
+    if(thread_id == 0) {
+      gather_exchange.flush(); cache_exchange.flush();
+    }
     thread_barrier.wait();
     recv_gathers();
+    recv_caches();
   } // end of execute_gathers
 
 
@@ -1677,6 +1810,7 @@ namespace graphlab {
     context_type context(*this, graph);
     const size_t TRY_RECV_MOD = 1000;
     size_t vcount = 0;
+    const bool caching_enabled = !gather_cache.empty();
     timer ti;
 
     fixed_dense_bitset<8 * sizeof(size_t)> local_bitset;  // allocate a word size = 64bits
@@ -1698,6 +1832,12 @@ namespace graphlab {
         // Only master vertices can be active in a super-step
         ASSERT_TRUE(graph.l_is_master(lvid));
         vertex_type vertex(graph.l_vertex(lvid));
+        // Add the cached gathers of the mirrors if the vertex gathered
+        if(caching_enabled &&
+           (sched_allv || vertex_programs[lvid].gather_edges(context, vertex) !=
+                          graphlab::NO_EDGES)) {
+          add_mirror_caches(lvid);
+        }
         // Get the local accumulator.  Note that it is possible that
         // the gather_accum was not set during the gather.
         const gather_type& accum = gather_accum[lvid];
@@ -1909,6 +2049,68 @@ namespace graphlab {
   } // end of recv_gather
 
 
+  template<typename VertexProgram>
+  void synchronous_engine<VertexProgram>::
+  sync_cache(lvid_type lvid, bool from_cache, bool accum_is_set,
+             const gather_type& accum) {
+    ASSERT_FALSE(graph.l_is_master(lvid));
+    const procid_t master = graph.l_master(lvid);
+    const vertex_id_type vid = graph.global_vid(lvid);
+    if(from_cache && cache_synced.get(lvid)) {
+      // The master has the cache: send only the deltas, if any
+      if(!has_cache_delta.get(lvid)) return;
+      vlocks[lvid].lock();
+      gather_type delta = cache_delta[lvid];
+      cache_delta[lvid] = gather_type();
+      has_cache_delta.clear_bit(lvid);
+      vlocks[lvid].unlock();
+      cache_exchange.send(master,
+                          std::make_pair(vid, std::make_pair((unsigned char)CACHE_DELTA,
+                                                             delta)));
+    } else if(accum_is_set) {
+      cache_exchange.send(master,
+                          std::make_pair(vid, std::make_pair((unsigned char)CACHE_SET,
+                                                             accum)));
+      cache_synced.set_bit(lvid);
+    } else if(cache_synced.get(lvid)) {
+      // The master holds a stale contribution
+      cache_exchange.send(master,
+                          std::make_pair(vid, std::make_pair((unsigned char)CACHE_CLEAR,
+                                                             gather_type())));
+      cache_synced.clear_bit(lvid);
+    }
+  } // end of sync_cache
+
+
+  template<typename VertexProgram>
+  void synchronous_engine<VertexProgram>::
+  recv_caches() {
+    typename cache_exchange_type::recv_buffer_type recv_buffer;
+    while(cache_exchange.recv(recv_buffer)) {
+      for (size_t i = 0;i < recv_buffer.size(); ++i) {
+        const procid_t proc = recv_buffer[i].proc;
+        typename cache_exchange_type::buffer_type& buffer = recv_buffer[i].buffer;
+        foreach(const vid_cache_pair_type& pair, buffer) {
+          const lvid_type lvid = graph.local_vid(pair.first);
+          ASSERT_TRUE(graph.l_is_master(lvid));
+          vlocks[lvid].lock();
+          mirror_cache[lvid].update(proc, pair.second.first, pair.second.second);
+          vlocks[lvid].unlock();
+        }
+      }
+    }
+  } // end of recv_caches
+
+
+  template<typename VertexProgram>
+  void synchronous_engine<VertexProgram>::
+  add_mirror_caches(lvid_type lvid) {
+    bool accum_is_set = has_gather_accum.get(lvid);
+    mirror_cache[lvid].add_to(gather_accum[lvid], accum_is_set);
+    if(accum_is_set) has_gather_accum.set_bit(lvid);
+  } // end of add_mirror_caches
+
+
   template<typename VertexProgram>
   void synchronous_engine<VertexProgram>::
   sync_message(lvid_type lvid, const size_t thread_id) {
@@ -1919,6 +2121,13 @@ namespace graphlab {
   } // end of send_message
 
 
+  template<typename VertexProgram>
+  void synchronous_engine<VertexProgram>::
+  send_remote_message(vertex_id_type gvid, const message_type& message) {
+    message_exchange.send(graph.master(gvid), std::make_pair(gvid, message));
+  } // end of send_remote_message
+
+
 
 
   template<typename VertexProgram>
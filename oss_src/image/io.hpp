@@ -9,6 +9,7 @@
 #define GRAPHLAB_IMAGE_IO_IMPL_HPP
 
 #include <string>
+#include <vector>
 #include <image/image_type.hpp>
 
 namespace graphlab {
@@ -37,6 +38,12 @@ void parse_jpeg(const char* data, size_t length,
 
 void decode_jpeg(const char* data, size_t length, char** decoded_data, size_t& out_length);
 
+/**
+ * Decode the jpeg into decoded_data, resizing it to the decoded length.
+ * decoded_data can be reused across calls to avoid an allocation per image.
+ */
+void decode_jpeg(const char* data, size_t length, std::vector<char>& decoded_data);
+
 /**
  * Parse the image information, set width, height and channels using libpng.
  */
@@ -45,6 +52,12 @@ void parse_png(const char* data, size_t length,
 
 void decode_png(const char* data, size_t length, char** decoded_data, size_t& out_length);
 
+/**
+ * Decode the png into decoded_data, resizing it to the decoded length.
+ * decoded_data can be reused across calls to avoid an allocation per image.
+ */
+void decode_png(const char* data, size_t length, std::vector<char>& decoded_data);
+
 void encode_png(const char* data, size_t width, size_t height, size_t channels, char** out_data, size_t& out_length); 
 /**************************************************************************/
 /*                                                                        */
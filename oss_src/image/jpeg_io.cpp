@@ -22,6 +22,7 @@
 #include <jpeglib.h>
 
 #include <string.h>
+#include <vector>
 
 namespace graphlab {
 
@@ -63,7 +64,12 @@ void parse_jpeg(const char* data, size_t length,
   jpeg_destroy_decompress(&cinfo);
 }
 
-void decode_jpeg(const char* data, size_t length, char** out_data, size_t& out_length) {
+/*
+ * Decodes into the buffer returned by alloc(decoded length). On failure the
+ * caller is responsible for releasing what alloc returned.
+ */
+template <typename Alloc>
+static void decode_jpeg_impl(const char* data, size_t length, Alloc alloc) {
   struct jpeg_decompress_struct cinfo;
   struct jpeg_error_mgr jerr;
   memset(&cinfo, 0, sizeof(cinfo));
@@ -71,8 +77,6 @@ void decode_jpeg(const char* data, size_t length, char** out_data, size_t& out_l
   // Initialize the JPEG decompression object with default error handling
   cinfo.err = jpeg_std_error(&jerr);
   jerr.error_exit = jpeg_error_exit;
-  *out_data = NULL;
-  out_length = 0;
 
   if (data == NULL) {
     log_and_throw("Trying to decode image with NULL data pointer.");
@@ -88,28 +92,49 @@ void decode_jpeg(const char* data, size_t length, char** out_data, size_t& out_l
     size_t width = cinfo.image_width;
     size_t height = cinfo.image_height;
     size_t channels = cinfo.num_components;
-    out_length = width * height * channels;
-    *out_data = new char[out_length];
+    char* out_data = alloc(width * height * channels);
     size_t row_stride = width * channels;
 
     size_t row_offset = 0;
     JSAMPROW rowptr[1];
     while (cinfo.output_scanline < cinfo.output_height) {
-      rowptr[0] = (unsigned char*)(*out_data + row_offset * row_stride);
+      rowptr[0] = (unsigned char*)(out_data + row_offset * row_stride);
       jpeg_read_scanlines(&cinfo, rowptr, 1);
       ++row_offset;
     }
 
     jpeg_finish_decompress(&cinfo);
+  } catch (...) {
+    jpeg_destroy_decompress(&cinfo);
+    throw;
+  }
+  jpeg_destroy_decompress(&cinfo);
+}
+
+void decode_jpeg(const char* data, size_t length, char** out_data, size_t& out_length) {
+  *out_data = NULL;
+  out_length = 0;
+  try {
+    decode_jpeg_impl(data, length, [&](size_t decoded_length) {
+      *out_data = new char[decoded_length];
+      out_length = decoded_length;
+      return *out_data;
+    });
   } catch (...) {
     if (*out_data != NULL) {
       delete[] *out_data;
+      *out_data = NULL;
       out_length = 0;
     }
-    jpeg_destroy_decompress(&cinfo);
     throw;
   }
-  jpeg_destroy_decompress(&cinfo);
+}
+
+void decode_jpeg(const char* data, size_t length, std::vector<char>& out_data) {
+  decode_jpeg_impl(data, length, [&](size_t decoded_length) {
+    out_data.resize(decoded_length);
+    return out_data.data();
+  });
 }
 
 }
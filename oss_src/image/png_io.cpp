@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <png.h>
 #include <string.h>
+#include <vector>
 #include <logger/logger.hpp>
 
 #ifndef png_infopp_NULL
@@ -289,7 +290,11 @@ void encode_png(const char* data ,size_t width, size_t height, size_t channels,
   png_destroy_write_struct(&png_ptr, &info_ptr); 
 }
 
-void decode_png(const char* data, size_t length, char** out_data, size_t& out_length) {
+/*
+ * Decodes into the buffer returned by alloc(decoded length).
+ */
+template <typename Alloc>
+static void decode_png_impl(const char* data, size_t length, Alloc alloc) {
   //Check for NULL data pointer
   if (data == NULL){
     log_and_throw("Trying to decode image with NULL data pointer");
@@ -317,13 +322,27 @@ void decode_png(const char* data, size_t length, char** out_data, size_t& out_le
 
   int channels = png_num_channels(color_type);
   size_t row_stride = width * channels;
-  out_length = width * height * channels;
-  *out_data = new char[out_length];
+  char* out_data = alloc(width * height * channels);
   for (size_t i = 0; i < height; ++i) {
-    png_read_row(png_ptr, (png_bytep)(*out_data + i * row_stride), NULL);
+    png_read_row(png_ptr, (png_bytep)(out_data + i * row_stride), NULL);
   }
   png_read_end(png_ptr,NULL);
   png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 }
 
+void decode_png(const char* data, size_t length, char** out_data, size_t& out_length) {
+  decode_png_impl(data, length, [&](size_t decoded_length) {
+    out_length = decoded_length;
+    *out_data = new char[decoded_length];
+    return *out_data;
+  });
+}
+
+void decode_png(const char* data, size_t length, std::vector<char>& out_data) {
+  decode_png_impl(data, length, [&](size_t decoded_length) {
+    out_data.resize(decoded_length);
+    return out_data.data();
+  });
+}
+
 } // end of graphlab
@@ -0,0 +1,320 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_LAMBDA_COLUMNAR_BATCH_HPP
+#define GRAPHLAB_LAMBDA_COLUMNAR_BATCH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <flexible_type/flexible_type.hpp>
+#include <serialization/oarchive.hpp>
+#include <serialization/iarchive.hpp>
+#include <sframe/sframe_rows.hpp>
+#include <logger/assertions.hpp>
+
+namespace graphlab {
+namespace lambda {
+
+/**
+ * \ingroup lambda
+ * A view of one column of a \ref columnar_batch.
+ *
+ * Integer, float and string columns are read in place from the buffer the
+ * batch was loaded from. Value i is present if bit (i % 8) of validity[i / 8]
+ * is set; missing values are NULL.
+ *  - INTEGER: int_values[i]
+ *  - FLOAT: float_values[i]
+ *  - STRING: the bytes [string_offsets[i], string_offsets[i+1]) of string_data
+ *
+ * Columns of any other type (or of mixed types) are stored generically, and
+ * decoded into generic_values; type is then UNDEFINED.
+ */
+struct columnar_column_view {
+  flex_type_enum type = flex_type_enum::UNDEFINED;
+  const unsigned char* validity = nullptr;
+  const flex_int* int_values = nullptr;
+  const flex_float* float_values = nullptr;
+  const uint64_t* string_offsets = nullptr;
+  const char* string_data = nullptr;
+  const flexible_type* generic_values = nullptr;
+
+  inline bool is_valid(size_t i) const {
+    return validity[i >> 3] & (1 << (i & 7));
+  }
+};
+
+/**
+ * \ingroup lambda
+ * The columnar wire layout used to ship batches of rows to and from the
+ * lambda workers over shared memory.
+ *
+ * Layout (all fixed width fields are 8 byte aligned relative to the start
+ * of the archive buffer):
+ * \verbatim
+ *   uint64 num_rows
+ *   uint64 num_columns
+ *   for each column:
+ *     char type           INTEGER, FLOAT, STRING, or UNDEFINED (generic)
+ *     validity bitmap     (num_rows + 7) / 8 bytes
+ *     INTEGER:            num_rows int64 values
+ *     FLOAT:              num_rows double values
+ *     STRING:             num_rows + 1 uint64 offsets, followed by the bytes
+ *     generic:            num_rows serialized flexible_types
+ * \endverbatim
+ *
+ * Compared to serializing the flexible_types, the typed columns carry no
+ * per value type tags or lengths, and can be read without constructing a
+ * flexible_type per value.
+ *
+ * Usage:
+ * \code
+ * oarchive oarc;
+ * write_columnar_batch(oarc, rows);
+ * ...
+ * iarchive iarc(buf, len);
+ * columnar_batch batch;
+ * batch.load(iarc);  // buf must stay alive while batch is used
+ * batch.column(0).int_values[5];
+ * \endcode
+ */
+class columnar_batch {
+ public:
+  /**
+   * Reads a batch from a buffer backed archive. The column views point into
+   * the archive buffer, which must be 8 byte aligned and outlive the batch.
+   */
+  void load(iarchive& iarc) {
+    ASSERT_TRUE(iarc.buf != nullptr);
+    align(iarc);
+    uint64_t num_rows = 0, num_columns = 0;
+    iarc.read_into(num_rows);
+    iarc.read_into(num_columns);
+    m_num_rows = num_rows;
+    m_columns.clear();
+    m_columns.resize(num_columns);
+    m_generic_values.clear();
+    m_generic_values.resize(num_columns);
+    const size_t bitmap_bytes = (m_num_rows + 7) / 8;
+
+    for (size_t j = 0; j < num_columns; ++j) {
+      auto& column = m_columns[j];
+      char type;
+      iarc >> type;
+      column.type = (flex_type_enum)(type);
+      align(iarc);
+      column.validity = reinterpret_cast<const unsigned char*>(iarc.buf + iarc.off);
+      iarc.off += bitmap_bytes;
+      align(iarc);
+      switch(column.type) {
+       case flex_type_enum::INTEGER:
+         column.int_values = reinterpret_cast<const flex_int*>(iarc.buf + iarc.off);
+         iarc.off += sizeof(flex_int) * m_num_rows;
+         break;
+       case flex_type_enum::FLOAT:
+         column.float_values = reinterpret_cast<const flex_float*>(iarc.buf + iarc.off);
+         iarc.off += sizeof(flex_float) * m_num_rows;
+         break;
+       case flex_type_enum::STRING:
+         column.string_offsets = reinterpret_cast<const uint64_t*>(iarc.buf + iarc.off);
+         iarc.off += sizeof(uint64_t) * (m_num_rows + 1);
+         column.string_data = iarc.buf + iarc.off;
+         iarc.off += column.string_offsets[m_num_rows];
+         align(iarc);
+         break;
+       default:
+         column.type = flex_type_enum::UNDEFINED;
+         m_generic_values[j].resize(m_num_rows);
+         for (auto& val: m_generic_values[j]) iarc >> val;
+         column.generic_values = m_generic_values[j].data();
+         align(iarc);
+         break;
+      }
+      ASSERT_LE(iarc.off, iarc.len);
+    }
+  }
+
+  inline size_t num_rows() const { return m_num_rows; }
+
+  inline size_t num_columns() const { return m_columns.size(); }
+
+  inline const columnar_column_view& column(size_t j) const { return m_columns[j]; }
+
+  inline const columnar_column_view* columns() const { return m_columns.data(); }
+
+  /**
+   * Returns one value as a flexible_type.
+   */
+  flexible_type value(size_t j, size_t i) const {
+    const auto& column = m_columns[j];
+    if (column.type == flex_type_enum::UNDEFINED) return column.generic_values[i];
+    if (!column.is_valid(i)) return FLEX_UNDEFINED;
+    switch(column.type) {
+     case flex_type_enum::INTEGER:
+       return column.int_values[i];
+     case flex_type_enum::FLOAT:
+       return column.float_values[i];
+     default:
+       return flex_string(column.string_data + column.string_offsets[i],
+                          column.string_offsets[i + 1] - column.string_offsets[i]);
+    }
+  }
+
+  /**
+   * Decodes a single column batch into a vector of values.
+   */
+  void to_values(std::vector<flexible_type>& out) const {
+    ASSERT_EQ(num_columns(), 1);
+    out.resize(m_num_rows);
+    for (size_t i = 0; i < m_num_rows; ++i) out[i] = value(0, i);
+  }
+
+  /**
+   * Decodes the batch into sframe_rows.
+   */
+  void to_sframe_rows(sframe_rows& out) const {
+    out.resize(num_columns(), m_num_rows);
+    auto& columns = out.get_columns();
+    for (size_t j = 0; j < num_columns(); ++j) {
+      auto& column = *columns[j];
+      for (size_t i = 0; i < m_num_rows; ++i) column[i] = value(j, i);
+    }
+  }
+
+ private:
+  static void align(iarchive& iarc) {
+    iarc.off = (iarc.off + 7) & ~size_t(7);
+  }
+
+  size_t m_num_rows = 0;
+  std::vector<columnar_column_view> m_columns;
+  std::vector<std::vector<flexible_type>> m_generic_values;
+};
+
+
+namespace columnar_batch_impl {
+
+inline void align(oarchive& oarc) {
+  size_t padding = ((oarc.off + 7) & ~size_t(7)) - oarc.off;
+  if (padding) {
+    oarc.expand_buf(padding);
+    memset(oarc.buf + oarc.off, 0, padding);
+    oarc.off += padding;
+  }
+}
+
+/*
+ * Writes one column of num_rows values, where get(i) returns the i-th value.
+ */
+template <typename GetFn>
+void write_column(oarchive& oarc, size_t num_rows, GetFn get) {
+  ASSERT_TRUE(oarc.out == nullptr);
+  // The column is typed if all the values which are present have the same
+  // integer, float or string type.
+  flex_type_enum type = flex_type_enum::UNDEFINED;
+  bool typed = true;
+  for (size_t i = 0; i < num_rows && typed; ++i) {
+    flex_type_enum t = get(i).get_type();
+    if (t == flex_type_enum::UNDEFINED) continue;
+    if (type == flex_type_enum::UNDEFINED) type = t;
+    typed = (t == type);
+  }
+  if (type == flex_type_enum::UNDEFINED) type = flex_type_enum::INTEGER;
+  if (!typed || (type != flex_type_enum::INTEGER &&
+                 type != flex_type_enum::FLOAT &&
+                 type != flex_type_enum::STRING)) {
+    type = flex_type_enum::UNDEFINED;
+  }
+
+  oarc << (char)(type);
+  align(oarc);
+  size_t bitmap_bytes = (num_rows + 7) / 8;
+  oarc.expand_buf(bitmap_bytes);
+  unsigned char* validity = reinterpret_cast<unsigned char*>(oarc.buf + oarc.off);
+  memset(validity, 0, bitmap_bytes);
+  for (size_t i = 0; i < num_rows; ++i) {
+    if (get(i).get_type() != flex_type_enum::UNDEFINED) validity[i >> 3] |= (1 << (i & 7));
+  }
+  oarc.off += bitmap_bytes;
+  align(oarc);
+
+  switch(type) {
+   case flex_type_enum::INTEGER:
+     for (size_t i = 0; i < num_rows; ++i) {
+       const flexible_type& val = get(i);
+       oarc.direct_assign(val.get_type() == flex_type_enum::INTEGER ? val.get<flex_int>() : flex_int(0));
+     }
+     break;
+   case flex_type_enum::FLOAT:
+     for (size_t i = 0; i < num_rows; ++i) {
+       const flexible_type& val = get(i);
+       oarc.direct_assign(val.get_type() == flex_type_enum::FLOAT ? val.get<flex_float>() : flex_float(0));
+     }
+     break;
+   case flex_type_enum::STRING: {
+     uint64_t offset = 0;
+     oarc.direct_assign(offset);
+     for (size_t i = 0; i < num_rows; ++i) {
+       const flexible_type& val = get(i);
+       if (val.get_type() == flex_type_enum::STRING) offset += val.get<flex_string>().size();
+       oarc.direct_assign(offset);
+     }
+     for (size_t i = 0; i < num_rows; ++i) {
+       const flexible_type& val = get(i);
+       if (val.get_type() == flex_type_enum::STRING) {
+         const flex_string& s = val.get<flex_string>();
+         oarc.write(s.data(), s.size());
+       }
+     }
+     align(oarc);
+     break;
+   }
+   default:
+     for (size_t i = 0; i < num_rows; ++i) oarc << get(i);
+     align(oarc);
+     break;
+  }
+}
+
+} // namespace columnar_batch_impl
+
+/**
+ * Writes sframe_rows to a buffer backed archive in the
+ * \ref columnar_batch layout.
+ */
+inline void write_columnar_batch(oarchive& oarc, const sframe_rows& rows) {
+  columnar_batch_impl::align(oarc);
+  uint64_t num_rows = rows.num_rows();
+  uint64_t num_columns = rows.num_columns();
+  oarc.direct_assign(num_rows);
+  oarc.direct_assign(num_columns);
+  const auto& columns = rows.cget_columns();
+  for (size_t j = 0; j < num_columns; ++j) {
+    const auto& column = *columns[j];
+    columnar_batch_impl::write_column(
+        oarc, num_rows, [&](size_t i)->const flexible_type& { return column[i]; });
+  }
+}
+
+/**
+ * Writes a single column of values to a buffer backed archive in the
+ * \ref columnar_batch layout.
+ */
+inline void write_columnar_batch(oarchive& oarc, const std::vector<flexible_type>& values) {
+  columnar_batch_impl::align(oarc);
+  uint64_t num_rows = values.size();
+  uint64_t num_columns = 1;
+  oarc.direct_assign(num_rows);
+  oarc.direct_assign(num_columns);
+  columnar_batch_impl::write_column(
+      oarc, num_rows, [&](size_t i)->const flexible_type& { return values[i]; });
+}
+
+} // namespace lambda
+} // namespace graphlab
+
+#endif
@@ -13,15 +13,43 @@ namespace graphlab {
 
 size_t DEFAULT_NUM_PYLAMBDA_WORKERS = 16;
 
+size_t PYLAMBDA_MIN_WORKERS = 2;
+
 size_t DEFAULT_NUM_GRAPH_LAMBDA_WORKERS = 16;
 
+size_t PYLAMBDA_MAX_INFLIGHT_BATCHES = 2;
+
+size_t PYLAMBDA_MEMO_CACHE_BYTES = 64 * 1024 * 1024;
+
+double PYLAMBDA_MEMO_MIN_HIT_RATE = 0.1;
+
 REGISTER_GLOBAL_WITH_CHECKS(int64_t,
                             DEFAULT_NUM_PYLAMBDA_WORKERS,
                             true, 
                             +[](int64_t val){ return val >= 1; });
 
+REGISTER_GLOBAL_WITH_CHECKS(int64_t,
+                            PYLAMBDA_MIN_WORKERS,
+                            true, 
+                            +[](int64_t val){ return val >= 1; });
+
 REGISTER_GLOBAL_WITH_CHECKS(int64_t,
                             DEFAULT_NUM_GRAPH_LAMBDA_WORKERS,
                             true, 
                             +[](int64_t val){ return val >= 1; });
+
+REGISTER_GLOBAL_WITH_CHECKS(int64_t,
+                            PYLAMBDA_MAX_INFLIGHT_BATCHES,
+                            true, 
+                            +[](int64_t val){ return val >= 1; });
+
+REGISTER_GLOBAL_WITH_CHECKS(int64_t,
+                            PYLAMBDA_MEMO_CACHE_BYTES,
+                            true, 
+                            +[](int64_t val){ return val >= 0; });
+
+REGISTER_GLOBAL_WITH_CHECKS(double,
+                            PYLAMBDA_MEMO_MIN_HIT_RATE,
+                            true, 
+                            +[](double val){ return val >= 0 && val <= 1; });
 }
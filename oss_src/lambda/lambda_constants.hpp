@@ -16,11 +16,34 @@ namespace graphlab {
  */
 extern size_t DEFAULT_NUM_PYLAMBDA_WORKERS;
 
+/**
+ * Number of pylambda workers started up front. More workers are started on
+ * demand, up to DEFAULT_NUM_PYLAMBDA_WORKERS.
+ */
+extern size_t PYLAMBDA_MIN_WORKERS;
+
 /**
  * Number of graph lambda workers
  */
 extern size_t DEFAULT_NUM_GRAPH_LAMBDA_WORKERS;
 
+/**
+ * Maximum number of batches a single lambda transform keeps in flight
+ * across the pylambda workers.
+ */
+extern size_t PYLAMBDA_MAX_INFLIGHT_BATCHES;
+
+/**
+ * Maximum size in bytes of the result cache of a memoized pylambda_function.
+ */
+extern size_t PYLAMBDA_MEMO_CACHE_BYTES;
+
+/**
+ * A memoized pylambda_function stops caching if the hit rate of its cache
+ * is below this.
+ */
+extern double PYLAMBDA_MEMO_MIN_HIT_RATE;
+
 }
 
 #endif
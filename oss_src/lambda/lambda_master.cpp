@@ -12,6 +12,8 @@
 #include <algorithm>
 #include <lambda/lambda_constants.hpp>
 #include <shmipc/shmipc.hpp>
+#include <sframe/sframe_rows.hpp>
+#include <lambda/columnar_batch.hpp>
 
 namespace graphlab { namespace lambda {
 
@@ -41,7 +43,12 @@ static lambda_master* instance_ptr = nullptr;
   }
 
   lambda_master::lambda_master(size_t nworkers) {
-    m_worker_pool.reset(new worker_pool<lambda_evaluator_proxy>(nworkers, lambda_worker_binary_and_args));
+    size_t initial_workers = std::min<size_t>(PYLAMBDA_MIN_WORKERS, nworkers);
+    m_worker_pool.reset(new worker_pool<lambda_evaluator_proxy>(initial_workers,
+                                                                lambda_worker_binary_and_args,
+                                                                3, nworkers));
+    m_worker_pool->set_worker_removed_callback(
+        [this](worker_type& worker) { worker_removed(worker); });
     if (nworkers < thread::cpu_count()) {
       logprogress_stream << "Using default " << nworkers << " lambda workers.\n";
       logprogress_stream << "To maximize the degree of parallelism, add the following code to the beginning of the program:\n";
@@ -52,51 +59,49 @@ static lambda_master* instance_ptr = nullptr;
     boost::optional<std::string> disable_smh = graphlab::getenv_str("GRAPHLAB_DISABLE_LAMBDA_SHM");
     
     if(! (disable_smh && *disable_smh == "1") ) {
-      /*
-       * Create an interprocess shared memory connection if possible.
-       */
-      auto shared_memory_setup = [](std::unique_ptr<lambda_evaluator_proxy>& proxy) {
-        return std::make_pair((void*)(proxy.get()), proxy->initialize_shared_memory_comm());
-      };
-      std::vector<std::pair<void*, std::string>> shared_memory_addresses = 
-          m_worker_pool->call_all_workers<std::pair<void*, std::string>>(shared_memory_setup);
-
-      for (auto shared_memory_address: shared_memory_addresses) {
-        // for each worker, try to connect and store the addresses
-        if (!shared_memory_address.second.empty()) {
-          std::shared_ptr<shmipc::client> client = std::make_shared<shmipc::client>();
-          if (client->connect(shared_memory_address.second)) {
-            m_shared_memory_worker_connections[shared_memory_address.first] = client;
-          }
-        }
-      }
+      // Interprocess shared memory connections are created on the first
+      // use of each worker; see prepare_worker().
+      m_shared_memory_enabled = true;
     } else {
       logprogress_stream << "SHM disabled; falling back to local TCP." << std::endl;
     }
   }
 
+  lambda_master::~lambda_master() {
+    // stop the pool first; its maintenance thread calls back into this object
+    m_worker_pool.reset();
+  }
+
   size_t lambda_master::make_lambda(const std::string& lambda_str) {
-    std::lock_guard<graphlab::mutex> lock(m_mtx);
+    // m_mtx must not be held while waiting for the workers, since
+    // evaluations holding a worker may need it in prepare_worker().
     auto make_lambda_fn = [lambda_str](std::unique_ptr<lambda_evaluator_proxy>& proxy) {
       auto ret = proxy->make_lambda(lambda_str);
       logstream(LOG_INFO) << "Lambda worker proxy make lambda: " << ret << std::endl;
-      return ret;
+      return std::make_pair((void*)(proxy.get()), ret);
     };
-    std::vector<size_t> returned_hashes = m_worker_pool->call_all_workers<size_t>(make_lambda_fn);
+    std::vector<std::pair<void*, size_t>> returned_hashes =
+        m_worker_pool->call_all_workers<std::pair<void*, size_t>>(make_lambda_fn);
     // validate all worker returns the same hash
-    size_t lambda_hash = returned_hashes[0];
+    size_t lambda_hash = returned_hashes[0].second;
     for (auto& v : returned_hashes) {
-      DASSERT_MSG(lambda_hash == v,
+      DASSERT_MSG(lambda_hash == v.second,
                   "workers should return the same lambda index");
     }
+    std::lock_guard<graphlab::mutex> lock(m_mtx);
     m_lambda_object_counter[lambda_hash]++;
+    m_lambda_strings[lambda_hash] = lambda_str;
+    for (auto& v : returned_hashes) {
+      m_worker_lambdas[v.first].insert(lambda_hash);
+    }
     return lambda_hash;
   }
 
   void lambda_master::release_lambda(size_t lambda_hash) noexcept {
     // Check the counter to see if the lambda is unique
-    std::lock_guard<graphlab::mutex> lock(m_mtx);
+    std::set<void*> registered_workers;
     {
+      std::lock_guard<graphlab::mutex> lock(m_mtx);
       if (m_lambda_object_counter.find(lambda_hash) == m_lambda_object_counter.end()) {
         return;
       }
@@ -104,10 +109,19 @@ static lambda_master* instance_ptr = nullptr;
       if (m_lambda_object_counter[lambda_hash] > 0) {
         return;
       }
+      m_lambda_object_counter.erase(lambda_hash);
+      m_lambda_strings.erase(lambda_hash);
+      for (auto& worker_lambdas : m_worker_lambdas) {
+        if (worker_lambdas.second.erase(lambda_hash)) {
+          registered_workers.insert(worker_lambdas.first);
+        }
+      }
     }
 
     // Ok, the lambda is unique, let's issue a release lambda to all workers
-    auto release_lambda_fn = [lambda_hash](std::unique_ptr<lambda_evaluator_proxy>& proxy) {
+    // it was registered on
+    auto release_lambda_fn = [lambda_hash, &registered_workers](std::unique_ptr<lambda_evaluator_proxy>& proxy) {
+      if (registered_workers.count(proxy.get()) == 0) return 0;
       try {
         proxy->release_lambda(lambda_hash);
       } catch (std::exception e){
@@ -121,7 +135,91 @@ static lambda_master* instance_ptr = nullptr;
       }
       return 0;
     };
-    m_worker_pool->call_all_workers<size_t>(release_lambda_fn);
+    try {
+      m_worker_pool->call_all_workers<size_t>(release_lambda_fn);
+    } catch (...) {
+      logstream(LOG_ERROR) << "Error on releasing lambda" << std::endl;
+    }
+  }
+
+
+  std::shared_ptr<shmipc::client> lambda_master::prepare_worker(worker_type& worker,
+                                                                size_t lambda_hash) {
+    void* key = worker.proxy.get();
+    std::string lambda_str;
+    bool need_lambda = false;
+    bool need_shared_memory = false;
+    std::shared_ptr<shmipc::client> shmclient;
+    {
+      std::lock_guard<graphlab::mutex> lock(m_mtx);
+      auto lambda_iter = m_lambda_strings.find(lambda_hash);
+      if (lambda_iter != m_lambda_strings.end() &&
+          m_worker_lambdas[key].count(lambda_hash) == 0) {
+        // the worker joined the pool after the lambda was made
+        need_lambda = true;
+        lambda_str = lambda_iter->second;
+      }
+      auto shm_iter = m_shared_memory_worker_connections.find(key);
+      if (shm_iter != m_shared_memory_worker_connections.end()) {
+        shmclient = shm_iter->second;
+      } else {
+        need_shared_memory = m_shared_memory_enabled;
+      }
+    }
+
+    if (need_lambda) {
+      logstream(LOG_INFO) << "Registering lambda " << lambda_hash
+                          << " on worker " << worker.id << std::endl;
+      worker.proxy->make_lambda(lambda_str);
+      std::lock_guard<graphlab::mutex> lock(m_mtx);
+      m_worker_lambdas[key].insert(lambda_hash);
+    }
+
+    if (need_shared_memory) {
+      /*
+       * Create an interprocess shared memory connection if possible.
+       */
+      std::string address = worker.proxy->initialize_shared_memory_comm();
+      if (!address.empty()) {
+        auto client = std::make_shared<shmipc::client>();
+        if (client->connect(address)) shmclient = client;
+      }
+      std::lock_guard<graphlab::mutex> lock(m_mtx);
+      m_shared_memory_worker_connections[key] = shmclient;
+    }
+    return shmclient;
+  }
+
+  void lambda_master::disable_shared_memory(worker_type& worker) {
+    std::lock_guard<graphlab::mutex> lock(m_mtx);
+    m_shared_memory_worker_connections[worker.proxy.get()].reset();
+  }
+
+  void lambda_master::worker_removed(worker_type& worker) {
+    std::lock_guard<graphlab::mutex> lock(m_mtx);
+    m_shared_memory_worker_connections.erase(worker.proxy.get());
+    m_worker_lambdas.erase(worker.proxy.get());
+  }
+
+  template <typename Fn>
+  void lambda_master::call_worker(size_t lambda_hash, Fn fn) {
+    for (size_t attempt = 0; ; ++attempt) {
+      auto worker = m_worker_pool->get_worker();
+      auto worker_guard = m_worker_pool->get_worker_guard(worker);
+      // catch and reinterpret comm failure
+      try {
+        auto shmclient = prepare_worker(*worker, lambda_hash);
+        fn(*worker, shmclient);
+        return;
+      } catch (cppipc::ipcexception e) {
+        // lambdas are expected to be free of side effects, so a batch whose
+        // worker crashed can be evaluated again on a fresh worker.
+        bool worker_died = (worker->process_ == nullptr) || !worker->process_->exists();
+        if (!worker_died || attempt > 0) throw reinterpret_comm_failure(e);
+        logstream(LOG_WARNING) << "Lambda worker " << worker->id
+                               << " died. Retrying on another worker." << std::endl;
+      }
+    }
   }
 
 
@@ -129,15 +227,10 @@ static lambda_master* instance_ptr = nullptr;
                                 const std::vector<flexible_type>& args,
                                 std::vector<flexible_type>& out,
                                 bool skip_undefined, int seed) {
-
-    auto worker = m_worker_pool->get_worker();
-    auto worker_guard = m_worker_pool->get_worker_guard(worker);
-    // catch and reinterpret comm failure
-    try {
-      out = worker->proxy->bulk_eval(lambda_hash, args, skip_undefined, seed);
-    } catch (cppipc::ipcexception e) {
-      throw reinterpret_comm_failure(e);
-    }
+    call_worker(lambda_hash, [&](worker_type& worker,
+                                 std::shared_ptr<shmipc::client>&) {
+      out = worker.proxy->bulk_eval(lambda_hash, args, skip_undefined, seed);
+    });
   }
 
 
@@ -150,18 +243,17 @@ static lambda_master* instance_ptr = nullptr;
    *
    * Performs a remote call for bulk_eval_rows and bulk_eval_dict_rows.
    *
-   * Arguments must be serialized into the "arguments" archive. This function
-   * will also take over management of the buffer inside of "arguments" and
-   * free it when done.
+   * Arguments must be serialized into the "arguments" archive, with the rows
+   * in the columnar_batch layout. This function will also take over
+   * management of the buffer inside of "arguments" and free it when done.
    *
-   * Results will be deserialized into the ret.
+   * Results, also in the columnar_batch layout, will be decoded into ret.
    *
    * This function may throw exceptions if remote exceptions were raised.
    */
-  template <typename RetType>
   static bool shm_call(const std::shared_ptr<shmipc::client>& shmclient,
                        oarchive& arguments,
-                       RetType& ret) {
+                       std::vector<flexible_type>& ret) {
     // send the message
     bool shmok = shmipc::large_send(*shmclient, arguments.buf, arguments.off);
     if (shmok == false) {
@@ -187,10 +279,13 @@ static lambda_master* instance_ptr = nullptr;
     char good_call;
     iarc >> good_call;
     if (good_call) {
-      iarc >> ret;
+      columnar_batch results;
+      results.load(iarc);
+      results.to_values(ret);
     } else {
       std::string message;
       iarc >> message;
+      free(buf);
       throw message;
     }
     free(buf);
@@ -207,39 +302,26 @@ static lambda_master* instance_ptr = nullptr;
                                   std::vector<flexible_type>& out,
                                   bool skip_undefined,
                                   int seed) {
-
-    auto worker = m_worker_pool->get_worker();
-    auto worker_guard = m_worker_pool->get_worker_guard(worker);
-
-    // catch and reinterpret comm failure
-    try {
-      auto shmclient_iter = m_shared_memory_worker_connections.find(worker->proxy.get());
-      if (shmclient_iter != m_shared_memory_worker_connections.end() &&
-          shmclient_iter->second.get() != nullptr) {
-        auto& shmclient = shmclient_iter->second;
+    call_worker(lambda_hash, [&](worker_type& worker,
+                                 std::shared_ptr<shmipc::client>& shmclient) {
+      if (shmclient != nullptr) {
         oarchive oarc;
         oarc << (char)(bulk_eval_serialized_tag::BULK_EVAL_ROWS)
              << lambda_hash
-             << args
              << skip_undefined
              << seed;
+        write_columnar_batch(oarc, args);
         bool good = shm_call(shmclient, oarc, out);
         // if shmcall was good, return. 
         if (good) return;
 
-        // otherwise shmcall was bad. reset the client so we don't ever use
+        // otherwise shmcall was bad. disable the client so we don't ever use
         // it again and fall back to regular IPC.
-        // (note. we cannot delete it from the
-        // m_shared_memory_worker_connections map because of concurency 
-        // issues. There may be parallel access to it and locking seems 
-        // overkill.
-        shmclient.reset();
+        disable_shared_memory(worker);
         logstream(LOG_WARNING) << "Unexpected SHMIPC failure. Falling back to CPPIPC" << std::endl;
       } 
-      out = worker->proxy->bulk_eval_rows(lambda_hash, args, skip_undefined, seed);
-    } catch (cppipc::ipcexception e) {
-      throw reinterpret_comm_failure(e);
-    }
+      out = worker.proxy->bulk_eval_rows(lambda_hash, args, skip_undefined, seed);
+    });
   }
 
 
@@ -248,14 +330,10 @@ static lambda_master* instance_ptr = nullptr;
                                 const std::vector<std::vector<flexible_type>>& values,
                                 std::vector<flexible_type>& out,
                                 bool skip_undefined, int seed) {
-    auto worker = m_worker_pool->get_worker();
-    auto worker_guard = m_worker_pool->get_worker_guard(worker);
-    // catch and reinterpret comm failure
-    try {
-      out = worker->proxy->bulk_eval_dict(lambda_hash, keys, values, skip_undefined, seed);
-    } catch (cppipc::ipcexception e) {
-      throw reinterpret_comm_failure(e);
-    }
+    call_worker(lambda_hash, [&](worker_type& worker,
+                                 std::shared_ptr<shmipc::client>&) {
+      out = worker.proxy->bulk_eval_dict(lambda_hash, keys, values, skip_undefined, seed);
+    });
   }
 
 
@@ -264,35 +342,54 @@ static lambda_master* instance_ptr = nullptr;
                                   const sframe_rows& rows,
                                   std::vector<flexible_type>& out,
                                   bool skip_undefined, int seed) {
-    auto worker = m_worker_pool->get_worker();
-    auto worker_guard = m_worker_pool->get_worker_guard(worker);
-    // catch and reinterpret comm failure
-    try {
-      auto shmclient_iter = m_shared_memory_worker_connections.find(worker->proxy.get());
-      if (shmclient_iter != m_shared_memory_worker_connections.end() &&
-          shmclient_iter->second.get() != nullptr) {
-        auto& shmclient = shmclient_iter->second;
+    call_worker(lambda_hash, [&](worker_type& worker,
+                                 std::shared_ptr<shmipc::client>& shmclient) {
+      if (shmclient != nullptr) {
         oarchive oarc;
         oarc << (char)(bulk_eval_serialized_tag::BULK_EVAL_DICT_ROWS)
              << lambda_hash
              << keys 
-             << rows
              << skip_undefined
              << seed;
+        write_columnar_batch(oarc, rows);
         bool good = shm_call(shmclient, oarc, out);
         // everything good. return
         if (good) return;
 
-
-        // shmcall was bad... reset the client so we don't ever use it again
+        // shmcall was bad... disable the client so we don't ever use it again
         // and fall back to regular IPC
-        shmclient.reset();
+        disable_shared_memory(worker);
         logstream(LOG_WARNING) << "Unexpected SHMIPC failure. Falling back to CPPIPC" << std::endl;
       } 
-      out = worker->proxy->bulk_eval_dict_rows(lambda_hash, keys, rows, skip_undefined, seed);
-    } catch (cppipc::ipcexception e) {
-      throw reinterpret_comm_failure(e);
-    }
+      out = worker.proxy->bulk_eval_dict_rows(lambda_hash, keys, rows, skip_undefined, seed);
+    });
+  }
+
+
+  std::future<std::vector<flexible_type>> lambda_master::bulk_eval_async(
+      size_t lambda_hash,
+      const sframe_rows& args,
+      bool skip_undefined, int seed) {
+    return std::async(std::launch::async,
+                      [this, lambda_hash, args, skip_undefined, seed]() {
+                        std::vector<flexible_type> out;
+                        bulk_eval(lambda_hash, args, out, skip_undefined, seed);
+                        return out;
+                      });
+  }
+
+
+  std::future<std::vector<flexible_type>> lambda_master::bulk_eval_async(
+      size_t lambda_hash,
+      const std::vector<std::string>& keys,
+      const sframe_rows& args,
+      bool skip_undefined, int seed) {
+    return std::async(std::launch::async,
+                      [this, lambda_hash, keys, args, skip_undefined, seed]() {
+                        std::vector<flexible_type> out;
+                        bulk_eval(lambda_hash, keys, args, out, skip_undefined, seed);
+                        return out;
+                      });
   }
 
 
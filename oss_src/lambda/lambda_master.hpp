@@ -9,6 +9,8 @@
 #define GRAPHLAB_LAMBDA_LAMBDA_MASTER_HPP
 
 #include <map>
+#include <set>
+#include <future>
 #include <globals/globals.hpp>
 #include <lambda/lambda_interface.hpp>
 #include <lambda/worker_pool.hpp>
@@ -31,7 +33,12 @@ namespace lambda {
    * \ref set_lambda_worker_binary or must be called first to inform
    * the location of the lambda worker binaries.
    *
-   * Internally, it manages a worker pool of lambda_workers.
+   * Internally, it manages an elastic worker pool of lambda_workers: a few
+   * workers are started up front and more are started on demand, up to the
+   * number of workers given to the constructor (see \ref worker_pool).
+   * Lambdas are registered on workers which join the pool later on their
+   * first use. An evaluation whose worker crashed is retried once on
+   * another worker.
    *
    * Each evaluation call is allocated to a worker, and block until the evaluation
    * returns or throws an exception.
@@ -79,9 +86,14 @@ namespace lambda {
 
     /**
      * Constructor. Do not use directly. Instead, use get_instance()
+     *
+     * \param nworkers The maximum number of workers. Only
+     * PYLAMBDA_MIN_WORKERS of them are started right away.
      */
     lambda_master(size_t nworkers);
 
+    ~lambda_master();
+
     /**
      * Register the lambda_str for all workers, and returns the id for the lambda.
      * Throws the exception  
@@ -127,7 +139,37 @@ namespace lambda {
         std::vector<flexible_type>& out,
         bool skip_undefined, int seed);
 
-    inline size_t num_workers() { return m_worker_pool->num_workers(); }
+    /**
+     * Asynchronous version of bulk_eval on sframe rows. The rows are
+     * copied (which is cheap, see \ref sframe_rows) before returning, so
+     * the caller may reuse its buffer immediately. Serialization, the call
+     * to the worker and deserialization of the result all happen in a
+     * background thread; the returned future rethrows any exception raised
+     * by the evaluation.
+     *
+     * Each pending evaluation holds one worker while it runs, so several
+     * calls in flight are spread over different workers.
+     */
+    std::future<std::vector<flexible_type>> bulk_eval_async(
+        size_t lambda_hash,
+        const sframe_rows& args,
+        bool skip_undefined, int seed);
+
+    /**
+     * \overload
+     * Lambda takes dictionary argument.
+     */
+    std::future<std::vector<flexible_type>> bulk_eval_async(
+        size_t lambda_hash,
+        const std::vector<std::string>& keys,
+        const sframe_rows& args,
+        bool skip_undefined, int seed);
+
+    /**
+     * Returns the maximum number of workers evaluations may run on in
+     * parallel.
+     */
+    inline size_t num_workers() { return m_worker_pool->max_workers(); }
 
     static void set_lambda_worker_binary(const std::vector<std::string>& path) { 
       lambda_worker_binary_and_args = path;
@@ -156,11 +198,43 @@ namespace lambda {
 
     lambda_master& operator=(lambda_master const&) = delete;
 
+    typedef worker_process<lambda_evaluator_proxy> worker_type;
+
+    /**
+     * Makes sure the lambda is registered on the worker, and returns the
+     * shared memory connection to the worker (nullptr if there is none).
+     */
+    std::shared_ptr<shmipc::client> prepare_worker(worker_type& worker,
+                                                   size_t lambda_hash);
+
+    /**
+     * Disables the shared memory connection of the worker after a failure.
+     */
+    void disable_shared_memory(worker_type& worker);
+
+    /**
+     * Forgets the state kept for a worker leaving the pool.
+     */
+    void worker_removed(worker_type& worker);
+
+    /**
+     * Calls fn(worker, shmclient) on a prepared worker. If the call fails
+     * because the worker process died, it is retried once on another worker.
+     */
+    template <typename Fn>
+    void call_worker(size_t lambda_hash, Fn fn);
+
    private:
     std::shared_ptr<worker_pool<lambda_evaluator_proxy>> m_worker_pool;
+    bool m_shared_memory_enabled = false;
+
+    // The following are all keyed by the worker's proxy, and protected by m_mtx.
+    // A nullptr connection means shared memory is not available for the worker.
     std::map<void*, std::shared_ptr<shmipc::client>> m_shared_memory_worker_connections;
+    std::map<void*, std::set<size_t>> m_worker_lambdas;
 
     std::unordered_map<size_t, size_t> m_lambda_object_counter;
+    std::unordered_map<size_t, std::string> m_lambda_strings;
     graphlab::mutex m_mtx;
 
     /** The binary for executing the lambda_workers.
@@ -0,0 +1,92 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <lambda/lambda_memo_cache.hpp>
+#include <logger/logger.hpp>
+
+namespace graphlab {
+namespace lambda {
+
+constexpr size_t lambda_memo_cache::NUM_SHARDS;
+constexpr size_t lambda_memo_cache::MIN_LOOKUPS_BEFORE_DISABLE;
+
+/**
+ * Approximate memory footprint of a cached value and its hash table entry.
+ */
+static size_t approximate_size(const flexible_type& value) {
+  size_t ret = sizeof(uint128_t) + sizeof(flexible_type) + 2 * sizeof(void*);
+  switch(value.get_type()) {
+   case flex_type_enum::STRING:
+     ret += value.get<flex_string>().size();
+     break;
+   case flex_type_enum::VECTOR:
+     ret += value.get<flex_vec>().size() * sizeof(flex_float);
+     break;
+   case flex_type_enum::LIST:
+     for (const auto& v: value.get<flex_list>()) ret += approximate_size(v);
+     break;
+   case flex_type_enum::DICT:
+     for (const auto& v: value.get<flex_dict>()) {
+       ret += approximate_size(v.first) + approximate_size(v.second);
+     }
+     break;
+   case flex_type_enum::IMAGE:
+     ret += value.get<flex_image>().m_image_data_size;
+     break;
+   default:
+     break;
+  }
+  return ret;
+}
+
+lambda_memo_cache::lambda_memo_cache(size_t byte_budget, double min_hit_rate)
+    : m_byte_budget(byte_budget), m_min_hit_rate(min_hit_rate),
+      m_enabled(true), m_num_bytes(0), m_num_lookups(0), m_num_hits(0) { }
+
+bool lambda_memo_cache::lookup(const uint128_t& key, flexible_type& out) {
+  if (!m_enabled) return false;
+  bool found = false;
+  {
+    auto& s = get_shard(key);
+    std::lock_guard<graphlab::mutex> guard(s.lock);
+    auto iter = s.values.find(key);
+    if (iter != s.values.end()) {
+      out = iter->second;
+      found = true;
+    }
+  }
+  size_t lookups = ++m_num_lookups;
+  size_t hits = found ? ++m_num_hits : m_num_hits.load();
+  if (lookups % MIN_LOOKUPS_BEFORE_DISABLE == 0 &&
+      hits < m_min_hit_rate * lookups) {
+    logstream(LOG_INFO) << "Lambda memoization hit rate " << double(hits) / lookups
+                        << " is too low. Disabling the cache." << std::endl;
+    disable();
+  }
+  return found;
+}
+
+void lambda_memo_cache::insert(const uint128_t& key, const flexible_type& value) {
+  if (!m_enabled) return;
+  size_t size = approximate_size(value);
+  if (m_num_bytes + size > m_byte_budget) return;
+  auto& s = get_shard(key);
+  std::lock_guard<graphlab::mutex> guard(s.lock);
+  if (s.values.emplace(key, value).second) m_num_bytes += size;
+}
+
+void lambda_memo_cache::disable() {
+  m_enabled = false;
+  for (auto& s: m_shards) {
+    std::lock_guard<graphlab::mutex> guard(s.lock);
+    s.values.clear();
+  }
+  m_num_bytes = 0;
+}
+
+} // namespace lambda
+} // namespace graphlab
@@ -0,0 +1,85 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_LAMBDA_LAMBDA_MEMO_CACHE_HPP
+#define GRAPHLAB_LAMBDA_LAMBDA_MEMO_CACHE_HPP
+
+#include <atomic>
+#include <unordered_map>
+#include <flexible_type/flexible_type.hpp>
+#include <util/cityhash_gl.hpp>
+#include <parallel/pthread_tools.hpp>
+
+namespace graphlab {
+namespace lambda {
+
+/**
+ * \ingroup lambda
+ * A thread safe cache of lambda results, keyed by a 128 bit hash of the
+ * lambda input.
+ *
+ * The cache holds at most byte_budget bytes (approximately) of results;
+ * once full, existing entries are still served but no new entries are
+ * added. Since every miss costs some hashing and bookkeeping on top of the
+ * lambda evaluation, the cache disables itself (and frees its memory) if
+ * its hit rate, checked every few thousand lookups, is below min_hit_rate.
+ */
+class lambda_memo_cache {
+ public:
+  lambda_memo_cache(size_t byte_budget, double min_hit_rate);
+
+  /**
+   * Returns true if the cache is still in use.
+   */
+  inline bool enabled() const { return m_enabled; }
+
+  /**
+   * Looks up a key. Returns true and stores the value in out on a hit.
+   */
+  bool lookup(const uint128_t& key, flexible_type& out);
+
+  /**
+   * Inserts a value, if the cache is enabled and has room for it.
+   */
+  void insert(const uint128_t& key, const flexible_type& value);
+
+  inline size_t num_lookups() const { return m_num_lookups; }
+
+  inline size_t num_hits() const { return m_num_hits; }
+
+  inline size_t size_in_bytes() const { return m_num_bytes; }
+
+ private:
+  static constexpr size_t NUM_SHARDS = 16;
+
+  /// The hit rate is checked every this many lookups
+  static constexpr size_t MIN_LOOKUPS_BEFORE_DISABLE = 4096;
+
+  struct shard {
+    graphlab::mutex lock;
+    std::unordered_map<uint128_t, flexible_type> values;
+  };
+
+  inline shard& get_shard(const uint128_t& key) {
+    return m_shards[size_t(key) % NUM_SHARDS];
+  }
+
+  void disable();
+
+  size_t m_byte_budget;
+  double m_min_hit_rate;
+  std::atomic<bool> m_enabled;
+  std::atomic<size_t> m_num_bytes;
+  std::atomic<size_t> m_num_lookups;
+  std::atomic<size_t> m_num_hits;
+  shard m_shards[NUM_SHARDS];
+};
+
+} // namespace lambda
+} // namespace graphlab
+
+#endif
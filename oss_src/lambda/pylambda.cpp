@@ -182,30 +182,68 @@ std::vector<flexible_type> pylambda_evaluator::bulk_eval_dict_rows(
   return ret;
 }
 
-std::vector<flexible_type>
-pylambda_evaluator::bulk_eval_rows_serialized(const char* ptr, size_t len) {
+std::vector<flexible_type> pylambda_evaluator::bulk_eval_columnar(
+    size_t lambda_id,
+    const std::vector<std::string>* keys,
+    const columnar_batch& values,
+    bool skip_undefined,
+    int seed) {
+
+  if (evaluation_functions.eval_lambda_by_columns == NULL) {
+    // no columnar support in the evaluation functions. Decode the values.
+    sframe_rows rows;
+    values.to_sframe_rows(rows);
+    if (keys == nullptr) return bulk_eval_rows(lambda_id, rows, skip_undefined, seed);
+    else return bulk_eval_dict_rows(lambda_id, *keys, rows, skip_undefined, seed);
+  }
+
+  evaluation_functions.set_random_seed(seed);
+
+  std::vector<flexible_type> ret(values.num_rows());
+
+  lambda_call_by_columnar_data lcd;
+  lcd.output_enum_type = flex_type_enum::UNDEFINED;
+  lcd.skip_undefined = skip_undefined;
+  lcd.input_keys = keys;
+  lcd.input_columns = values.columns();
+  lcd.n_columns = values.num_columns();
+  lcd.n_rows = values.num_rows();
+  lcd.output_values = ret.data();
+
+  evaluation_functions.eval_lambda_by_columns(lambda_id, &lcd);
+  python::check_for_python_exception();
+
+  return ret;
+}
+
+void pylambda_evaluator::bulk_eval_rows_serialized(const char* ptr, size_t len,
+                                                   oarchive& response) {
   iarchive iarc(ptr, len);
   char c;
   iarc >> c;
+  std::vector<flexible_type> ret;
   if (c == (char)bulk_eval_serialized_tag::BULK_EVAL_ROWS) {
     size_t lambda_id;
-    sframe_rows rows;
     bool skip_undefined;
     int seed;
-    iarc >> lambda_id >> rows >> skip_undefined >> seed;
-    return bulk_eval_rows(lambda_id, rows, skip_undefined, seed);
+    columnar_batch rows;
+    iarc >> lambda_id >> skip_undefined >> seed;
+    rows.load(iarc);
+    ret = bulk_eval_columnar(lambda_id, nullptr, rows, skip_undefined, seed);
   } else if (c == (char)bulk_eval_serialized_tag::BULK_EVAL_DICT_ROWS) {
     size_t lambda_id;
     std::vector<std::string> keys;
-    sframe_rows values;
     bool skip_undefined;
     int seed;
-    iarc >> lambda_id >> keys >> values >> skip_undefined >> seed;
-    return bulk_eval_dict_rows(lambda_id, keys, values, skip_undefined, seed);
+    columnar_batch values;
+    iarc >> lambda_id >> keys >> skip_undefined >> seed;
+    values.load(iarc);
+    ret = bulk_eval_columnar(lambda_id, &keys, values, skip_undefined, seed);
   } else {
     logstream(LOG_FATAL) << "Invalid serialized result" << std::endl;
-    return std::vector<flexible_type>();
   }
+  response << (char)(1);
+  write_columnar_batch(response, ret);
 }
 
 std::string pylambda_evaluator::initialize_shared_memory_comm() {
@@ -235,14 +273,17 @@ std::string pylambda_evaluator::initialize_shared_memory_comm() {
                 oarchive oarc;
                 oarc.buf = send_buffer;
                 oarc.len = send_buffer_length;
+                // on failure, the partially written response is discarded
                 try {
-                  auto ret = bulk_eval_rows_serialized(receive_buffer, message_length);
-                  oarc << (char)(1) << ret;
+                  bulk_eval_rows_serialized(receive_buffer, message_length, oarc);
                 } catch (std::string& s) {
+                  oarc.off = 0;
                   oarc << (char)(0) << s;
                 } catch (const char* s) {
+                  oarc.off = 0;
                   oarc << (char)(0) << std::string(s);
                 } catch (...) {
+                  oarc.off = 0;
                   oarc << (char)(0) << std::string("Unknown Runtime Exception");
                 }
                 shmipc::large_send(*m_shared_memory_server,
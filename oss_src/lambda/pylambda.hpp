@@ -8,6 +8,7 @@
 #ifndef GRAPHLAB_LAMBDA_PYLAMBDA_EVALUATOR_HPP
 #define GRAPHLAB_LAMBDA_PYLAMBDA_EVALUATOR_HPP
 #include <lambda/lambda_interface.hpp>
+#include <lambda/columnar_batch.hpp>
 #include <flexible_type/flexible_type.hpp>
 #include <python_callbacks/python_callbacks.hpp>
 #include <parallel/pthread_tools.hpp>
@@ -62,6 +63,23 @@ struct lambda_call_by_sframe_rows_data {
   flexible_type* output_values = nullptr;
 };
 
+/** The data used in the call by columnar batch call type. The columns
+ *  are read in place from the shared memory message; see columnar_batch.
+ *  If input_keys is null, the batch has a single column and the lambda is
+ *  called on each value. Otherwise the lambda is called on a dictionary
+ *  per row, as in the call by sframe rows.
+ */
+struct lambda_call_by_columnar_data {
+  flex_type_enum output_enum_type = flex_type_enum::UNDEFINED;
+  bool skip_undefined = false;
+
+  const std::vector<std::string>* input_keys = nullptr;
+  const columnar_column_view* input_columns = nullptr;
+  size_t n_columns = 0;
+  size_t n_rows = 0;
+  flexible_type* output_values = nullptr;
+};
+
 /** The data used in applying a graph triple apply.
  */
 struct lambda_graph_triple_apply_data {
@@ -88,6 +106,7 @@ struct pylambda_evaluation_functions {
   void (*eval_lambda_by_dict)(size_t, lambda_call_by_dict_data*);
   void (*eval_lambda_by_sframe_rows)(size_t, lambda_call_by_sframe_rows_data*);
   void (*eval_graph_triple_apply)(size_t, lambda_graph_triple_apply_data*);  
+  void (*eval_lambda_by_columns)(size_t, lambda_call_by_columnar_data*);
 };
 
 /** This is called through the cython functions to set up the
@@ -209,14 +228,25 @@ class pylambda_evaluator : public lambda_evaluator_interface {
 
   
   /**
-   * Redirects to either bulk_eval_rows or bulk_eval_dict_rows.
+   * Evaluates the lambda on a columnar batch, read in place. keys is
+   * null for a single column batch; otherwise the lambda takes a dictionary
+   * argument as in bulk_eval_dict_rows.
+   */
+  std::vector<flexible_type> bulk_eval_columnar(size_t lambda_hash,
+                                                const std::vector<std::string>* keys,
+                                                const columnar_batch& values,
+                                                bool skip_undefined, int seed);
+
+  /**
+   * Handles a shared memory request.
    * First byte in the string is a bulk_eval_serialized_tag byte to denote
-   * whether this call is going to bulk_eval_rows or bulk_eval_dict_rows.
+   * whether this call takes a single column or a dictionary argument.
    *
-   * Deserializes the remaining parameters from the string 
-   * and calls the function accordingly.
+   * Deserializes the remaining parameters from the string, with the rows in
+   * the columnar_batch layout, calls the function accordingly, and writes
+   * the results to the response, also in the columnar_batch layout.
    */
-  std::vector<flexible_type> bulk_eval_rows_serialized(const char* ptr, size_t len);
+  void bulk_eval_rows_serialized(const char* ptr, size_t len, oarchive& response);
 
   graphlab::shmipc::server* m_shared_memory_server;
   graphlab::thread m_shared_memory_listener;
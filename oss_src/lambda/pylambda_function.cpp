@@ -7,6 +7,9 @@
  */
 #include <lambda/pylambda_function.hpp>
 #include <lambda/lambda_master.hpp>
+#include <lambda/lambda_memo_cache.hpp>
+#include <lambda/lambda_constants.hpp>
+#include <util/cityhash_gl.hpp>
 #include <sframe/sframe_rows.hpp>
 #include <fileio/file_ownership_handle.hpp>
 
@@ -40,11 +43,24 @@ void pylambda_function::set_random_seed(int value) {
   random_seed = value;
 }
 
+void pylambda_function::set_memoize(bool value) {
+  if (value) {
+    m_memo_cache = std::make_shared<lambda_memo_cache>(PYLAMBDA_MEMO_CACHE_BYTES,
+                                                       PYLAMBDA_MEMO_MIN_HIT_RATE);
+  } else {
+    m_memo_cache.reset();
+  }
+}
+
 //// Evaluating Interface 
 
 /* One to one */
 void pylambda_function::eval(const sframe_rows& rows,
                              std::vector<flexible_type>& out) {
+  if (m_memo_cache && m_memo_cache->enabled()) {
+    memoized_eval(nullptr, rows, out);
+    return;
+  }
   lambda::lambda_master::get_instance().bulk_eval(lambda_hash, rows, out, skip_undefined, random_seed);
 };
 
@@ -52,8 +68,100 @@ void pylambda_function::eval(const sframe_rows& rows,
 void pylambda_function::eval(const std::vector<std::string>& keys, 
                              const sframe_rows& rows,
                              std::vector<flexible_type>& out) {
+  if (m_memo_cache && m_memo_cache->enabled()) {
+    memoized_eval(&keys, rows, out);
+    return;
+  }
   lambda::lambda_master::get_instance().bulk_eval(lambda_hash, keys, rows, out, skip_undefined, random_seed);
 }
 
+std::future<std::vector<flexible_type>>
+pylambda_function::eval_async(const sframe_rows& rows) {
+  if (m_memo_cache && m_memo_cache->enabled()) {
+    return std::async(std::launch::async, [this, rows]() {
+                        std::vector<flexible_type> out;
+                        eval(rows, out);
+                        return out;
+                      });
+  }
+  return lambda::lambda_master::get_instance().bulk_eval_async(
+      lambda_hash, rows, skip_undefined, random_seed);
+}
+
+std::future<std::vector<flexible_type>>
+pylambda_function::eval_async(const std::vector<std::string>& keys,
+                              const sframe_rows& rows) {
+  if (m_memo_cache && m_memo_cache->enabled()) {
+    return std::async(std::launch::async, [this, keys, rows]() {
+                        std::vector<flexible_type> out;
+                        eval(keys, rows, out);
+                        return out;
+                      });
+  }
+  return lambda::lambda_master::get_instance().bulk_eval_async(
+      lambda_hash, keys, rows, skip_undefined, random_seed);
+}
+
+void pylambda_function::memoized_eval(const std::vector<std::string>* keys,
+                                      const sframe_rows& rows,
+                                      std::vector<flexible_type>& out) {
+  const size_t num_rows = rows.num_rows();
+  const size_t num_columns = rows.num_columns();
+  const auto& columns = rows.cget_columns();
+  out.resize(num_rows);
+
+  // hash each row, including the value types since equal values of
+  // different types may hash the same.
+  uint128_t base_hash = keys ? hash128(*keys) : 0;
+  std::vector<uint128_t> row_hashes(num_rows);
+  // rows which are not cached, each one with a distinct hash
+  std::vector<size_t> missing_rows;
+  // for each row not in the cache, its index in missing_rows
+  std::vector<size_t> missing_index(num_rows, size_t(-1));
+  std::unordered_map<uint128_t, size_t> missing_hashes;
+  for (size_t i = 0; i < num_rows; ++i) {
+    uint128_t h = base_hash;
+    for (size_t j = 0; j < num_columns; ++j) {
+      const flexible_type& val = (*columns[j])[i];
+      h = hash128_combine(h, hash128_combine(uint128_t(val.get_type()), val.hash128()));
+    }
+    row_hashes[i] = h;
+    if (m_memo_cache->lookup(h, out[i])) continue;
+    auto iter = missing_hashes.find(h);
+    if (iter == missing_hashes.end()) {
+      iter = missing_hashes.emplace(h, missing_rows.size()).first;
+      missing_rows.push_back(i);
+    }
+    missing_index[i] = iter->second;
+  }
+  if (missing_rows.empty()) return;
+
+  // evaluate the distinct missing rows only
+  sframe_rows missing;
+  for (size_t j = 0; j < num_columns; ++j) {
+    auto column = std::make_shared<std::vector<flexible_type>>(missing_rows.size());
+    for (size_t k = 0; k < missing_rows.size(); ++k) {
+      (*column)[k] = (*columns[j])[missing_rows[k]];
+    }
+    missing.add_decoded_column(column);
+  }
+  std::vector<flexible_type> missing_out;
+  if (keys) {
+    lambda::lambda_master::get_instance().bulk_eval(lambda_hash, *keys, missing, missing_out,
+                                                    skip_undefined, random_seed);
+  } else {
+    lambda::lambda_master::get_instance().bulk_eval(lambda_hash, missing, missing_out,
+                                                    skip_undefined, random_seed);
+  }
+  ASSERT_EQ(missing_out.size(), missing_rows.size());
+
+  for (size_t k = 0; k < missing_rows.size(); ++k) {
+    m_memo_cache->insert(row_hashes[missing_rows[k]], missing_out[k]);
+  }
+  for (size_t i = 0; i < num_rows; ++i) {
+    if (missing_index[i] != size_t(-1)) out[i] = missing_out[missing_index[i]];
+  }
+}
+
 } // end of lambda
 } // end of graphlab
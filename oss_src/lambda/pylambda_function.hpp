@@ -10,6 +10,7 @@
 
 #include<vector>
 #include<string>
+#include<future>
 #include<flexible_type/flexible_type.hpp>
 
 namespace graphlab {
@@ -22,6 +23,8 @@ class file_ownership_handle;
 
 namespace lambda {
 
+class lambda_memo_cache;
+
 /**
  * Represents a python lambda function object which is evaluated in parallel.
  *
@@ -37,6 +40,9 @@ namespace lambda {
  * f.set_skip_undefined(true);
  * f.set_random_seed(0);
  *
+ * // (optional) Cache results of a deterministic function.
+ * f.set_memoize(true);
+ *
  * // evaluate on a minibatch of values.
  * std::vector<flexible_type> out;
  * f.evaluate({1,2,3}, out);
@@ -57,6 +63,13 @@ namespace lambda {
  *  - each call to evaluate() will grab one avaiable worker.
  *  - if no worker is avaiable, block.
  *  - when evaluate returns, the corresponding worker is released.
+ *
+ * With set_memoize(true), results are cached in this process keyed by the
+ * hash of the input row, and only rows not seen before (within and across
+ * batches) are sent to the workers. This must only be used for functions
+ * which always return the same output for the same input. The cache is
+ * bounded by PYLAMBDA_MEMO_CACHE_BYTES, and turns itself off if its hit
+ * rate is below PYLAMBDA_MEMO_MIN_HIT_RATE (see \ref lambda_memo_cache).
  */
 class pylambda_function {
  public:
@@ -79,6 +92,7 @@ class pylambda_function {
   //// Options
   void set_skip_undefined(bool value);
   void set_random_seed(int value);
+  void set_memoize(bool value);
 
   //// Evaluating Interface 
 
@@ -91,10 +105,25 @@ class pylambda_function {
             const sframe_rows& rows,
             std::vector<flexible_type>& out);
 
+  /* One to one, returning before the evaluation completes.
+   * See lambda_master::bulk_eval_async */
+  std::future<std::vector<flexible_type>> eval_async(const sframe_rows& rows);
+
+  /* Many to one, returning before the evaluation completes */
+  std::future<std::vector<flexible_type>> eval_async(
+      const std::vector<std::string>& keys,
+      const sframe_rows& rows);
+
  private:
+  /* Evaluation through the memoization cache. keys is nullptr for one to one */
+  void memoized_eval(const std::vector<std::string>* keys,
+                     const sframe_rows& rows,
+                     std::vector<flexible_type>& out);
+
   size_t lambda_hash = -1;
   bool skip_undefined = false;
   size_t random_seed = 0;
+  std::shared_ptr<lambda_memo_cache> m_memo_cache;
   std::shared_ptr<fileio::file_ownership_handle> m_pickle_file_handle;
 };
 
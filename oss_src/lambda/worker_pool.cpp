@@ -13,4 +13,11 @@ EXPORT double LAMBDA_WORKER_CONNECTION_TIMEOUT = 60;
 
 REGISTER_GLOBAL(double, LAMBDA_WORKER_CONNECTION_TIMEOUT, true)
 
+/** Workers started on demand by an elastic worker_pool are shut down
+ *  after being idle for this many seconds.
+ */
+EXPORT double LAMBDA_WORKER_IDLE_TIMEOUT = 60;
+
+REGISTER_GLOBAL(double, LAMBDA_WORKER_IDLE_TIMEOUT, true)
+
 }
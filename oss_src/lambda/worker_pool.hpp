@@ -8,6 +8,7 @@
 #ifndef GRAPHLAB_LAMBDA_WORKER_POOL_HPP
 #define GRAPHLAB_LAMBDA_WORKER_POOL_HPP
 
+#include<functional>
 #include<lambda/lambda_utils.hpp>
 #include<logger/assertions.hpp>
 #include<fileio/temp_files.hpp>
@@ -22,6 +23,7 @@
 namespace graphlab {
 
 extern double LAMBDA_WORKER_CONNECTION_TIMEOUT;
+extern double LAMBDA_WORKER_IDLE_TIMEOUT;
 
 namespace lambda {
 
@@ -40,6 +42,15 @@ struct worker_process {
   std::string address;
   // process object
   std::unique_ptr<process> process_;
+  // exponential moving average of the time (in seconds) the worker is held
+  // per get_worker()/release_worker() pair
+  double avg_latency = 0;
+  // number of get_worker()/release_worker() pairs
+  size_t num_calls = 0;
+  // true while handed out by get_worker()
+  bool held = false;
+  // started when the worker is handed out, and when it becomes idle
+  timer held_timer;
 
   // next avaiable worker id 
   static int get_next_id() {
@@ -256,9 +267,21 @@ class worker_guard;
  * The pool is initialized with a fixed number of workers. Due to system resource
  * limitation, the actual pool may contain less workers than intended.
  *
+ * - Elastic pool:
+ * If constructed with max_workers greater than the initial number of workers,
+ * the pool grows on demand: whenever get_worker() leaves no idle worker, a
+ * background thread starts (pre-warms) one more worker, up to max_workers.
+ * Workers above the initial number which stay idle for more than
+ * LAMBDA_WORKER_IDLE_TIMEOUT seconds are shut down again.
+ * Workers started after construction are not seen by call_all_workers()
+ * calls made before they joined, so per worker state must be (re)created
+ * lazily by the user; see set_worker_removed_callback().
+ *
  * - Acquire worker:
  * User request a worker process by calling get_worker(),
  * which returns a unique_ptr and transfers the ownership of the worker process.
+ * Among the idle workers, the one with the lowest average latency is
+ * returned, so slow (or pausing) workers receive fewer requests.
  *
  * - Release worker:
  * After the use of the worker, The requested worker_process must be returned
@@ -288,6 +311,8 @@ class worker_guard;
 template<typename ProxyType>
 class worker_pool {
 public:
+  typedef std::function<void(worker_process<ProxyType>&)> worker_callback_type;
+
   /**
    * Return the next available worker.
    * Block until any worker is available.
@@ -300,9 +325,19 @@ public:
    */
   std::unique_ptr<worker_process<ProxyType>> get_worker() {
     std::unique_lock<graphlab::mutex> lck(m_mutex);
+    if (m_available_workers.empty()) request_spawn();
     wait_for_one(lck);
-    auto worker = std::move(m_available_workers.front());
-    m_available_workers.pop_front();
+    // pick the idle worker with the lowest latency
+    auto best = m_available_workers.begin();
+    for (auto iter = m_available_workers.begin(); iter != m_available_workers.end(); ++iter) {
+      if ((*iter)->avg_latency < (*best)->avg_latency) best = iter;
+    }
+    auto worker = std::move(*best);
+    m_available_workers.erase(best);
+    // pre-warm the next worker if this was the last idle one
+    if (m_available_workers.empty()) request_spawn();
+    worker->held = true;
+    worker->held_timer.start();
     return worker;
   }
 
@@ -322,16 +357,26 @@ public:
    */
   void release_worker(std::unique_ptr<worker_process<ProxyType>>& worker) {
     logstream(LOG_DEBUG) << "Release worker " << worker->id << std::endl;
-    std::unique_lock<graphlab::mutex> lck(m_mutex);
+    if (worker->held) {
+      double latency = worker->held_timer.current_time();
+      worker->avg_latency = (worker->num_calls == 0) ? latency :
+          (1 - LATENCY_DECAY) * worker->avg_latency + LATENCY_DECAY * latency;
+      ++worker->num_calls;
+      worker->held = false;
+    }
     if (check_alive(worker) == true) {
       // put the worker back to queue
+      worker->held_timer.start();
+      std::unique_lock<graphlab::mutex> lck(m_mutex);
       m_available_workers.push_back(std::move(worker));
     } else {
       logstream(LOG_WARNING) << "Replacing dead worker " << worker->id << std::endl;
-      // clear dead worker
-      worker.reset(nullptr);
+      // clear dead worker. The worker still counts towards the pool size
+      // while its replacement starts.
+      remove_worker(worker);
       // start new worker
       auto new_worker = try_spawn_worker<ProxyType>(m_worker_binary_and_args, new_worker_address(), m_connection_timeout);
+      std::unique_lock<graphlab::mutex> lck(m_mutex);
       if (new_worker != nullptr) {
         // put new worker back to queue
         m_available_workers.push_back(std::move(new_worker));
@@ -341,8 +386,7 @@ public:
                                << m_num_workers << std::endl;
       }
     }
-    lck.unlock();
-    cv.notify_one();
+    cv.notify_all();
   }
 
   /**
@@ -350,6 +394,11 @@ public:
    */
   size_t num_workers() const { return m_num_workers; };
 
+  /**
+   * Return the maximum number of workers in the pool.
+   */
+  size_t max_workers() const { return m_max_workers; };
+
   /**
    * Return number of avaiable workers in the pool.
    */
@@ -358,6 +407,16 @@ public:
     return m_available_workers.size();
   }
 
+  /**
+   * Sets a function called on every worker just before it is shut down,
+   * either because it died or because it stayed idle for too long.
+   * The callback is not called while the pool is being destroyed.
+   */
+  void set_worker_removed_callback(worker_callback_type fn) {
+    std::unique_lock<graphlab::mutex> lck(m_mutex);
+    m_worker_removed_callback = fn;
+  }
+
   /**
    * Call the function on all worker in parallel and return the results.
    * Block until all workers are available.
@@ -369,48 +428,66 @@ public:
     // take out all workers from m_avaiable_workers
     // equivalent to call get_worker() in batch with lck acquired.
     std::vector<std::unique_ptr<worker_process<ProxyType>>> temp_workers;
-    for (size_t i = 0; i < m_num_workers; ++i) {
+    while (!m_available_workers.empty()) {
       temp_workers.push_back(std::move(m_available_workers.front()));
       m_available_workers.pop_front();
     }
+    size_t num_called_workers = temp_workers.size();
 
     // The following code calls release_worker() for crash recovery,
     // and release_worker() calls lock inside.
     // Because no workers is avaialable externally, we can safely release the lock.
     lck.unlock();
 
-    try {
-      std::vector<std::shared_ptr<worker_guard<ProxyType>>> guards;
-      for (auto& worker: temp_workers)
-        guards.push_back(get_worker_guard(worker));
-      std::vector<RetType> ret(m_num_workers);
-      parallel_for(0, m_num_workers, [&](size_t i) {
-        try {
-          ret[i] = f(temp_workers[i]->proxy);
-        } catch (cppipc::ipcexception e) {
-          throw reinterpret_comm_failure(e);
-        }
-      });
-      return ret;
-    } catch (...) {
-      ASSERT_EQ(m_available_workers.size(), m_num_workers);
-      std::rethrow_exception(std::current_exception());
-    }
+    std::vector<std::shared_ptr<worker_guard<ProxyType>>> guards;
+    for (auto& worker: temp_workers)
+      guards.push_back(get_worker_guard(worker));
+    std::vector<RetType> ret(num_called_workers);
+    parallel_for(0, num_called_workers, [&](size_t i) {
+      try {
+        ret[i] = f(temp_workers[i]->proxy);
+      } catch (cppipc::ipcexception e) {
+        throw reinterpret_comm_failure(e);
+      }
+    });
+    return ret;
   }
 
-  /// constructor
+  /**
+   * Constructor.
+   *
+   * \param num_workers Number of workers started right away. The pool
+   * never shrinks below this.
+   * \param worker_binary_and_args The worker binary and its arguments.
+   * \param connection_timeout Timeout connecting to a new worker.
+   * \param max_workers The maximum number of workers the pool may grow to.
+   * 0 (or anything below num_workers) means the pool has a fixed size.
+   */
   worker_pool(size_t num_workers,
               std::vector<std::string> worker_binary_and_args,
-              int connection_timeout = 3) {
+              int connection_timeout = 3,
+              size_t max_workers = 0) {
     m_connection_timeout = connection_timeout;
     m_worker_binary_and_args = worker_binary_and_args;
     m_num_workers = 0;
     init(num_workers);
+    m_min_workers = m_num_workers;
+    m_max_workers = std::max(max_workers, m_num_workers);
+    if (m_max_workers > m_min_workers) {
+      m_maintenance_thread.launch([this]() { maintenance_loop(); });
+    }
   }
 
   /// destructor
   ~worker_pool() {
     std::unique_lock<graphlab::mutex> lck(m_mutex);
+    m_stopping = true;
+    m_maintenance_cv.signal();
+    lck.unlock();
+    if (m_max_workers > m_min_workers) m_maintenance_thread.join();
+    lck.lock();
+    // drop the requests the maintenance thread did not get to
+    m_num_spawning = 0;
     try {
       wait_for_all(lck);
     } catch (...) { }
@@ -420,11 +497,14 @@ public:
   }
 
 private:
+  /// Weight of the latest sample in the moving average of worker latency
+  static constexpr double LATENCY_DECAY = 0.2;
+
   /**
    * Wait until all workers are returned. Throw error if pool size become 0.
    */
   void wait_for_all(std::unique_lock<graphlab::mutex>& lck) {
-    while (m_available_workers.size() < m_num_workers || m_num_workers == 0) {
+    while (m_available_workers.size() < m_num_workers || m_num_spawning > 0) {
       cv.wait(lck);
     }
     if (m_num_workers == 0) {
@@ -436,14 +516,96 @@ private:
    * Wait until a single worker is aviailable. Throw error if pool size become 0.
    */
   void wait_for_one(std::unique_lock<graphlab::mutex>& lck) {
-    while (m_available_workers.empty() || m_num_workers == 0) {
+    while (m_available_workers.empty() && (m_num_workers > 0 || m_num_spawning > 0)) {
       cv.wait(lck);
     }
-    if (m_num_workers == 0) {
+    if (m_available_workers.empty()) {
       throw("Worker pool is empty");
     }
   }
 
+  /**
+   * Ask the maintenance thread to start one more worker, if the pool may
+   * still grow. Must be called with the lock acquired.
+   */
+  void request_spawn() {
+    if (m_stopping || m_num_workers + m_num_spawning >= m_max_workers) return;
+    ++m_num_spawning;
+    m_maintenance_cv.signal();
+  }
+
+  /**
+   * Shut down a worker which is no longer in the pool.
+   * Must be called without the lock.
+   */
+  void remove_worker(std::unique_ptr<worker_process<ProxyType>>& worker) {
+    worker_callback_type callback;
+    {
+      std::unique_lock<graphlab::mutex> lck(m_mutex);
+      callback = m_worker_removed_callback;
+    }
+    if (callback) callback(*worker);
+    worker.reset();
+  }
+
+  /**
+   * Starts the requested workers and shuts down the idle ones, until the
+   * pool is destroyed.
+   */
+  void maintenance_loop() {
+    std::unique_lock<graphlab::mutex> lck(m_mutex);
+    while (!m_stopping) {
+      if (m_num_spawning > m_num_started) {
+        ++m_num_started;
+        lck.unlock();
+        auto new_worker = try_spawn_worker<ProxyType>(m_worker_binary_and_args,
+                                                      new_worker_address(),
+                                                      m_connection_timeout);
+        if (new_worker != nullptr) new_worker->held_timer.start();
+        lck.lock();
+        --m_num_spawning;
+        --m_num_started;
+        if (new_worker != nullptr) {
+          m_available_workers.push_back(std::move(new_worker));
+          ++m_num_workers;
+          logstream(LOG_INFO) << "Increase number of workers to "
+                              << m_num_workers << std::endl;
+        } else {
+          // stop growing if workers cannot be started
+          m_max_workers = m_num_workers + m_num_spawning;
+          logstream(LOG_WARNING) << "Cannot start more lambda workers. "
+                                 << "Limiting the pool to " << m_max_workers
+                                 << " workers" << std::endl;
+        }
+        cv.notify_all();
+        continue;
+      }
+
+      // shut down workers above the initial pool size which stayed idle
+      std::vector<std::unique_ptr<worker_process<ProxyType>>> idle_workers;
+      for (auto iter = m_available_workers.begin();
+           iter != m_available_workers.end() && m_num_workers > m_min_workers;) {
+        if ((*iter)->held_timer.current_time() > LAMBDA_WORKER_IDLE_TIMEOUT) {
+          idle_workers.push_back(std::move(*iter));
+          iter = m_available_workers.erase(iter);
+          --m_num_workers;
+        } else {
+          ++iter;
+        }
+      }
+      if (!idle_workers.empty()) {
+        logstream(LOG_INFO) << "Decrease number of idle workers to "
+                            << m_num_workers << std::endl;
+        lck.unlock();
+        for (auto& worker: idle_workers) remove_worker(worker);
+        lck.lock();
+        cv.notify_all();
+        continue;
+      }
+      m_maintenance_cv.timedwait(lck, 1);
+    }
+  }
+
   /**
    * Return true if the worker process is alive.
    */
@@ -493,7 +655,17 @@ private:
   int m_connection_timeout;
   std::deque<std::unique_ptr<worker_process<ProxyType>>> m_available_workers;
   size_t m_num_workers;
+  size_t m_min_workers = 0;
+  size_t m_max_workers = 0;
+  // number of requested workers which have not joined the pool yet
+  size_t m_num_spawning = 0;
+  // number of requested workers the maintenance thread is starting
+  size_t m_num_started = 0;
+  bool m_stopping = false;
+  worker_callback_type m_worker_removed_callback;
   graphlab::condition_variable cv;
+  graphlab::condition_variable m_maintenance_cv;
+  graphlab::thread m_maintenance_thread;
   graphlab::mutex m_mutex;
 }; // end of worker_pool
 
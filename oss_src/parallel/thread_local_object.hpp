@@ -0,0 +1,72 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_PARALLEL_THREAD_LOCAL_OBJECT_HPP
+#define GRAPHLAB_PARALLEL_THREAD_LOCAL_OBJECT_HPP
+
+#include <pthread.h>
+#include <cstddef>
+
+namespace graphlab {
+
+/**
+ * \ingroup threading
+ * A T owned by each thread, default constructed on the first call to get()
+ * in the thread and deleted when the thread exits.
+ *
+ * Lookups go through a __thread pointer; a pthread key is only used to
+ * delete the object at thread exit. The pointer is reset before the object
+ * is deleted, so code run by ~T() sees the thread as having no object.
+ *
+ * All members are static: there is one object per thread for each
+ * (T, Tag) pair. Use a distinct Tag to keep two objects of the same type.
+ */
+template <typename T, typename Tag = T>
+class thread_local_object {
+ public:
+  /// Returns the object of the calling thread, creating it if needed.
+  static T& get() {
+    if (thread_ptr == NULL) {
+      pthread_once(&key_once, create_key);
+      thread_ptr = new T;
+      pthread_setspecific(key, thread_ptr);
+    }
+    return *thread_ptr;
+  }
+
+  /// Returns the object of the calling thread, or NULL if it has none.
+  static T* get_if_exists() {
+    return thread_ptr;
+  }
+
+ private:
+  static void destroy(void* ptr) {
+    thread_ptr = NULL;
+    delete reinterpret_cast<T*>(ptr);
+  }
+
+  static void create_key() {
+    pthread_key_create(&key, destroy);
+  }
+
+  static pthread_key_t key;
+  static pthread_once_t key_once;
+  static __thread T* thread_ptr;
+};
+
+template <typename T, typename Tag>
+pthread_key_t thread_local_object<T, Tag>::key;
+
+template <typename T, typename Tag>
+pthread_once_t thread_local_object<T, Tag>::key_once = PTHREAD_ONCE_INIT;
+
+template <typename T, typename Tag>
+__thread T* thread_local_object<T, Tag>::thread_ptr = NULL;
+
+} // namespace graphlab
+
+#endif
@@ -5,11 +5,43 @@
  * This software may be modified and distributed under the terms
  * of the BSD license. See the LICENSE file for details.
  */
+#include <cstdio>
 #include <sframe/csv_writer.hpp>
 #include <flexible_type/string_escape.hpp>
 #include <logger/logger.hpp>
 namespace graphlab {
 
+namespace {
+
+/*
+ * Formats an integer or a float into buf (of at least NUMBER_BUFFER_SIZE
+ * characters) exactly as std::string(val) would, but without going through a
+ * stringstream. Returns the length written.
+ */
+const size_t NUMBER_BUFFER_SIZE = 32;
+
+size_t format_number(const flexible_type& val, char* buf) {
+  if (val.get_type() == flex_type_enum::INTEGER) {
+    flex_int i = val.get<flex_int>();
+    uint64_t u = i < 0 ? -(uint64_t)i : (uint64_t)i;
+    char digits[24];
+    size_t ndigits = 0;
+    do {
+      digits[ndigits++] = '0' + (u % 10);
+      u /= 10;
+    } while (u > 0);
+    size_t len = 0;
+    if (i < 0) buf[len++] = '-';
+    while (ndigits > 0) buf[len++] = digits[--ndigits];
+    return len;
+  } else {
+    // the default ostream formatting of a double
+    return snprintf(buf, NUMBER_BUFFER_SIZE, "%.*g", 6, val.get<flex_float>());
+  }
+}
+
+} // anonymous namespace
+
 void csv_writer::write_verbatim(std::ostream& out,
                                 const std::vector<std::string>& row) {
   for (size_t i = 0;i < row.size(); ++i) {
@@ -24,7 +56,10 @@ void csv_writer::csv_print_internal(std::string& out, const flexible_type& val)
   switch(val.get_type()) {
     case flex_type_enum::INTEGER:
     case flex_type_enum::FLOAT:
-      out += std::string(val);
+      {
+        char buf[NUMBER_BUFFER_SIZE];
+        out.append(buf, format_number(val, buf));
+      }
       break;
     case flex_type_enum::DATETIME:
     case flex_type_enum::VECTOR:
@@ -71,10 +106,17 @@ void csv_writer::csv_print(std::ostream& out,
   switch(val.get_type()) {
     case flex_type_enum::INTEGER:
     case flex_type_enum::FLOAT:
-      if (quote_level == csv_quote_level::QUOTE_ALL) {
-        out << quote_char << std::string(val) << quote_char; // quote numbers only at QUOTE_ALL
-      } else {
-        out << std::string(val);
+      {
+        char buf[NUMBER_BUFFER_SIZE];
+        size_t len = format_number(val, buf);
+        if (quote_level == csv_quote_level::QUOTE_ALL) {
+          // quote numbers only at QUOTE_ALL
+          out << quote_char;
+          out.write(buf, len);
+          out << quote_char;
+        } else {
+          out.write(buf, len);
+        }
       }
       break;
     case flex_type_enum::DATETIME:
@@ -190,18 +232,28 @@ void csv_writer::csv_print(std::ostream& out,
   }
 }
 
-void csv_writer::write(std::ostream& out,
-                       const std::vector<flexible_type>& row) {
+template <typename Row>
+void csv_writer::write_row(std::ostream& out, const Row& row) {
   // if row size is 1, we cannot allow empty output
   bool allow_empty_output = row.size() > 1;
   for (size_t i = 0;i < row.size(); ++i) {
-    csv_print(out, row[i], row.size() > 1);
+    csv_print(out, row[i], allow_empty_output);
     // put a delimiter after every element except for the last element.
     if (i + 1 < row.size()) out << delimiter;
   }
   out << line_terminator;
 }
 
+void csv_writer::write(std::ostream& out,
+                       const std::vector<flexible_type>& row) {
+  write_row(out, row);
+}
+
+void csv_writer::write(std::ostream& out,
+                       const sframe_rows::row& row) {
+  write_row(out, row);
+}
+
 
 
 } // namespace graphlab
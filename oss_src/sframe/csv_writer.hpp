@@ -11,6 +11,7 @@
 #include <vector>
 #include <iostream>
 #include <flexible_type/flexible_type.hpp>
+#include <sframe/sframe_rows.hpp>
 namespace graphlab {
 
 class csv_writer {
@@ -95,6 +96,12 @@ class csv_writer {
    */
   void write(std::ostream& out, const std::vector<flexible_type>& row);
 
+  /**
+   * \overload
+   * Writes a row of an sframe_rows without copying it out.
+   */
+  void write(std::ostream& out, const sframe_rows::row& row);
+
   /**
    * Converts one value to a string.
    * \param out The stream to write to
@@ -115,6 +122,9 @@ class csv_writer {
 
  private:
 
+  template <typename Row>
+  void write_row(std::ostream& out, const Row& row);
+
   /**
    * Converts one value, appending it to a string.
    * minimal quoting is performed: only strings are quoted.
@@ -126,7 +136,8 @@ class csv_writer {
    * These are basically some optimizations to csv_print / csv_print_internal
    * to avoid allocating additional strings everytime. We just
    * repeatedly make use of the same set of buffers.
-   * This does mean that csv_print is *not* thread safe. But that's alright.
+   * This does mean that csv_print is *not* thread safe. But that's alright:
+   * parallel writers each use their own copy of the csv_writer.
    */
 
   /** The buffer used by csv_print to handle additional quoting required.
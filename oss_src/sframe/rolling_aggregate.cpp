@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cmath>
+#include <deque>
 #include <flexible_type/flexible_type.hpp>
 #include <boost/circular_buffer.hpp>
 #include <boost/algorithm/string.hpp>
@@ -7,6 +9,192 @@
 namespace graphlab {
 namespace rolling_aggregate {
 
+/**
+ * Sum over the window. Integer sums are exact; float sums are compensated
+ * (Neumaier) so that subtracting the values leaving the window does not
+ * accumulate much error.
+ */
+class sliding_sum : public sliding_window_aggregate {
+ public:
+  explicit sliding_sum(flex_type_enum type) : m_is_float(type == flex_type_enum::FLOAT) { }
+
+  void add(ssize_t, const flexible_type& val) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) return;
+    if (m_is_float) accumulate(val.get<flex_float>());
+    else m_int_sum += val.get<flex_int>();
+  }
+
+  void remove(ssize_t, const flexible_type& val) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) return;
+    if (m_is_float) accumulate(-val.get<flex_float>());
+    else m_int_sum -= val.get<flex_int>();
+  }
+
+  void reset() {
+    m_int_sum = 0;
+    m_sum = 0;
+    m_compensation = 0;
+  }
+
+  flexible_type emit() const {
+    if (m_is_float) return m_sum + m_compensation;
+    else return m_int_sum;
+  }
+
+  bool needs_rebuild() const { return m_is_float; }
+
+ private:
+  void accumulate(double x) {
+    double t = m_sum + x;
+    if (std::abs(m_sum) >= std::abs(x)) m_compensation += (m_sum - t) + x;
+    else m_compensation += (x - t) + m_sum;
+    m_sum = t;
+  }
+
+  bool m_is_float;
+  flex_int m_int_sum = 0;
+  double m_sum = 0;
+  double m_compensation = 0;
+};
+
+/**
+ * Number of non-missing values in the window.
+ */
+class sliding_count : public sliding_window_aggregate {
+ public:
+  void add(ssize_t, const flexible_type& val) {
+    if (val.get_type() != flex_type_enum::UNDEFINED) ++m_count;
+  }
+  void remove(ssize_t, const flexible_type& val) {
+    if (val.get_type() != flex_type_enum::UNDEFINED) --m_count;
+  }
+  void reset() { m_count = 0; }
+  flexible_type emit() const { return flex_int(m_count); }
+
+ private:
+  size_t m_count = 0;
+};
+
+/**
+ * Mean, variance or standard deviation over the window, using Welford's
+ * update and its inverse. Matches the emitted values of
+ * groupby_operators::average, variance and stdv.
+ */
+class sliding_moments : public sliding_window_aggregate {
+ public:
+  enum class moment { MEAN, VAR, STDV };
+
+  explicit sliding_moments(moment m) : m_moment(m) { }
+
+  void add(ssize_t, const flexible_type& val) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) return;
+    double x = (double)val;
+    ++m_count;
+    double delta = x - m_mean;
+    m_mean += delta / m_count;
+    m_M2 += delta * (x - m_mean);
+  }
+
+  void remove(ssize_t, const flexible_type& val) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) return;
+    if (m_count <= 1) {
+      reset();
+      return;
+    }
+    double x = (double)val;
+    --m_count;
+    double delta = x - m_mean;
+    m_mean -= delta / m_count;
+    m_M2 = std::max(0.0, m_M2 - delta * (x - m_mean));
+  }
+
+  void reset() {
+    m_count = 0;
+    m_mean = 0;
+    m_M2 = 0;
+  }
+
+  flexible_type emit() const {
+    switch(m_moment) {
+     case moment::MEAN:
+       if (m_count == 0) return FLEX_UNDEFINED;
+       return m_mean;
+     case moment::VAR:
+       return m_count <= 1 ? 0.0 : m_M2 / m_count;
+     case moment::STDV:
+     default:
+       return m_count <= 1 ? 0.0 : std::sqrt(m_M2 / m_count);
+    }
+  }
+
+  bool needs_rebuild() const { return true; }
+
+ private:
+  moment m_moment;
+  size_t m_count = 0;
+  double m_mean = 0;
+  double m_M2 = 0;
+};
+
+/**
+ * Min or max over the window with a monotonic deque of (position, value).
+ * The front of the deque is the extremum of the window; every value is
+ * pushed and popped at most once, so updates are amortized O(1).
+ */
+template <bool IsMax>
+class sliding_extremum : public sliding_window_aggregate {
+ public:
+  void add(ssize_t pos, const flexible_type& val) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) return;
+    while (!m_deque.empty() && !better(m_deque.back().second, val)) {
+      m_deque.pop_back();
+    }
+    m_deque.emplace_back(pos, val);
+  }
+
+  void remove(ssize_t pos, const flexible_type&) {
+    while (!m_deque.empty() && m_deque.front().first <= pos) m_deque.pop_front();
+  }
+
+  void reset() { m_deque.clear(); }
+
+  flexible_type emit() const {
+    if (m_deque.empty()) return FLEX_UNDEFINED;
+    return m_deque.front().second;
+  }
+
+ private:
+  // true if a must stay ahead of a newer value b in the deque
+  static bool better(const flexible_type& a, const flexible_type& b) {
+    return IsMax ? (b < a) : (a < b);
+  }
+
+  std::deque<std::pair<ssize_t, flexible_type>> m_deque;
+};
+
+std::unique_ptr<sliding_window_aggregate> make_sliding_aggregate(
+    std::shared_ptr<group_aggregate_value> agg_op,
+    flex_type_enum input_type) {
+  typedef std::unique_ptr<sliding_window_aggregate> ret_type;
+  auto op = agg_op.get();
+  if (dynamic_cast<groupby_operators::sum*>(op)) {
+    return ret_type(new sliding_sum(input_type));
+  } else if (dynamic_cast<groupby_operators::non_null_count*>(op)) {
+    return ret_type(new sliding_count());
+  } else if (dynamic_cast<groupby_operators::average*>(op)) {
+    return ret_type(new sliding_moments(sliding_moments::moment::MEAN));
+  } else if (dynamic_cast<groupby_operators::stdv*>(op)) {
+    return ret_type(new sliding_moments(sliding_moments::moment::STDV));
+  } else if (dynamic_cast<groupby_operators::variance*>(op)) {
+    return ret_type(new sliding_moments(sliding_moments::moment::VAR));
+  } else if (dynamic_cast<groupby_operators::min*>(op)) {
+    return ret_type(new sliding_extremum<false>());
+  } else if (dynamic_cast<groupby_operators::max*>(op)) {
+    return ret_type(new sliding_extremum<true>());
+  }
+  return nullptr;
+}
+
 ssize_t clip(ssize_t val, ssize_t lower, ssize_t upper) {
   return std::min(upper, std::max(lower, val));
 }
@@ -87,15 +275,23 @@ std::shared_ptr<sarray<flexible_type>> rolling_apply(
   parallel_for(0, num_segments, [&](size_t segment_id) {
     auto range = seg_ranges[segment_id];
     
-    // Create buffer for the window
-    auto window_buf = boost::circular_buffer<flexible_type>(total_window_size,
-        flex_undefined());
+    // Create buffer for the window. It always holds exactly the values of
+    // the logical window, in order, with NULLs for rows outside the array.
+    auto window_buf = boost::circular_buffer<flexible_type>(total_window_size);
     auto out_iter = ret_sarray->get_output_iterator(segment_id);
 
     sarray_reader_buffer<flexible_type> buf_reader(reader,
                                                    range.first,
                                                    range.second+1);
 
+    // The incrementally updated aggregate, if the function supports it.
+    // Otherwise every window is aggregated from scratch.
+    auto sliding_agg = make_sliding_aggregate(agg_op, input.get_type());
+    // Number of non-NULL values in the window
+    size_t observations = 0;
+    // Number of slides since the sliding aggregate was last rebuilt
+    size_t slides_since_rebuild = 0;
+
     // The esteemed "current" value that all the documentation talks about
     ssize_t logical_pos = ssize_t(seg_starts[segment_id]);
     // The last row for which this thread should calculate the aggregate
@@ -107,25 +303,34 @@ std::shared_ptr<sarray<flexible_type>> rolling_apply(
     std::pair<ssize_t,ssize_t> my_logical_window =
       std::make_pair(window_start+logical_pos, window_end+logical_pos);
 
+    auto read_value = [&](ssize_t i)->flexible_type {
+      if(i >= 0 && buf_reader.has_next()) {
+        return buf_reader.next();
+      } else {
+        // If this is a "fake" section of the logical window, just fill with
+        // NULL values
+        return flex_undefined();
+      }
+    };
+
     // Initially fill the window buffer
     for(ssize_t i = my_logical_window.first;
         i <= my_logical_window.second;
         ++i) {
-      if(i >= 0 && buf_reader.has_next()) {
-        window_buf.push_back(buf_reader.next());
-      }
+      window_buf.push_back(read_value(i));
+      if(window_buf.back().get_type() != flex_type_enum::UNDEFINED) ++observations;
+      if(sliding_agg) sliding_agg->add(i, window_buf.back());
     }
 
     // Go through array with window
     while(logical_pos < logical_end) {
       // First check if we have the minimum non-NULL observations. This is here
       // to remove the burden of checking from every aggregation function.
-      if(check_num_observations &&
-          !has_min_observations(min_observations,
-            window_buf.begin(), window_buf.end())) {
+      if(check_num_observations && observations < min_observations) {
         *out_iter = flex_undefined();
       } else {
-        auto result = full_window_aggregate(agg_op, window_buf.begin(), window_buf.end());
+        auto result = sliding_agg ? sliding_agg->emit() :
+            full_window_aggregate(agg_op, window_buf.begin(), window_buf.end());
         // Record the emitted type from the function. We just take the first
         // one that is non-NULL.
         if(fn_returned_types[segment_id] == flex_type_enum::UNDEFINED && 
@@ -137,16 +342,31 @@ std::shared_ptr<sarray<flexible_type>> rolling_apply(
 
       // Update logical window
       ++logical_pos;
+      if(logical_pos >= logical_end) break;
+
+      const flexible_type& leaving = window_buf.front();
+      if(leaving.get_type() != flex_type_enum::UNDEFINED) --observations;
+      if(sliding_agg) sliding_agg->remove(my_logical_window.first, leaving);
+
       ++my_logical_window.first;
       ++my_logical_window.second;
 
       // Get the next value in the SArray
-      if(my_logical_window.second >= 0 && buf_reader.has_next()) {
-        window_buf.push_back(buf_reader.next());
-      } else {
-        // If this is a "fake" section of the logical window, just fill with
-        // NULL values
-        window_buf.push_back(flex_undefined());
+      window_buf.push_back(read_value(my_logical_window.second));
+      if(window_buf.back().get_type() != flex_type_enum::UNDEFINED) ++observations;
+
+      if(sliding_agg) {
+        // Floating point state drifts as values are removed, so recompute
+        // it from the window once per window length; amortized O(1).
+        if(sliding_agg->needs_rebuild() &&
+           ++slides_since_rebuild >= total_window_size) {
+          sliding_agg->reset();
+          ssize_t pos = my_logical_window.first;
+          for(const auto& val : window_buf) sliding_agg->add(pos++, val);
+          slides_since_rebuild = 0;
+        } else {
+          sliding_agg->add(my_logical_window.second, window_buf.back());
+        }
       }
     }
   }
@@ -46,6 +46,45 @@ std::shared_ptr<sarray<flexible_type>> rolling_apply(
     ssize_t window_end,
     size_t min_observations);
 
+/**
+ * An aggregate over a moving window which is updated as values enter and
+ * leave the window, instead of being recomputed over the whole window.
+ * Values are identified by their (logical) row number; they are added in
+ * increasing row order and removed in the same order. NULL values are
+ * passed through and must be ignored by the implementation.
+ */
+class sliding_window_aggregate {
+ public:
+  virtual ~sliding_window_aggregate() { }
+
+  /// Adds the value at row pos to the window
+  virtual void add(ssize_t pos, const flexible_type& val) = 0;
+
+  /// Removes the value at row pos, the oldest in the window
+  virtual void remove(ssize_t pos, const flexible_type& val) = 0;
+
+  /// Empties the window
+  virtual void reset() = 0;
+
+  /// Emits the aggregate of the current window
+  virtual flexible_type emit() const = 0;
+
+  /**
+   * Returns true if the state accumulates floating point error as values
+   * are removed, and should be periodically rebuilt from the window.
+   */
+  virtual bool needs_rebuild() const { return false; }
+};
+
+/**
+ * Returns a sliding window implementation of the given groupby aggregator
+ * (sum, non-NULL count, avg, var, stdv, min and max over scalar values), or
+ * nullptr if the aggregator has none.
+ */
+std::unique_ptr<sliding_window_aggregate> make_sliding_aggregate(
+    std::shared_ptr<group_aggregate_value> agg_op,
+    flex_type_enum input_type);
+
 
 /// Aggregate functions
 template<typename Iterator>
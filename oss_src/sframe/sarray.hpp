@@ -21,6 +21,7 @@
 #include <sframe/swriter_base.hpp>
 #include <sframe/sarray_file_format_v2.hpp>
 #include <sframe/sarray_index_file.hpp>
+#include <sframe/sarray_statistics.hpp>
 #include <sframe/algorithm.hpp>
 #include <sframe/sframe_config.hpp>
 #include <flexible_type/flexible_type.hpp>
@@ -369,6 +370,17 @@ class sarray : public swriter_base<swriter_impl::output_iterator<T> > {
     }
   }
 
+  /**
+   * Merges the statistics persisted with each segment of the array into
+   * statistics for the whole array. Returns false if they are not available
+   * (see \ref get_sarray_statistics), in which case the caller must scan.
+   */
+  bool get_statistics(sarray_segment_statistics& ret) const {
+    ASSERT_MSG(inited, "Invalid SArray");
+    ASSERT_MSG(!writing, "Cannot read statistics of an SArray which is still writing.");
+    return get_sarray_statistics(index_info, ret);
+  }
+
   /**
    * Returns the number of elements in the SArray
    */
@@ -472,6 +484,13 @@ class sarray : public swriter_base<swriter_impl::output_iterator<T> > {
               std::inserter(ret.index_info.segment_files, ret.index_info.segment_files.end()));
     std::copy(other.files_managed.begin(), other.files_managed.end(),
               std::inserter(ret.files_managed, ret.files_managed.end()));
+    // segment statistics follow their segments
+    std::string stats = append_segment_statistics(index_info, other.index_info);
+    if (stats.empty()) {
+      ret.index_info.metadata.erase(SARRAY_STATISTICS_METADATA_KEY);
+    } else {
+      ret.index_info.metadata[SARRAY_STATISTICS_METADATA_KEY] = stats;
+    }
     return ret;
   }
   /**
@@ -135,7 +135,7 @@ class sarray_format_reader<flexible_type>
                            size_t row_end, 
                            sframe_rows& out_obj) {
     size_t ret = 0;
-    out_obj.resize(1);
+    out_obj.reset(1);
     ret = read_rows(row_start, row_end, *(out_obj.get_columns()[0]));
     return ret;
   }
@@ -10,14 +10,21 @@
 #include <string>
 #include <memory>
 #include <typeinfo>
+#include <type_traits>
 #include <map>
+#include <deque>
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <parallel/mutex.hpp>
+#include <parallel/thread_pool.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <logger/logger.hpp>
 #include <random/random.hpp>
 #include <util/dense_bitset.hpp>
 #include <sframe/sarray_file_format_interface.hpp>
 #include <sframe/sarray_index_file.hpp>
+#include <sframe/sarray_statistics.hpp>
 #include <fileio/general_fstream.hpp>
 #include <fileio/temp_files.hpp>
 #include <serialization/serialization_includes.hpp>
@@ -563,6 +570,14 @@ read_rows(size_t row_start,
 template <typename T>
 class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
  public:
+  /**
+   * Waits for the blocks still being written by the thread pool, if the
+   * writer was not closed.
+   */
+  ~sarray_group_format_writer_v2() {
+    if (m_flush_queue) finish_flushes(false);
+  }
+
   /**
    * Open has to be called before any of the other functions are called.
    * No files are actually opened at this point.
@@ -576,9 +591,17 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
     m_array_open = true;
     m_writer.init(index_file, segments_to_create, columns_to_create);
     m_nsegments = segments_to_create;
+    m_collect_statistics = SFRAME_WRITER_COLLECT_STATISTICS &&
+        std::is_same<T, flexible_type>::value;
     m_column_buffers.resize(columns_to_create);
     for (size_t i = 0; i < columns_to_create; ++i) {
       m_column_buffers[i].segment_data.resize(segments_to_create);
+      m_column_buffers[i].segment_statistics.resize(segments_to_create);
+      m_column_buffers[i].pending_blocks.resize(segments_to_create);
+      m_column_buffers[i].flush_scheduled.resize(segments_to_create, false);
+    }
+    if (SFRAME_WRITER_ASYNC_FLUSH && thread_pool::get_instance().size() > 1) {
+      m_flush_queue = std::make_shared<flush_queue>();
     }
     for (size_t i = 0; i < m_nsegments; ++i) {
       open_segment(i);
@@ -630,7 +653,7 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
     DASSERT_EQ(m_array_open, true);
     m_column_buffers[columnid].segment_data[segmentid].push_back(t);
     if (m_column_buffers[columnid].segment_data[segmentid].size() >= 
-        m_column_buffers[columnid].elements_before_flush) {
+        m_column_buffers[columnid].get_elements_before_flush()) {
       flush_block(columnid, segmentid);
     }
   }
@@ -645,11 +668,11 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
     DASSERT_LT(columnid, m_column_buffers.size());
     DASSERT_EQ(m_array_open, true);
 
-    auto& el_before_flush = m_column_buffers[columnid].elements_before_flush;
-    auto& buffer = m_column_buffers[columnid].segment_data[segmentid];
+    auto& colbuf = m_column_buffers[columnid];
+    auto& buffer = colbuf.segment_data[segmentid];
     for(const auto& elem: t) {
       buffer.push_back(elem);
-      if (buffer.size() >= el_before_flush) {
+      if (buffer.size() >= colbuf.get_elements_before_flush()) {
         flush_block(columnid, segmentid);
       }
     }
@@ -665,13 +688,12 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
     DASSERT_LT(columnid, m_column_buffers.size());
     DASSERT_EQ(m_array_open, true);
 
-    auto el_before_flush = m_column_buffers[columnid].elements_before_flush;
-    auto& buffer = m_column_buffers[columnid].segment_data[segmentid];
+    auto& colbuf = m_column_buffers[columnid];
+    auto& buffer = colbuf.segment_data[segmentid];
     for(const auto& elem: t) {
       buffer.push_back(std::move(elem));
-      if (buffer.size() >= el_before_flush) {
+      if (buffer.size() >= colbuf.get_elements_before_flush()) {
         flush_block(columnid, segmentid);
-        el_before_flush = m_column_buffers[columnid].elements_before_flush;
       }
     }
   }
@@ -687,7 +709,7 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
     DASSERT_EQ(m_array_open, true);
     m_column_buffers[columnid].segment_data[segmentid].push_back(std::forward<T>(t));
     if (m_column_buffers[columnid].segment_data[segmentid].size() >= 
-        m_column_buffers[columnid].elements_before_flush) {
+        m_column_buffers[columnid].get_elements_before_flush()) {
       flush_block(columnid, segmentid);
     }
   }
@@ -704,8 +726,17 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
       for (size_t j = 0;j < m_column_buffers.size(); ++j) {
         flush_block(j, i);
       }
+    }
+    if (m_flush_queue) finish_flushes(true);
+    for (size_t i = 0;i < m_nsegments; ++i) {
       m_writer.close_segment(i);
     }
+    if (m_collect_statistics) {
+      for (size_t j = 0;j < m_column_buffers.size(); ++j) {
+        get_index_info().columns[j].metadata[SARRAY_STATISTICS_METADATA_KEY] =
+            encode_segment_statistics(m_column_buffers[j].segment_statistics);
+      }
+    }
     /*
      * for (size_t i = 0;i < m_column_buffers.size(); ++i) {
      *   logstream(LOG_INFO) << "Writing column " << i 
@@ -753,6 +784,8 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
   bool m_array_open = false;
   /// The number of segments
   size_t m_nsegments;
+  /// Whether per-segment statistics are accumulated on flush
+  bool m_collect_statistics = false;
   /// The writer
   v2_block_impl::block_writer m_writer;
 
@@ -761,12 +794,183 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
     // segment.  When the block has been written, the archive is cleared.
     simple_spinlock lock;
     std::vector<std::vector<T> > segment_data;
-    size_t elements_before_flush = SARRAY_WRITER_INITAL_ELEMENTS_PER_BLOCK;
+    // For each segment, the full blocks handed to the thread pool and not
+    // written yet, in order. At most one pool task (flush_scheduled) writes
+    // the blocks of a segment of a column, which keeps them in order.
+    std::vector<std::deque<std::vector<T> > > pending_blocks;
+    std::vector<char> flush_scheduled;
+    // Statistics of everything flushed so far for each segment.
+    std::vector<sarray_segment_statistics> segment_statistics;
+    // The number of elements to buffer before flushing a block. Updated by
+    // the thread writing the blocks of the column (which may be a pool
+    // thread) and read without the lock by the thread filling the buffers.
+    // Wrapped so that column_buffer stays copyable for the resize in open.
+    struct atomic_size {
+      std::atomic<size_t> value;
+      explicit atomic_size(size_t v): value(v) { }
+      atomic_size(const atomic_size& other): value(other.value.load()) { }
+    };
+    atomic_size elements_before_flush{SARRAY_WRITER_INITAL_ELEMENTS_PER_BLOCK};
+    // Protected by lock
     size_t total_bytes_written = 0;
     size_t total_elements_written = 0;
+
+    size_t get_elements_before_flush() const {
+      return elements_before_flush.value.load(std::memory_order_relaxed);
+    }
   };
   
   std::vector<column_buffer> m_column_buffers;
+
+  /**
+   * The blocks being encoded, compressed and written by the thread pool.
+   * Shared with the pool tasks, which may run after the writer is gone when
+   * the blocks they were launched for were written by someone else.
+   */
+  struct flush_queue {
+    mutex lock;
+    conditional cond;
+    /// Tasks writing the pending blocks of one segment of one column
+    std::deque<std::function<void(void)> > tasks;
+    /// Number of tasks queued or running
+    size_t active_tasks = 0;
+    /// Number of cells in blocks handed over and not written yet
+    size_t pending_cells = 0;
+    /// The first exception thrown while writing a block
+    std::exception_ptr error;
+  };
+  /// NULL if blocks are written by the thread filling them
+  std::shared_ptr<flush_queue> m_flush_queue;
+
+  /**
+   * Runs one queued task, if any. Returns false if the queue was empty.
+   * Tasks do not throw: errors are recorded in the queue.
+   */
+  static bool run_flush_task(flush_queue& queue) {
+    std::function<void(void)> task;
+    {
+      std::lock_guard<mutex> guard(queue.lock);
+      if (queue.tasks.empty()) return false;
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+    task();
+    std::lock_guard<mutex> guard(queue.lock);
+    --queue.active_tasks;
+    queue.cond.broadcast();
+    return true;
+  }
+
+  /**
+   * Waits until pred holds (pred is called with the queue lock held).
+   * Meanwhile, runs queued tasks on this thread rather than waiting for the
+   * pool: the writer may itself be running on all of the pool threads.
+   */
+  template <typename Predicate>
+  void wait_for_flushes(Predicate pred) {
+    flush_queue& queue = *m_flush_queue;
+    while (true) {
+      std::unique_lock<mutex> guard(queue.lock);
+      if (pred(queue)) return;
+      if (queue.tasks.empty()) {
+        queue.cond.wait(guard);
+      } else {
+        guard.unlock();
+        run_flush_task(queue);
+      }
+    }
+  }
+
+  /**
+   * Waits for all the pending blocks to be written. Rethrows the first
+   * exception thrown while writing them if rethrow is set.
+   */
+  void finish_flushes(bool rethrow) {
+    wait_for_flushes([](const flush_queue& queue) {
+      return queue.active_tasks == 0;
+    });
+    if (rethrow && m_flush_queue->error) {
+      auto error = m_flush_queue->error;
+      m_flush_queue->error = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  /**
+   * Hands the current contents of a segment of a column to the thread pool,
+   * then waits while more than SFRAME_WRITER_MAX_BUFFERED_CELLS cells are
+   * pending.
+   */
+  void flush_block_async(size_t columnid, size_t segmentid) {
+    auto& colbuf = m_column_buffers[columnid];
+    auto& buffer = colbuf.segment_data[segmentid];
+    flush_queue& queue = *m_flush_queue;
+    {
+      std::lock_guard<mutex> guard(queue.lock);
+      if (queue.error) {
+        auto error = queue.error;
+        queue.error = nullptr;
+        std::rethrow_exception(error);
+      }
+      queue.pending_cells += buffer.size();
+    }
+    bool schedule = false;
+    {
+      std::lock_guard<simple_spinlock> guard(colbuf.lock);
+      colbuf.pending_blocks[segmentid].push_back(std::move(buffer));
+      schedule = !colbuf.flush_scheduled[segmentid];
+      colbuf.flush_scheduled[segmentid] = true;
+    }
+    buffer = std::vector<T>();
+    buffer.reserve(colbuf.get_elements_before_flush());
+    if (schedule) {
+      {
+        std::lock_guard<mutex> guard(queue.lock);
+        queue.tasks.push_back([=]() { write_pending_blocks(columnid, segmentid); });
+        ++queue.active_tasks;
+      }
+      auto shared_queue = m_flush_queue;
+      thread_pool::get_instance().launch([shared_queue]() {
+        run_flush_task(*shared_queue);
+      });
+    }
+    wait_for_flushes([](const flush_queue& queue) {
+      return queue.pending_cells <= SFRAME_WRITER_MAX_BUFFERED_CELLS;
+    });
+  }
+
+  /**
+   * Writes the pending blocks of a segment of a column until there are none
+   * left.
+   */
+  void write_pending_blocks(size_t columnid, size_t segmentid) {
+    auto& colbuf = m_column_buffers[columnid];
+    while (true) {
+      std::vector<T> block;
+      {
+        std::lock_guard<simple_spinlock> guard(colbuf.lock);
+        auto& pending = colbuf.pending_blocks[segmentid];
+        if (pending.empty()) {
+          colbuf.flush_scheduled[segmentid] = false;
+          return;
+        }
+        block = std::move(pending.front());
+        pending.pop_front();
+      }
+      size_t num_cells = block.size();
+      std::exception_ptr error;
+      try {
+        write_buffered_block(columnid, segmentid, block);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<mutex> guard(m_flush_queue->lock);
+      m_flush_queue->pending_cells -= num_cells;
+      if (error && !m_flush_queue->error) m_flush_queue->error = error;
+      m_flush_queue->cond.broadcast();
+    }
+  }
+
   /**
    * Makes a particular segment writable with \ref write_segment
    * Should throw an exception if the segment is already open, or if
@@ -794,64 +998,78 @@ class sarray_group_format_writer_v2: public sarray_group_format_writer<T> {
   /**
    * Flushes the current contents of a segment of a column 
    */
-  void flush_block(size_t columnid, size_t segmentid); 
+  void flush_block(size_t columnid, size_t segmentid) {
+    if (m_column_buffers[columnid].segment_data[segmentid].empty()) return;
+    if (m_flush_queue) {
+      flush_block_async(columnid, segmentid);
+    } else {
+      write_buffered_block(columnid, segmentid,
+                           m_column_buffers[columnid].segment_data[segmentid]);
+      m_column_buffers[columnid].segment_data[segmentid].clear();
+    }
+  }
+
+  /**
+   * Encodes, compresses and writes a block of a segment of a column, and
+   * updates the estimated number of elements before the next flush.
+   */
+  void write_buffered_block(size_t columnid, size_t segmentid,
+                            const std::vector<T>& data);
+
+  /**
+   * Records a block of num_elements elements written in num_bytes bytes,
+   * and publishes the new estimate of the number of elements per block.
+   */
+  void update_elements_before_flush(column_buffer& colbuf,
+                                    size_t num_bytes, size_t num_elements) {
+    size_t estimate;
+    {
+      std::lock_guard<simple_spinlock> guard(colbuf.lock);
+      colbuf.total_bytes_written += num_bytes;
+      colbuf.total_elements_written += num_elements;
+      estimate = (float)(SFRAME_DEFAULT_BLOCK_SIZE) / (
+          (float)(colbuf.total_bytes_written+1) / (float)(colbuf.total_elements_written+1));
+    }
+    estimate = std::max(estimate, SARRAY_WRITER_MIN_ELEMENTS_PER_BLOCK);
+    estimate = std::min(estimate,
+                        SFRAME_WRITER_MAX_BUFFERED_CELLS / (m_nsegments * m_column_buffers.size()));
+    estimate = std::min(estimate, SFRAME_WRITER_MAX_BUFFERED_CELLS_PER_BLOCK);
+    colbuf.elements_before_flush.value.store(estimate, std::memory_order_relaxed);
+  }
 };
 
 template <>
-inline void sarray_group_format_writer_v2<flexible_type>::flush_block(size_t columnid, 
-                                                               size_t segmentid) {
+inline void sarray_group_format_writer_v2<flexible_type>::write_buffered_block(
+    size_t columnid, size_t segmentid, const std::vector<flexible_type>& data) {
   // flexible_type specialization. writes typed blocks.
-  // if there is no data to write, skip
   auto& colbuf = m_column_buffers[columnid];
-  if (colbuf.segment_data[segmentid].empty()) return;
-  size_t write_size = colbuf.segment_data[segmentid].size();
+  size_t write_size = data.size();
+  if (m_collect_statistics) {
+    colbuf.segment_statistics[segmentid].add(data);
+  }
   size_t ret = m_writer.write_typed_block(segmentid,
                                           columnid,
-                                          colbuf.segment_data[segmentid],
+                                          data,
                                           v2_block_impl::block_info());
-  colbuf.segment_data[segmentid].clear();
   // update the column buffer counters and estimates the number of elements 
   // before the next flush.
-  std::lock_guard<simple_spinlock> guard(colbuf.lock);
-  colbuf.total_bytes_written += ret;
-  colbuf.total_elements_written += write_size;
-  colbuf.elements_before_flush = (float)(SFRAME_DEFAULT_BLOCK_SIZE) / (
-      (float)(colbuf.total_bytes_written+1) / (float)(colbuf.total_elements_written+1));
-  colbuf.elements_before_flush = std::max(colbuf.elements_before_flush, 
-                                          SARRAY_WRITER_MIN_ELEMENTS_PER_BLOCK);
-  colbuf.elements_before_flush = std::min(colbuf.elements_before_flush, 
-                                          SFRAME_WRITER_MAX_BUFFERED_CELLS / (m_nsegments * m_column_buffers.size()));
-  colbuf.elements_before_flush = std::min(colbuf.elements_before_flush, 
-                                          SFRAME_WRITER_MAX_BUFFERED_CELLS_PER_BLOCK);
+  update_elements_before_flush(colbuf, ret, write_size);
 }
 
 template <typename T>
-inline void sarray_group_format_writer_v2<T>::flush_block(size_t columnid, 
-                                                          size_t segmentid){
+inline void sarray_group_format_writer_v2<T>::write_buffered_block(
+    size_t columnid, size_t segmentid, const std::vector<T>& data) {
   // regular type specialization. writes bytes 
-  // if there is no data to write, skip
   auto& colbuf = m_column_buffers[columnid];
-  if (colbuf.segment_data[segmentid].empty()) return;
-  size_t write_size = colbuf.segment_data[segmentid].size();
+  size_t write_size = data.size();
   size_t ret = m_writer.write_block(segmentid,
                                     columnid,
-                                    colbuf.segment_data[segmentid],
+                                    data,
                                     v2_block_impl::block_info());
-  colbuf.segment_data[segmentid].clear();
 
   // update the column buffer counters and estimates the number of elements 
   // before the next flush.
-  std::lock_guard<simple_spinlock> guard(colbuf.lock);
-  colbuf.total_bytes_written += ret;
-  colbuf.total_elements_written += write_size;
-  colbuf.elements_before_flush = (float)(SFRAME_DEFAULT_BLOCK_SIZE) / (
-      (float)(colbuf.total_bytes_written+1) / (float)(colbuf.total_elements_written+1));
-  colbuf.elements_before_flush = std::max(colbuf.elements_before_flush, 
-                                          SARRAY_WRITER_MIN_ELEMENTS_PER_BLOCK);
-  colbuf.elements_before_flush = std::min(colbuf.elements_before_flush, 
-                                          SFRAME_WRITER_MAX_BUFFERED_CELLS / (m_nsegments * m_column_buffers.size()));
-  colbuf.elements_before_flush = std::min(colbuf.elements_before_flush, 
-                                          SFRAME_WRITER_MAX_BUFFERED_CELLS_PER_BLOCK);
+  update_elements_before_flush(colbuf, ret, write_size);
 
 }
 
@@ -868,7 +1086,7 @@ inline void sarray_group_format_writer_v2<flexible_type>::write_segment(size_t s
     auto& buffer = m_column_buffers[i].segment_data[segmentid];
     std::copy(cols[i]->begin(), cols[i]->end(), std::back_inserter(buffer));
     if (m_column_buffers[i].segment_data[segmentid].size() >= 
-        m_column_buffers[i].elements_before_flush) {
+        m_column_buffers[i].get_elements_before_flush()) {
       flush_block(i, segmentid);
     }
   }
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <sframe/sarray_statistics.hpp>
+
+namespace graphlab {
+
+const char* SARRAY_STATISTICS_METADATA_KEY = "__segment_statistics__";
+
+void sarray_segment_statistics::add(const flexible_type& val) {
+  ++num_elements;
+  switch(val.get_type()) {
+    case flex_type_enum::UNDEFINED:
+      ++num_missing;
+      return;
+    case flex_type_enum::INTEGER: {
+      flex_int ival = val.get<flex_int>();
+      if (num_int == 0) {
+        int_min = ival;
+        int_max = ival;
+      } else {
+        int_min = std::min(int_min, ival);
+        int_max = std::max(int_max, ival);
+      }
+      // wrap around on overflow the same way a flex_int accumulator would
+      int_sum = (flex_int)((uint64_t)int_sum + (uint64_t)ival);
+      ++num_int;
+      double delta = ival - mean;
+      mean += delta / (num_int + num_float);
+      m2 += delta * (ival - mean);
+      break;
+    }
+    case flex_type_enum::FLOAT: {
+      flex_float fval = val.get<flex_float>();
+      if (std::isnan(fval)) {
+        ++num_nan;
+        break;
+      }
+      if (num_float == 0) {
+        float_min = fval;
+        float_max = fval;
+      } else {
+        float_min = std::min(float_min, fval);
+        float_max = std::max(float_max, fval);
+      }
+      float_sum += fval;
+      ++num_float;
+      double delta = fval - mean;
+      mean += delta / (num_int + num_float);
+      m2 += delta * (fval - mean);
+      break;
+    }
+    case flex_type_enum::DATETIME:
+      // is_zero is not defined on datetimes
+      return;
+    default:
+      break;
+  }
+  if (!val.is_zero()) ++num_nonzero;
+}
+
+void sarray_segment_statistics::add(const std::vector<flexible_type>& vals) {
+  for (const auto& val: vals) add(val);
+}
+
+void sarray_segment_statistics::combine(const sarray_segment_statistics& other) {
+  size_t n = num_int + num_float;
+  size_t other_n = other.num_int + other.num_float;
+  if (n + other_n > 0) {
+    double delta = other.mean - mean;
+    mean = mean * ((double)n / (double)(n + other_n)) +
+        other.mean * ((double)other_n / (double)(n + other_n));
+    m2 += other.m2 + delta * n * delta * other_n / (double)(n + other_n);
+  }
+
+  if (other.num_int > 0) {
+    int_min = num_int > 0 ? std::min(int_min, other.int_min) : other.int_min;
+    int_max = num_int > 0 ? std::max(int_max, other.int_max) : other.int_max;
+  }
+  if (other.num_float > 0) {
+    float_min = num_float > 0 ? std::min(float_min, other.float_min) : other.float_min;
+    float_max = num_float > 0 ? std::max(float_max, other.float_max) : other.float_max;
+  }
+  int_sum = (flex_int)((uint64_t)int_sum + (uint64_t)other.int_sum);
+  float_sum += other.float_sum;
+  num_int += other.num_int;
+  num_float += other.num_float;
+  num_elements += other.num_elements;
+  num_missing += other.num_missing;
+  num_nonzero += other.num_nonzero;
+  num_nan += other.num_nan;
+}
+
+/*
+ * The encoding is a ';' separated list of segments, each of which is a ','
+ * separated list of fields. Doubles are written with enough digits to
+ * round trip exactly.
+ */
+std::string encode_segment_statistics(
+    const std::vector<sarray_segment_statistics>& stats) {
+  std::stringstream strm;
+  char buf[64];
+  auto write_double = [&](double d) {
+    snprintf(buf, sizeof(buf), "%.17g", d);
+    strm << buf;
+  };
+  for (size_t i = 0; i < stats.size(); ++i) {
+    const auto& s = stats[i];
+    if (i > 0) strm << ";";
+    strm << s.num_elements << "," << s.num_missing << ","
+         << s.num_nonzero << "," << s.num_nan << ","
+         << s.num_int << "," << s.int_sum << ","
+         << s.int_min << "," << s.int_max << ","
+         << s.num_float << ",";
+    write_double(s.float_sum); strm << ",";
+    write_double(s.float_min); strm << ",";
+    write_double(s.float_max); strm << ",";
+    write_double(s.mean); strm << ",";
+    write_double(s.m2);
+  }
+  return strm.str();
+}
+
+bool decode_segment_statistics(const std::string& str,
+                               std::vector<sarray_segment_statistics>& stats) {
+  stats.clear();
+  if (str.empty()) return true;
+  const char* c = str.c_str();
+  while(true) {
+    sarray_segment_statistics s;
+    char* end = nullptr;
+    auto read_size = [&](size_t& out) {
+      out = std::strtoull(c, &end, 10);
+      if (end == c) return false;
+      c = end;
+      return true;
+    };
+    auto read_int = [&](flex_int& out) {
+      out = std::strtoll(c, &end, 10);
+      if (end == c) return false;
+      c = end;
+      return true;
+    };
+    auto read_double = [&](double& out) {
+      out = std::strtod(c, &end);
+      if (end == c) return false;
+      c = end;
+      return true;
+    };
+    auto read_sep = [&]() {
+      if (*c != ',') return false;
+      ++c;
+      return true;
+    };
+    bool ok = read_size(s.num_elements) && read_sep() &&
+        read_size(s.num_missing) && read_sep() &&
+        read_size(s.num_nonzero) && read_sep() &&
+        read_size(s.num_nan) && read_sep() &&
+        read_size(s.num_int) && read_sep() &&
+        read_int(s.int_sum) && read_sep() &&
+        read_int(s.int_min) && read_sep() &&
+        read_int(s.int_max) && read_sep() &&
+        read_size(s.num_float) && read_sep() &&
+        read_double(s.float_sum) && read_sep() &&
+        read_double(s.float_min) && read_sep() &&
+        read_double(s.float_max) && read_sep() &&
+        read_double(s.mean) && read_sep() &&
+        read_double(s.m2);
+    if (!ok) return false;
+    stats.push_back(s);
+    if (*c == '\0') return true;
+    if (*c != ';') return false;
+    ++c;
+  }
+}
+
+bool get_sarray_statistics(const index_file_information& info,
+                           sarray_segment_statistics& ret) {
+  auto iter = info.metadata.find(SARRAY_STATISTICS_METADATA_KEY);
+  if (iter == info.metadata.end()) return false;
+  std::vector<sarray_segment_statistics> stats;
+  if (!decode_segment_statistics(iter->second, stats)) return false;
+
+  size_t num_rows = 0;
+  for (size_t len: info.segment_sizes) num_rows += len;
+
+  ret = sarray_segment_statistics();
+  for (const auto& s: stats) ret.combine(s);
+  return ret.num_elements == num_rows;
+}
+
+std::string append_segment_statistics(const index_file_information& first,
+                                      const index_file_information& second) {
+  auto first_iter = first.metadata.find(SARRAY_STATISTICS_METADATA_KEY);
+  auto second_iter = second.metadata.find(SARRAY_STATISTICS_METADATA_KEY);
+  if (first_iter == first.metadata.end() ||
+      second_iter == second.metadata.end()) {
+    return "";
+  }
+  if (first_iter->second.empty()) return second_iter->second;
+  if (second_iter->second.empty()) return first_iter->second;
+  return first_iter->second + ";" + second_iter->second;
+}
+
+} // namespace graphlab
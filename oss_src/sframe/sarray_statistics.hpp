@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_SFRAME_SARRAY_STATISTICS_HPP
+#define GRAPHLAB_SFRAME_SARRAY_STATISTICS_HPP
+#include <string>
+#include <vector>
+#include <flexible_type/flexible_type.hpp>
+#include <sframe/sarray_index_file.hpp>
+
+namespace graphlab {
+
+/**
+ * The column metadata key under which per-segment statistics are persisted.
+ */
+extern const char* SARRAY_STATISTICS_METADATA_KEY;
+
+/**
+ * A small mergeable summary of the values in one segment of an SArray.
+ *
+ * The sarray_group_format_writer_v2 accumulates one of these for every
+ * (column, segment) pair as blocks are flushed and stores them in the column
+ * metadata (see \ref SARRAY_STATISTICS_METADATA_KEY). Since segment files are
+ * immutable, the statistics remain valid for as long as the segment is
+ * referenced: appending two SArrays simply concatenates their segment
+ * statistics, and whole-array aggregates (sum, mean, min, max, var,
+ * num_missing, nnz) can be answered by merging a handful of these instead of
+ * scanning the data.
+ *
+ * Integer and float values are tracked separately so that sums and extrema
+ * on integer columns remain exact.
+ */
+struct sarray_segment_statistics {
+  /// Total number of values, including missing values
+  size_t num_elements = 0;
+  /// Number of UNDEFINED values
+  size_t num_missing = 0;
+  /// Number of values for which flexible_type::is_zero() is false.
+  /// DATETIME values, which is_zero does not support, are not counted.
+  size_t num_nonzero = 0;
+  /// Number of float values which are NaN. (excluded from all moments below)
+  size_t num_nan = 0;
+
+  /// Number of integer values and their sum/extrema
+  size_t num_int = 0;
+  flex_int int_sum = 0;
+  flex_int int_min = 0;
+  flex_int int_max = 0;
+
+  /// Number of (non-NaN) float values and their sum/extrema
+  size_t num_float = 0;
+  double float_sum = 0;
+  double float_min = 0;
+  double float_max = 0;
+
+  /// Mean and sum of squared deviations over all integer and float values
+  double mean = 0;
+  double m2 = 0;
+
+  /// Accumulates a single value
+  void add(const flexible_type& val);
+
+  /// Accumulates a collection of values
+  void add(const std::vector<flexible_type>& vals);
+
+  /**
+   * Merges the statistics of another segment into this one.
+   * The variance update follows
+   * http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+   */
+  void combine(const sarray_segment_statistics& other);
+};
+
+/**
+ * Encodes a list of segment statistics into a string suitable for storage
+ * in the index file metadata.
+ */
+std::string encode_segment_statistics(
+    const std::vector<sarray_segment_statistics>& stats);
+
+/**
+ * Decodes a string produced by \ref encode_segment_statistics.
+ * Returns false if the string is malformed.
+ */
+bool decode_segment_statistics(const std::string& str,
+                               std::vector<sarray_segment_statistics>& stats);
+
+/**
+ * Reads the persisted segment statistics of a column and merges them into
+ * statistics for the whole column. Returns false if the column has no
+ * statistics, or if they do not account for exactly the rows of the column
+ * (for instance if a segment was written by a path which does not collect
+ * statistics), in which case the caller should fall back to a scan.
+ */
+bool get_sarray_statistics(const index_file_information& info,
+                           sarray_segment_statistics& ret);
+
+/**
+ * Returns the concatenation of the persisted segment statistics of two
+ * columns, for use when the columns are appended. Returns an empty string if
+ * either side has no statistics.
+ */
+std::string append_segment_statistics(const index_file_information& first,
+                                      const index_file_information& second);
+
+} // namespace graphlab
+#endif
@@ -117,7 +117,7 @@ const block_info& block_manager::get_block_info(block_address addr) {
 }
 
 std::shared_ptr<std::vector<char> > 
-block_manager::read_block(block_address addr, block_info** ret_info) {
+block_manager::read_raw_block(block_address addr, block_info** ret_info) {
 
   size_t segment_id, column_id, block_id;
   std::tie(segment_id, column_id, block_id) = addr;
@@ -146,22 +146,29 @@ block_manager::read_block(block_address addr, block_info** ret_info) {
   if (fin->fail()) {
     m_buffer_pool.release_buffer(std::move(ret));
     ret.reset();
-    return ret;
   }
-  guard.unlock();
+  return ret;
+}
 
 
-  if (info.flags & LZ4_COMPRESSION) {
+std::shared_ptr<std::vector<char> > 
+block_manager::read_block(block_address addr, block_info** ret_info) {
+  block_info* info = NULL;
+  std::shared_ptr<std::vector<char> > ret = read_raw_block(addr, &info);
+  if(ret_info) (*ret_info) = info;
+  if (!ret) return ret;
+
+  if (info->flags & LZ4_COMPRESSION) {
     /*
      * Decompress into another buffer.
      */
     std::shared_ptr<std::vector<char> > decompression_buffer = 
         m_buffer_pool.get_new_buffer();
-    decompression_buffer->resize(info.block_size);
+    decompression_buffer->resize(info->block_size);
     LZ4_decompress_safe(ret->data(),                   // src
                         decompression_buffer->data(),  // target
-                        info.length,                   // src length
-                        info.block_size);              // target length
+                        info->length,                  // src length
+                        info->block_size);             // target length
     std::swap(ret, decompression_buffer);
     m_buffer_pool.release_buffer(std::move(decompression_buffer));
   } 
@@ -195,6 +195,21 @@ class block_manager {
   std::shared_ptr<std::vector<char> >
     read_block(block_address addr, block_info** ret_info = NULL);
 
+  /** 
+   * Reads a block as stored on disk: unlike \ref read_block(), the block is
+   * not decompressed, and is info.length bytes long. Used to copy blocks
+   * between files as they are (see \ref block_writer::write_raw_block()).
+   *
+   * If info is not NULL, A pointer to the block information will be stored 
+   * info *info, as in \ref read_block().
+   *
+   * Return an empty pointer on failure.
+   *
+   * Safe for concurrent operation.
+   */
+  std::shared_ptr<std::vector<char> >
+    read_raw_block(block_address addr, block_info** ret_info = NULL);
+
 
   /** 
    * Reads a block given a block address ((array_group ID, segment ID, block
@@ -12,6 +12,7 @@ extern "C" {
 #include <sframe/sarray_index_file.hpp>
 #include <sframe/sframe_constants.hpp>
 #include <sframe/sarray_v2_type_encoding.hpp>
+#include <parallel/thread_pool.hpp>
 
 namespace graphlab {
 namespace v2_block_impl {
@@ -25,7 +26,8 @@ void block_writer::init(std::string group_index_file,
 
   // 1x for the compression buffer, 
   // 1x for the flexible_type serialization buffer
-  m_buffer_pool.init(2 * num_segments); 
+  // for each segment, or each pool thread writing blocks
+  m_buffer_pool.init(2 * std::max(num_segments, thread_pool::get_instance().size()));
 
   m_blocks.resize(num_segments);
   for (auto& m_blockseg: m_blocks) m_blockseg.resize(num_columns);
@@ -89,40 +91,54 @@ size_t block_writer::write_block(size_t segment_id,
   clen = LZ4_compress(data, cbuffer, block.block_size);
 
   char* buffer_to_write = NULL;
-  size_t buffer_to_write_len = 0;
   if (clen < COMPRESSION_DISABLE_THRESHOLD * block.block_size) {
     // compression has a benefit!
     block.flags |= LZ4_COMPRESSION;
     block.length = clen;
     buffer_to_write = cbuffer;
-    buffer_to_write_len = clen;
   } else {
     // compression has no benefit! do not compress!
     // unset LZ4
     block.flags &= (~(size_t)LZ4_COMPRESSION);
     block.length = block.block_size;
     buffer_to_write = data;
-    buffer_to_write_len = block.block_size;
   }
 
-  size_t padding = ((buffer_to_write_len + 4095) / 4096) * 4096 - buffer_to_write_len;
+  append_block(segment_id, column_id, buffer_to_write, block);
+  m_buffer_pool.release_buffer(std::move(compression_buffer));
+  return block.length;
+}
+
+size_t block_writer::write_raw_block(size_t segment_id,
+                                     size_t column_id, 
+                                     const char* data,
+                                     block_info block) {
+  DASSERT_LT(segment_id, m_index_info.nsegments);
+  DASSERT_LT(column_id, m_index_info.columns.size());
+  DASSERT_TRUE(m_output_files[segment_id] != nullptr);
+  append_block(segment_id, column_id, data, block);
+  return block.length;
+}
+
+void block_writer::append_block(size_t segment_id,
+                                size_t column_id,
+                                const char* data,
+                                block_info block) {
+  size_t padding = ((block.length + 4095) / 4096) * 4096 - block.length;
   ASSERT_LT(padding, 4096);
   // write!
   m_output_file_locks[segment_id].lock();
   block.offset = m_output_bytes_written[segment_id];
-  m_output_bytes_written[segment_id] += buffer_to_write_len + padding;
+  m_output_bytes_written[segment_id] += block.length + padding;
   m_index_info.columns[column_id].segment_sizes[segment_id] += block.num_elem;
-  m_output_files[segment_id]->write(buffer_to_write, buffer_to_write_len);
+  m_output_files[segment_id]->write(data, block.length);
   m_output_files[segment_id]->write(padding_bytes, padding);
   m_blocks[segment_id][column_id].push_back(block);
   m_output_file_locks[segment_id].unlock();
 
-  m_buffer_pool.release_buffer(std::move(compression_buffer));
-
   if (!m_output_files[segment_id]->good()) {
     log_and_throw_io_failure("Fail to write. Disk may be full.");
   }
-  return buffer_to_write_len;
 }
 
 size_t block_writer::write_typed_block(size_t segment_id,
@@ -79,6 +79,19 @@ class block_writer {
                    char* data,
                    block_info block);
 
+  /**
+   * Writes a block exactly as it was read from another segment with
+   * \ref block_manager::read_raw_block(): block.length bytes of (possibly
+   * compressed) data described by block. The data is neither encoded nor
+   * compressed again. Only the offset of block is updated.
+   *
+   * Returns the actual number of bytes written.
+   */
+  size_t write_raw_block(size_t segment_id,
+                         size_t column_id,
+                         const char* data,
+                         block_info block);
+
   /**
    * Writes a block of data into a segment.
    *
@@ -154,6 +167,15 @@ class block_writer {
 
   /// Writes the file footer
   void emit_footer(size_t segment_id);
+
+  /**
+   * Appends block.length bytes of data to a segment, padded to 4K, and
+   * records the block.
+   */
+  void append_block(size_t segment_id,
+                    size_t column_id,
+                    const char* data,
+                    block_info block);
 };
 
 } // namespace v2_block_impl
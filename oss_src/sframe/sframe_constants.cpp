@@ -26,6 +26,8 @@ EXPORT const size_t SARRAY_WRITER_MIN_ELEMENTS_PER_BLOCK = 8;
 EXPORT const size_t SARRAY_WRITER_INITAL_ELEMENTS_PER_BLOCK = 16;
 EXPORT size_t SFRAME_WRITER_MAX_BUFFERED_CELLS = 32*1024*1024; // 64M elements
 EXPORT size_t SFRAME_WRITER_MAX_BUFFERED_CELLS_PER_BLOCK = 256*1024; // 1M elements.
+EXPORT size_t SFRAME_WRITER_COLLECT_STATISTICS = true;
+EXPORT size_t SFRAME_WRITER_ASYNC_FLUSH = true;
 EXPORT // will be modified at startup to be 4x nCPUS
 EXPORT size_t SFRAME_MAX_BLOCKS_IN_CACHE = 32;
 EXPORT size_t SFRAME_CSV_PARSER_READ_SIZE = 50 * 1024 * 1024; // 50MB
@@ -34,6 +36,7 @@ EXPORT size_t SFRAME_JOIN_BUFFER_NUM_CELLS = 50*1024*1024;
 EXPORT size_t SFRAME_IO_READ_LOCK = false;
 EXPORT size_t SFRAME_SORT_PIVOT_ESTIMATION_SAMPLE_SIZE = 2000000;
 EXPORT size_t SFRAME_SORT_MAX_SEGMENTS = 128;
+EXPORT size_t SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS = 100000;
 EXPORT const size_t SFRAME_IO_LOCK_FILE_SIZE_THRESHOLD = 4 * 1024 * 1024;
 EXPORT std::string LIBODBC_PREFIX("");
 EXPORT size_t ODBC_BUFFER_SIZE = size_t(3 * 1024 * 1024) * size_t(1024); // 3 GB (to allow for a blob or two)
@@ -98,6 +101,16 @@ REGISTER_GLOBAL_WITH_CHECKS(int64_t,
                             true, 
                             +[](int64_t val){ return val >= 1024; });
 
+REGISTER_GLOBAL_WITH_CHECKS(int64_t, 
+                            SFRAME_WRITER_COLLECT_STATISTICS,
+                            true, 
+                            +[](int64_t val){ return val == 0 || val == 1 ; });
+
+REGISTER_GLOBAL_WITH_CHECKS(int64_t, 
+                            SFRAME_WRITER_ASYNC_FLUSH,
+                            true, 
+                            +[](int64_t val){ return val == 0 || val == 1 ; });
+
 REGISTER_GLOBAL_WITH_CHECKS(int64_t, 
                             SFRAME_IO_READ_LOCK,
                             true, 
@@ -113,6 +126,11 @@ REGISTER_GLOBAL_WITH_CHECKS(int64_t,
                             true,
                             +[](int64_t val){ return val > 1; });
 
+REGISTER_GLOBAL_WITH_CHECKS(int64_t,
+                            SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS,
+                            true,
+                            +[](int64_t val){ return val >= 0; });
+
 REGISTER_GLOBAL_WITH_CHECKS(int64_t,
                             ODBC_BUFFER_SIZE,
                             true,
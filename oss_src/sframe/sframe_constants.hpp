@@ -110,6 +110,23 @@ extern size_t SFRAME_WRITER_MAX_BUFFERED_CELLS_PER_BLOCK;
  */
 extern size_t SFRAME_WRITER_MAX_BUFFERED_CELLS;
 
+/**
+ * If non-zero, the sarray_group_format_writer_v2 accumulates per-segment
+ * column statistics (see \ref sarray_segment_statistics) as blocks are
+ * flushed, and persists them in the column metadata of the index file.
+ */
+extern size_t SFRAME_WRITER_COLLECT_STATISTICS;
+
+/**
+ * If non-zero, the sarray_group_format_writer_v2 hands full blocks to the
+ * thread pool to be encoded, compressed and written, so that the columns
+ * and segments of a write are compressed in parallel. Blocks of a column
+ * are still written in order. The cells handed over and not written yet
+ * count against SFRAME_WRITER_MAX_BUFFERED_CELLS: past it, the writing
+ * thread helps writing blocks until enough are out.
+ */
+extern size_t SFRAME_WRITER_ASYNC_FLUSH;
+
 /**
  * The maximum number of data blocks that can be maintained in a reader's
  * decoded cache
@@ -161,6 +178,13 @@ extern size_t SFRAME_SORT_PIVOT_ESTIMATION_SAMPLE_SIZE;
  */
 extern size_t SFRAME_SORT_MAX_SEGMENTS;
 
+/**
+ * save_as_csv formats the segments in parallel (into temporary files which
+ * are then appended in order) when the frame has at least this many rows,
+ * or when its length is not known up front.
+ */
+extern size_t SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS;
+
 /**
  * A variable the user can set to look for libodbc.so
  */
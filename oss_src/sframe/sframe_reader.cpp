@@ -97,8 +97,9 @@ size_t sframe_reader::read_rows(size_t row_start,
 size_t sframe_reader::read_rows(size_t row_start, 
                                 size_t row_end, 
                                 sframe_rows& out_obj) {
-  // sframe_rows is made up of a collection of columns
-  out_obj.resize(column_data.size());
+  // sframe_rows is made up of a collection of columns. The previous batch
+  // may still be held downstream: take fresh columns rather than copying it.
+  out_obj.reset(column_data.size());
   for (size_t i = 0;i < column_data.size(); ++i) {
     column_data[i]->read_rows(row_start, row_end, *(out_obj.get_columns()[i]));
   }
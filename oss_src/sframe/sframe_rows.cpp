@@ -6,22 +6,89 @@
  * of the BSD license. See the LICENSE file for details.
  */
 #include <logger/assertions.hpp>
+#include <parallel/thread_local_object.hpp>
 #include <sframe/sframe_rows.hpp>
 #include <sframe/sarray_v2_block_types.hpp>
 #include <sframe/sarray_v2_type_encoding.hpp>
 
 namespace graphlab {
 
+namespace {
+
+/*
+ * Released columns are kept for reuse in a per-thread pool. Only columns up
+ * to MAX_RECYCLED_COLUMN_CAPACITY values are kept, and at most
+ * MAX_RECYCLED_COLUMNS of them. With 16 byte flexible_types this bounds the
+ * retained memory to 16 MB per thread.
+ */
+const size_t MAX_RECYCLED_COLUMNS = 64;
+const size_t MAX_RECYCLED_COLUMN_CAPACITY = 16384;
+
+typedef sframe_rows::decoded_column_type decoded_column_type;
+
+struct column_pool {
+  std::vector<decoded_column_type*> columns;
+  ~column_pool() {
+    for (auto col: columns) delete col;
+  }
+};
+
+typedef thread_local_object<column_pool> thread_column_pool;
+
+void release_column(decoded_column_type* col) {
+  // release the values now: their payloads go back to the flexible_type
+  // free lists of this thread
+  col->clear();
+  column_pool* pool = thread_column_pool::get_if_exists();
+  if (pool != NULL &&
+      col->capacity() <= MAX_RECYCLED_COLUMN_CAPACITY &&
+      pool->columns.size() < MAX_RECYCLED_COLUMNS) {
+    pool->columns.push_back(col);
+  } else {
+    delete col;
+  }
+}
+
+/*
+ * Returns a column with the same contents as col, from the pool.
+ */
+sframe_rows::ptr_to_decoded_column_type
+copy_column(const decoded_column_type& col) {
+  auto ret = sframe_rows::make_column();
+  ret->assign(col.begin(), col.end());
+  return ret;
+}
+
+} // anonymous namespace
+
+sframe_rows::ptr_to_decoded_column_type sframe_rows::make_column() {
+  auto& pool = thread_column_pool::get();
+  decoded_column_type* col = NULL;
+  if (pool.columns.empty()) {
+    col = new decoded_column_type;
+  } else {
+    col = pool.columns.back();
+    pool.columns.pop_back();
+  }
+  return ptr_to_decoded_column_type(col, release_column);
+}
+
+void sframe_rows::reset(size_t num_cols) {
+  if (m_decoded_columns.size() != num_cols) m_decoded_columns.resize(num_cols);
+  for (auto& col: m_decoded_columns) {
+    if (col != nullptr && col.unique()) col->clear();
+    else col = make_column();
+  }
+  m_is_unique = true;
+}
+
 void sframe_rows::resize(size_t num_cols, ssize_t num_rows) {
   ensure_unique();
   if (m_decoded_columns.size() != num_cols) m_decoded_columns.resize(num_cols);
   for (auto& col: m_decoded_columns) {
     if (col == nullptr) {
-      if (num_rows == -1) {
-        col = std::make_shared<decoded_column_type>();
-      } else {
-        col = std::make_shared<decoded_column_type>(num_rows, flex_undefined());
-      }
+      col = make_column();
+      if (num_rows != -1) col->resize(num_rows, flex_undefined());
     } else if (num_rows != -1 && col->size() != (size_t)num_rows) {
       col->resize(num_rows, flex_undefined());
     }
@@ -30,6 +97,7 @@ void sframe_rows::resize(size_t num_cols, ssize_t num_rows) {
 
 void sframe_rows::clear() {
   m_decoded_columns.clear();
+  m_is_unique = true;
 }
 
 void sframe_rows::save(oarchive& oarc) const {
@@ -75,7 +143,7 @@ void sframe_rows::ensure_unique() {
   if (m_is_unique) return;
   for (auto& col: m_decoded_columns) {
     if (!col.unique()) {
-      col = std::make_shared<decoded_column_type>(*col);
+      col = copy_column(*col);
     }
   }
   m_is_unique = true;
@@ -100,7 +168,7 @@ void sframe_rows::type_check_inplace(const std::vector<flex_type_enum>& typelist
           if (val.get_type() != typelist[c] && 
               val.get_type() != flex_type_enum::UNDEFINED) {
             // damn. modifications are required
-            arr = std::make_shared<decoded_column_type>(*arr);
+            arr = copy_column(*arr);
             current_array_is_unique = true;
             break;
           }
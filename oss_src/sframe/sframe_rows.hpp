@@ -9,6 +9,7 @@
 #define GRAPHLAB_SFRAME_sframe_rows_HPP
 #include <vector>
 #include <map>
+#include <memory>
 #include <flexible_type/flexible_type.hpp>
 namespace graphlab {
 class oarchive;
@@ -114,6 +115,27 @@ class sframe_rows {
    */
   void add_decoded_column(const ptr_to_decoded_column_type& decoded_column);
 
+  /**
+   * Prepares the sframe_rows to be entirely overwritten with num_cols
+   * columns (for instance by a reader). Unlike resize(), columns shared with
+   * another sframe_rows are not copied, but replaced with empty columns
+   * from \ref make_column. Columns owned by this sframe_rows only are
+   * emptied, keeping their storage.
+   */
+  void reset(size_t num_cols);
+
+  /**
+   * Returns a new empty column. The column reuses the storage of a column
+   * released earlier on the calling thread, if any. When the last reference
+   * to the column goes away, its values are destroyed and its storage is
+   * kept for the next batch of the releasing thread.
+   *
+   * Batches in the query pipeline are produced and dropped at a high rate,
+   * so this saves the allocation (and the page faults) of a fresh column
+   * array per column per batch.
+   */
+  static ptr_to_decoded_column_type make_column();
+
 
   /**
    * Returns a modifiable reference to the set of column groups
@@ -15,6 +15,7 @@
 #include <fileio/fs_utils.hpp>
 #include <logger/assertions.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -156,17 +157,20 @@ void sframe_save_blockwise(const sframe& sf_source,
       auto cur = *(cols.begin());
       std::pop_heap(cols.begin(), cols.end(), comparator);
       cols.pop_back();
-      // read a block
+      // read a block as stored. Blocks are self contained, so the compressed
+      // bytes can be copied as they are, without decoding and encoding them
+      // again.
       v2_block_impl::block_info* infoptr = nullptr;
       v2_block_impl::block_info info;
       v2_block_impl::block_address block_address
                           {std::get<0>(cur.segment_address),
                            std::get<1>(cur.segment_address),
                            cur.current_block_number};
-      auto data = block_manager.read_block(block_address , &infoptr);
+      auto data = block_manager.read_raw_block(block_address , &infoptr);
+      if (!data) log_and_throw_io_failure("Unable to read block to save");
       info = *infoptr;
       // write to segment 0. We have only 1 segment 
-      writer.write_block(0, cur.column_number, data->data(), info);
+      writer.write_raw_block(0, cur.column_number, data->data(), info);
       // increment the block number
       advance_column_blocks_to_next_block(block_manager, cur);
       // increment the row number
@@ -203,6 +207,115 @@ void sframe_save_blockwise(const sframe& sf_source,
   }
 }
 
+bool sframe_save_by_linking(const sframe& sf_source,
+                            std::string index_file) {
+  // The SFrame must be made of, in order, all the columns of a single array
+  // group, and both must be on the local file system.
+  size_t num_columns = sf_source.num_columns();
+  if (num_columns == 0 || !fileio::get_protocol(index_file).empty()) return false;
+  std::vector<index_file_information> column_indices;
+  std::string group_file;
+  std::vector<std::string> segment_files;
+  for (size_t i = 0;i < num_columns; ++i) {
+    auto column_index = sf_source.select_column(i)->get_index_info();
+    if (column_index.version < 2) return false;
+    auto group_and_column = parse_v2_segment_filename(column_index.index_file);
+    if (group_and_column.second != i) return false;
+    if (i == 0) {
+      group_file = group_and_column.first;
+      for (const auto& segment_file: column_index.segment_files) {
+        segment_files.push_back(parse_v2_segment_filename(segment_file).first);
+      }
+    } else if (group_and_column.first != group_file ||
+               column_index.segment_files.size() != segment_files.size()) {
+      return false;
+    }
+    for (size_t j = 0;j < segment_files.size(); ++j) {
+      auto segment_and_column = parse_v2_segment_filename(column_index.segment_files[j]);
+      if (segment_and_column.first != segment_files[j] ||
+          segment_and_column.second != i) {
+        return false;
+      }
+    }
+    column_indices.push_back(column_index);
+  }
+  if (group_file.empty() || !fileio::get_protocol(group_file).empty()) return false;
+  // the segment files are those of the group, which has no other columns
+  auto group_index = read_array_group_index_file(group_file);
+  if (group_index.columns.size() != num_columns ||
+      group_index.segment_files.size() != segment_files.size()) {
+    return false;
+  }
+  for (size_t j = 0;j < segment_files.size(); ++j) {
+    if (parse_v2_segment_filename(group_index.segment_files[j]).first != segment_files[j]) {
+      return false;
+    }
+  }
+
+  // link the segment files, named as sframe_save_blockwise names its segment
+  std::string base_name; 
+  size_t last_dot = index_file.find_last_of(".");
+  if (last_dot != std::string::npos) {
+    base_name = index_file.substr(0, last_dot);
+  } else {
+    base_name = index_file;
+  } 
+  std::vector<std::string> new_segment_files;
+  boost::system::error_code ec;
+  for (size_t j = 0;j < segment_files.size(); ++j) {
+    std::stringstream strm;
+    strm << base_name << ".";
+    strm.fill('0'); strm.width(4);
+    strm << j;
+    std::string target = strm.str();
+    boost::filesystem::path source_path(segment_files[j]), target_path(target);
+    // an existing target is replaced, unless it is one of the source files
+    bool target_is_source = false;
+    if (boost::filesystem::exists(target_path, ec)) {
+      for (const auto& segment_file: segment_files) {
+        target_is_source = target_is_source ||
+            boost::filesystem::equivalent(segment_file, target_path, ec);
+      }
+      if (!target_is_source) boost::filesystem::remove(target_path, ec);
+    }
+    if (!target_is_source) boost::filesystem::create_hard_link(source_path, target_path, ec);
+    if (target_is_source || ec) {
+      // e.g. a different file system. Undo, and copy the blocks instead.
+      logstream(LOG_INFO) << "Cannot link " << segment_files[j] << " to "
+                          << target << ": copying blocks" << std::endl;
+      for (const auto& linked: new_segment_files) {
+        boost::filesystem::remove(linked, ec);
+      }
+      return false;
+    }
+    new_segment_files.push_back(target);
+  }
+
+  // write the new array group index, and the frame index referencing it
+  group_index_file_information output_index;
+  output_index.group_index_file = base_name + ".sidx";
+  output_index.version = 2;
+  output_index.nsegments = new_segment_files.size();
+  output_index.segment_files = new_segment_files;
+  for (size_t i = 0;i < num_columns; ++i) {
+    auto column_index = column_indices[i];
+    column_index.index_file = output_index.group_index_file + ":" + std::to_string(i);
+    for (size_t j = 0;j < new_segment_files.size(); ++j) {
+      column_index.segment_files[j] = new_segment_files[j] + ":" + std::to_string(i);
+    }
+    output_index.columns.push_back(column_index);
+  }
+  write_array_group_index_file(output_index.group_index_file, output_index);
+
+  auto frame_index = sf_source.get_index_info();
+  frame_index.column_files.clear();
+  for (const auto& col: output_index.columns) {
+    frame_index.column_files.push_back(col.index_file);
+  }
+  write_sframe_index_file(index_file, frame_index);
+  return true;
+}
+
 void sframe_save(const sframe& sf_source,
                  std::string index_file) {
   // if there are any columns on sarray v1 format, we use the naive form
@@ -214,7 +327,7 @@ void sframe_save(const sframe& sf_source,
 
   if (has_legacy_sframe) {
     sframe_save_naive(sf_source, index_file); 
-  } else {
+  } else if (!sframe_save_by_linking(sf_source, index_file)) {
     sframe_save_blockwise(sf_source, index_file);
   }
 }
@@ -18,11 +18,23 @@ void sframe_save_naive(const sframe& sf,
 
 /**
  * Saves an SFrame to another index file location using a more efficient method,
- * block by block.
+ * block by block. Blocks are copied as stored, without decoding them.
  */
 void sframe_save_blockwise(const sframe& sf, 
                            std::string index_file);
 
+/**
+ * Saves an SFrame which is exactly one array group on the local file system
+ * (as written by an sframe, or loaded from disk) by hard linking its segment
+ * files to the target location and writing new index files. Segment files
+ * are never modified once written, so this is safe.
+ *
+ * Returns false, having written nothing, if the SFrame is not laid out this
+ * way or the files cannot be linked (for instance across file systems).
+ */
+bool sframe_save_by_linking(const sframe& sf, 
+                            std::string index_file);
+
 /**
  * Automatically determines the optimal strategy to save an sframe
  */
@@ -0,0 +1,851 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <map>
+#include <cctype>
+#include <type_traits>
+#include <logger/logger.hpp>
+#include <sframe_query_engine/algorithm/expression.hpp>
+
+namespace graphlab {
+namespace query_eval {
+
+typedef std::function<flexible_type(const sframe_rows::row&)> row_fn;
+typedef flexible_type (*binary_kernel)(const flexible_type&, const flexible_type&);
+
+namespace {
+
+/**
+ * A compiled subexpression.
+ */
+struct expr_node {
+  row_fn fn;
+  /// static type, UNDEFINED if not known
+  flex_type_enum type = flex_type_enum::UNDEFINED;
+  /// true if value holds the value of the subexpression
+  bool is_constant = false;
+  flexible_type value;
+  /// the input column if the subexpression is a column read
+  size_t column = size_t(-1);
+};
+
+/**************************************************************************/
+/*                                                                        */
+/*                           Runtime helpers                              */
+/*                                                                        */
+/**************************************************************************/
+
+inline bool is_numeric(flex_type_enum t) {
+  return t == flex_type_enum::INTEGER || t == flex_type_enum::FLOAT;
+}
+
+inline double as_double(const flexible_type& v) {
+  return v.get_type() == flex_type_enum::INTEGER ? double(v.get<flex_int>())
+                                                 : v.get<flex_float>();
+}
+
+flexible_type unsupported(const char* op, const flexible_type& a) {
+  log_and_throw(std::string("Expression: unsupported operand type for ") + op +
+                ": " + flex_type_enum_to_name(a.get_type()));
+}
+
+flexible_type unsupported(const char* op, const flexible_type& a, const flexible_type& b) {
+  log_and_throw(std::string("Expression: unsupported operand types for ") + op +
+                ": " + flex_type_enum_to_name(a.get_type()) +
+                " and " + flex_type_enum_to_name(b.get_type()));
+}
+
+/*
+ * Integer arithmetic wraps around on overflow. It is done on the unsigned
+ * values since signed overflow is undefined behavior.
+ */
+inline flex_int wrapping_add(flex_int a, flex_int b) { return flex_int(uint64_t(a) + uint64_t(b)); }
+inline flex_int wrapping_sub(flex_int a, flex_int b) { return flex_int(uint64_t(a) - uint64_t(b)); }
+inline flex_int wrapping_mul(flex_int a, flex_int b) { return flex_int(uint64_t(a) * uint64_t(b)); }
+inline flex_int wrapping_neg(flex_int a) { return flex_int(uint64_t(0) - uint64_t(a)); }
+
+void division_by_zero() {
+  log_and_throw("Expression: division by zero");
+}
+
+/// python truth value
+bool truth(const flexible_type& v) {
+  switch(v.get_type()) {
+   case flex_type_enum::UNDEFINED: return false;
+   case flex_type_enum::INTEGER: return v.get<flex_int>() != 0;
+   case flex_type_enum::FLOAT: return v.get<flex_float>() != 0;
+   case flex_type_enum::STRING: return !v.get<flex_string>().empty();
+   case flex_type_enum::VECTOR: return !v.get<flex_vec>().empty();
+   case flex_type_enum::LIST: return !v.get<flex_list>().empty();
+   case flex_type_enum::DICT: return !v.get<flex_dict>().empty();
+   default: return true;
+  }
+}
+
+/// Resolves a possibly negative python index into a sequence of length len
+size_t sequence_index(const flexible_type& k, size_t len) {
+  if (k.get_type() != flex_type_enum::INTEGER) {
+    log_and_throw("Expression: sequence indices must be integers");
+  }
+  flex_int i = k.get<flex_int>();
+  if (i < 0) i += len;
+  if (i < 0 || size_t(i) >= len) log_and_throw("Expression: index out of range");
+  return i;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*                          Binary operators                              */
+/*                                                                        */
+/**************************************************************************/
+/*
+ * Each operator provides the integer and float kernels, and the fully
+ * dynamic version used when the operand types are not known statically.
+ */
+
+template <typename Op>
+flexible_type numeric_binary(const flexible_type& a, const flexible_type& b) {
+  if (a.get_type() == flex_type_enum::INTEGER && b.get_type() == flex_type_enum::INTEGER) {
+    return Op::apply(a.get<flex_int>(), b.get<flex_int>());
+  } else if (is_numeric(a.get_type()) && is_numeric(b.get_type())) {
+    return Op::apply(as_double(a), as_double(b));
+  }
+  return unsupported(Op::name(), a, b);
+}
+
+struct add_op {
+  static const char* name() { return "+"; }
+  static flexible_type apply(flex_int a, flex_int b) { return wrapping_add(a, b); }
+  static flexible_type apply(double a, double b) { return a + b; }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    if (a.get_type() == b.get_type()) {
+      switch(a.get_type()) {
+       case flex_type_enum::STRING:
+         return a.get<flex_string>() + b.get<flex_string>();
+       case flex_type_enum::LIST: {
+         flex_list ret = a.get<flex_list>();
+         const flex_list& other = b.get<flex_list>();
+         ret.insert(ret.end(), other.begin(), other.end());
+         return ret;
+       }
+       case flex_type_enum::VECTOR: {
+         flex_vec ret = a.get<flex_vec>();
+         const flex_vec& other = b.get<flex_vec>();
+         ret.insert(ret.end(), other.begin(), other.end());
+         return ret;
+       }
+       default:
+         break;
+      }
+    }
+    return numeric_binary<add_op>(a, b);
+  }
+};
+
+struct sub_op {
+  static const char* name() { return "-"; }
+  static flexible_type apply(flex_int a, flex_int b) { return wrapping_sub(a, b); }
+  static flexible_type apply(double a, double b) { return a - b; }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    return numeric_binary<sub_op>(a, b);
+  }
+};
+
+struct mul_op {
+  static const char* name() { return "*"; }
+  static flexible_type apply(flex_int a, flex_int b) { return wrapping_mul(a, b); }
+  static flexible_type apply(double a, double b) { return a * b; }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    return numeric_binary<mul_op>(a, b);
+  }
+};
+
+struct truediv_op {
+  static const char* name() { return "/"; }
+  static flexible_type apply(flex_int a, flex_int b) {
+    if (b == 0) division_by_zero();
+    return double(a) / double(b);
+  }
+  static flexible_type apply(double a, double b) {
+    if (b == 0) division_by_zero();
+    return a / b;
+  }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    return numeric_binary<truediv_op>(a, b);
+  }
+};
+
+struct floordiv_op {
+  static const char* name() { return "//"; }
+  static flexible_type apply(flex_int a, flex_int b) {
+    if (b == 0) division_by_zero();
+    // the quotient of the smallest integer by -1 overflows
+    if (b == -1) return wrapping_neg(a);
+    flex_int q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) --q;
+    return q;
+  }
+  static flexible_type apply(double a, double b) {
+    if (b == 0) division_by_zero();
+    return std::floor(a / b);
+  }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    return numeric_binary<floordiv_op>(a, b);
+  }
+};
+
+struct mod_op {
+  static const char* name() { return "%"; }
+  static flexible_type apply(flex_int a, flex_int b) {
+    if (b == 0) division_by_zero();
+    if (b == -1) return flex_int(0);
+    flex_int r = a % b;
+    if (r != 0 && ((r < 0) != (b < 0))) r += b;
+    return r;
+  }
+  static flexible_type apply(double a, double b) {
+    if (b == 0) division_by_zero();
+    double r = std::fmod(a, b);
+    if (r != 0 && ((r < 0) != (b < 0))) r += b;
+    return r;
+  }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    return numeric_binary<mod_op>(a, b);
+  }
+};
+
+struct eq_op {
+  static const char* name() { return "=="; }
+  static flexible_type apply(flex_int a, flex_int b) { return flex_int(a == b); }
+  static flexible_type apply(double a, double b) { return flex_int(a == b); }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    if (is_numeric(a.get_type()) && is_numeric(b.get_type())) return numeric_binary<eq_op>(a, b);
+    if (a.get_type() != b.get_type()) return flex_int(0);
+    if (a.get_type() == flex_type_enum::UNDEFINED) return flex_int(1);
+    return flex_int(a == b);
+  }
+};
+
+struct ne_op {
+  static const char* name() { return "!="; }
+  static flexible_type apply(flex_int a, flex_int b) { return flex_int(a != b); }
+  static flexible_type apply(double a, double b) { return flex_int(a != b); }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    return flex_int(!eq_op::generic(a, b).get<flex_int>());
+  }
+};
+
+/*
+ * The orderings: numbers compare by value, and strings lexicographically.
+ */
+template <typename Compare>
+struct order_op {
+  static const char* name() { return Compare::name(); }
+  static flexible_type apply(flex_int a, flex_int b) { return flex_int(Compare()(a, b)); }
+  static flexible_type apply(double a, double b) { return flex_int(Compare()(a, b)); }
+  static flexible_type generic(const flexible_type& a, const flexible_type& b) {
+    if (a.get_type() == flex_type_enum::STRING && b.get_type() == flex_type_enum::STRING) {
+      return flex_int(Compare()(a.get<flex_string>(), b.get<flex_string>()));
+    }
+    return numeric_binary<order_op>(a, b);
+  }
+};
+
+struct less_cmp {
+  static const char* name() { return "<"; }
+  template <typename T> bool operator()(const T& a, const T& b) const { return a < b; }
+};
+struct less_equal_cmp {
+  static const char* name() { return "<="; }
+  template <typename T> bool operator()(const T& a, const T& b) const { return a <= b; }
+};
+struct greater_cmp {
+  static const char* name() { return ">"; }
+  template <typename T> bool operator()(const T& a, const T& b) const { return a > b; }
+};
+struct greater_equal_cmp {
+  static const char* name() { return ">="; }
+  template <typename T> bool operator()(const T& a, const T& b) const { return a >= b; }
+};
+
+template <typename Op>
+flexible_type generic_kernel(const flexible_type& a, const flexible_type& b) {
+  return Op::generic(a, b);
+}
+
+/*
+ * A kernel specialized for operand types A and B. Falls back to the
+ * dynamic version if the values do not have the expected types (i.e. are
+ * missing).
+ */
+template <typename Op, typename A, typename B>
+flexible_type typed_kernel(const flexible_type& a, const flexible_type& b) {
+  static constexpr flex_type_enum a_type = std::is_same<A, flex_int>::value ?
+      flex_type_enum::INTEGER : flex_type_enum::FLOAT;
+  static constexpr flex_type_enum b_type = std::is_same<B, flex_int>::value ?
+      flex_type_enum::INTEGER : flex_type_enum::FLOAT;
+  if (a.get_type() != a_type || b.get_type() != b_type) return Op::generic(a, b);
+  if (a_type == flex_type_enum::INTEGER && b_type == flex_type_enum::INTEGER) {
+    return Op::apply(a.get<flex_int>(), b.get<flex_int>());
+  } else {
+    return Op::apply(double(a.get<A>()), double(b.get<B>()));
+  }
+}
+
+template <typename Op>
+binary_kernel select_kernel(flex_type_enum a, flex_type_enum b) {
+  if (a == flex_type_enum::INTEGER && b == flex_type_enum::INTEGER) {
+    return typed_kernel<Op, flex_int, flex_int>;
+  } else if (a == flex_type_enum::INTEGER && b == flex_type_enum::FLOAT) {
+    return typed_kernel<Op, flex_int, flex_float>;
+  } else if (a == flex_type_enum::FLOAT && b == flex_type_enum::INTEGER) {
+    return typed_kernel<Op, flex_float, flex_int>;
+  } else if (a == flex_type_enum::FLOAT && b == flex_type_enum::FLOAT) {
+    return typed_kernel<Op, flex_float, flex_float>;
+  }
+  return generic_kernel<Op>;
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*                         Other operators                                */
+/*                                                                        */
+/**************************************************************************/
+
+flexible_type getitem(const flexible_type& a, const flexible_type& k) {
+  switch(a.get_type()) {
+   case flex_type_enum::DICT:
+     for (const auto& kv: a.get<flex_dict>()) {
+       if (eq_op::generic(kv.first, k).get<flex_int>()) return kv.second;
+     }
+     log_and_throw("Expression: key not found in dictionary");
+   case flex_type_enum::LIST: {
+     const flex_list& l = a.get<flex_list>();
+     return l[sequence_index(k, l.size())];
+   }
+   case flex_type_enum::VECTOR: {
+     const flex_vec& v = a.get<flex_vec>();
+     return v[sequence_index(k, v.size())];
+   }
+   case flex_type_enum::STRING: {
+     const flex_string& s = a.get<flex_string>();
+     return flex_string(1, s[sequence_index(k, s.size())]);
+   }
+   default:
+     return unsupported("[]", a);
+  }
+}
+
+flexible_type dict_get(const flexible_type& a, const flexible_type& k, const flexible_type& def) {
+  if (a.get_type() != flex_type_enum::DICT) return unsupported("get", a);
+  for (const auto& kv: a.get<flex_dict>()) {
+    if (eq_op::generic(kv.first, k).get<flex_int>()) return kv.second;
+  }
+  return def;
+}
+
+flexible_type contains(const flexible_type& k, const flexible_type& a) {
+  switch(a.get_type()) {
+   case flex_type_enum::STRING:
+     if (k.get_type() != flex_type_enum::STRING) return unsupported("in", k, a);
+     return flex_int(a.get<flex_string>().find(k.get<flex_string>()) != std::string::npos);
+   case flex_type_enum::LIST:
+     for (const auto& v: a.get<flex_list>()) {
+       if (eq_op::generic(v, k).get<flex_int>()) return flex_int(1);
+     }
+     return flex_int(0);
+   case flex_type_enum::VECTOR:
+     if (!is_numeric(k.get_type())) return flex_int(0);
+     for (const auto& v: a.get<flex_vec>()) {
+       if (v == as_double(k)) return flex_int(1);
+     }
+     return flex_int(0);
+   case flex_type_enum::DICT:
+     for (const auto& kv: a.get<flex_dict>()) {
+       if (eq_op::generic(kv.first, k).get<flex_int>()) return flex_int(1);
+     }
+     return flex_int(0);
+   default:
+     return unsupported("in", k, a);
+  }
+}
+
+flexible_type length(const flexible_type& a) {
+  switch(a.get_type()) {
+   case flex_type_enum::STRING: return flex_int(a.get<flex_string>().size());
+   case flex_type_enum::VECTOR: return flex_int(a.get<flex_vec>().size());
+   case flex_type_enum::LIST: return flex_int(a.get<flex_list>().size());
+   case flex_type_enum::DICT: return flex_int(a.get<flex_dict>().size());
+   default: return unsupported("len", a);
+  }
+}
+
+const flex_string& string_arg(const char* op, const flexible_type& a) {
+  if (a.get_type() != flex_type_enum::STRING) unsupported(op, a);
+  return a.get<flex_string>();
+}
+
+flexible_type lower(const flexible_type& a) {
+  flex_string s = string_arg("lower", a);
+  std::transform(s.begin(), s.end(), s.begin(),
+                 [](char c) { return (char)std::tolower((unsigned char)c); });
+  return s;
+}
+
+flexible_type upper(const flexible_type& a) {
+  flex_string s = string_arg("upper", a);
+  std::transform(s.begin(), s.end(), s.begin(),
+                 [](char c) { return (char)std::toupper((unsigned char)c); });
+  return s;
+}
+
+flexible_type strip(const flexible_type& a) {
+  const flex_string& s = string_arg("strip", a);
+  size_t begin = 0, end = s.size();
+  while (begin < end && std::isspace((unsigned char)s[begin])) ++begin;
+  while (end > begin && std::isspace((unsigned char)s[end - 1])) --end;
+  return s.substr(begin, end - begin);
+}
+
+flexible_type startswith(const flexible_type& a, const flexible_type& p) {
+  const flex_string& s = string_arg("startswith", a);
+  const flex_string& prefix = string_arg("startswith", p);
+  return flex_int(s.compare(0, prefix.size(), prefix) == 0);
+}
+
+flexible_type endswith(const flexible_type& a, const flexible_type& p) {
+  const flex_string& s = string_arg("endswith", a);
+  const flex_string& suffix = string_arg("endswith", p);
+  return flex_int(s.size() >= suffix.size() &&
+                  s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+
+flexible_type split(const flexible_type& a, const flexible_type& sep) {
+  const flex_string& s = string_arg("split", a);
+  const flex_string& separator = string_arg("split", sep);
+  if (separator.empty()) log_and_throw("Expression: empty separator");
+  flex_list ret;
+  size_t begin = 0;
+  while (true) {
+    size_t end = s.find(separator, begin);
+    if (end == std::string::npos) {
+      ret.push_back(s.substr(begin));
+      break;
+    }
+    ret.push_back(s.substr(begin, end - begin));
+    begin = end + separator.size();
+  }
+  return ret;
+}
+
+flexible_type to_str(const flexible_type& a) {
+  if (a.get_type() == flex_type_enum::UNDEFINED) return flex_string("None");
+  return a.to<flex_string>();
+}
+
+/*
+ * True if only whitespace follows position pos of s. Like Python's int()
+ * and float(), the conversions reject trailing garbage ("12abc").
+ */
+bool only_space_after(const flex_string& s, size_t pos) {
+  while (pos < s.size() && std::isspace((unsigned char)s[pos])) ++pos;
+  return pos == s.size();
+}
+
+flexible_type to_int(const flexible_type& a) {
+  switch(a.get_type()) {
+   case flex_type_enum::INTEGER: return a;
+   case flex_type_enum::FLOAT: {
+     flex_float v = a.get<flex_float>();
+     // also rejects nan
+     if (!(v >= -std::ldexp(1.0, 63) && v < std::ldexp(1.0, 63))) {
+       log_and_throw("Expression: float out of range for int()");
+     }
+     return flex_int(v);
+   }
+   case flex_type_enum::STRING:
+     {
+       const flex_string& s = a.get<flex_string>();
+       size_t pos = 0;
+       flex_int ret = 0;
+       try {
+         ret = std::stoll(s, &pos);
+       } catch (...) {
+         pos = 0;
+       }
+       if (pos == 0 || !only_space_after(s, pos)) {
+         log_and_throw("Expression: invalid literal for int(): " + s);
+       }
+       return ret;
+     }
+   default: return unsupported("int", a);
+  }
+}
+
+flexible_type to_float(const flexible_type& a) {
+  switch(a.get_type()) {
+   case flex_type_enum::INTEGER: return flex_float(a.get<flex_int>());
+   case flex_type_enum::FLOAT: return a;
+   case flex_type_enum::STRING:
+     {
+       const flex_string& s = a.get<flex_string>();
+       size_t pos = 0;
+       flex_float ret = 0;
+       try {
+         ret = std::stod(s, &pos);
+       } catch (...) {
+         pos = 0;
+       }
+       if (pos == 0 || !only_space_after(s, pos)) {
+         log_and_throw("Expression: could not convert string to float: " + s);
+       }
+       return ret;
+     }
+   default: return unsupported("float", a);
+  }
+}
+
+flexible_type negate(const flexible_type& a) {
+  switch(a.get_type()) {
+   case flex_type_enum::INTEGER: return wrapping_neg(a.get<flex_int>());
+   case flex_type_enum::FLOAT: return -a.get<flex_float>();
+   default: return unsupported("-", a);
+  }
+}
+
+flexible_type absolute(const flexible_type& a) {
+  switch(a.get_type()) {
+   case flex_type_enum::INTEGER: {
+     flex_int v = a.get<flex_int>();
+     return v < 0 ? wrapping_neg(v) : v;
+   }
+   case flex_type_enum::FLOAT: return std::fabs(a.get<flex_float>());
+   default: return unsupported("abs", a);
+  }
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*                             The compiler                               */
+/*                                                                        */
+/**************************************************************************/
+
+class expression_compiler {
+ public:
+  expression_compiler(const std::vector<std::string>& column_names,
+                      const std::vector<flex_type_enum>& column_types)
+      : m_column_names(column_names), m_column_types(column_types) { }
+
+  expr_node compile(const flexible_type& expr) {
+    if (expr.get_type() != flex_type_enum::LIST || expr.get<flex_list>().empty() ||
+        expr.get<flex_list>()[0].get_type() != flex_type_enum::STRING) {
+      log_and_throw("Expression: expected a list starting with an operator name");
+    }
+    const flex_list& e = expr.get<flex_list>();
+    const std::string& op = e[0].get<flex_string>();
+    size_t nargs = e.size() - 1;
+
+    auto expect_args = [&](size_t n) {
+      if (nargs != n) {
+        log_and_throw("Expression: " + op + " expects " + std::to_string(n) + " arguments");
+      }
+    };
+
+    if (op == "const") {
+      expect_args(1);
+      return make_constant(e[1]);
+    } else if (op == "input") {
+      expect_args(0);
+      return compile_input();
+    } else if (op == "if") {
+      expect_args(3);
+      return compile_if(compile(e[1]), compile(e[2]), compile(e[3]));
+    } else if (op == "and" || op == "or") {
+      if (nargs == 0) log_and_throw("Expression: " + op + " expects arguments");
+      std::vector<expr_node> args;
+      for (size_t i = 1; i < e.size(); ++i) args.push_back(compile(e[i]));
+      return compile_and_or(op == "and", args);
+    } else if (op == "getitem") {
+      expect_args(2);
+      return compile_getitem(e[1], compile(e[2]));
+    } else if (op == "get") {
+      expect_args(3);
+      return make_ternary(compile(e[1]), compile(e[2]), compile(e[3]),
+                          dict_get, flex_type_enum::UNDEFINED);
+    }
+
+    // binary operators
+    static const std::map<std::string, std::pair<binary_kernel(*)(flex_type_enum, flex_type_enum), bool>>
+        arithmetic{{"+", {select_kernel<add_op>, false}},
+                   {"-", {select_kernel<sub_op>, false}},
+                   {"*", {select_kernel<mul_op>, false}},
+                   {"/", {select_kernel<truediv_op>, false}},
+                   {"//", {select_kernel<floordiv_op>, false}},
+                   {"%", {select_kernel<mod_op>, false}},
+                   {"==", {select_kernel<eq_op>, true}},
+                   {"!=", {select_kernel<ne_op>, true}},
+                   {"<", {select_kernel<order_op<less_cmp>>, true}},
+                   {"<=", {select_kernel<order_op<less_equal_cmp>>, true}},
+                   {">", {select_kernel<order_op<greater_cmp>>, true}},
+                   {">=", {select_kernel<order_op<greater_equal_cmp>>, true}}};
+    auto arith_iter = arithmetic.find(op);
+    if (arith_iter != arithmetic.end()) {
+      expect_args(2);
+      expr_node a = compile(e[1]);
+      expr_node b = compile(e[2]);
+      binary_kernel kernel = arith_iter->second.first(a.type, b.type);
+      flex_type_enum type = flex_type_enum::UNDEFINED;
+      if (arith_iter->second.second) {
+        type = flex_type_enum::INTEGER;
+      } else if (is_numeric(a.type) && is_numeric(b.type)) {
+        type = (op == "/" || a.type == flex_type_enum::FLOAT || b.type == flex_type_enum::FLOAT) ?
+            flex_type_enum::FLOAT : flex_type_enum::INTEGER;
+      } else if (op == "+" && a.type == b.type &&
+                 (a.type == flex_type_enum::STRING || a.type == flex_type_enum::LIST ||
+                  a.type == flex_type_enum::VECTOR)) {
+        type = a.type;
+      }
+      return make_binary(a, b, kernel, type);
+    }
+
+    static const std::map<std::string, std::pair<binary_kernel, flex_type_enum>> binary{
+      {"in", {contains, flex_type_enum::INTEGER}},
+      {"startswith", {startswith, flex_type_enum::INTEGER}},
+      {"endswith", {endswith, flex_type_enum::INTEGER}},
+      {"split", {split, flex_type_enum::LIST}}};
+    auto binary_iter = binary.find(op);
+    if (binary_iter != binary.end()) {
+      expect_args(2);
+      return make_binary(compile(e[1]), compile(e[2]),
+                         binary_iter->second.first, binary_iter->second.second);
+    }
+
+    typedef flexible_type (*unary_fn)(const flexible_type&);
+    static const std::map<std::string, std::pair<unary_fn, flex_type_enum>> unary{
+      {"not", {[](const flexible_type& a)->flexible_type { return flex_int(!truth(a)); },
+               flex_type_enum::INTEGER}},
+      {"is_none", {[](const flexible_type& a)->flexible_type {
+                     return flex_int(a.get_type() == flex_type_enum::UNDEFINED); },
+                   flex_type_enum::INTEGER}},
+      {"neg", {negate, flex_type_enum::UNDEFINED}},
+      {"abs", {absolute, flex_type_enum::UNDEFINED}},
+      {"len", {length, flex_type_enum::INTEGER}},
+      {"lower", {lower, flex_type_enum::STRING}},
+      {"upper", {upper, flex_type_enum::STRING}},
+      {"strip", {strip, flex_type_enum::STRING}},
+      {"str", {to_str, flex_type_enum::STRING}},
+      {"int", {to_int, flex_type_enum::INTEGER}},
+      {"float", {to_float, flex_type_enum::FLOAT}}};
+    auto unary_iter = unary.find(op);
+    if (unary_iter != unary.end()) {
+      expect_args(1);
+      expr_node a = compile(e[1]);
+      flex_type_enum type = unary_iter->second.second;
+      if ((op == "neg" || op == "abs") && is_numeric(a.type)) type = a.type;
+      return make_unary(a, unary_iter->second.first, type);
+    }
+
+    log_and_throw("Expression: unknown operator " + op);
+  }
+
+ private:
+  bool is_sframe_input() const { return !m_column_names.empty(); }
+
+  expr_node make_constant(const flexible_type& value) {
+    expr_node ret;
+    ret.is_constant = true;
+    ret.value = value;
+    ret.type = value.get_type();
+    ret.fn = [value](const sframe_rows::row&) { return value; };
+    return ret;
+  }
+
+  expr_node make_column(size_t column) {
+    expr_node ret;
+    ret.column = column;
+    ret.type = m_column_types[column];
+    ret.fn = [column](const sframe_rows::row& row) { return row[column]; };
+    return ret;
+  }
+
+  expr_node compile_input() {
+    if (!is_sframe_input()) return make_column(0);
+    // the whole row as a dictionary
+    flex_list names(m_column_names.begin(), m_column_names.end());
+    expr_node ret;
+    ret.type = flex_type_enum::DICT;
+    ret.fn = [names](const sframe_rows::row& row) {
+      flex_dict d(names.size());
+      for (size_t i = 0; i < names.size(); ++i) d[i] = {names[i], row[i]};
+      return flexible_type(std::move(d));
+    };
+    return ret;
+  }
+
+  expr_node compile_getitem(const flexible_type& container, expr_node key) {
+    // x['a'] on an sframe row is a column read
+    if (is_sframe_input() && key.is_constant &&
+        key.value.get_type() == flex_type_enum::STRING &&
+        container.get_type() == flex_type_enum::LIST &&
+        container.get<flex_list>().size() == 1 &&
+        container.get<flex_list>()[0] == flexible_type("input")) {
+      auto iter = std::find(m_column_names.begin(), m_column_names.end(),
+                            key.value.get<flex_string>());
+      if (iter == m_column_names.end()) {
+        log_and_throw("Expression: no column named " + key.value.get<flex_string>());
+      }
+      return make_column(iter - m_column_names.begin());
+    }
+    expr_node a = compile(container);
+    flex_type_enum type = flex_type_enum::UNDEFINED;
+    if (a.type == flex_type_enum::VECTOR) type = flex_type_enum::FLOAT;
+    else if (a.type == flex_type_enum::STRING) type = flex_type_enum::STRING;
+    return make_binary(a, key, getitem, type);
+  }
+
+  expr_node compile_if(expr_node c, expr_node a, expr_node b) {
+    if (c.is_constant) return truth(c.value) ? a : b;
+    expr_node ret;
+    ret.type = (a.type == b.type) ? a.type : flex_type_enum::UNDEFINED;
+    row_fn cfn = c.fn, afn = a.fn, bfn = b.fn;
+    ret.fn = [cfn, afn, bfn](const sframe_rows::row& row) {
+      return truth(cfn(row)) ? afn(row) : bfn(row);
+    };
+    return ret;
+  }
+
+  expr_node compile_and_or(bool is_and, const std::vector<expr_node>& args) {
+    // python semantics: returns the first falsy (and) / truthy (or) operand,
+    // or the last one
+    std::vector<row_fn> fns;
+    for (const auto& arg: args) fns.push_back(arg.fn);
+    expr_node ret;
+    ret.type = args[0].type;
+    for (const auto& arg: args) {
+      if (arg.type != ret.type) ret.type = flex_type_enum::UNDEFINED;
+    }
+    ret.fn = [is_and, fns](const sframe_rows::row& row) {
+      flexible_type v;
+      for (size_t i = 0; i < fns.size(); ++i) {
+        v = fns[i](row);
+        if (truth(v) != is_and) break;
+      }
+      return v;
+    };
+    return ret;
+  }
+
+  /*
+   * Folds an operation on constant operands into a constant. The operation
+   * is only folded if it succeeds: an error (e.g. a division by zero in a
+   * branch which is never taken) is raised when a row is evaluated instead.
+   */
+  template <typename Eval>
+  bool try_fold(Eval eval, expr_node& ret) {
+    flexible_type value;
+    try {
+      value = eval();
+    } catch (...) {
+      return false;
+    }
+    ret = make_constant(value);
+    return true;
+  }
+
+  template <typename Fn>
+  expr_node make_unary(const expr_node& a, Fn f, flex_type_enum type) {
+    expr_node folded;
+    if (a.is_constant && try_fold([&]() { return f(a.value); }, folded)) return folded;
+    expr_node ret;
+    ret.type = type;
+    if (a.column != size_t(-1)) {
+      size_t column = a.column;
+      ret.fn = [column, f](const sframe_rows::row& row) { return f(row[column]); };
+    } else {
+      row_fn afn = a.fn;
+      ret.fn = [afn, f](const sframe_rows::row& row) { return f(afn(row)); };
+    }
+    return ret;
+  }
+
+  /*
+   * Columns and constants are passed to the kernel by reference, without
+   * going through a row function.
+   */
+  template <typename Fn>
+  expr_node make_binary(const expr_node& a, const expr_node& b, Fn f, flex_type_enum type) {
+    expr_node folded;
+    if (a.is_constant && b.is_constant &&
+        try_fold([&]() { return f(a.value, b.value); }, folded)) {
+      return folded;
+    }
+    expr_node ret;
+    ret.type = type;
+    size_t ac = a.column, bc = b.column;
+    if (ac != size_t(-1) && bc != size_t(-1)) {
+      ret.fn = [ac, bc, f](const sframe_rows::row& row) { return f(row[ac], row[bc]); };
+    } else if (ac != size_t(-1) && b.is_constant) {
+      flexible_type bv = b.value;
+      ret.fn = [ac, bv, f](const sframe_rows::row& row) { return f(row[ac], bv); };
+    } else if (a.is_constant && bc != size_t(-1)) {
+      flexible_type av = a.value;
+      ret.fn = [av, bc, f](const sframe_rows::row& row) { return f(av, row[bc]); };
+    } else if (b.is_constant) {
+      row_fn afn = a.fn;
+      flexible_type bv = b.value;
+      ret.fn = [afn, bv, f](const sframe_rows::row& row) { return f(afn(row), bv); };
+    } else {
+      row_fn afn = a.fn, bfn = b.fn;
+      ret.fn = [afn, bfn, f](const sframe_rows::row& row) { return f(afn(row), bfn(row)); };
+    }
+    return ret;
+  }
+
+  template <typename Fn>
+  expr_node make_ternary(const expr_node& a, const expr_node& b, const expr_node& c,
+                         Fn f, flex_type_enum type) {
+    expr_node folded;
+    if (a.is_constant && b.is_constant && c.is_constant &&
+        try_fold([&]() { return f(a.value, b.value, c.value); }, folded)) {
+      return folded;
+    }
+    expr_node ret;
+    ret.type = type;
+    row_fn afn = a.fn, bfn = b.fn, cfn = c.fn;
+    ret.fn = [afn, bfn, cfn, f](const sframe_rows::row& row) {
+      return f(afn(row), bfn(row), cfn(row));
+    };
+    return ret;
+  }
+
+  const std::vector<std::string>& m_column_names;
+  const std::vector<flex_type_enum>& m_column_types;
+};
+
+} // anonymous namespace
+
+compiled_expression compile_expression(const flexible_type& expr,
+                                       const std::vector<std::string>& column_names,
+                                       const std::vector<flex_type_enum>& column_types) {
+  if (column_names.empty()) {
+    ASSERT_EQ(column_types.size(), 1);
+  } else {
+    ASSERT_EQ(column_names.size(), column_types.size());
+  }
+  expression_compiler compiler(column_names, column_types);
+  expr_node root = compiler.compile(expr);
+  compiled_expression ret;
+  ret.fn = root.fn;
+  ret.output_type = root.type;
+  return ret;
+}
+
+} // namespace query_eval
+} // namespace graphlab
@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_QUERY_EVAL_EXPRESSION_HPP
+#define GRAPHLAB_QUERY_EVAL_EXPRESSION_HPP
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <flexible_type/flexible_type.hpp>
+#include <sframe/sframe_rows.hpp>
+
+namespace graphlab {
+namespace query_eval {
+
+/**
+ * A row expression compiled by \ref compile_expression.
+ */
+struct compiled_expression {
+  /// Evaluates the expression on one row of the input
+  std::function<flexible_type(const sframe_rows::row&)> fn;
+
+  /// The output type if it is known at compile time, UNDEFINED otherwise
+  flex_type_enum output_type = flex_type_enum::UNDEFINED;
+};
+
+/**
+ * Compiles a small expression language, standing in for simple python
+ * lambdas, into a native row function which can be used with a
+ * TRANSFORM_NODE. Expressions are nested lists whose first element is the
+ * operator name:
+ *
+ * \verbatim
+ *   ["const", value]           a constant
+ *   ["input"]                  the lambda argument: the value for an sarray,
+ *                              a dictionary of column name to value for an
+ *                              sframe
+ *   ["if", c, a, b]            a if c else b
+ *   ["and", a, b, ...]         a and b and ...  (likewise "or")
+ *   ["not", a]
+ *   ["+", a, b]                also "-", "*", "/", "//", "%", with python
+ *                              semantics ("/" is true division)
+ *   ["==", a, b]               also "!=", "<", "<=", ">", ">="
+ *   ["neg", a], ["abs", a]
+ *   ["getitem", a, k]          a[k] on dictionaries, lists, vectors and
+ *                              strings
+ *   ["get", a, k, default]     a.get(k, default)
+ *   ["in", k, a]               k in a
+ *   ["is_none", a]             a is None
+ *   ["len", a], ["lower", a], ["upper", a], ["strip", a],
+ *   ["startswith", a, s], ["endswith", a, s], ["split", a, sep],
+ *   ["str", a], ["int", a], ["float", a]
+ * \endverbatim
+ *
+ * For example, lambda x: x['a'] * 2 if x['b'] else 0 is
+ * \code
+ * ["if", ["getitem", ["input"], ["const", "b"]],
+ *        ["*", ["getitem", ["input"], ["const", "a"]], ["const", 2]],
+ *        ["const", 0]]
+ * \endcode
+ *
+ * When the input is an sframe (column_names is not empty), x['a'] with a
+ * constant key compiles to a direct read of column "a", and arithmetic and
+ * comparisons on columns and constants of known numeric types are compiled
+ * to kernels specialized for those types. Constant subexpressions are
+ * evaluated once at compile time.
+ *
+ * \param expr The expression.
+ * \param column_names The column names of an sframe input, or empty for an
+ * sarray input.
+ * \param column_types The types of the input columns.
+ *
+ * Throws if the expression is malformed. Evaluating the expression throws
+ * on type errors, such as adding a string to an integer.
+ */
+compiled_expression compile_expression(const flexible_type& expr,
+                                       const std::vector<std::string>& column_names,
+                                       const std::vector<flex_type_enum>& column_types);
+
+} // namespace query_eval
+} // namespace graphlab
+
+#endif
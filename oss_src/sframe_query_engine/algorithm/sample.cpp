@@ -0,0 +1,251 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <globals/globals.hpp>
+#include <logger/logger.hpp>
+#include <random/random.hpp>
+#include <util/cityhash_gl.hpp>
+#include <sframe/sframe.hpp>
+#include <sframe/sarray_v2_block_manager.hpp>
+#include <sframe_query_engine/algorithm/sample.hpp>
+#include <sframe_query_engine/operators/all_operators.hpp>
+#include <sframe_query_engine/planning/planner.hpp>
+#include <sframe_query_engine/planning/optimization_engine.hpp>
+
+namespace graphlab {
+namespace query_eval {
+
+double SFRAME_BLOCK_SAMPLING_THRESHOLD = 0;
+
+REGISTER_GLOBAL_WITH_CHECKS(double,
+                            SFRAME_BLOCK_SAMPLING_THRESHOLD,
+                            true,
+                            +[](double val){ return val >= 0 && val <= 1; });
+
+/**
+ * Block sampling is only picked automatically if at least this many blocks
+ * are expected to be selected, so that small arrays still get a reasonably
+ * spread out sample.
+ */
+static constexpr double MIN_EXPECTED_SAMPLED_BLOCKS = 16;
+
+typedef std::vector<std::pair<size_t, size_t> > row_ranges;
+
+static size_t get_length(std::shared_ptr<planner_node> node) {
+  int64_t length = infer_planner_node_length(node);
+  if (length == -1) {
+    length = planner().materialize(node).num_rows();
+  }
+  return length;
+}
+
+/*
+ * A mask which is 1 on the rows in a sorted list of disjoint [begin, end)
+ * ranges, and 0 elsewhere.
+ */
+static std::shared_ptr<planner_node> make_range_mask(
+    size_t length, std::shared_ptr<const row_ranges> ranges) {
+  if (ranges->empty()) {
+    return op_constant::make_planner_node(flex_int(0), flex_type_enum::INTEGER, length);
+  }
+  if (ranges->size() == 1 && ranges->front().first == 0 &&
+      ranges->front().second >= length) {
+    return op_constant::make_planner_node(flex_int(1), flex_type_enum::INTEGER, length);
+  }
+  transform_type fn = [ranges](const sframe_rows::row& row)->flexible_type {
+    size_t idx = row[0].get<flex_int>();
+    auto iter = std::upper_bound(ranges->begin(), ranges->end(),
+                                 std::make_pair(idx, size_t(-1)));
+    if (iter == ranges->begin()) return flex_int(0);
+    --iter;
+    return flex_int(idx < iter->second);
+  };
+  return op_transform::make_planner_node(op_range::make_planner_node(0, length),
+                                         fn, flex_type_enum::INTEGER);
+}
+
+static std::shared_ptr<planner_node> make_row_bernoulli_mask(
+    size_t length, double fraction, int random_seed) {
+  uint64_t seed_hash = flexible_type((flex_int)(random_seed)).hash();
+  uint64_t sample_limit = hash64_proportion_cutoff(fraction);
+  transform_type fn = [sample_limit, seed_hash](const sframe_rows::row& row)->flexible_type {
+    uint64_t d = hash64(row[0].get<flex_int>() ^ seed_hash);
+    return flex_int(d <= sample_limit);
+  };
+  return op_transform::make_planner_node(op_range::make_planner_node(0, length),
+                                         fn, flex_type_enum::INTEGER);
+}
+
+sampling_method sampling_method_from_string(const std::string& name) {
+  if (name == "row") return sampling_method::ROW_BERNOULLI;
+  if (name == "block") return sampling_method::BLOCK_BERNOULLI;
+  if (name == "block_systematic") return sampling_method::BLOCK_SYSTEMATIC;
+  if (name == "auto") return sampling_method::AUTO;
+  log_and_throw("Unknown sampling method: " + name);
+}
+
+std::vector<size_t> get_source_block_boundaries(std::shared_ptr<planner_node> node) {
+  auto optimized = optimization_engine::optimize_planner_graph(node, materialize_options());
+
+  std::vector<index_file_information> columns;
+  if (optimized->operator_type == planner_node_type::SARRAY_SOURCE_NODE) {
+    const auto& sa = optimized->any_operator_parameters.at("sarray")
+        .as<std::shared_ptr<sarray<flexible_type>>>();
+    columns.push_back(sa->get_index_info());
+  } else if (optimized->operator_type == planner_node_type::SFRAME_SOURCE_NODE) {
+    const auto& sf = optimized->any_operator_parameters.at("sframe").as<sframe>();
+    for (size_t i = 0; i < sf.num_columns(); ++i) {
+      columns.push_back(sf.select_column(i)->get_index_info());
+    }
+  }
+  if (columns.empty()) return {};
+
+  size_t begin_index = optimized->operator_parameters.at("begin_index");
+  size_t end_index = optimized->operator_parameters.at("end_index");
+
+  // find the block start rows of the column with the fewest blocks
+  auto& manager = v2_block_impl::block_manager::get_instance();
+  std::vector<size_t> best_block_starts;
+  bool have_best = false;
+  for (const auto& column: columns) {
+    if (column.version != 2) return {};
+    std::vector<size_t> block_starts;
+    size_t row = 0;
+    for (const auto& segment_file: column.segment_files) {
+      auto column_address = manager.open_column(segment_file);
+      size_t nblocks = manager.num_blocks_in_column(column_address);
+      for (size_t j = 0; j < nblocks; ++j) {
+        v2_block_impl::block_address block_address{std::get<0>(column_address),
+                                                   std::get<1>(column_address), j};
+        block_starts.push_back(row);
+        row += manager.get_block_info(block_address).num_elem;
+      }
+      manager.close_column(column_address);
+    }
+    if (!have_best || block_starts.size() < best_block_starts.size()) {
+      best_block_starts = std::move(block_starts);
+      have_best = true;
+    }
+  }
+
+  std::vector<size_t> ret{0};
+  for (size_t start: best_block_starts) {
+    if (start > begin_index && start < end_index) ret.push_back(start - begin_index);
+  }
+  if (end_index > begin_index) ret.push_back(end_index - begin_index);
+  return ret;
+}
+
+std::shared_ptr<planner_node> make_sample_mask(std::shared_ptr<planner_node> node,
+                                               double fraction,
+                                               int random_seed,
+                                               sampling_method method) {
+  size_t length = get_length(node);
+  if (method == sampling_method::AUTO &&
+      !(fraction < SFRAME_BLOCK_SAMPLING_THRESHOLD)) {
+    method = sampling_method::ROW_BERNOULLI;
+  }
+  if (method == sampling_method::ROW_BERNOULLI) {
+    return make_row_bernoulli_mask(length, fraction, random_seed);
+  }
+
+  std::vector<size_t> boundaries = get_source_block_boundaries(node);
+  size_t num_blocks = boundaries.empty() ? 0 : boundaries.size() - 1;
+
+  if (method == sampling_method::AUTO) {
+    if (num_blocks > 0 && num_blocks * fraction >= MIN_EXPECTED_SAMPLED_BLOCKS) {
+      method = sampling_method::BLOCK_BERNOULLI;
+    } else {
+      method = sampling_method::ROW_BERNOULLI;
+    }
+  }
+  if (method == sampling_method::ROW_BERNOULLI || num_blocks == 0) {
+    return make_row_bernoulli_mask(length, fraction, random_seed);
+  }
+  DASSERT_EQ(boundaries.back(), length);
+
+  uint64_t seed_hash = flexible_type((flex_int)(random_seed)).hash();
+  std::vector<bool> selected(num_blocks, false);
+  if (method == sampling_method::BLOCK_BERNOULLI) {
+    uint64_t sample_limit = hash64_proportion_cutoff(fraction);
+    for (size_t i = 0; i < num_blocks; ++i) {
+      selected[i] = hash64(i ^ seed_hash) <= sample_limit;
+    }
+  } else {
+    ASSERT_TRUE(method == sampling_method::BLOCK_SYSTEMATIC);
+    if (fraction > 0) {
+      size_t step = std::max<size_t>(1, std::llround(1.0 / fraction));
+      for (size_t i = seed_hash % step; i < num_blocks; i += step) {
+        selected[i] = true;
+      }
+    }
+  }
+
+  // merge the runs of selected blocks into row ranges
+  auto ranges = std::make_shared<row_ranges>();
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (!selected[i]) continue;
+    if (!ranges->empty() && ranges->back().second == boundaries[i]) {
+      ranges->back().second = boundaries[i + 1];
+    } else {
+      ranges->emplace_back(boundaries[i], boundaries[i + 1]);
+    }
+  }
+  logstream(LOG_INFO) << "Block sampling selected " << ranges->size()
+                      << " row ranges out of " << num_blocks << " blocks" << std::endl;
+  return make_range_mask(length, ranges);
+}
+
+std::shared_ptr<planner_node> make_exact_sample_mask(std::shared_ptr<planner_node> node,
+                                                     size_t num_rows,
+                                                     int random_seed) {
+  size_t length = get_length(node);
+  auto ranges = std::make_shared<row_ranges>();
+  if (num_rows >= length) {
+    if (length > 0) ranges->emplace_back(0, length);
+    return make_range_mask(length, ranges);
+  }
+  if (num_rows == 0) return make_range_mask(length, ranges);
+
+  random::generator gen;
+  gen.seed(size_t(random_seed));
+  // uniform in (0, 1)
+  auto uniform = [&gen]() {
+    double u = 0;
+    while (u == 0) u = gen.uniform<double>(0, 1);
+    return u;
+  };
+
+  // Algorithm L: the reservoir starts with the first num_rows indices, and
+  // the number of indices to skip until the next replacement is geometric.
+  std::vector<size_t> reservoir(num_rows);
+  for (size_t i = 0; i < num_rows; ++i) reservoir[i] = i;
+  double w = std::exp(std::log(uniform()) / num_rows);
+  size_t i = num_rows - 1;
+  while (true) {
+    double skip = std::floor(std::log(uniform()) / std::log1p(-w));
+    if (!(skip < double(length - i - 1))) break;
+    i += size_t(skip) + 1;
+    reservoir[gen.fast_uniform<size_t>(0, num_rows - 1)] = i;
+    w *= std::exp(std::log(uniform()) / num_rows);
+  }
+
+  std::sort(reservoir.begin(), reservoir.end());
+  for (size_t idx: reservoir) {
+    if (!ranges->empty() && ranges->back().second == idx) {
+      ranges->back().second = idx + 1;
+    } else {
+      ranges->emplace_back(idx, idx + 1);
+    }
+  }
+  return make_range_mask(length, ranges);
+}
+
+} // end of query_eval
+} // end of graphlab
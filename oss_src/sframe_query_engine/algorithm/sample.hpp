@@ -0,0 +1,98 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_QUERY_EVAL_SAMPLE_HPP
+#define GRAPHLAB_QUERY_EVAL_SAMPLE_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace graphlab {
+namespace query_eval {
+
+struct planner_node;
+
+/**
+ * Sampling fractions below this use block level Bernoulli sampling when
+ * sampling_method::AUTO is requested. Defaults to 0: block sampling is off
+ * unless this is raised.
+ */
+extern double SFRAME_BLOCK_SAMPLING_THRESHOLD;
+
+/**
+ * The ways in which rows can be selected by \ref make_sample_mask.
+ */
+enum class sampling_method {
+  /// Every row is selected independently with probability fraction.
+  ROW_BERNOULLI,
+  /// Every storage block of the source is selected independently with
+  /// probability fraction. All rows of a selected block are kept.
+  BLOCK_BERNOULLI,
+  /// Every (1/fraction)-th storage block of the source is selected, starting
+  /// from a random offset.
+  BLOCK_SYSTEMATIC,
+  /// BLOCK_BERNOULLI if fraction is below \ref SFRAME_BLOCK_SAMPLING_THRESHOLD
+  /// and enough blocks would be selected, ROW_BERNOULLI otherwise.
+  AUTO
+};
+
+/**
+ * Parses the name of a sampling method, as passed through the unity
+ * sample() functions: "row", "block", "block_systematic" or "auto".
+ * Throws on any other name.
+ */
+sampling_method sampling_method_from_string(const std::string& name);
+
+/**
+ * Returns the row offsets (relative to the first row of the node) at which
+ * the storage blocks of a source node begin, followed by the length of the
+ * node. Returns an empty vector if the node does not optimize down to a
+ * SARRAY_SOURCE_NODE or SFRAME_SOURCE_NODE over v2 sarrays.
+ *
+ * For an sframe, the boundaries of the column with the fewest blocks are
+ * used. The blocks of the other columns are not aligned to them, so skipping
+ * a range of rows only avoids reading the blocks of the other columns which
+ * lie entirely inside it.
+ */
+std::vector<size_t> get_source_block_boundaries(std::shared_ptr<planner_node> node);
+
+/**
+ * Returns a planner node emitting one integer per row of node, which is 1
+ * if the row is in the sample and 0 otherwise. The sample is deterministic
+ * for a given random_seed.
+ *
+ * For the block sampling methods, the mask consists of long runs of zeros
+ * aligned with the storage blocks of the source, so that applying it with a
+ * logical filter skips the reads of the blocks which are not selected (see
+ * the SKIP_NEXT_BLOCK handling of the logical filter and source operators).
+ * The rows of a block are kept or dropped together, so block samples are
+ * not row samples. If the source block layout cannot be determined, the
+ * block methods fall back to ROW_BERNOULLI.
+ */
+std::shared_ptr<planner_node> make_sample_mask(std::shared_ptr<planner_node> node,
+                                               double fraction,
+                                               int random_seed,
+                                               sampling_method method = sampling_method::ROW_BERNOULLI);
+
+/**
+ * Returns a planner node emitting one integer per row of node, with exactly
+ * min(num_rows, length of node) rows set to 1, chosen uniformly at random
+ * without replacement. The row indices are drawn by reservoir sampling
+ * (Li's Algorithm L) over the row numbers, which touches only
+ * O(num_rows * log(length / num_rows)) indices rather than every row.
+ *
+ * The length of node must be known.
+ */
+std::shared_ptr<planner_node> make_exact_sample_mask(std::shared_ptr<planner_node> node,
+                                                     size_t num_rows,
+                                                     int random_seed);
+
+} // end of query_eval
+} // end of graphlab
+
+#endif // GRAPHLAB_QUERY_EVAL_SAMPLE_HPP
@@ -24,6 +24,8 @@
 #include <sframe_query_engine/operators/lambda_transform.hpp>
 #include <sframe_query_engine/operators/optonly_identity_operator.hpp>
 #include <sframe_query_engine/operators/ternary_operator.hpp>
+#include <sframe_query_engine/operators/limit.hpp>
+#include <sframe_query_engine/operators/topk.hpp>
 
 
 #endif /* GRAPHLAB_SFRAME_QUERY_ALL_OPERATORS_H_ */
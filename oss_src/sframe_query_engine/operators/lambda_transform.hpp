@@ -11,7 +11,10 @@
 #include <sframe_query_engine/operators/operator.hpp>
 #include <sframe_query_engine/execution/query_context.hpp>
 #include <sframe_query_engine/operators/operator_properties.hpp>
+#include <deque>
+#include <future>
 #include <lambda/pylambda_function.hpp>
+#include <lambda/lambda_constants.hpp>
 #include <exceptions/error_types.hpp>
 namespace graphlab { 
 namespace query_eval {
@@ -19,6 +22,14 @@ namespace query_eval {
 /**
  * A "transform" operator that applies a python lambda function to a 
  * single stream of input.
+ *
+ * Up to PYLAMBDA_MAX_INFLIGHT_BATCHES input blocks are submitted to the
+ * lambda workers asynchronously before the oldest result is waited for, so
+ * that reading the input and serializing the next batch overlap with the
+ * python evaluation of the previous ones. Results are emitted in input
+ * order. Since blocks are read ahead of what has been emitted, the operator
+ * handles skipping itself: the result of a block the consumer skips is
+ * discarded, and blocks not yet read are skipped in the input.
  */
 template<>
 class operator_impl<planner_node_type::LAMBDA_TRANSFORM_NODE> : public query_operator {
@@ -30,7 +41,8 @@ class operator_impl<planner_node_type::LAMBDA_TRANSFORM_NODE> : public query_ope
 
   static query_operator_attributes attributes() {
     query_operator_attributes ret;
-    ret.attribute_bitfield = query_operator_attributes::LINEAR;
+    ret.attribute_bitfield = query_operator_attributes::LINEAR |
+        query_operator_attributes::SUPPORTS_SKIPPING;
     ret.num_inputs = 1;
     return ret;
   }
@@ -47,28 +59,56 @@ class operator_impl<planner_node_type::LAMBDA_TRANSFORM_NODE> : public query_ope
   }
 
   inline void execute(query_context& context) {
+    const size_t max_inflight = std::max<size_t>(1, PYLAMBDA_MAX_INFLIGHT_BATCHES);
+    // pending evaluations and their number of input rows, oldest first
+    std::deque<std::pair<size_t, std::future<std::vector<flexible_type>>>> inflight;
+    bool input_done = false;
+    bool skip_next_block = (context.initial_state() == emit_state::SKIP_NEXT_BLOCK);
+
     while(1) {
-      auto rows = context.get_next(0);
-      if (rows == nullptr)
-        break;
+      if (skip_next_block && inflight.empty()) {
+        // the next block has not been read yet. Skip it in the input.
+        if (input_done) break;
+        context.skip_next(0);
+        skip_next_block = (context.emit(nullptr) == emit_state::SKIP_NEXT_BLOCK);
+        continue;
+      }
 
-      auto output = context.get_output_buffer();
-      output->resize(1, rows->num_rows());
-      std::vector<flexible_type> out;
-
-      // TODO exception handling
-      if (m_column_names.empty()) {
-        // evalute on sarray
-        m_lambda->eval(*rows, out);
-      } else {
-        // need column names to evalute on sframe
-        m_lambda->eval(m_column_names, *rows, out);
+      // fill the pipeline
+      while (!input_done && inflight.size() < max_inflight) {
+        auto rows = context.get_next(0);
+        if (rows == nullptr) {
+          input_done = true;
+          break;
+        }
+        if (m_column_names.empty()) {
+          // evalute on sarray
+          inflight.emplace_back(rows->num_rows(), m_lambda->eval_async(*rows));
+        } else {
+          // need column names to evalute on sframe
+          inflight.emplace_back(rows->num_rows(),
+                                m_lambda->eval_async(m_column_names, *rows));
+        }
       }
-    
+      if (inflight.empty()) break;
+
+      // get() rethrows any evaluation error. Skipped results are still
+      // waited for so that no evaluation outlives the operator.
+      size_t num_rows = inflight.front().first;
+      std::vector<flexible_type> out = inflight.front().second.get();
+      inflight.pop_front();
+
+      if (skip_next_block) {
+        skip_next_block = (context.emit(nullptr) == emit_state::SKIP_NEXT_BLOCK);
+        continue;
+      }
+
+      auto output = context.get_output_buffer();
+      output->resize(1, num_rows);
       for (size_t i = 0;i < out.size(); ++i) {
         (*output)[i][0] = convert_value_to_output_type(out[i], m_output_type);
       }
-      context.emit(output);
+      skip_next_block = (context.emit(output) == emit_state::SKIP_NEXT_BLOCK);
     }
   }
 
@@ -78,12 +118,14 @@ class operator_impl<planner_node_type::LAMBDA_TRANSFORM_NODE> : public query_ope
       flex_type_enum output_type,
       const std::vector<std::string> column_names = {},
       bool skip_undefined = false,
-      int random_seed = -1) {
+      int random_seed = -1,
+      bool memoize = false) {
 
     flex_list column_names_list(column_names.begin(), column_names.end());
     auto lambda_function = std::make_shared<lambda::pylambda_function>(lambda_str);
     lambda_function->set_skip_undefined(skip_undefined);
     lambda_function->set_random_seed(random_seed);
+    lambda_function->set_memoize(memoize);
     return planner_node::make_shared(planner_node_type::LAMBDA_TRANSFORM_NODE, 
                                      {{"output_type", (int)(output_type)},
                                       {"lambda_str", lambda_str},
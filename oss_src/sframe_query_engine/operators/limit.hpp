@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_SFRAME_QUERY_MANAGER_LIMIT_HPP
+#define GRAPHLAB_SFRAME_QUERY_MANAGER_LIMIT_HPP
+#include <algorithm>
+#include <sstream>
+#include <flexible_type/flexible_type.hpp>
+#include <sframe_query_engine/operators/operator.hpp>
+#include <sframe_query_engine/execution/query_context.hpp>
+#include <sframe_query_engine/operators/operator_properties.hpp>
+
+namespace graphlab {
+namespace query_eval {
+
+/**
+ * A "limit" operator which outputs only the first "limit" rows of its input.
+ *
+ * As soon as "limit" rows have been emitted, the operator returns without
+ * requesting any further blocks from its input, so everything upstream
+ * (filters, transforms, source reads) stops as well.
+ *
+ * The operator is neither linear nor sub-linear: the first n rows of a
+ * sliced input are not the first n rows of the whole input, so the planner
+ * must never segment through it. Instead, the optimizer pushes limits down
+ * through linear transforms and into source nodes where possible
+ * (see limit_transforms.hpp).
+ */
+template<>
+class operator_impl<planner_node_type::LIMIT_NODE> : public query_operator {
+ public:
+
+  planner_node_type type() const { return planner_node_type::LIMIT_NODE; }
+
+  static std::string name() { return "limit"; }
+
+  inline operator_impl(size_t limit) : m_limit(limit) { };
+
+  static query_operator_attributes attributes() {
+    query_operator_attributes ret;
+    ret.attribute_bitfield = query_operator_attributes::NONE;
+    ret.num_inputs = 1;
+    return ret;
+  }
+
+  inline std::shared_ptr<query_operator> clone() const {
+    return std::make_shared<operator_impl>(*this);
+  }
+
+  inline void execute(query_context& context) {
+    size_t num_emitted = 0;
+    while(num_emitted < m_limit) {
+      auto rows = context.get_next(0);
+      if (rows == nullptr) break;
+      size_t nrows = rows->num_rows();
+      if (nrows == 0) continue;
+
+      size_t rows_to_emit = std::min(nrows, m_limit - num_emitted);
+      auto output_buffer = context.get_output_buffer();
+      if (rows_to_emit == nrows) {
+        *output_buffer = *rows;
+      } else {
+        size_t ncols = rows->num_columns();
+        output_buffer->resize(ncols, rows_to_emit);
+        for (size_t i = 0; i < rows_to_emit; ++i) {
+          (*output_buffer)[i] = (*rows)[i];
+        }
+      }
+      num_emitted += rows_to_emit;
+      context.emit(output_buffer);
+    }
+  }
+
+  static std::shared_ptr<planner_node> make_planner_node(
+      std::shared_ptr<planner_node> source, size_t limit) {
+    return planner_node::make_shared(planner_node_type::LIMIT_NODE,
+                                     {{"limit", flex_int(limit)}},
+                                     std::map<std::string, any>(),
+                                     {source});
+  }
+
+  static std::shared_ptr<query_operator> from_planner_node(
+      std::shared_ptr<planner_node> pnode) {
+    ASSERT_EQ((int)pnode->operator_type, (int)planner_node_type::LIMIT_NODE);
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    ASSERT_TRUE(pnode->operator_parameters.count("limit"));
+    size_t limit = pnode->operator_parameters["limit"];
+    return std::make_shared<operator_impl>(limit);
+  }
+
+  static std::vector<flex_type_enum> infer_type(
+      std::shared_ptr<planner_node> pnode) {
+    ASSERT_EQ((int)pnode->operator_type, (int)planner_node_type::LIMIT_NODE);
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    return infer_planner_node_type(pnode->inputs[0]);
+  }
+
+  static int64_t infer_length(std::shared_ptr<planner_node> pnode) {
+    ASSERT_EQ((int)pnode->operator_type, (int)planner_node_type::LIMIT_NODE);
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    int64_t input_length = infer_planner_node_length(pnode->inputs[0]);
+    if (input_length == -1) return -1;
+    flex_int limit = pnode->operator_parameters["limit"];
+    return std::min<int64_t>(input_length, limit);
+  }
+
+  static std::string repr(std::shared_ptr<planner_node> pnode, pnode_tagger& get_tag) {
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    std::ostringstream out;
+    out << "Limit(" << get_tag(pnode->inputs[0]) << ", "
+        << pnode->operator_parameters["limit"] << ")";
+    return out.str();
+  }
+
+ private:
+  size_t m_limit;
+};
+
+typedef operator_impl<planner_node_type::LIMIT_NODE> op_limit;
+
+} // query_eval
+} // graphlab
+
+#endif // GRAPHLAB_SFRAME_QUERY_MANAGER_LIMIT_HPP
@@ -39,6 +39,8 @@ enum class planner_node_type : int {
     GENERALIZED_UNION_PROJECT_NODE,
     REDUCE_NODE,
     TERNARY_OPERATOR,
+    LIMIT_NODE,
+    TOPK_NODE,
 
       // These are used as logical-node-only types.  Do not actually become an operator.
       IDENTITY_NODE,
@@ -57,8 +57,10 @@ struct operator_impl<planner_node_type::PROJECT_NODE> : public query_operator {
 
       auto out = context.get_output_buffer();
       auto& rows_columns = rows->cget_columns();
+      // drop the previous columns first: get_columns() would copy them if
+      // they are still shared downstream
+      out->clear();
       auto& out_columns = out->get_columns();
-      out_columns.clear();
       for (size_t i = 0;i < m_indices.size(); ++i) {
         DASSERT_LT(i, m_indices.size()); 
         out_columns.push_back(rows_columns[m_indices[i]]);
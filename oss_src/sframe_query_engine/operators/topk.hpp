@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_SFRAME_QUERY_MANAGER_TOPK_HPP
+#define GRAPHLAB_SFRAME_QUERY_MANAGER_TOPK_HPP
+#include <algorithm>
+#include <sstream>
+#include <flexible_type/flexible_type.hpp>
+#include <sframe_query_engine/operators/operator.hpp>
+#include <sframe_query_engine/execution/query_context.hpp>
+#include <sframe_query_engine/operators/operator_properties.hpp>
+#include <util/fast_top_k.hpp>
+
+namespace graphlab {
+namespace query_eval {
+
+/**
+ * A "topk" operator which outputs the k rows of its input with the largest
+ * (or smallest if reverse is set) values in a given column, in sorted order.
+ * Rows for which the column value is missing (or NaN) are ignored.
+ *
+ * Like reduce, this is a sub-linear operator, so when the plan is parallel
+ * sliced, every segment produces its own top k. The caller is expected to
+ * merge the (at most num_segments * k) resulting rows, for instance with
+ * \ref extract_and_sort_top_k.
+ *
+ * Candidates are accumulated in a buffer which is trimmed back to k with
+ * \ref extract_and_sort_top_k whenever it grows past a multiple of k. Once
+ * the buffer has been trimmed once, the k-th best value is known and rows
+ * which cannot enter the top k are rejected with a single comparison and
+ * never copied.
+ */
+template<>
+class operator_impl<planner_node_type::TOPK_NODE> : public query_operator {
+ public:
+
+  planner_node_type type() const { return planner_node_type::TOPK_NODE; }
+
+  static std::string name() { return "topk"; }
+
+  inline operator_impl(size_t k, size_t column, bool reverse)
+      : m_k(k), m_column(column), m_reverse(reverse) { };
+
+  static query_operator_attributes attributes() {
+    query_operator_attributes ret;
+    ret.attribute_bitfield = query_operator_attributes::SUB_LINEAR;
+    ret.num_inputs = 1;
+    return ret;
+  }
+
+  inline std::shared_ptr<query_operator> clone() const {
+    return std::make_shared<operator_impl>(*this);
+  }
+
+  inline void execute(query_context& context) {
+    const size_t column = m_column;
+    const bool reverse = m_reverse;
+    auto less_than = [column, reverse](const std::vector<flexible_type>& a,
+                                       const std::vector<flexible_type>& b) {
+      return reverse ? (b[column] < a[column]) : (a[column] < b[column]);
+    };
+
+    std::vector<std::vector<flexible_type>> candidates;
+    // the size at which the candidate buffer is trimmed back to k
+    const size_t trim_size = std::max<size_t>(2 * m_k, context.block_size());
+    // true if candidates holds exactly the current top k, the last of which
+    // is the smallest.
+    bool have_threshold = false;
+
+    while(m_k > 0) {
+      auto rows = context.get_next(0);
+      if (rows == nullptr) break;
+      for (const auto& row: *rows) {
+        const flexible_type& val = row[column];
+        if (val.is_na()) continue;
+        if (have_threshold) {
+          const flexible_type& threshold = candidates[m_k - 1][column];
+          if (!(reverse ? (val < threshold) : (threshold < val))) continue;
+        }
+        candidates.push_back(row);
+        if (candidates.size() >= trim_size) {
+          extract_and_sort_top_k(candidates, m_k, less_than);
+          have_threshold = (candidates.size() == m_k);
+        }
+      }
+    }
+
+    extract_and_sort_top_k(candidates, m_k, less_than);
+    if (candidates.empty()) return;
+
+    size_t ncols = candidates[0].size();
+    size_t block_size = context.block_size();
+    for (size_t start = 0; start < candidates.size(); start += block_size) {
+      size_t end = std::min(start + block_size, candidates.size());
+      auto output_buffer = context.get_output_buffer();
+      output_buffer->resize(ncols, end - start);
+      for (size_t i = start; i < end; ++i) {
+        for (size_t j = 0; j < ncols; ++j) {
+          (*output_buffer)[i - start][j] = std::move(candidates[i][j]);
+        }
+      }
+      context.emit(output_buffer);
+    }
+  }
+
+  static std::shared_ptr<planner_node> make_planner_node(
+      std::shared_ptr<planner_node> source,
+      size_t k, size_t column = 0, bool reverse = false) {
+    return planner_node::make_shared(planner_node_type::TOPK_NODE,
+                                     {{"k", flex_int(k)},
+                                      {"column", flex_int(column)},
+                                      {"reverse", flex_int(reverse)}},
+                                     std::map<std::string, any>(),
+                                     {source});
+  }
+
+  static std::shared_ptr<query_operator> from_planner_node(
+      std::shared_ptr<planner_node> pnode) {
+    ASSERT_EQ((int)pnode->operator_type, (int)planner_node_type::TOPK_NODE);
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    ASSERT_TRUE(pnode->operator_parameters.count("k"));
+    ASSERT_TRUE(pnode->operator_parameters.count("column"));
+    ASSERT_TRUE(pnode->operator_parameters.count("reverse"));
+    size_t k = pnode->operator_parameters["k"];
+    size_t column = pnode->operator_parameters["column"];
+    bool reverse = !pnode->operator_parameters["reverse"].is_zero();
+    return std::make_shared<operator_impl>(k, column, reverse);
+  }
+
+  static std::vector<flex_type_enum> infer_type(
+      std::shared_ptr<planner_node> pnode) {
+    ASSERT_EQ((int)pnode->operator_type, (int)planner_node_type::TOPK_NODE);
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    return infer_planner_node_type(pnode->inputs[0]);
+  }
+
+  static int64_t infer_length(std::shared_ptr<planner_node> pnode) {
+    return -1;
+  }
+
+  static std::string repr(std::shared_ptr<planner_node> pnode, pnode_tagger& get_tag) {
+    ASSERT_EQ(pnode->inputs.size(), 1);
+    std::ostringstream out;
+    out << "TopK(" << get_tag(pnode->inputs[0])
+        << ", k=" << pnode->operator_parameters["k"]
+        << ", col=" << pnode->operator_parameters["column"];
+    if (!pnode->operator_parameters["reverse"].is_zero()) out << ", reverse";
+    out << ")";
+    return out.str();
+  }
+
+ private:
+  size_t m_k;
+  size_t m_column;
+  bool m_reverse;
+};
+
+typedef operator_impl<planner_node_type::TOPK_NODE> op_topk;
+
+} // query_eval
+} // graphlab
+
+#endif // GRAPHLAB_SFRAME_QUERY_MANAGER_TOPK_HPP
@@ -60,8 +60,8 @@ struct operator_impl<planner_node_type::UNION_NODE> : public query_operator {
       }
 
       auto out = context.get_output_buffer();
+      out->clear();
       auto& out_columns = out->get_columns();
-      out_columns.clear();
 
       for(size_t i = 0; i < num_inputs; ++i) {
         std::copy(input_v[i]->get_columns().begin(), input_v[i]->get_columns().end(),
@@ -0,0 +1,148 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_SFRAME_QUERY_OPTIMIZATION_LIMIT_TRANSFORMS_H_
+#define GRAPHLAB_SFRAME_QUERY_OPTIMIZATION_LIMIT_TRANSFORMS_H_
+
+#include <sframe_query_engine/planning/optimizations/optimization_transforms.hpp>
+#include <sframe_query_engine/planning/optimization_engine.hpp>
+#include <sframe_query_engine/operators/all_operators.hpp>
+#include <sframe_query_engine/operators/operator_transformations.hpp>
+#include <sframe_query_engine/planning/optimization_node_info.hpp>
+#include <sframe_query_engine/operators/operator_properties.hpp>
+#include <flexible_type/flexible_type.hpp>
+
+namespace graphlab {
+namespace query_eval {
+
+class opt_limit_transform : public opt_transform {
+  bool transform_applies(planner_node_type t) {
+    return (t == planner_node_type::LIMIT_NODE);
+  }
+};
+
+/**  Transform limit(limit(a, m), n) -> limit(a, min(m, n))
+ */
+class opt_merge_limits : public opt_limit_transform {
+
+  std::string description() { return "limit(limit(a, m), n) -> limit(a, min(m, n))"; }
+
+  bool apply_transform(optimization_engine *opt_manager, cnode_info_ptr n) {
+    DASSERT_TRUE(n->type == planner_node_type::LIMIT_NODE);
+
+    if(n->inputs[0]->type != planner_node_type::LIMIT_NODE)
+      return false;
+
+    size_t limit = std::min<size_t>(n->p("limit"), n->inputs[0]->p("limit"));
+
+    pnode_ptr new_pnode = op_limit::make_planner_node(n->inputs[0]->inputs[0]->pnode, limit);
+    opt_manager->replace_node(n, new_pnode);
+    return true;
+  }
+};
+
+/**  Transform limit(source, n) -> source[begin:begin+n]
+ */
+class opt_limit_on_source : public opt_limit_transform {
+
+  std::string description() { return "limit(source, n) -> source[:n]"; }
+
+  bool apply_transform(optimization_engine *opt_manager, cnode_info_ptr n) {
+    DASSERT_TRUE(n->type == planner_node_type::LIMIT_NODE);
+
+    if(!n->inputs[0]->is_source_node())
+      return false;
+
+    size_t limit = n->p("limit");
+    size_t length = n->inputs[0]->length();
+
+    std::map<pnode_ptr, pnode_ptr> memo;
+    pnode_ptr new_pnode = make_sliced_graph(n->inputs[0]->pnode, 0,
+                                            std::min(limit, length), memo);
+    opt_manager->replace_node(n, new_pnode);
+    return true;
+  }
+};
+
+/**  Transform limit(linear_transform(a, ...), n) -> linear_transform(limit(a, n), ...)
+ *
+ *   Linear transforms emit exactly one row per input row, so the first n
+ *   rows of the output depend only on the first n rows of each input.
+ *   Pushing the limit towards the sources lets it eventually be absorbed
+ *   into a source slice, removing the limit entirely.
+ */
+class opt_limit_linear_transform_exchange : public opt_limit_transform {
+
+  std::string description() {
+    return "limit(linear_transform(a, ...), n) -> linear_transform(limit(a, n), ...)";
+  }
+
+  bool apply_transform(optimization_engine *opt_manager, cnode_info_ptr n) {
+    DASSERT_TRUE(n->type == planner_node_type::LIMIT_NODE);
+
+    // Activated only if the input is a linear transform with just this
+    // output; otherwise other consumers still need the full input.
+    if(!n->inputs[0]->is_linear_transform()
+       || n->inputs[0]->outputs.size() > 1)
+      return false;
+
+    size_t limit = n->p("limit");
+
+    pnode_ptr ret = n->inputs[0]->pnode->clone();
+    ret->inputs.resize(n->inputs[0]->pnode->inputs.size());
+
+    for(size_t i = 0; i < n->inputs[0]->pnode->inputs.size(); ++i) {
+      ret->inputs[i] = op_limit::make_planner_node(n->inputs[0]->pnode->inputs[i], limit);
+    }
+
+    opt_manager->replace_node(n, ret);
+    return true;
+  }
+};
+
+/**  Transform limit(append(a, b), n) -> limit(a, n) if a has at least n rows,
+ *   and append(a, limit(b, n - length(a))) otherwise, when the length of a
+ *   is known.
+ */
+class opt_limit_append_exchange : public opt_limit_transform {
+
+  std::string description() {
+    return "limit(append(a, b), n) -> limit(a, n) or append(a, limit(b, n - |a|))";
+  }
+
+  bool apply_transform(optimization_engine *opt_manager, cnode_info_ptr n) {
+    DASSERT_TRUE(n->type == planner_node_type::LIMIT_NODE);
+
+    if(n->inputs[0]->type != planner_node_type::APPEND_NODE
+       || n->inputs[0]->outputs.size() > 1)
+      return false;
+
+    const cnode_info_ptr& append_node = n->inputs[0];
+    int64_t first_length = infer_planner_node_length(append_node->inputs[0]->pnode);
+    if(first_length == -1)
+      return false;
+
+    size_t limit = n->p("limit");
+
+    if(size_t(first_length) >= limit) {
+      pnode_ptr new_pnode = op_limit::make_planner_node(append_node->inputs[0]->pnode, limit);
+      opt_manager->replace_node(n, new_pnode);
+      return true;
+    }
+
+    pnode_ptr new_pnode = op_append::make_planner_node(
+        append_node->inputs[0]->pnode,
+        op_limit::make_planner_node(append_node->inputs[1]->pnode,
+                                    limit - first_length));
+    opt_manager->replace_node(n, new_pnode);
+    return true;
+  }
+};
+
+}}
+
+#endif
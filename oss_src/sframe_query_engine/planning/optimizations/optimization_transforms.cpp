@@ -12,6 +12,7 @@
 #include <sframe_query_engine/planning/optimizations/logical_filter_transforms.hpp>
 #include <sframe_query_engine/planning/optimizations/general_union_project_transforms.hpp>
 #include <sframe_query_engine/planning/optimizations/source_transforms.hpp>
+#include <sframe_query_engine/planning/optimizations/limit_transforms.hpp>
 
 namespace graphlab {
 namespace query_eval {
@@ -79,6 +80,15 @@ void populate_transforms(optimization_transform_registry *otr) {
   otr->register_optimization({1, 2, 3}, std::make_shared<opt_project_append_exchange>());
   otr->register_optimization({1, 2, 3}, std::make_shared<opt_eliminate_singleton_union>());
 
+  ////////////////////////////////////////////////////////////////////////////////
+  // Push limits towards the sources so that they can be absorbed into
+  // source slices.
+
+  otr->register_optimization({1, 2, 3}, std::make_shared<opt_merge_limits>());
+  otr->register_optimization({1, 2, 3}, std::make_shared<opt_limit_on_source>());
+  otr->register_optimization({1, 2, 3}, std::make_shared<opt_limit_linear_transform_exchange>());
+  otr->register_optimization({1, 2, 3}, std::make_shared<opt_limit_append_exchange>());
+
   ////////////////////////////////////////////////////////////////////////////////
   // Optimizations that are allowed to turn the graph into a state
   // which cannot be materialized.
@@ -7,6 +7,7 @@
  */
 #include <sgraph/sgraph.hpp>
 #include <sgraph/hilbert_parallel_for.hpp>
+#include <sgraph/sgraph_edge_order.hpp>
 #include <sframe/shuffle.hpp>
 #include <sframe/algorithm.hpp>
 #include <sframe/sarray_sorted_buffer.hpp>
@@ -583,6 +584,9 @@ bool sgraph::add_edges(sframe edges,
   fast_validate_add_edges(edges, groupa, groupb);
 
   commit_edge_buffer(groupa, groupb, edges);
+  if (SGRAPH_INGRESS_EDGE_ORDER != (size_t)edge_order::INSERTION) {
+    reorder_edges(*this, (edge_order)SGRAPH_INGRESS_EDGE_ORDER, groupa, groupb);
+  }
   logstream(LOG_EMPH) << "Num vertices for group " << groupa << ": " << num_vertices(groupa) << "\n"
                       << "Num vertices for group " << groupb << ": " << num_vertices(groupb) << "\n"
                       << "Num edges " << groupa << " -> " << groupb << ": " << num_edges(groupa, groupb)
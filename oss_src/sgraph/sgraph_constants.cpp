@@ -19,6 +19,9 @@ EXPORT size_t SGRAPH_TRIPLE_APPLY_EDGE_BATCH_SIZE = 1024;
 EXPORT size_t SGRAPH_DEFAULT_NUM_PARTITIONS = 8;
 EXPORT size_t SGRAPH_INGRESS_VID_BUFFER_SIZE = 1024 * 1024 * 1;
 EXPORT size_t SGRAPH_HILBERT_CURVE_PARALLEL_FOR_NUM_THREADS = thread::cpu_count();
+EXPORT size_t SGRAPH_EDGE_CACHE_CAPACITY = 1024 * 1024 * 1024;
+EXPORT size_t SGRAPH_INGRESS_EDGE_ORDER = 0;
+EXPORT double SGRAPH_SPARSE_GATHER_FRACTION = 0.05;
 
 REGISTER_GLOBAL_WITH_CHECKS(int64_t, 
                             SGRAPH_TRIPLE_APPLY_LOCK_ARRAY_SIZE, 
@@ -51,4 +54,19 @@ REGISTER_GLOBAL_WITH_CHECKS(int64_t,
                             SGRAPH_HILBERT_CURVE_PARALLEL_FOR_NUM_THREADS,
                             true,
                             +[](int64_t val){ return val >= 1; });
+
+REGISTER_GLOBAL_WITH_CHECKS(int64_t, 
+                            SGRAPH_EDGE_CACHE_CAPACITY,
+                            true,
+                            +[](int64_t val){ return val >= 0; });
+
+REGISTER_GLOBAL_WITH_CHECKS(int64_t, 
+                            SGRAPH_INGRESS_EDGE_ORDER,
+                            true,
+                            +[](int64_t val){ return val >= 0 && val <= 2; });
+
+REGISTER_GLOBAL_WITH_CHECKS(double,
+                            SGRAPH_SPARSE_GATHER_FRACTION,
+                            true,
+                            +[](double val){ return val >= 0 && val <= 1; });
 }
@@ -41,6 +41,26 @@ extern size_t SGRAPH_INGRESS_VID_BUFFER_SIZE;
  * Number of threads used for hilber curve parallel for
  */
 extern size_t SGRAPH_HILBERT_CURVE_PARALLEL_FOR_NUM_THREADS;
+
+/**
+ * The maximum number of bytes of edge structure kept in memory by the
+ * sgraph_edge_cache. 0 disables the cache.
+ */
+extern size_t SGRAPH_EDGE_CACHE_CAPACITY;
+
+/**
+ * The order in which sgraph::add_edges leaves the edges of the partitions
+ * it adds to, as an edge_order value: 0 insertion order (no sorting), 1
+ * sorted by (source, target), 2 hilbert order.
+ */
+extern size_t SGRAPH_INGRESS_EDGE_ORDER;
+
+/**
+ * A frontier gather visits the edges of the active vertices directly,
+ * instead of sweeping all edges of a partition, when less than this
+ * fraction of the vertices of the partition are active.
+ */
+extern double SGRAPH_SPARSE_GATHER_FRACTION;
 }
 
 #endif
@@ -0,0 +1,178 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <sgraph/sgraph_edge_cache.hpp>
+#include <sgraph/sgraph.hpp>
+#include <sgraph/sgraph_constants.hpp>
+#include <logger/logger.hpp>
+#include <timer/timer.hpp>
+
+namespace graphlab {
+namespace sgraph_compute {
+
+/**************************************************************************/
+/*                                                                        */
+/*                          edge_partition_csr                            */
+/*                                                                        */
+/**************************************************************************/
+
+namespace {
+
+/*
+ * Given the key of each edge, fills offsets (of size num_keys + 1) and edges
+ * with a counting sort of the edges by key.
+ */
+void build_index(const compact_id_array& keys, size_t num_keys,
+                 compact_id_array& offsets, compact_id_array& edges) {
+  size_t num_edges = keys.size();
+  offsets.resize(num_keys + 1, num_edges);
+  edges.resize(num_edges, num_edges);
+  std::vector<size_t> next(num_keys + 1, 0);
+  for (size_t e = 0; e < num_edges; ++e) ++next[keys[e] + 1];
+  for (size_t v = 0; v < num_keys; ++v) next[v + 1] += next[v];
+  for (size_t v = 0; v <= num_keys; ++v) offsets.set(v, next[v]);
+  for (size_t e = 0; e < num_edges; ++e) edges.set(next[keys[e]]++, e);
+}
+
+} // anonymous namespace
+
+void read_edge_ids(const sarray<flexible_type>& column, size_t num_vertices,
+                   compact_id_array& ids) {
+  auto reader = column.get_reader();
+  size_t num_rows = reader->size();
+  ids.resize(num_rows, num_vertices);
+  std::vector<flexible_type> buffer;
+  for (size_t row_start = 0; row_start < num_rows; row_start += buffer.size()) {
+    size_t row_end = std::min(num_rows, row_start + SGRAPH_TRIPLE_APPLY_EDGE_BATCH_SIZE);
+    reader->read_rows(row_start, row_end, buffer);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      size_t id = buffer[i];
+      ASSERT_LT(id, num_vertices);
+      ids.set(row_start + i, id);
+    }
+  }
+}
+
+void edge_partition_csr::build(const sarray<flexible_type>& src_column,
+                               const sarray<flexible_type>& dst_column,
+                               size_t num_src_vertices,
+                               size_t num_dst_vertices) {
+  read_edge_ids(src_column, num_src_vertices, m_src);
+  read_edge_ids(dst_column, num_dst_vertices, m_dst);
+  ASSERT_EQ(m_src.size(), m_dst.size());
+  build_index(m_src, num_src_vertices, m_out_offsets, m_out_edges);
+  build_index(m_dst, num_dst_vertices, m_in_offsets, m_in_edges);
+}
+
+size_t edge_partition_csr::memory_usage() const {
+  return m_src.memory_usage() + m_dst.memory_usage() +
+      m_out_offsets.memory_usage() + m_out_edges.memory_usage() +
+      m_in_offsets.memory_usage() + m_in_edges.memory_usage();
+}
+
+size_t edge_partition_csr::estimate_memory_usage(size_t num_edges,
+                                                 size_t num_src_vertices,
+                                                 size_t num_dst_vertices) {
+  return compact_id_array::memory_usage(num_edges, num_src_vertices) +
+      compact_id_array::memory_usage(num_edges, num_dst_vertices) +
+      compact_id_array::memory_usage(num_src_vertices + 1, num_edges) +
+      compact_id_array::memory_usage(num_dst_vertices + 1, num_edges) +
+      2 * compact_id_array::memory_usage(num_edges, num_edges);
+}
+
+/**************************************************************************/
+/*                                                                        */
+/*                          sgraph_edge_cache                             */
+/*                                                                        */
+/**************************************************************************/
+
+sgraph_edge_cache& sgraph_edge_cache::get_instance() {
+  static sgraph_edge_cache instance;
+  return instance;
+}
+
+std::shared_ptr<const edge_partition_csr>
+sgraph_edge_cache::get(const sframe& edgeframe,
+                       size_t num_src_vertices,
+                       size_t num_dst_vertices) {
+  auto src_column = edgeframe.select_column(sgraph::SRC_COLUMN_NAME);
+  auto dst_column = edgeframe.select_column(sgraph::DST_COLUMN_NAME);
+  std::string src_file = src_column->get_index_file();
+  std::string dst_file = dst_column->get_index_file();
+  if (src_file.empty() || dst_file.empty()) return nullptr;
+  std::string key = src_file + "\n" + dst_file;
+
+  size_t bytes = edge_partition_csr::estimate_memory_usage(
+      edgeframe.num_rows(), num_src_vertices, num_dst_vertices);
+  {
+    std::lock_guard<graphlab::mutex> guard(m_lock);
+    auto iter = m_entries.find(key);
+    if (iter != m_entries.end()) {
+      iter->second.last_used = ++m_clock;
+      return iter->second.csr;
+    }
+    if (bytes > SGRAPH_EDGE_CACHE_CAPACITY) return nullptr;
+  }
+
+  // Build outside of the lock so that partitions load in parallel.
+  timer ti;
+  auto csr = std::make_shared<edge_partition_csr>();
+  csr->build(*src_column, *dst_column, num_src_vertices, num_dst_vertices);
+  bytes = csr->memory_usage();
+  logstream(LOG_INFO) << "Cached " << csr->num_edges() << " edges ("
+                      << bytes << " bytes) in " << ti.current_time() << " secs"
+                      << std::endl;
+
+  std::lock_guard<graphlab::mutex> guard(m_lock);
+  auto iter = m_entries.find(key);
+  if (iter != m_entries.end()) {
+    // another thread got there first
+    iter->second.last_used = ++m_clock;
+    return iter->second.csr;
+  }
+  // Even if it cannot be kept, the structure is still good for this pass.
+  if (make_room(bytes)) {
+    entry& e = m_entries[key];
+    e.csr = csr;
+    e.bytes = bytes;
+    e.last_used = ++m_clock;
+    m_bytes += bytes;
+  }
+  return csr;
+}
+
+bool sgraph_edge_cache::make_room(size_t bytes) {
+  if (bytes > SGRAPH_EDGE_CACHE_CAPACITY) return false;
+  while (m_bytes + bytes > SGRAPH_EDGE_CACHE_CAPACITY && !m_entries.empty()) {
+    auto victim = m_entries.begin();
+    for (auto iter = m_entries.begin(); iter != m_entries.end(); ++iter) {
+      if (iter->second.last_used < victim->second.last_used) victim = iter;
+    }
+    m_bytes -= victim->second.bytes;
+    m_entries.erase(victim);
+  }
+  return true;
+}
+
+void sgraph_edge_cache::clear() {
+  std::lock_guard<graphlab::mutex> guard(m_lock);
+  m_entries.clear();
+  m_bytes = 0;
+}
+
+size_t sgraph_edge_cache::memory_usage() const {
+  std::lock_guard<graphlab::mutex> guard(m_lock);
+  return m_bytes;
+}
+
+size_t sgraph_edge_cache::num_entries() const {
+  std::lock_guard<graphlab::mutex> guard(m_lock);
+  return m_entries.size();
+}
+
+} // namespace sgraph_compute
+} // namespace graphlab
@@ -0,0 +1,198 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_SGRAPH_SGRAPH_EDGE_CACHE_HPP
+#define GRAPHLAB_SGRAPH_SGRAPH_EDGE_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <parallel/mutex.hpp>
+#include <sframe/sframe.hpp>
+
+namespace graphlab {
+namespace sgraph_compute {
+
+/**
+ * An array of unsigned integers stored in 32 bits when the largest value
+ * fits, and in 64 bits otherwise.
+ */
+class compact_id_array {
+ public:
+  /// Resizes to n zero entries, able to hold values up to max_value.
+  void resize(size_t n, size_t max_value) {
+    m_wide = max_value > (size_t)(uint32_t)(-1);
+    m_ids32.clear(); m_ids64.clear();
+    if (m_wide) m_ids64.resize(n, 0);
+    else m_ids32.resize(n, 0);
+  }
+
+  inline size_t operator[](size_t i) const {
+    return m_wide ? m_ids64[i] : m_ids32[i];
+  }
+
+  inline void set(size_t i, size_t val) {
+    if (m_wide) m_ids64[i] = val;
+    else m_ids32[i] = val;
+  }
+
+  inline size_t size() const {
+    return m_wide ? m_ids64.size() : m_ids32.size();
+  }
+
+  inline size_t memory_usage() const {
+    return m_ids64.size() * sizeof(uint64_t) + m_ids32.size() * sizeof(uint32_t);
+  }
+
+  /// The number of bytes a compact_id_array of n values up to max_value takes.
+  static size_t memory_usage(size_t n, size_t max_value) {
+    return n * (max_value > (size_t)(uint32_t)(-1) ? sizeof(uint64_t) : sizeof(uint32_t));
+  }
+
+ private:
+  bool m_wide = false;
+  std::vector<uint32_t> m_ids32;
+  std::vector<uint64_t> m_ids64;
+};
+
+/**
+ * Reads a vertex id column of an edge partition, checking that all ids are
+ * less than num_vertices.
+ */
+void read_edge_ids(const sarray<flexible_type>& column, size_t num_vertices,
+                   compact_id_array& ids);
+
+/**
+ * The structure of one edge partition held in memory.
+ *
+ * Edges are numbered by their row in the edge partition sframe. The source
+ * and target vertex ids (the local ids within their vertex partitions) are
+ * stored in edge order, together with a CSR index grouping edges by source
+ * and a CSC index grouping edges by target:
+ *
+ * \code
+ * for (size_t v = 0; v < csr.num_dst_vertices(); ++v) {
+ *   for (size_t i = csr.in_begin(v); i < csr.in_end(v); ++i) {
+ *     size_t e = csr.in_edge(i);   // csr.dst(e) == v
+ *     ... csr.src(e) ...
+ *   }
+ * }
+ * \endcode
+ *
+ * Within each vertex, edges are listed in increasing row order.
+ */
+class edge_partition_csr {
+ public:
+  /**
+   * Reads the source and target id columns of an edge partition and builds
+   * the indices.
+   */
+  void build(const sarray<flexible_type>& src_column,
+             const sarray<flexible_type>& dst_column,
+             size_t num_src_vertices,
+             size_t num_dst_vertices);
+
+  inline size_t num_edges() const { return m_src.size(); }
+  inline size_t num_src_vertices() const { return m_out_offsets.size() - 1; }
+  inline size_t num_dst_vertices() const { return m_in_offsets.size() - 1; }
+
+  /// The source vertex of edge e
+  inline size_t src(size_t e) const { return m_src[e]; }
+  inline const compact_id_array& src_ids() const { return m_src; }
+  /// The target vertex of edge e
+  inline size_t dst(size_t e) const { return m_dst[e]; }
+  inline const compact_id_array& dst_ids() const { return m_dst; }
+
+  /// The range of out edges of source vertex v is [out_begin(v), out_end(v))
+  inline size_t out_begin(size_t v) const { return m_out_offsets[v]; }
+  inline size_t out_end(size_t v) const { return m_out_offsets[v + 1]; }
+  inline size_t out_edge(size_t i) const { return m_out_edges[i]; }
+
+  /// The range of in edges of target vertex v is [in_begin(v), in_end(v))
+  inline size_t in_begin(size_t v) const { return m_in_offsets[v]; }
+  inline size_t in_end(size_t v) const { return m_in_offsets[v + 1]; }
+  inline size_t in_edge(size_t i) const { return m_in_edges[i]; }
+
+  /// The number of bytes used
+  size_t memory_usage() const;
+
+  /// The number of bytes a partition of the given size will use
+  static size_t estimate_memory_usage(size_t num_edges,
+                                      size_t num_src_vertices,
+                                      size_t num_dst_vertices);
+
+ private:
+  compact_id_array m_src, m_dst;
+  compact_id_array m_out_offsets, m_out_edges;
+  compact_id_array m_in_offsets, m_in_edges;
+};
+
+/**
+ * A process wide cache of \ref edge_partition_csr, so that iterative
+ * computations read the edge structure from disk once instead of on every
+ * iteration.
+ *
+ * Entries are keyed by the files backing the source and target id columns of
+ * the edge partition. Since sarray files are immutable, a cached entry stays
+ * valid for as long as the columns exist, across sgraph copies and across
+ * changes to the other edge fields.
+ *
+ * The total size of the cache is bounded by SGRAPH_EDGE_CACHE_CAPACITY
+ * bytes. The least recently used entries are evicted to make room, and a
+ * partition which does not fit at all is not cached; the caller then falls
+ * back to reading the edge sframe.
+ */
+class sgraph_edge_cache {
+ public:
+  static sgraph_edge_cache& get_instance();
+
+  /**
+   * Returns the structure of the given edge partition, building it if it is
+   * not cached. Returns nullptr if the partition does not fit in the cache
+   * or its id columns are not backed by files.
+   *
+   * \param edgeframe The edge partition.
+   * \param num_src_vertices The number of vertices in the source partition.
+   * \param num_dst_vertices The number of vertices in the target partition.
+   */
+  std::shared_ptr<const edge_partition_csr> get(const sframe& edgeframe,
+                                                size_t num_src_vertices,
+                                                size_t num_dst_vertices);
+
+  /// Drops all entries.
+  void clear();
+
+  /// The number of bytes held by cached entries.
+  size_t memory_usage() const;
+
+  /// The number of cached entries.
+  size_t num_entries() const;
+
+ private:
+  sgraph_edge_cache() { }
+
+  struct entry {
+    std::shared_ptr<const edge_partition_csr> csr;
+    size_t bytes = 0;
+    size_t last_used = 0;
+  };
+
+  /// Evicts until bytes more fit in the capacity. Called with m_lock held.
+  bool make_room(size_t bytes);
+
+  mutable graphlab::mutex m_lock;
+  std::map<std::string, entry> m_entries;
+  size_t m_bytes = 0;
+  size_t m_clock = 0;
+};
+
+} // namespace sgraph_compute
+} // namespace graphlab
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <algorithm>
+#include <numeric>
+#include <sgraph/sgraph_edge_order.hpp>
+#include <sgraph/sgraph_edge_cache.hpp>
+#include <sframe_query_engine/algorithm/ec_permute.hpp>
+#include <parallel/lambda_omp.hpp>
+#include <logger/logger.hpp>
+#include <timer/timer.hpp>
+
+namespace graphlab {
+
+namespace {
+
+const char* EDGE_ORDER_METADATA_KEY = "__edge_order__";
+
+/*
+ * The position of (x, y) along a hilbert curve over an n*n square, n a
+ * power of 2. Unlike coordinate_to_hilbert_index, supports coordinates
+ * beyond 16 bits.
+ */
+uint64_t hilbert_index64(uint64_t x, uint64_t y, uint64_t n) {
+  uint64_t d = 0;
+  for (uint64_t s = n / 2; s > 0; s /= 2) {
+    uint64_t rx = (x & s) > 0;
+    uint64_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    // rotate the quadrant
+    if (ry == 0) {
+      if (rx == 1) {
+        x = s - 1 - x;
+        y = s - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+/*
+ * Writes an id column, optionally recording the edge order.
+ */
+std::shared_ptr<sarray<flexible_type>> write_id_column(const std::vector<size_t>& ids,
+                                                       const std::string& order_metadata) {
+  auto ret = std::make_shared<sarray<flexible_type>>();
+  ret->open_for_write(1);
+  ret->set_type(flex_type_enum::INTEGER);
+  if (!order_metadata.empty()) ret->set_metadata(EDGE_ORDER_METADATA_KEY, order_metadata);
+  auto out = ret->get_output_iterator(0);
+  for (size_t id: ids) {
+    *out = flexible_type(flex_int(id));
+    ++out;
+  }
+  ret->close();
+  return ret;
+}
+
+std::vector<size_t> read_ids(const sframe& edges, const std::string& column, size_t num_vertices) {
+  sgraph_compute::compact_id_array compact;
+  sgraph_compute::read_edge_ids(*edges.select_column(column), num_vertices, compact);
+  std::vector<size_t> ret(compact.size());
+  for (size_t i = 0; i < ret.size(); ++i) ret[i] = compact[i];
+  return ret;
+}
+
+/*
+ * Replaces the id columns of an edge partition with new_src and new_dst, and
+ * moves row i of the other columns to row forward_map[i] (if not empty).
+ */
+sframe rebuild_edge_partition(sframe& edges,
+                              const std::vector<size_t>& new_src,
+                              const std::vector<size_t>& new_dst,
+                              const std::vector<size_t>& forward_map,
+                              const std::string& order_metadata) {
+  std::vector<std::string> other_columns;
+  for (const auto& name: edges.column_names()) {
+    if (name != sgraph::SRC_COLUMN_NAME && name != sgraph::DST_COLUMN_NAME) {
+      other_columns.push_back(name);
+    }
+  }
+  sframe others;
+  if (!other_columns.empty()) {
+    others = edges.select_columns(other_columns);
+    if (!forward_map.empty()) {
+      auto forward_map_sarray = std::make_shared<sarray<flexible_type>>();
+      forward_map_sarray->open_for_write(1);
+      forward_map_sarray->set_type(flex_type_enum::INTEGER);
+      auto out = forward_map_sarray->get_output_iterator(0);
+      for (size_t i: forward_map) {
+        *out = flexible_type(flex_int(i));
+        ++out;
+      }
+      forward_map_sarray->close();
+      others = query_eval::permute_sframe(others, forward_map_sarray);
+    }
+  }
+  auto src_column = write_id_column(new_src, order_metadata);
+  auto dst_column = write_id_column(new_dst, "");
+
+  std::vector<std::shared_ptr<sarray<flexible_type>>> columns;
+  for (const auto& name: edges.column_names()) {
+    if (name == sgraph::SRC_COLUMN_NAME) columns.push_back(src_column);
+    else if (name == sgraph::DST_COLUMN_NAME) columns.push_back(dst_column);
+    else columns.push_back(others.select_column(name));
+  }
+  return sframe(columns, edges.column_names());
+}
+
+void reorder_edge_partition(sframe& edges, size_t num_src_vertices, size_t num_dst_vertices,
+                            edge_order order) {
+  size_t num_edges = edges.num_rows();
+  std::vector<size_t> src = read_ids(edges, sgraph::SRC_COLUMN_NAME, num_src_vertices);
+  std::vector<size_t> dst = read_ids(edges, sgraph::DST_COLUMN_NAME, num_dst_vertices);
+
+  // sorted[k] is the row which goes to position k
+  std::vector<size_t> sorted(num_edges);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  if (order == edge_order::SOURCE_TARGET) {
+    std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+      return src[a] < src[b] || (src[a] == src[b] && dst[a] < dst[b]);
+    });
+  } else if (order == edge_order::HILBERT) {
+    uint64_t n = 1;
+    while (n < std::max(num_src_vertices, num_dst_vertices)) n *= 2;
+    std::vector<uint64_t> keys(num_edges);
+    for (size_t i = 0; i < num_edges; ++i) keys[i] = hilbert_index64(src[i], dst[i], n);
+    std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+      return keys[a] < keys[b];
+    });
+  }
+
+  std::vector<size_t> new_src(num_edges), new_dst(num_edges), forward_map;
+  bool is_identity = true;
+  for (size_t k = 0; k < num_edges; ++k) {
+    new_src[k] = src[sorted[k]];
+    new_dst[k] = dst[sorted[k]];
+    is_identity = is_identity && (sorted[k] == k);
+  }
+  if (!is_identity) {
+    forward_map.resize(num_edges);
+    for (size_t k = 0; k < num_edges; ++k) forward_map[sorted[k]] = k;
+  }
+  std::string metadata = std::to_string((int)order) + ":" + std::to_string(num_edges);
+  edges = rebuild_edge_partition(edges, new_src, new_dst, forward_map, metadata);
+}
+
+} // anonymous namespace
+
+
+void reorder_edges(sgraph& g, edge_order order, size_t groupa, size_t groupb) {
+  timer ti;
+  size_t nparts = g.get_num_partitions();
+  parallel_for(0, nparts * nparts, [&](size_t i) {
+    size_t partition1 = i / nparts, partition2 = i % nparts;
+    sframe& edges = g.edge_partition(partition1, partition2, groupa, groupb);
+    if (edges.num_rows() == 0 ||
+        get_edge_order(g, partition1, partition2, groupa, groupb) == order) {
+      return;
+    }
+    reorder_edge_partition(edges,
+                           g.vertex_partition(partition1, groupa).num_rows(),
+                           g.vertex_partition(partition2, groupb).num_rows(),
+                           order);
+  });
+  logstream(LOG_INFO) << "Reordered edges in " << ti.current_time() << " secs" << std::endl;
+}
+
+
+edge_order get_edge_order(const sgraph& g, size_t partition1, size_t partition2,
+                          size_t groupa, size_t groupb) {
+  const sframe& edges = g.edge_partition(partition1, partition2, groupa, groupb);
+  std::string metadata;
+  if (edges.num_rows() == 0 ||
+      !edges.select_column(sgraph::SRC_COLUMN_NAME)->get_metadata(EDGE_ORDER_METADATA_KEY, metadata)) {
+    return edge_order::INSERTION;
+  }
+  // The metadata is "<order>:<number of edges>". If edges were appended
+  // since, the column (and its metadata) was carried over but the order no
+  // longer holds.
+  size_t sep = metadata.find(':');
+  if (sep == std::string::npos ||
+      metadata.substr(sep + 1) != std::to_string(edges.num_rows())) {
+    return edge_order::INSERTION;
+  }
+  int order = std::stoi(metadata.substr(0, sep));
+  if (order < 0 || order > (int)edge_order::HILBERT) return edge_order::INSERTION;
+  return (edge_order)order;
+}
+
+
+void relabel_vertices_by_degree(sgraph& g, size_t group) {
+  timer ti;
+  size_t nparts = g.get_num_partitions();
+  size_t ngroups = g.get_num_groups();
+
+  // the edge groups touching the vertex group
+  std::vector<std::pair<size_t, size_t>> edge_groups;
+  for (size_t other = 0; other < ngroups; ++other) {
+    edge_groups.push_back({group, other});
+    if (other != group) edge_groups.push_back({other, group});
+  }
+  auto num_vertices = [&](size_t partition, size_t groupid) {
+    return g.vertex_partition(partition, groupid).num_rows();
+  };
+
+  // 1. count the degrees
+  std::vector<std::vector<size_t>> degree(nparts);
+  std::vector<mutex> degree_locks(nparts);
+  for (size_t p = 0; p < nparts; ++p) degree[p].resize(num_vertices(p, group), 0);
+  for (const auto& edge_group: edge_groups) {
+    parallel_for(0, nparts * nparts, [&](size_t i) {
+      size_t partition1 = i / nparts, partition2 = i % nparts;
+      const sframe& edges = g.edge_partition(partition1, partition2,
+                                             edge_group.first, edge_group.second);
+      if (edges.num_rows() == 0) return;
+      if (edge_group.first == group) {
+        auto src = read_ids(edges, sgraph::SRC_COLUMN_NAME, num_vertices(partition1, group));
+        std::lock_guard<mutex> guard(degree_locks[partition1]);
+        for (size_t v: src) ++degree[partition1][v];
+      }
+      if (edge_group.second == group) {
+        auto dst = read_ids(edges, sgraph::DST_COLUMN_NAME, num_vertices(partition2, group));
+        std::lock_guard<mutex> guard(degree_locks[partition2]);
+        for (size_t v: dst) ++degree[partition2][v];
+      }
+    });
+  }
+
+  // 2. permute the vertex partitions. new_id[p][v] is the new id of vertex v.
+  std::vector<std::vector<size_t>> new_id(nparts);
+  parallel_for(0, nparts, [&](size_t p) {
+    size_t n = degree[p].size();
+    std::vector<size_t> sorted(n);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+      return degree[p][a] > degree[p][b];
+    });
+    new_id[p].resize(n);
+    bool is_identity = true;
+    for (size_t k = 0; k < n; ++k) {
+      new_id[p][sorted[k]] = k;
+      is_identity = is_identity && (sorted[k] == k);
+    }
+    if (is_identity) return;
+    auto forward_map = std::make_shared<sarray<flexible_type>>();
+    forward_map->open_for_write(1);
+    forward_map->set_type(flex_type_enum::INTEGER);
+    auto out = forward_map->get_output_iterator(0);
+    for (size_t v = 0; v < n; ++v) {
+      *out = flexible_type(flex_int(new_id[p][v]));
+      ++out;
+    }
+    forward_map->close();
+    sframe& vertices = g.vertex_partition(p, group);
+    vertices = query_eval::permute_sframe(vertices, forward_map);
+  });
+
+  // 3. rewrite the vertex ids of the edges, in place
+  for (const auto& edge_group: edge_groups) {
+    parallel_for(0, nparts * nparts, [&](size_t i) {
+      size_t partition1 = i / nparts, partition2 = i % nparts;
+      sframe& edges = g.edge_partition(partition1, partition2,
+                                       edge_group.first, edge_group.second);
+      if (edges.num_rows() == 0) return;
+      auto src = read_ids(edges, sgraph::SRC_COLUMN_NAME,
+                          num_vertices(partition1, edge_group.first));
+      auto dst = read_ids(edges, sgraph::DST_COLUMN_NAME,
+                          num_vertices(partition2, edge_group.second));
+      if (edge_group.first == group) {
+        for (auto& v: src) v = new_id[partition1][v];
+      }
+      if (edge_group.second == group) {
+        for (auto& v: dst) v = new_id[partition2][v];
+      }
+      edges = rebuild_edge_partition(edges, src, dst, {}, "");
+    });
+  }
+  logstream(LOG_INFO) << "Relabeled vertices in " << ti.current_time() << " secs" << std::endl;
+}
+
+} // namespace graphlab
@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#ifndef GRAPHLAB_SGRAPH_SGRAPH_EDGE_ORDER_HPP
+#define GRAPHLAB_SGRAPH_SGRAPH_EDGE_ORDER_HPP
+
+#include <string>
+#include <sgraph/sgraph.hpp>
+
+namespace graphlab {
+
+/**
+ * The order of the edges within an edge partition.
+ */
+enum class edge_order {
+  /// The order in which edges were added
+  INSERTION = 0,
+  /// Sorted by source vertex, then target vertex
+  SOURCE_TARGET = 1,
+  /// Sorted along a hilbert curve over the (source, target) square
+  HILBERT = 2
+};
+
+/**
+ * Sorts the edges within each edge partition between vertex groups groupa
+ * and groupb, so that the vertex data accessed by a sweep over the edges
+ * (triple_apply, gather) is read mostly sequentially. Edges with equal keys
+ * keep their relative order. Edge fields are permuted along with the ids.
+ *
+ * The ordering is recorded in the metadata of the source id column and can
+ * be queried with \ref get_edge_order. Adding edges to a partition later
+ * resets its order to INSERTION, unless SGRAPH_INGRESS_EDGE_ORDER is set.
+ */
+void reorder_edges(sgraph& g, edge_order order, size_t groupa = 0, size_t groupb = 0);
+
+/**
+ * Returns the recorded order of edge partition (partition1, partition2)
+ * between vertex groups groupa and groupb.
+ */
+edge_order get_edge_order(const sgraph& g, size_t partition1, size_t partition2,
+                          size_t groupa = 0, size_t groupb = 0);
+
+/**
+ * Reorders the vertices of each partition of a vertex group by decreasing
+ * degree (in plus out, counted over all edge groups touching the vertex
+ * group), and rewrites the vertex ids of the edges accordingly. The high
+ * degree vertices, which most edges touch, then share a small, cache
+ * resident prefix of the vertex partition.
+ *
+ * Vertex ids are local to a partition, so vertex data previously loaded by
+ * local id (e.g. with sgraph_compute::create_vertex_data) must be reloaded.
+ * The recorded edge order of the affected partitions is reset to INSERTION;
+ * call \ref reorder_edges afterwards to sort them.
+ */
+void relabel_vertices_by_degree(sgraph& g, size_t group = 0);
+
+} // namespace graphlab
+
+#endif
@@ -17,6 +17,9 @@
 #include <sgraph/sgraph.hpp>
 #include <sgraph/hilbert_parallel_for.hpp>
 #include <sgraph/sgraph_compute_vertex_block.hpp>
+#include <sgraph/sgraph_edge_cache.hpp>
+#include <sgraph/sgraph_constants.hpp>
+#include <util/dense_bitset.hpp>
 #include <util/cityhash_gl.hpp>
 
 namespace graphlab {
@@ -78,6 +81,22 @@ namespace sgraph_compute {
  * \endcode
  *
  *
+ * ### Frontier Gather ###
+ * A second gather overload takes the set of active vertices (for instance
+ * the vertices whose value changed in the last iteration), and only gathers
+ * over the edges whose other end is active: in edges from active sources for
+ * IN_EDGE, out edges to active targets for OUT_EDGE. Vertices without active
+ * neighbors keep the initial value. Edge partitions with no active vertices
+ * on the other side are skipped. When the edge structure is cached (see
+ * \ref sgraph_edge_cache) and the frontier is small, the edges of the active
+ * vertices are visited directly rather than filtering a sweep of all edges.
+ *
+ * \code
+ *  std::vector<dense_bitset> active = ga.make_active_set(g);
+ *  active[partition].set_bit(local_id);
+ *  ret = ga.gather(g, gather_fn, flexible_type(0), edge_direction::IN_EDGE, active);
+ * \endcode
+ *
  * ### Parallel For Edges###
  *
  * The parallel_for_edges() performs the following operations on the graph:
@@ -143,6 +162,7 @@ class sgraph_engine {
            // That does depend on the edge direction I am 
            // executing.
            for(auto edgepart: edgeparts) {
+           if (!has_active_edges(edgepart, edgedir)) continue;
            logstream(LOG_INFO) << "Planning Execution on Edge Partition: " 
                                << edgepart.first << " " << edgepart.second << std::endl;
              for(size_t gather_vgroup: sgraph_compute_group) {
@@ -185,6 +205,7 @@ class sgraph_engine {
            // edges going from group a to group b. So depending on the requested
            // edge direction, we have to a little careful about which edge sets
            // we are actually loading.
+           if (!has_active_edges(edgepart, edgedir)) return;
            for(size_t gather_vgroup: sgraph_compute_group) {
              edge_partition_address address;
              // TODO: revisit the code when we actually have vertex groups 
@@ -199,6 +220,48 @@ class sgraph_engine {
     return combine_sarrays;
   }
 
+  /**
+   * Returns an empty active set for the vertices of group 0: one bitset per
+   * vertex partition, indexed by the local vertex id.
+   */
+  static std::vector<dense_bitset> make_active_set(const sgraph& graph) {
+    std::vector<dense_bitset> ret(graph.get_num_partitions());
+    for (size_t i = 0; i < ret.size(); ++i) {
+      ret[i].resize(graph.vertex_partition(i).num_rows());
+      ret[i].clear();
+    }
+    return ret;
+  }
+
+  /**
+   * Gather over the edges incident to the active vertices only. See the
+   * class documentation. Operates on vertex group 0.
+   *
+   * \param active One bitset per vertex partition, as returned by
+   * \ref make_active_set, marking the active vertices.
+   */
+  std::vector<std::shared_ptr<sarray<T>>> gather(sgraph& graph,
+                                const_gather_function_type gather_fn,
+                                const T& initial_value,
+                                edge_direction edgedir,
+                                const std::vector<dense_bitset>& active) {
+    ASSERT_EQ(active.size(), graph.get_num_partitions());
+    m_active = &active;
+    m_active_count.resize(active.size());
+    for (size_t i = 0; i < active.size(); ++i) {
+      ASSERT_EQ(active[i].size(), graph.vertex_partition(i).num_rows());
+      m_active_count[i] = active[i].popcount();
+    }
+    try {
+      gather(graph, gather_fn, initial_value, edgedir);
+    } catch (...) {
+      m_active = nullptr;
+      throw;
+    }
+    m_active = nullptr;
+    return combine_sarrays;
+  }
+
 
   /**************************************************************************/
   /*                                                                        */
@@ -277,6 +340,24 @@ class sgraph_engine {
   static constexpr size_t LOCK_ARRAY_SIZE = 1024;
   graphlab::mutex lock_array[LOCK_ARRAY_SIZE];
   flex_type_enum m_return_type = flex_type_enum::UNDEFINED;
+  // The active vertices of a frontier gather, or nullptr if all are active
+  const std::vector<dense_bitset>* m_active = nullptr;
+  std::vector<size_t> m_active_count;
+
+  /**
+   * Returns false if a frontier gather has nothing to do on the edge
+   * partition (src partition, dst partition).
+   */
+  bool has_active_edges(std::pair<size_t, size_t> edgepart, edge_direction edgedir) const {
+    if (m_active == nullptr) return true;
+    bool in = (edgedir != edge_direction::OUT_EDGE) && m_active_count[edgepart.first] > 0;
+    bool out = (edgedir != edge_direction::IN_EDGE) && m_active_count[edgepart.second] > 0;
+    return in || out;
+  }
+
+  inline bool is_active(size_t partition, size_t vid) const {
+    return m_active == nullptr || (*m_active)[partition].get(vid);
+  }
 
   template <typename S>
   typename std::enable_if<std::is_same<S, flexible_type>::value>::type
@@ -409,6 +490,21 @@ class sgraph_engine {
 
     vertex_partition_address src_address = address.get_src_vertex_partition();
     vertex_partition_address dst_address = address.get_dst_vertex_partition();
+
+    // If the edges carry no data besides the vertex ids, the edge structure
+    // is all we need, and it can be kept in memory across iterations.
+    if (edgeframe.num_columns() == 2) {
+      auto csr = sgraph_edge_cache::get_instance().get(
+          edgeframe,
+          vertex_data[src_address.group][src_address.partition].m_vertices.size(),
+          vertex_data[dst_address.group][dst_address.partition].m_vertices.size());
+      if (csr) {
+        compute_const_gather_cached(*csr, srcid_column, dstid_column,
+                                    address, central_group, edgedir, gather);
+        return;
+      }
+    }
+
     while (row_start < row_end) {
       size_t nrows = std::min<size_t>(1024, row_end - row_start);
       std::vector<std::vector<flexible_type> > all_edgedata;
@@ -420,8 +516,9 @@ class sgraph_engine {
         size_t srcid = edgedata[srcid_column];
         size_t dstid = edgedata[dstid_column];
 
-        if (edgedir == edge_direction::IN_EDGE || 
-            edgedir == edge_direction::ANY_EDGE) {
+        if ((edgedir == edge_direction::IN_EDGE || 
+             edgedir == edge_direction::ANY_EDGE) &&
+            is_active(src_address.partition, srcid)) {
           DASSERT_EQ(address.dst_group, central_group);
           // acquire lock on the combine target
           size_t vertexhash = hash64_combine(hash64(dst_address.partition), hash64(dstid));
@@ -434,7 +531,8 @@ class sgraph_engine {
                  edge_direction::IN_EDGE,
                  combine_data[dst_address.partition][dstid]);
         }
-        if (edgedir == edge_direction::OUT_EDGE || edgedir == edge_direction::ANY_EDGE) {
+        if ((edgedir == edge_direction::OUT_EDGE || edgedir == edge_direction::ANY_EDGE) &&
+            is_active(dst_address.partition, dstid)) {
           DASSERT_EQ(address.src_group, central_group);
           // acquire lock on the combine target
           size_t vertexhash = hash64_combine(hash64(src_address.partition), hash64(srcid));
@@ -452,6 +550,108 @@ class sgraph_engine {
     }
   }
 
+  /**
+   * compute_const_gather over the cached structure of an edge partition
+   * whose only fields are the vertex ids. Edges are visited grouped by the
+   * vertex being gathered into, so the combiner lock is taken once per
+   * vertex rather than once per edge. For a small frontier, the edges of the
+   * active vertices are visited instead.
+   */
+  void compute_const_gather_cached(const edge_partition_csr& csr,
+                                   size_t srcid_column,
+                                   size_t dstid_column,
+                                   edge_partition_address address,
+                                   size_t central_group,
+                                   edge_direction edgedir,
+                                   const_gather_function_type& gather) {
+    vertex_partition_address src_address = address.get_src_vertex_partition();
+    vertex_partition_address dst_address = address.get_dst_vertex_partition();
+    auto& src_vertices = vertex_data[src_address.group][src_address.partition];
+    auto& dst_vertices = vertex_data[dst_address.group][dst_address.partition];
+    graph_data_type edgedata(2);
+
+    // Gathers over the edge (srcid, dstid) into the target vertex
+    auto gather_in_edge = [&](size_t srcid, size_t dstid) {
+      edgedata[srcid_column] = srcid;
+      edgedata[dstid_column] = dstid;
+      gather(dst_vertices[dstid], edgedata, src_vertices[srcid],
+             edge_direction::IN_EDGE,
+             combine_data[dst_address.partition][dstid]);
+    };
+    // Gathers over the edge (srcid, dstid) into the source vertex
+    auto gather_out_edge = [&](size_t srcid, size_t dstid) {
+      edgedata[srcid_column] = srcid;
+      edgedata[dstid_column] = dstid;
+      gather(src_vertices[srcid], edgedata, dst_vertices[dstid],
+             edge_direction::OUT_EDGE,
+             combine_data[src_address.partition][srcid]);
+    };
+
+    if (edgedir == edge_direction::IN_EDGE ||
+        edgedir == edge_direction::ANY_EDGE) {
+      DASSERT_EQ(address.dst_group, central_group);
+      if (is_sparse_frontier(src_address.partition, csr.num_src_vertices())) {
+        // push from the active sources
+        const dense_bitset& active = (*m_active)[src_address.partition];
+        size_t srcid = 0;
+        for (bool found = active.first_bit(srcid); found; found = active.next_bit(srcid)) {
+          for (size_t i = csr.out_begin(srcid); i < csr.out_end(srcid); ++i) {
+            size_t dstid = csr.dst(csr.out_edge(i));
+            size_t vertexhash = hash64_combine(hash64(dst_address.partition), hash64(dstid));
+            std::unique_lock<graphlab::mutex> guard(lock_array[vertexhash % LOCK_ARRAY_SIZE]);
+            gather_in_edge(srcid, dstid);
+          }
+        }
+      } else {
+        for (size_t dstid = 0; dstid < csr.num_dst_vertices(); ++dstid) {
+          if (csr.in_begin(dstid) == csr.in_end(dstid)) continue;
+          size_t vertexhash = hash64_combine(hash64(dst_address.partition), hash64(dstid));
+          std::unique_lock<graphlab::mutex> guard(lock_array[vertexhash % LOCK_ARRAY_SIZE]);
+          for (size_t i = csr.in_begin(dstid); i < csr.in_end(dstid); ++i) {
+            size_t srcid = csr.src(csr.in_edge(i));
+            if (is_active(src_address.partition, srcid)) gather_in_edge(srcid, dstid);
+          }
+        }
+      }
+    }
+    if (edgedir == edge_direction::OUT_EDGE ||
+        edgedir == edge_direction::ANY_EDGE) {
+      DASSERT_EQ(address.src_group, central_group);
+      if (is_sparse_frontier(dst_address.partition, csr.num_dst_vertices())) {
+        // push from the active targets
+        const dense_bitset& active = (*m_active)[dst_address.partition];
+        size_t dstid = 0;
+        for (bool found = active.first_bit(dstid); found; found = active.next_bit(dstid)) {
+          for (size_t i = csr.in_begin(dstid); i < csr.in_end(dstid); ++i) {
+            size_t srcid = csr.src(csr.in_edge(i));
+            size_t vertexhash = hash64_combine(hash64(src_address.partition), hash64(srcid));
+            std::unique_lock<graphlab::mutex> guard(lock_array[vertexhash % LOCK_ARRAY_SIZE]);
+            gather_out_edge(srcid, dstid);
+          }
+        }
+      } else {
+        for (size_t srcid = 0; srcid < csr.num_src_vertices(); ++srcid) {
+          if (csr.out_begin(srcid) == csr.out_end(srcid)) continue;
+          size_t vertexhash = hash64_combine(hash64(src_address.partition), hash64(srcid));
+          std::unique_lock<graphlab::mutex> guard(lock_array[vertexhash % LOCK_ARRAY_SIZE]);
+          for (size_t i = csr.out_begin(srcid); i < csr.out_end(srcid); ++i) {
+            size_t dstid = csr.dst(csr.out_edge(i));
+            if (is_active(dst_address.partition, dstid)) gather_out_edge(srcid, dstid);
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * True if few enough vertices of the partition are active to visit their
+   * edges directly rather than sweep all edges.
+   */
+  bool is_sparse_frontier(size_t partition, size_t num_vertices) const {
+    return m_active != nullptr &&
+        m_active_count[partition] < SGRAPH_SPARSE_GATHER_FRACTION * num_vertices;
+  }
+
   std::shared_ptr<sarray<T>> compute_edge_map(sframe& edgeframe,
                                               edge_partition_address address,
                                               const_edge_map_function_type map_fn,
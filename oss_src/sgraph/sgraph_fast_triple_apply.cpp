@@ -7,6 +7,7 @@
  */
 #include <sgraph/sgraph_fast_triple_apply.hpp>
 #include <sgraph/sgraph_constants.hpp>
+#include <sgraph/sgraph_edge_cache.hpp>
 #include <sgraph/hilbert_parallel_for.hpp>
 #include <parallel/pthread_tools.hpp>
 #include <util/cityhash_gl.hpp>
@@ -147,6 +148,29 @@ namespace {
     mytimer.start();
     visitor.init(m_graph, m_edge_fields_info, src_partition, dst_partition);
 
+    // Only the vertex ids are needed. Iterate over the cached edge structure
+    // instead of reading the edge sframe.
+    std::shared_ptr<const edge_partition_csr> csr;
+    if (m_edge_fields_info.size() == 2) {
+      csr = sgraph_edge_cache::get_instance().get(
+          edgeframe_compute,
+          m_graph.vertex_partition(src_partition).size(),
+          m_graph.vertex_partition(dst_partition).size());
+    }
+    if (csr) {
+      in_parallel([&](size_t threadid, size_t nthreads) {
+        size_t row_start = csr->num_edges() * threadid / nthreads;
+        size_t row_end = csr->num_edges() * (threadid + 1) / nthreads;
+        visitor.visit_edge_structure(*csr, row_start, row_end);
+      });
+      visitor.finalize();
+      logstream(LOG_INFO) << "Finish working on partition "
+                          << partition_address.partition1
+                          << ", " << partition_address.partition2
+                          << " from cache in " << mytimer.current_time() <<  " secs" << std::endl;
+      return;
+    }
+
     auto reader = edgeframe_compute.get_reader();
 
     in_parallel([&](size_t threadid, size_t nthreads) {
@@ -291,6 +315,26 @@ namespace {
       }
     }
 
+    /**
+     * Visits edges [row_start, row_end) of a partition whose only fields are
+     * the vertex ids, which cannot be mutated.
+     */
+    void visit_edge_structure(const edge_partition_csr& csr,
+                              size_t row_start, size_t row_end) {
+      DASSERT_FALSE(m_mutating_edge_data);
+      std::vector<flexible_type> edata(2);
+      for (size_t e = row_start; e < row_end; ++e) {
+        size_t srcid = csr.src(e);
+        size_t dstid = csr.dst(e);
+        edata[0] = srcid;
+        edata[1] = dstid;
+        fast_edge_scope scope({src_partition, srcid},
+                              {dst_partition, dstid},
+                              &edata);
+        apply_fn(scope);
+      }
+    }
+
     /**
      * Replace the edge partition sframe with the modified edge data.
      * Modified vertex data is taken care by the \ref triple_apply_impl
@@ -343,5 +387,136 @@ namespace {
     single_edge_triple_apply_visitor visitor(apply_fn);
     compute.run(visitor);
   }
+
+/**************************************************************************/
+/*                                                                        */
+/*                     Typed fast triple apply                            */
+/*                                                                        */
+/**************************************************************************/
+
+  void check_typed_fast_triple_apply_fields(const sgraph& g,
+                                            const std::vector<std::string>& edge_fields,
+                                            const std::vector<std::string>& mutated_edge_fields) {
+    const auto& all_edge_fields = g.get_edge_fields();
+    const auto& all_edge_field_types = g.get_edge_field_types();
+    for (auto& f: edge_fields) {
+      auto iter = std::find(all_edge_fields.begin(), all_edge_fields.end(), f);
+      if (iter == all_edge_fields.end()) {
+        log_and_throw(std::string("Cannot find edge field: ") + f);
+      }
+      flex_type_enum ftype = all_edge_field_types[iter - all_edge_fields.begin()];
+      if (ftype != flex_type_enum::INTEGER && ftype != flex_type_enum::FLOAT) {
+        log_and_throw(std::string("Edge field \"") + f + "\" must be of integer or float type.");
+      }
+    }
+    for (auto& f: mutated_edge_fields) {
+      if (std::find(edge_fields.begin(), edge_fields.end(), f) == edge_fields.end()) {
+        log_and_throw(std::string("Mutated edge field \"" + f + "\" must be inlucded in all edge fields."));
+      }
+      if (f == sgraph::SRC_COLUMN_NAME || f == sgraph::DST_COLUMN_NAME) {
+        log_and_throw(std::string("Id column cannot be mutable: ") + f);
+      }
+    }
+  }
+
+  namespace {
+    /*
+     * Decodes a column without missing values into a vector of T.
+     */
+    template <typename T>
+    void read_typed_column(const sarray<flexible_type>& column,
+                           const std::string& name,
+                           std::vector<T>& out) {
+      auto reader = column.get_reader();
+      out.resize(reader->size());
+      in_parallel([&](size_t threadid, size_t nthreads) {
+        size_t row_start = out.size() * threadid / nthreads;
+        size_t row_end = out.size() * (threadid + 1) / nthreads;
+        std::vector<flexible_type> buffer;
+        while (row_start < row_end) {
+          size_t nrows = std::min<size_t>(SGRAPH_TRIPLE_APPLY_EDGE_BATCH_SIZE, row_end - row_start);
+          reader->read_rows(row_start, row_start + nrows, buffer);
+          for (size_t i = 0; i < buffer.size(); ++i) {
+            if (buffer[i].get_type() == flex_type_enum::UNDEFINED) {
+              log_and_throw(std::string("Edge field \"") + name +
+                            "\" has missing values, which typed_fast_triple_apply does not support.");
+            }
+            out[row_start + i] = (T)(buffer[i]);
+          }
+          row_start += nrows;
+        }
+      });
+    }
+
+    template <typename T>
+    std::shared_ptr<sarray<flexible_type>> write_typed_column(const std::vector<T>& values,
+                                                              flex_type_enum type) {
+      auto ret = std::make_shared<sarray<flexible_type>>();
+      ret->open_for_write(1);
+      ret->set_type(type);
+      auto out = ret->get_output_iterator(0);
+      for (const auto& v: values) {
+        *out = v;
+        ++out;
+      }
+      ret->close();
+      return ret;
+    }
+  } // end of empty namespace
+
+  void typed_edge_partition::load(sgraph& g, size_t src_partition, size_t dst_partition,
+                                  const std::vector<std::string>& edge_fields) {
+    m_src_partition = src_partition;
+    m_dst_partition = dst_partition;
+    m_fields = edge_fields;
+    const sframe& edges = g.edge_partition(src_partition, dst_partition);
+    size_t num_src_vertices = g.vertex_partition(src_partition).size();
+    size_t num_dst_vertices = g.vertex_partition(dst_partition).size();
+
+    m_csr = sgraph_edge_cache::get_instance().get(edges, num_src_vertices, num_dst_vertices);
+    if (m_csr) {
+      m_src = &m_csr->src_ids();
+      m_dst = &m_csr->dst_ids();
+    } else {
+      read_edge_ids(*edges.select_column(sgraph::SRC_COLUMN_NAME), num_src_vertices, m_uncached_src);
+      read_edge_ids(*edges.select_column(sgraph::DST_COLUMN_NAME), num_dst_vertices, m_uncached_dst);
+      m_src = &m_uncached_src;
+      m_dst = &m_uncached_dst;
+    }
+
+    size_t nfields = edge_fields.size();
+    m_floats.clear(); m_floats.resize(nfields);
+    m_ints.clear(); m_ints.resize(nfields);
+    m_float_ptrs.assign(nfields, nullptr);
+    m_int_ptrs.assign(nfields, nullptr);
+    for (size_t i = 0; i < nfields; ++i) {
+      size_t column_id = edges.column_index(edge_fields[i]);
+      auto column = edges.select_column(column_id);
+      if (edges.column_type(column_id) == flex_type_enum::FLOAT) {
+        read_typed_column(*column, edge_fields[i], m_floats[i]);
+        m_float_ptrs[i] = m_floats[i].data();
+      } else {
+        read_typed_column(*column, edge_fields[i], m_ints[i]);
+        m_int_ptrs[i] = m_ints[i].data();
+      }
+    }
+  }
+
+  void typed_edge_partition::save(sgraph& g, const std::vector<std::string>& mutated_edge_fields) {
+    sframe& edges = g.edge_partition(m_src_partition, m_dst_partition);
+    for (const auto& field: mutated_edge_fields) {
+      size_t i = std::find(m_fields.begin(), m_fields.end(), field) - m_fields.begin();
+      DASSERT_LT(i, m_fields.size());
+      auto column = m_float_ptrs[i] ?
+          write_typed_column(m_floats[i], flex_type_enum::FLOAT) :
+          write_typed_column(m_ints[i], flex_type_enum::INTEGER);
+      edges = edges.replace_column(column, field);
+    }
+    m_floats.clear();
+    m_ints.clear();
+    m_float_ptrs.clear();
+    m_int_ptrs.clear();
+    m_csr.reset();
+  }
 } // end of sgraph_compute
 } // end of grahlab
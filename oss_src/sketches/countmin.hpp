@@ -53,6 +53,9 @@ class countmin {
   std::vector<size_t> seeds;
   std::vector<std::vector<size_t> > counts; /// Buckets
 
+  /// Number of hashes computed ahead of the count updates in add_many
+  static constexpr size_t HASH_BLOCK_SIZE = 256;
+
  public:
   /**
    * Constructs a countmin sketch having "width" 2^bits and "depth".
@@ -85,11 +88,50 @@ class countmin {
     // we use std::hash first, to bring it to a 64-bit number
     size_t i = hash64(std::hash<T>()(t));
     for (size_t j = 0; j < num_hash; ++j) {
-      size_t bin = hash64(seeds[j] ^ i) % num_bins;  // TODO: bit mask 
+      size_t bin = hash64(seeds[j] ^ i) & (num_bins - 1);
       counts[j][bin] += count; 
     }
   }
 
+  /**
+   * Adds every object in the range [begin, end) with a count of 1.
+   * Equivalent to calling add() on each element, but the objects are hashed
+   * in blocks and the count matrix is then updated one row at a time.
+   */
+  template <typename Iterator>
+  void add_many(Iterator begin, Iterator end) {
+    size_t hashes[HASH_BLOCK_SIZE];
+    while (begin != end) {
+      size_t n = 0;
+      for (; n < HASH_BLOCK_SIZE && begin != end; ++n, ++begin) {
+        hashes[n] = std::hash<T>()(*begin);
+      }
+      add_hashes(hashes, n);
+    }
+  }
+
+  /**
+   * Adds n objects, each with a count of 1, given by their precomputed
+   * std::hash values. add_hashes(&h, 1) where h = std::hash<T>()(t) is
+   * equivalent to add(t).
+   */
+  void add_hashes(const size_t* hashes, size_t n) {
+    size_t mixed[HASH_BLOCK_SIZE];
+    while (n > 0) {
+      size_t block = n < HASH_BLOCK_SIZE ? n : size_t(HASH_BLOCK_SIZE);
+      for (size_t k = 0; k < block; ++k) mixed[k] = hash64(hashes[k]);
+      for (size_t j = 0; j < num_hash; ++j) {
+        size_t* row = counts[j].data();
+        const size_t seed = seeds[j];
+        for (size_t k = 0; k < block; ++k) {
+          ++row[hash64(seed ^ mixed[k]) & (num_bins - 1)];
+        }
+      }
+      hashes += block;
+      n -= block;
+    }
+  }
+
   /**
    * Adds an arbitrary object to be counted. Any object type can be used,
    * and there are no restrictions as long as std::hash<T> can be used to
@@ -99,7 +141,7 @@ class countmin {
     // we use std::hash first, to bring it to a 64-bit number
     size_t i = hash64(std::hash<T>()(t));
     for (size_t j = 0; j < num_hash; ++j) {
-      size_t bin = hash64(seeds[j] ^ i) % num_bins;  // TODO: bit mask 
+      size_t bin = hash64(seeds[j] ^ i) & (num_bins - 1);
       __sync_add_and_fetch(&(counts[j][bin]), count); 
     }
   }
@@ -113,7 +155,7 @@ class countmin {
  
     // Compute the minimum value across hashes.
     for (size_t j = 0; j < num_hash; ++j) {
-      size_t bin = hash64(seeds[j] ^ i) % num_bins;
+      size_t bin = hash64(seeds[j] ^ i) & (num_bins - 1);
       if (counts[j][bin] < E)
         E = counts[j][bin];      
     }
@@ -46,6 +46,9 @@ class countsketch {
 
   std::vector<std::vector<counter_int> > counts; /// Buckets
 
+  /// Number of hashes computed ahead of the count updates in add_many
+  static constexpr size_t HASH_BLOCK_SIZE = 256;
+
  public:
   /**
    * Constructs a CountSketch having "width" 2^bits and "depth".
@@ -89,11 +92,52 @@ class countsketch {
       counter_int s = (counter_int)( hash64(seeds_binary[j] ^ i) & 1);
       s = 2*s - 1;
       // compute which bin to increment
-      size_t bin = hash64(seeds[j] ^ i) % num_bins;  // TODO: bit mask
+      size_t bin = hash64(seeds[j] ^ i) & (num_bins - 1);
       counts[j][bin] += s * (counter_int) count;
     }
   }
 
+  /**
+   * Adds every object in the range [begin, end) with a count of 1.
+   * Equivalent to calling add() on each element, but the objects are hashed
+   * in blocks and the count matrix is then updated one row at a time.
+   */
+  template <typename Iterator>
+  void add_many(Iterator begin, Iterator end) {
+    size_t hashes[HASH_BLOCK_SIZE];
+    while (begin != end) {
+      size_t n = 0;
+      for (; n < HASH_BLOCK_SIZE && begin != end; ++n, ++begin) {
+        hashes[n] = std::hash<T>()(*begin);
+      }
+      add_hashes(hashes, n);
+    }
+  }
+
+  /**
+   * Adds n objects, each with a count of 1, given by their precomputed
+   * std::hash values. add_hashes(&h, 1) where h = std::hash<T>()(t) is
+   * equivalent to add(t).
+   */
+  void add_hashes(const size_t* hashes, size_t n) {
+    size_t mixed[HASH_BLOCK_SIZE];
+    while (n > 0) {
+      size_t block = n < HASH_BLOCK_SIZE ? n : size_t(HASH_BLOCK_SIZE);
+      for (size_t k = 0; k < block; ++k) mixed[k] = hash64(hashes[k]);
+      for (size_t j = 0; j < num_hash; ++j) {
+        counter_int* row = counts[j].data();
+        const size_t seed = seeds[j];
+        const size_t seed_binary = seeds_binary[j];
+        for (size_t k = 0; k < block; ++k) {
+          counter_int s = 2 * (counter_int)(hash64(seed_binary ^ mixed[k]) & 1) - 1;
+          row[hash64(seed ^ mixed[k]) & (num_bins - 1)] += s;
+        }
+      }
+      hashes += block;
+      n -= block;
+    }
+  }
+
  /**
    * Returns the estimate of the frequency for a given object.
    */
@@ -109,7 +153,7 @@ class countsketch {
       counter_int s = (counter_int) (hash64(seeds_binary[j] ^ i) & 1);  // convert trailing bit to 1 or -1
       s = 2*s - 1;
       // compute which bin to increment
-      size_t bin = hash64(seeds[j] ^ i) % num_bins;  // TODO: bit mask
+      size_t bin = hash64(seeds[j] ^ i) & (num_bins - 1);
       counter_int estimate = s * counts[j][bin];
       estimates.push_back(estimate);
     }
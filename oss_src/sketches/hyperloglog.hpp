@@ -9,7 +9,10 @@
 #define GRAPHLAB_SKETCH_HYPERLOGLOG_HPP
 #include <cmath>
 #include <cstdint>
+#include <algorithm>
 #include <functional>
+#include <type_traits>
+#include <vector>
 #include <util/cityhash_gl.hpp>
 #include <logger/assertions.hpp>
 namespace graphlab {
@@ -39,6 +42,13 @@ namespace sketches {
  *   hll.estimate() // will return an estimate of the number of unique element
  *   hll.error_bound() // will return the standard deviation on the estimate
  * \endcode
+ *
+ * When many values are available at once (a block read from an SArray, or a
+ * typed numeric buffer) add_many() should be preferred over repeated calls to
+ * add(): it hashes the whole batch in one tight loop and only then scatters
+ * into the registers. If the std::hash values are already available (for
+ * instance because they are shared with another sketch), add_hashes() skips
+ * the hashing entirely. All three paths produce identical sketches.
  */
 class hyperloglog {
  private:
@@ -83,11 +93,44 @@ class hyperloglog {
     // Then cityhash's hash64 twice to distribute the hash.
     // empirically, one hash64 does not produce enough scattering to
     // get a good estimate
-    size_t h = hash64(hash64(std::hash<T>()(t)));
-    size_t index = h >> (64 - m_b);
-    DASSERT_LT(index, m_buckets.size());
-    unsigned char pos = h != 0 ? 1 + __builtin_clz(h) : sizeof(size_t);
-    m_buckets[index] = std::max(m_buckets[index], pos);
+    add_mixed_hash(hash64(hash64(std::hash<T>()(t))));
+  }
+
+  /**
+   * Adds all the objects in the range [begin, end). Equivalent to calling
+   * add() on each element, but the hashes are computed in blocks ahead of
+   * the register updates so that the hash loop can be vectorized.
+   */
+  template <typename Iterator>
+  void add_many(Iterator begin, Iterator end) {
+    typedef typename std::decay<decltype(*begin)>::type value_type;
+    size_t hashes[HASH_BLOCK_SIZE];
+    while (begin != end) {
+      size_t n = 0;
+      for (; n < HASH_BLOCK_SIZE && begin != end; ++n, ++begin) {
+        hashes[n] = std::hash<value_type>()(*begin);
+      }
+      add_hashes(hashes, n);
+    }
+  }
+
+  /**
+   * Adds n objects given by their precomputed std::hash values.
+   * add_hashes(&h, 1) where h = std::hash<T>()(t) is equivalent to add(t).
+   */
+  void add_hashes(const size_t* hashes, size_t n) {
+    size_t mixed[HASH_BLOCK_SIZE];
+    while (n > 0) {
+      size_t block = n < HASH_BLOCK_SIZE ? n : size_t(HASH_BLOCK_SIZE);
+      for (size_t i = 0; i < block; ++i) {
+        mixed[i] = hash64(hash64(hashes[i]));
+      }
+      for (size_t i = 0; i < block; ++i) {
+        add_mixed_hash(mixed[i]);
+      }
+      hashes += block;
+      n -= block;
+    }
   }
 
   /**
@@ -99,8 +142,12 @@ class hyperloglog {
    */
   void combine(const hyperloglog& other) {
     ASSERT_EQ(m_buckets.size(), other.m_buckets.size());
-    for (size_t i = 0;i < m_buckets.size(); ++i) {
-      m_buckets[i] = std::max(m_buckets[i], other.m_buckets[i]);
+    // written over raw pointers so the compiler can emit a packed byte max
+    unsigned char* __restrict__ dest = m_buckets.data();
+    const unsigned char* __restrict__ src = other.m_buckets.data();
+    const size_t len = m_buckets.size();
+    for (size_t i = 0;i < len; ++i) {
+      dest[i] = dest[i] < src[i] ? src[i] : dest[i];
     }
   }
 
@@ -116,21 +163,59 @@ class hyperloglog {
    * Returns the estimate of the number of unique items.
    */
   inline double estimate() {
-    double E = 0;
-    for (size_t i = 0;i < m_buckets.size(); ++i) {
-      E += std::pow(2.0, -(double)m_buckets[i]);
+    // Register values are bounded by the hash width, so 2^-k comes from a
+    // table rather than std::pow. Four independent partial sums keep the
+    // loop free of a serial floating point dependency chain.
+    static const inverse_power_table inv_pow;
+    const unsigned char* buckets = m_buckets.data();
+    const size_t len = m_buckets.size();
+    double partial[4] = {0, 0, 0, 0};
+    size_t zero_count = 0;
+    size_t i = 0;
+    for (;i + 4 <= len; i += 4) {
+      partial[0] += inv_pow.values[buckets[i]];
+      partial[1] += inv_pow.values[buckets[i + 1]];
+      partial[2] += inv_pow.values[buckets[i + 2]];
+      partial[3] += inv_pow.values[buckets[i + 3]];
+      zero_count += (buckets[i] == 0) + (buckets[i + 1] == 0) +
+                    (buckets[i + 2] == 0) + (buckets[i + 3] == 0);
+    }
+    for (;i < len; ++i) {
+      partial[0] += inv_pow.values[buckets[i]];
+      zero_count += (buckets[i] == 0);
     }
+    double E = (partial[0] + partial[1]) + (partial[2] + partial[3]);
     E = m_alpha * m_m * m_m / E;
     // perform bias correction for small values
     if (E <= 2.5 * m_m) {
-      size_t zero_count = 0;
-      for(auto i: m_buckets) zero_count += (i == 0);
       if (zero_count != 0) E = m_m * std::log((double)m_m / zero_count);
     }
     // we do not need correction for large values 64-bit hash, assume 
     // collisions are unlikely
     return E;
   }
+
+ private:
+  /// Number of hashes computed ahead of the register updates in add_many
+  static constexpr size_t HASH_BLOCK_SIZE = 256;
+
+  /// 2^-k for every value a register can hold
+  struct inverse_power_table {
+    double values[256];
+    inverse_power_table() {
+      for (size_t k = 0; k < 256; ++k) values[k] = std::ldexp(1.0, -(int)k);
+    }
+  };
+
+  /**
+   * Updates the register selected by a fully mixed 64-bit hash.
+   */
+  inline void add_mixed_hash(size_t h) {
+    size_t index = h >> (64 - m_b);
+    DASSERT_LT(index, m_buckets.size());
+    unsigned char pos = h != 0 ? 1 + __builtin_clz(h) : sizeof(size_t);
+    m_buckets[index] = std::max(m_buckets[index], pos);
+  }
 }; // hyperloglog
 } // namespace sketch 
 } // namespace graphlab
@@ -86,6 +86,25 @@ class space_saving {
   void add(const T& t, size_t count = 1) {
     add_impl(t, count, 0);
   }
+
+  /**
+   * Adds every item in the range [begin, end), each with a count of 1.
+   * Runs of equal consecutive items (common in sorted or low cardinality
+   * columns) are collapsed into a single update, so the item is hashed
+   * and looked up once per run rather than once per element.
+   */
+  template <typename Iterator>
+  void add_many(Iterator begin, Iterator end) {
+    while(begin != end) {
+      Iterator run_end = begin;
+      size_t count = 1;
+      for(++run_end; run_end != end && *run_end == *begin; ++run_end) {
+        ++count;
+      }
+      add_impl(*begin, count, 0);
+      begin = run_end;
+    }
+  }
   
   /**
    * Returns the number of elements inserted into the sketch.
@@ -79,6 +79,27 @@ class space_saving_flextype {
     }
   }
   
+  /**
+   * Adds every item in the range [begin, end), each with a count of 1.
+   * Equivalent to calling add() on each element; runs of identical
+   * consecutive values are collapsed into a single counted add().
+   */
+  template <typename Iterator>
+  inline void add_many(Iterator begin, Iterator end) {
+    while(begin != end) {
+      const flexible_type& t = *begin;
+      Iterator run_end = begin;
+      size_t count = 1;
+      for(++run_end; run_end != end
+              && run_end->get_type() == t.get_type()
+              && *run_end == t; ++run_end) {
+        ++count;
+      }
+      add(t, count);
+      begin = run_end;
+    }
+  }
+
   /**
    * Returns the number of elements inserted into the sketch.
    */
@@ -6,6 +6,10 @@
  * of the BSD license. See the LICENSE file for details.
  */
 #include <unity/extensions/grouped_sframe.hpp>
+#include <unity/lib/variant_deep_serialize.hpp>
+#include <sframe/sframe.hpp>
+#include <sframe/sarray.hpp>
+#include <sframe_query_engine/algorithm/ec_permute.hpp>
 
 namespace graphlab {
 
@@ -14,6 +18,7 @@ void grouped_sframe::group(const gl_sframe &sf, const std::vector<std::string>
     column_names, bool is_grouped) {
   if(m_inited)
     log_and_throw("Group has already been called on this object!");
+  check_key_columns(sf, column_names);
 
   // Do our "grouping" if it hasn't already been done
   if(!is_grouped) {
@@ -21,33 +26,23 @@ void grouped_sframe::group(const gl_sframe &sf, const std::vector<std::string>
   } else {
     m_grouped_sf = sf;
   }
+  // get_group slices the grouped SFrame; keep it materialized so that the
+  // slices are read through the block index
+  m_grouped_sf.materialize();
   m_key_col_names = column_names;
 
-  // Get indices from column names
-  std::vector<size_t> col_ids;
-  std::unordered_set<size_t> dedup_set;
-  for(const auto &i : column_names) {
-    auto col_id = sf.column_index(i);
-    col_ids.push_back(col_id);
-    auto ins_ret = dedup_set.insert(col_id);
-    if(!ins_ret.second)
-      log_and_throw("Found duplicate column name: " + i);
-  }
-
   // Build the directory of ranges to allow querying of the groups
-  // (this is an extra, sequential pass over the data)
-  auto sf_range = m_grouped_sf.range_iterator();
+  // (this is an extra, sequential pass over the key columns)
+  auto sf_range = m_grouped_sf.select_columns(column_names).range_iterator();
   auto iter = sf_range.begin();
   size_t cnt = 0;
-  std::vector<flexible_type> prev_elem(col_ids.size());
-  std::vector<flexible_type> cur_elem(col_ids.size());
+  std::vector<flexible_type> prev_elem(column_names.size());
+  std::vector<flexible_type> cur_elem(column_names.size());
   bool first = true;
   for(; iter != sf_range.end(); ++iter, ++cnt) {
     // Create cur_elem
-    int col_cnt = 0;
-    for(const auto &i : col_ids) {
-      cur_elem[col_cnt] = (*iter)[i];
-      ++col_cnt;
+    for(size_t i = 0; i < cur_elem.size(); ++i) {
+      cur_elem[i] = (*iter)[i];
     }
 
     // Check for new group
@@ -64,13 +59,73 @@ void grouped_sframe::group(const gl_sframe &sf, const std::vector<std::string>
     prev_elem = cur_elem;
   }
 
-  if(col_ids.size() > 1) {
-    m_group_type = flex_type_enum::LIST;
+  finish_group(prev_elem);
+}
+
+void grouped_sframe::group_by_hash(const gl_sframe &sf,
+    const std::vector<std::string> column_names) {
+  if(m_inited)
+    log_and_throw("Group has already been called on this object!");
+  check_key_columns(sf, column_names);
+  m_key_col_names = column_names;
+
+  // Number the groups in order of first appearance. The group of each row
+  // is streamed to disk; only the per-group tables are kept in memory.
+  std::vector<size_t> group_size;
+  std::vector<flexible_type> key(column_names.size());
+  auto row_group = std::make_shared<sarray<flexible_type>>();
+  row_group->open_for_write(1);
+  row_group->set_type(flex_type_enum::INTEGER);
+  auto group_out = row_group->get_output_iterator(0);
+  for(const auto &row : sf.select_columns(column_names).range_iterator()) {
+    for(size_t i = 0; i < key.size(); ++i) {
+      key[i] = row[i];
+    }
+    auto ins_ret = m_key2range.insert(std::make_pair(key, group_size.size()));
+    if(ins_ret.second) {
+      group_size.push_back(0);
+      if(key.size() == 1)
+        m_group_names.push_back(key[0]);
+      else
+        m_group_names.push_back(key);
+    }
+    *group_out = flexible_type(flex_int(ins_ret.first->second));
+    ++group_out;
+    ++group_size[ins_ret.first->second];
+  }
+  row_group->close();
+
+  // Lay the groups out one after the other. Within a group, rows keep their
+  // relative order.
+  std::vector<size_t> next_row(group_size.size());
+  size_t offset = 0;
+  for(size_t i = 0; i < group_size.size(); ++i) {
+    m_range_directory.push_back(offset);
+    next_row[i] = offset;
+    offset += group_size[i];
+  }
+
+  if(offset == 0) {
+    // nothing to permute
+    m_grouped_sf = sf;
+    m_grouped_sf.materialize();
   } else {
-    m_group_type = prev_elem[0].get_type();
+    // A second pass over the group ids gives each row its destination.
+    auto forward_map = std::make_shared<sarray<flexible_type>>();
+    forward_map->open_for_write(1);
+    forward_map->set_type(flex_type_enum::INTEGER);
+    auto out = forward_map->get_output_iterator(0);
+    for(const auto &group_id : gl_sarray(row_group).range_iterator()) {
+      *out = flexible_type(flex_int(next_row[group_id.get<flex_int>()]++));
+      ++out;
+    }
+    forward_map->close();
+
+    sframe values = sf.materialize_to_sframe();
+    m_grouped_sf = gl_sframe(query_eval::permute_sframe(values, forward_map));
   }
 
-  m_inited = true;
+  finish_group(key);
 }
 
 gl_sframe grouped_sframe::get_group(std::vector<flexible_type> key) {
@@ -204,6 +259,61 @@ gl_sframe grouped_sframe::group_info() const {
   return writer.close(); 
 }
 
+void grouped_sframe::save_impl(oarchive& oarc) const {
+  oarc << m_inited;
+  if(!m_inited) return;
+  variant_deep_save(m_grouped_sf, oarc);
+  oarc << m_key_col_names << m_range_directory << m_group_names
+       << size_t(m_group_type);
+}
+
+void grouped_sframe::load_version(iarchive& iarc, size_t version) {
+  if(version > GROUPED_SFRAME_VERSION)
+    log_and_throw("Unable to load grouped_sframe of version " +
+        std::to_string(version));
+  iarc >> m_inited;
+  if(!m_inited) return;
+  variant_deep_load(m_grouped_sf, iarc);
+  size_t group_type = 0;
+  iarc >> m_key_col_names >> m_range_directory >> m_group_names >> group_type;
+  m_group_type = (flex_type_enum)group_type;
+
+  // Rebuild the key lookup from the group names
+  m_key2range.clear();
+  for(size_t i = 0; i < m_group_names.size(); ++i) {
+    if(m_key_col_names.size() == 1) {
+      m_key2range.insert(std::make_pair(std::vector<flexible_type>{m_group_names[i]}, i));
+    } else {
+      m_key2range.insert(std::make_pair(m_group_names[i].get<flex_list>(), i));
+    }
+  }
+  m_groups_sa = gl_sarray();
+  m_iterating = false;
+  m_cur_iterator_idx = 0;
+}
+
+/// Private methods
+void grouped_sframe::check_key_columns(const gl_sframe &sf,
+    const std::vector<std::string> &column_names) const {
+  std::unordered_set<size_t> dedup_set;
+  for(const auto &i : column_names) {
+    auto col_id = sf.column_index(i);
+    auto ins_ret = dedup_set.insert(col_id);
+    if(!ins_ret.second)
+      log_and_throw("Found duplicate column name: " + i);
+  }
+}
+
+void grouped_sframe::finish_group(const std::vector<flexible_type> &last_key) {
+  if(last_key.size() > 1) {
+    m_group_type = flex_type_enum::LIST;
+  } else {
+    m_group_type = last_key[0].get_type();
+  }
+
+  m_inited = true;
+}
+
 /// Private methods
 gl_sframe grouped_sframe::get_group_by_index(size_t range_dir_idx) {
   int64_t range_start = m_range_directory[range_dir_idx];
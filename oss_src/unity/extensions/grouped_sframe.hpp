@@ -48,6 +48,21 @@ class EXPORT grouped_sframe: public graphlab::toolkit_class_base {
   void group(const gl_sframe &sf, const std::vector<std::string> column_names,
       bool is_grouped);
 
+  /**
+   * Groups an SFrame like \ref group, but without sorting it.
+   *
+   * Each row is assigned its group through a hash table over the keys, and
+   * the rows are then moved (with an external memory permute) so that each
+   * group's rows are contiguous, in their original relative order. The
+   * groups are ordered by their first appearance in the SFrame rather than
+   * by key.
+   *
+   * Throws if group has already been called on this object, or the column
+   * names are not valid.
+   */
+  void group_by_hash(const gl_sframe &sf,
+      const std::vector<std::string> column_names);
+
 
   /**
    * Get the SFrame that corresponds to the group named `key`.
@@ -123,9 +138,39 @@ class EXPORT grouped_sframe: public graphlab::toolkit_class_base {
    */
   gl_sframe group_info() const;
 
+  /**
+   * Saves the grouped SFrame along with its group index, so that a loaded
+   * grouped_sframe answers get_group without regrouping.
+   */
+  void save_impl(oarchive& oarc) const;
+
+  void load_version(iarchive& iarc, size_t version);
+
+  size_t get_version() const {
+    return GROUPED_SFRAME_VERSION;
+  }
+
  protected:
  private:
+  static constexpr size_t GROUPED_SFRAME_VERSION = 1;
+
   /// Methods
+
+  /**
+   * Checks that the key columns exist in sf and are distinct.
+   *
+   * Internal method
+   */
+  void check_key_columns(const gl_sframe &sf,
+      const std::vector<std::string> &column_names) const;
+
+  /**
+   * Sets the group type and marks the object as grouped, once the range
+   * directory is built. last_key is the key of the last row.
+   *
+   * Internal method
+   */
+  void finish_group(const std::vector<flexible_type> &last_key);
   
   /**
    * Get a group by its index in the range directory.
@@ -160,6 +205,8 @@ class EXPORT grouped_sframe: public graphlab::toolkit_class_base {
   BEGIN_CLASS_MEMBER_REGISTRATION("grouped_sframe")
   REGISTER_CLASS_MEMBER_FUNCTION(grouped_sframe::group, "data", "column_names",
       "is_grouped")
+  REGISTER_CLASS_MEMBER_FUNCTION(grouped_sframe::group_by_hash, "data",
+      "column_names")
   REGISTER_CLASS_MEMBER_FUNCTION(grouped_sframe::get_group, "key")
   REGISTER_CLASS_MEMBER_FUNCTION(grouped_sframe::num_groups)
   REGISTER_CLASS_MEMBER_FUNCTION(grouped_sframe::groups)
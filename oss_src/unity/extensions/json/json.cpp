@@ -1,5 +1,6 @@
 #include "decoder.hpp"
 #include "encoder.hpp"
+#include "lines.hpp"
 
 #include <unity/lib/toolkit_function_macros.hpp>
 #include <unity/lib/toolkit_class_macros.hpp>
@@ -19,5 +20,6 @@ static flexible_type _test_flexible_type(const flexible_type& value) {
 BEGIN_FUNCTION_REGISTRATION;
 REGISTER_NAMED_FUNCTION("json.to_serializable", JSON::to_serializable, "input");
 REGISTER_NAMED_FUNCTION("json.from_serializable", JSON::from_serializable, "data", "schema");
+REGISTER_NAMED_FUNCTION("json.read_json_lines", JSON::read_json_lines, "url");
 REGISTER_NAMED_FUNCTION("json._test_flexible_type", _test_flexible_type, "input");
 END_FUNCTION_REGISTRATION;
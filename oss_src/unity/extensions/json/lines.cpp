@@ -0,0 +1,557 @@
+#include "lines.hpp"
+
+#include <fileio/general_fstream.hpp>
+#include <fileio/fs_utils.hpp>
+#include <fileio/sanitize_url.hpp>
+#include <parallel/lambda_omp.hpp>
+#include <parallel/pthread_tools.hpp>
+#include <sframe/sframe.hpp>
+#include <sframe/sarray.hpp>
+#include <logger/logger.hpp>
+#include <timer/timer.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace graphlab {
+namespace JSON {
+
+namespace {
+
+// The file is read sequentially in chunks of about this size, cut at a
+// line boundary. The lines of a chunk are parsed in parallel.
+const size_t READ_CHUNK_SIZE = 16 * 1024 * 1024;
+
+struct syntax_error {
+  const char* what;
+};
+
+/*
+ * A recursive descent JSON parser producing flexible_type values.
+ * Objects become dicts, arrays of numbers become vectors, other arrays
+ * become lists, true/false become 1/0 and null becomes None.
+ *
+ * The input must be followed by a newline or a NUL character so that
+ * numbers can be parsed with strtod.
+ */
+class value_parser {
+ public:
+  value_parser(const char* begin, const char* end) : pos(begin), end(end) { }
+
+  void skip_whitespace() {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n')) ++pos;
+  }
+
+  bool at_end() {
+    skip_whitespace();
+    return pos == end;
+  }
+
+  /// Skips whitespace and consumes c if it is the next character.
+  bool accept(char c) {
+    skip_whitespace();
+    if (pos < end && *pos == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c, const char* what) {
+    if (!accept(c)) throw syntax_error{what};
+  }
+
+  flexible_type parse_value() {
+    skip_whitespace();
+    if (pos == end) throw syntax_error{"unexpected end of line"};
+    switch(*pos) {
+     case '{':
+       return parse_object();
+     case '[':
+       return parse_array();
+     case '"': {
+       flexible_type ret(flex_type_enum::STRING);
+       parse_string(ret.mutable_get<flex_string>());
+       return ret;
+     }
+     case 't':
+       parse_literal("true");
+       return flex_int(1);
+     case 'f':
+       parse_literal("false");
+       return flex_int(0);
+     case 'n':
+       parse_literal("null");
+       return FLEX_UNDEFINED;
+     default:
+       return parse_number();
+    }
+  }
+
+  /// Parses a string (with its quotes) into out.
+  void parse_string(std::string& out) {
+    out.clear();
+    expect('"', "expected a string");
+    while (true) {
+      const char* run = pos;
+      while (pos < end && *pos != '"' && *pos != '\\') ++pos;
+      out.append(run, pos);
+      if (pos == end) throw syntax_error{"unterminated string"};
+      if (*pos++ == '"') return;
+      if (pos == end) throw syntax_error{"unterminated string"};
+      char c = *pos++;
+      switch(c) {
+       case '"': case '\\': case '/': out.push_back(c); break;
+       case 'b': out.push_back('\b'); break;
+       case 'f': out.push_back('\f'); break;
+       case 'n': out.push_back('\n'); break;
+       case 'r': out.push_back('\r'); break;
+       case 't': out.push_back('\t'); break;
+       case 'u': {
+         uint32_t code = parse_hex4();
+         // a surrogate pair encodes a code point beyond the BMP
+         if (code >= 0xD800 && code < 0xDC00 &&
+             end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u') {
+           pos += 2;
+           uint32_t low = parse_hex4();
+           if (low < 0xDC00 || low >= 0xE000) throw syntax_error{"invalid surrogate pair"};
+           code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+         }
+         append_utf8(code, out);
+         break;
+       }
+       default:
+         throw syntax_error{"invalid escape sequence"};
+      }
+    }
+  }
+
+  const char* pos;
+  const char* end;
+
+ private:
+  flexible_type parse_object() {
+    ++pos;
+    flex_dict ret;
+    if (accept('}')) return ret;
+    do {
+      flexible_type key(flex_type_enum::STRING);
+      skip_whitespace();
+      parse_string(key.mutable_get<flex_string>());
+      expect(':', "expected ':'");
+      ret.push_back({std::move(key), parse_value()});
+    } while (accept(','));
+    expect('}', "expected ',' or '}'");
+    return ret;
+  }
+
+  flexible_type parse_array() {
+    ++pos;
+    flex_list values;
+    bool all_numeric = true;
+    if (!accept(']')) {
+      do {
+        values.push_back(parse_value());
+        flex_type_enum t = values.back().get_type();
+        all_numeric = all_numeric && (t == flex_type_enum::INTEGER || t == flex_type_enum::FLOAT);
+      } while (accept(','));
+      expect(']', "expected ',' or ']'");
+    }
+    if (!all_numeric) return values;
+    flex_vec ret(values.size());
+    for (size_t i = 0; i < values.size(); ++i) ret[i] = values[i].to<flex_float>();
+    return ret;
+  }
+
+  flexible_type parse_number() {
+    const char* start = pos;
+    bool negative = (*pos == '-');
+    if (negative) ++pos;
+    if (pos == end || !is_digit(*pos)) throw syntax_error{"unexpected character"};
+    // integers are accumulated directly, anything else goes through strtod
+    uint64_t value = 0;
+    bool overflow = false;
+    for (; pos < end && is_digit(*pos); ++pos) {
+      overflow = overflow || value > (uint64_t(1) << 63) / 10;
+      value = value * 10 + (*pos - '0');
+    }
+    bool is_integer = !(pos < end && (*pos == '.' || *pos == 'e' || *pos == 'E'));
+    if (is_integer && !overflow &&
+        value <= (negative ? (uint64_t(1) << 63) : uint64_t(INT64_MAX))) {
+      return negative ? flex_int(-value) : flex_int(value);
+    }
+    char* number_end = nullptr;
+    double ret = std::strtod(start, &number_end);
+    if (number_end == start || number_end > end) throw syntax_error{"invalid number"};
+    pos = number_end;
+    return ret;
+  }
+
+  static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  void parse_literal(const char* literal) {
+    size_t len = strlen(literal);
+    if (size_t(end - pos) < len || strncmp(pos, literal, len) != 0) {
+      throw syntax_error{"unexpected character"};
+    }
+    pos += len;
+  }
+
+  uint32_t parse_hex4() {
+    if (end - pos < 4) throw syntax_error{"invalid \\u escape"};
+    uint32_t code = 0;
+    for (size_t i = 0; i < 4; ++i, ++pos) {
+      char c = *pos;
+      code <<= 4;
+      if (c >= '0' && c <= '9') code |= c - '0';
+      else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+      else throw syntax_error{"invalid \\u escape"};
+    }
+    return code;
+  }
+
+  static void append_utf8(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+      out.push_back(code);
+    } else if (code < 0x800) {
+      out.push_back(0xC0 | (code >> 6));
+      out.push_back(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      out.push_back(0xE0 | (code >> 12));
+      out.push_back(0x80 | ((code >> 6) & 0x3F));
+      out.push_back(0x80 | (code & 0x3F));
+    } else {
+      out.push_back(0xF0 | (code >> 18));
+      out.push_back(0x80 | ((code >> 12) & 0x3F));
+      out.push_back(0x80 | ((code >> 6) & 0x3F));
+      out.push_back(0x80 | (code & 0x3F));
+    }
+  }
+};
+
+
+/*
+ * The same rule as SArray.unpack uses for dict values:
+ * 1. if either is UNDEFINED, use the other
+ * 2. if one is INTEGER and the other FLOAT, use FLOAT
+ * 3. if one can be converted to another, use the more generic one
+ * 4. if none of the above, use STRING
+ */
+flex_type_enum combine_types(flex_type_enum t1, flex_type_enum t2) {
+  if (t1 == flex_type_enum::UNDEFINED) {
+    return t2;
+  } else if (t2 == flex_type_enum::UNDEFINED) {
+    return t1;
+  } else if ((t1 == flex_type_enum::INTEGER && t2 == flex_type_enum::FLOAT) ||
+             (t2 == flex_type_enum::INTEGER && t1 == flex_type_enum::FLOAT)) {
+    return flex_type_enum::FLOAT;
+  } else if (flex_type_is_convertible(t1, t2)) {
+    return t2;
+  } else if (flex_type_is_convertible(t2, t1)) {
+    return t1;
+  } else {
+    return flex_type_enum::STRING;
+  }
+}
+
+/// The (row within the chunk, value) pairs of one column, parsed by one thread
+typedef std::vector<std::pair<size_t, flexible_type>> column_buffer;
+
+/*
+ * The output column of one key. The type of a column is inferred from the
+ * first chunk in which it has a value, and later values are converted to it.
+ */
+struct output_column {
+  std::string name;
+  std::shared_ptr<sarray<flexible_type>> data;
+  sarray<flexible_type>::iterator out;
+  bool typed = false;
+  flex_type_enum type = flex_type_enum::UNDEFINED;
+  size_t num_rows = 0;
+  size_t num_failures = 0;
+
+  void set_type(flex_type_enum t) {
+    type = t;
+    typed = true;
+    data->set_type(t);
+    out = data->get_output_iterator(0);
+  }
+
+  /// Pads the column with missing values up to row.
+  void fill_to(size_t row) {
+    for (; num_rows < row; ++num_rows) {
+      *out = FLEX_UNDEFINED;
+      ++out;
+    }
+  }
+
+  void write(flexible_type& value) {
+    if (value.get_type() == type || value.get_type() == flex_type_enum::UNDEFINED) {
+      *out = std::move(value);
+    } else if (flex_type_is_convertible(value.get_type(), type)) {
+      flexible_type converted(type);
+      converted.soft_assign(value);
+      *out = std::move(converted);
+    } else {
+      *out = FLEX_UNDEFINED;
+      ++num_failures;
+    }
+    ++out;
+    ++num_rows;
+  }
+};
+
+enum class line_format { UNKNOWN, OBJECTS, VALUES };
+
+class json_lines_reader {
+ public:
+  json_lines_reader()
+      : num_threads(std::max<size_t>(thread_pool::get_instance().size(), 1)),
+        thread_columns(num_threads), thread_num_rows(num_threads),
+        key_caches(num_threads) { }
+
+  void read(general_ifstream& fin) {
+    std::string buffer;
+    while (true) {
+      size_t carry = buffer.size();
+      buffer.resize(carry + READ_CHUNK_SIZE);
+      fin.read(&buffer[carry], READ_CHUNK_SIZE);
+      size_t num_read = fin.gcount();
+      buffer.resize(carry + num_read);
+      bool eof = (num_read < READ_CHUNK_SIZE);
+      size_t cut = buffer.size();
+      if (!eof) {
+        cut = buffer.rfind('\n');
+        // a line longer than a chunk: keep reading
+        if (cut == std::string::npos) continue;
+        ++cut;
+      }
+      process_chunk(buffer.c_str(), buffer.c_str() + cut);
+      buffer.erase(0, cut);
+      if (eof) break;
+      logprogress_stream << "Parsed " << total_rows << " lines in "
+                         << ti.current_time() << " secs." << std::endl;
+    }
+  }
+
+  sframe finish() {
+    if (format == line_format::UNKNOWN) {
+      log_and_throw("No JSON values found");
+    }
+    size_t num_failures = 0;
+    std::vector<size_t> order(columns.size());
+    std::iota(order.begin(), order.end(), 0);
+    parallel_for(0, columns.size(), [&](size_t c) {
+      // only missing values: use FLOAT, as SArray.unpack does
+      if (!columns[c].typed) columns[c].set_type(flex_type_enum::FLOAT);
+      columns[c].fill_to(total_rows);
+      columns[c].data->close();
+    });
+    for (const auto& column: columns) num_failures += column.num_failures;
+    if (num_failures > 0) {
+      logprogress_stream << num_failures << " values could not be converted to the type "
+                         << "of their column and were replaced by None." << std::endl;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return columns[a].name < columns[b].name;
+    });
+    std::vector<std::shared_ptr<sarray<flexible_type>>> data;
+    std::vector<std::string> names;
+    for (size_t c: order) {
+      data.push_back(columns[c].data);
+      names.push_back(columns[c].name);
+    }
+    logprogress_stream << "Read " << total_rows << " lines in "
+                       << ti.current_time() << " secs." << std::endl;
+    return sframe(data, names);
+  }
+
+ private:
+  void process_chunk(const char* begin, const char* end) {
+    if (format == line_format::UNKNOWN) {
+      value_parser parser(begin, end);
+      if (parser.at_end()) return;
+      if (*parser.pos == '{') {
+        format = line_format::OBJECTS;
+      } else {
+        format = line_format::VALUES;
+        add_column("X1");
+      }
+    }
+
+    // 1. parse the lines of each thread's share of the chunk. A parse
+    // error is rethrown here by in_parallel.
+    in_parallel([&](size_t thread_id, size_t nthreads) {
+      const char* range_begin = line_boundary(begin, end, thread_id, nthreads);
+      const char* range_end = line_boundary(begin, end, thread_id + 1, nthreads);
+      for (auto& buffer: thread_columns[thread_id]) buffer.clear();
+      thread_num_rows[thread_id] = 0;
+      parse_lines(range_begin, range_end, thread_id);
+    });
+
+    std::vector<size_t> thread_row_begin(num_threads, 0);
+    size_t chunk_rows = 0;
+    for (size_t t = 0; t < num_threads; ++t) {
+      thread_row_begin[t] = chunk_rows;
+      chunk_rows += thread_num_rows[t];
+    }
+
+    // 2. create the columns of the keys seen for the first time
+    for (size_t c = columns.size(); c < column_names.size(); ++c) {
+      add_column(column_names[c]);
+    }
+
+    // 3. append the chunk to every column
+    parallel_for(0, columns.size(), [&](size_t c) {
+      output_column& column = columns[c];
+      if (!column.typed) {
+        flex_type_enum type = flex_type_enum::UNDEFINED;
+        for (size_t t = 0; t < num_threads; ++t) {
+          if (c >= thread_columns[t].size()) continue;
+          for (const auto& value: thread_columns[t][c]) {
+            type = combine_types(type, value.second.get_type());
+          }
+        }
+        // nothing to write until the column has a type
+        if (type == flex_type_enum::UNDEFINED) return;
+        column.set_type(type);
+      }
+      for (size_t t = 0; t < num_threads; ++t) {
+        if (c >= thread_columns[t].size()) continue;
+        for (auto& value: thread_columns[t][c]) {
+          size_t row = total_rows + thread_row_begin[t] + value.first;
+          // a key repeated within an object: the first value wins
+          if (row < column.num_rows) continue;
+          column.fill_to(row);
+          column.write(value.second);
+        }
+      }
+      column.fill_to(total_rows + chunk_rows);
+    });
+    total_rows += chunk_rows;
+  }
+
+  /*
+   * The first line start at or after the i'th of n equal splits of
+   * [begin, end).
+   */
+  static const char* line_boundary(const char* begin, const char* end, size_t i, size_t n) {
+    if (i == 0) return begin;
+    if (i >= n) return end;
+    const char* p = begin + (end - begin) * i / n;
+    // begin always starts a line (and has no character before it)
+    if (p == begin) return begin;
+    // if p - 1 is a newline, p already starts a line
+    while (p < end && *(p - 1) != '\n') ++p;
+    return p;
+  }
+
+  void parse_lines(const char* begin, const char* end, size_t thread_id) {
+    std::vector<column_buffer>& buffers = thread_columns[thread_id];
+    size_t& row = thread_num_rows[thread_id];
+    std::string key;
+    while (begin < end) {
+      const char* line_end = std::find(begin, end, '\n');
+      value_parser parser(begin, line_end);
+      try {
+        if (!parser.at_end()) {
+          if (format == line_format::VALUES) {
+            buffers[0].push_back({row, parser.parse_value()});
+          } else {
+            if (!parser.accept('{')) throw syntax_error{"expected a JSON object"};
+            // the top level object is parsed straight into the column buffers
+            if (!parser.accept('}')) {
+              do {
+                parser.skip_whitespace();
+                parser.parse_string(key);
+                size_t c = column_index(key, thread_id);
+                if (c >= buffers.size()) buffers.resize(c + 1);
+                parser.expect(':', "expected ':'");
+                buffers[c].push_back({row, parser.parse_value()});
+              } while (parser.accept(','));
+              parser.expect('}', "expected ',' or '}'");
+            }
+          }
+          if (!parser.at_end()) throw syntax_error{"unexpected data after the value"};
+          ++row;
+        }
+      } catch (syntax_error& e) {
+        std::string line(begin, std::min<size_t>(line_end - begin, 256));
+        log_and_throw(std::string(SYNTAX_ERROR_PREFIX) + " (" + e.what + ") at character " +
+                      std::to_string(parser.pos - begin) + " of line: " + line);
+      }
+      begin = line_end + 1;
+    }
+  }
+
+  size_t column_index(const std::string& key, size_t thread_id) {
+    auto& cache = key_caches[thread_id];
+    auto iter = cache.find(key);
+    if (iter != cache.end()) return iter->second;
+    std::lock_guard<mutex> guard(column_names_lock);
+    auto global_iter = column_ids.find(key);
+    size_t c;
+    if (global_iter != column_ids.end()) {
+      c = global_iter->second;
+    } else {
+      c = column_names.size();
+      column_ids[key] = c;
+      column_names.push_back(key);
+    }
+    cache[key] = c;
+    return c;
+  }
+
+  void add_column(const std::string& name) {
+    output_column column;
+    column.name = name;
+    column.data = std::make_shared<sarray<flexible_type>>();
+    column.data->open_for_write(1);
+    columns.push_back(std::move(column));
+    for (auto& buffers: thread_columns) buffers.resize(columns.size());
+  }
+
+  size_t num_threads;
+  line_format format = line_format::UNKNOWN;
+  size_t total_rows = 0;
+  timer ti;
+
+  std::vector<output_column> columns;
+  std::vector<std::vector<column_buffer>> thread_columns;
+  std::vector<size_t> thread_num_rows;
+
+  // column ids of the keys, shared between the threads
+  mutex column_names_lock;
+  std::unordered_map<std::string, size_t> column_ids;
+  std::vector<std::string> column_names;
+  std::vector<std::unordered_map<std::string, size_t>> key_caches;
+};
+
+} // anonymous namespace
+
+
+gl_sframe read_json_lines(const std::string& url) {
+  json_lines_reader reader;
+  bool found_file = false;
+  for (const auto& file: fileio::get_glob_files(url)) {
+    if (file.second != fileio::file_status::REGULAR_FILE) continue;
+    found_file = true;
+    general_ifstream fin(file.first);
+    if (!fin.good()) log_and_throw("Cannot open " + sanitize_url(file.first));
+    reader.read(fin);
+  }
+  if (!found_file) {
+    log_and_throw(std::string("No files corresponding to the specified path (") +
+                  sanitize_url(url) + std::string(")."));
+  }
+  return gl_sframe(reader.finish());
+}
+
+} // namespace JSON
+} // namespace graphlab
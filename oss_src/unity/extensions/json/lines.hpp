@@ -0,0 +1,16 @@
+#include <unity/lib/gl_sframe.hpp>
+
+namespace graphlab {
+  namespace JSON {
+    // Reads a file of newline-delimited JSON values into an SFrame.
+    // If the first value is an object, each key becomes a column
+    // (sorted by name, missing keys are None). Otherwise all values
+    // go to a single column "X1".
+    gl_sframe read_json_lines(const std::string& url);
+
+    // Lines which are not valid JSON fail with a message starting with
+    // this prefix. SFrame.read_json falls back to the CSV parser only on
+    // these errors.
+    const char* const SYNTAX_ERROR_PREFIX = "JSON syntax error";
+  }
+}
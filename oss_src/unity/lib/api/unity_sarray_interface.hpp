@@ -34,8 +34,9 @@ GENERATE_INTERFACE_AND_PROXY(unity_sarray_base, unity_sarray_proxy,
       (std::shared_ptr<unity_sarray_base>, head, (size_t))
       (std::vector<flexible_type>, _head, (size_t))
       (std::shared_ptr<unity_sarray_base>, vector_slice, (size_t)(size_t))
-      (std::shared_ptr<unity_sarray_base>, transform, (const std::string&)(flex_type_enum)(bool)(int))
+      (std::shared_ptr<unity_sarray_base>, transform, (const std::string&)(flex_type_enum)(bool)(int)(bool))
       (std::shared_ptr<unity_sarray_base>, transform_native, (const function_closure_info&)(flex_type_enum)(bool)(int))
+      (std::shared_ptr<unity_sarray_base>, transform_expression, (const flexible_type&)(flex_type_enum)(bool))
       (std::shared_ptr<unity_sarray_base>, filter, (const std::string&)(bool)(int))
       (std::shared_ptr<unity_sarray_base>, logical_filter, (std::shared_ptr<unity_sarray_base>))
       (std::shared_ptr<unity_sarray_base>, topk_index, (size_t)(bool))
@@ -59,7 +60,8 @@ GENERATE_INTERFACE_AND_PROXY(unity_sarray_base, unity_sarray_proxy,
       (std::shared_ptr<unity_sarray_base>, drop_missing_values, )
       (std::shared_ptr<unity_sarray_base>, fill_missing_values, (flexible_type))
       (std::shared_ptr<unity_sarray_base>, clip, (flexible_type)(flexible_type))
-      (std::shared_ptr<unity_sarray_base>, sample, (float)(int))
+      (std::shared_ptr<unity_sarray_base>, sample, (float)(int)(const std::string&))
+      (std::shared_ptr<unity_sarray_base>, sample_rows, (size_t)(int))
       (std::shared_ptr<unity_sarray_base>, hash, (int))
       (std::shared_ptr<unity_sarray_base>, tail, (size_t))
       (std::vector<flexible_type>, _tail, (size_t))
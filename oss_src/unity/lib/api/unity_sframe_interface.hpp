@@ -30,8 +30,9 @@ GENERATE_INTERFACE_AND_PROXY(unity_sframe_base, unity_sframe_proxy,
       (csv_parsing_errors, construct_from_csvs, (std::string)(csv_parsing_config_map)(str_flex_type_map))
       (void, clear, )
       (size_t, size, )
-      (std::shared_ptr<unity_sarray_base>, transform, (const std::string&)(flex_type_enum)(bool)(int))
+      (std::shared_ptr<unity_sarray_base>, transform, (const std::string&)(flex_type_enum)(bool)(int)(bool))
       (std::shared_ptr<unity_sarray_base>, transform_native, (const function_closure_info&)(flex_type_enum)(bool)(int))
+      (std::shared_ptr<unity_sarray_base>, transform_expression, (const flexible_type&)(flex_type_enum)(bool))
       (std::shared_ptr<unity_sframe_base>, flat_map, (const std::string&)(std::vector<std::string>)
                                      (std::vector<flex_type_enum>)(bool)(int))
       (void, save_frame, (std::string) )
@@ -54,8 +55,10 @@ GENERATE_INTERFACE_AND_PROXY(unity_sframe_base, unity_sframe_proxy,
       (void, swap_columns, (size_t)(size_t))
       (void, begin_iterator, )
       (std::vector<std::vector<flexible_type>>, iterator_get_next, (size_t))
+      (std::vector<std::vector<flexible_type>>, iterator_get_next_columns, (size_t))
       (void, save_as_csv, (const std::string&)(csv_parsing_config_map))
-      (std::shared_ptr<unity_sframe_base>, sample, (float)(int))
+      (std::shared_ptr<unity_sframe_base>, sample, (float)(int)(const std::string&))
+      (std::shared_ptr<unity_sframe_base>, sample_rows, (size_t)(int))
       (std::list<std::shared_ptr<unity_sframe_base>>, random_split, (float)(int))
       (std::shared_ptr<unity_sframe_base>, groupby_aggregate, (const std::vector<std::string>&)
                                               (const std::vector<std::vector<std::string>>&)
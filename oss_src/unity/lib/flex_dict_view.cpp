@@ -6,11 +6,80 @@
  * of the BSD license. See the LICENSE file for details.
  */
 #include <vector>
+#include <cmath>
 #include <flexible_type/flexible_type.hpp>
 #include <unity/lib/flex_dict_view.hpp>
 
 namespace graphlab {
 
+  namespace {
+    /*
+     * Whether keys of the type are hashed by flex_dict_key_set. These types
+     * only compare equal to each other.
+     */
+    inline bool is_hashed_key_type(flex_type_enum type) {
+      return type == flex_type_enum::INTEGER || type == flex_type_enum::FLOAT ||
+          type == flex_type_enum::STRING || type == flex_type_enum::UNDEFINED;
+    }
+
+    /*
+     * Integers compare equal to floats after conversion to double; both
+     * hash through the integral value of that double.
+     */
+    inline size_t hash_numeric_key(double value) {
+      if (std::isnan(value)) return flexible_type(value).hash();
+      if (value == std::floor(value) && std::fabs(value) < 9.2e18) {
+        return flexible_type(flex_int(value)).hash();
+      }
+      return flexible_type(value).hash();
+    }
+  }
+
+  const size_t flex_dict_key_set::npos;
+
+  size_t flex_dict_key_set::key_hash::operator()(const flexible_type& key) const {
+    switch(key.get_type()) {
+     case flex_type_enum::INTEGER:
+       return hash_numeric_key(double(key.get<flex_int>()));
+     case flex_type_enum::FLOAT:
+       return hash_numeric_key(key.get<flex_float>());
+     default:
+       return key.hash();
+    }
+  }
+
+  flex_dict_key_set::flex_dict_key_set(const std::vector<flexible_type>& keys) {
+    for (const auto& key: keys) insert(key);
+  }
+
+  size_t flex_dict_key_set::insert(const flexible_type& key) {
+    size_t id = find(key);
+    if (id != npos) return id;
+    id = m_num_ids++;
+    if (is_hashed_key_type(key.get_type())) {
+      m_hashed.insert(std::make_pair(key, id));
+    } else {
+      m_others.push_back(std::make_pair(key, id));
+    }
+    return id;
+  }
+
+  size_t flex_dict_key_set::find(const flexible_type& key) const {
+    size_t id = npos;
+    if (is_hashed_key_type(key.get_type())) {
+      auto iter = m_hashed.find(key);
+      if (iter != m_hashed.end()) id = iter->second;
+    } else {
+      for (const auto& hashed: m_hashed) {
+        if (hashed.first == key) id = std::min(id, hashed.second);
+      }
+    }
+    for (const auto& other: m_others) {
+      if (other.second < id && other.first == key) id = other.second;
+    }
+    return id;
+  }
+
   flex_dict_view::flex_dict_view(const flex_dict& value) {
     m_flex_dict_ptr = &value;
   }
@@ -24,12 +93,29 @@ namespace graphlab {
     log_and_throw("Cannot construct a flex_dict_view object from type ");
   }
 
-  const flexible_type& flex_dict_view::operator[](const flexible_type& key) const {
-    for(const auto& value : (*m_flex_dict_ptr)) {
-      if (value.first == key) {
-        return value.second;
+  size_t flex_dict_view::find(const flexible_type& key) const {
+    if (!m_index && m_flex_dict_ptr->size() >= INDEX_MIN_SIZE && ++m_num_lookups > 1) {
+      m_index = std::make_shared<flex_dict_key_set>();
+      for (size_t i = 0; i < m_flex_dict_ptr->size(); ++i) {
+        size_t id = m_index->insert((*m_flex_dict_ptr)[i].first);
+        if (id == m_index_positions.size()) m_index_positions.push_back(i);
       }
     }
+    if (m_index) {
+      size_t id = m_index->find(key);
+      return id == flex_dict_key_set::npos ? id : m_index_positions[id];
+    }
+    for (size_t i = 0; i < m_flex_dict_ptr->size(); ++i) {
+      if ((*m_flex_dict_ptr)[i].first == key) return i;
+    }
+    return flex_dict_key_set::npos;
+  }
+
+  const flexible_type& flex_dict_view::operator[](const flexible_type& key) const {
+    size_t position = find(key);
+    if (position != flex_dict_key_set::npos) {
+      return (*m_flex_dict_ptr)[position].second;
+    }
 
     std::stringstream s;
     s << "Cannot find key " << key << " in flex_dict.";
@@ -37,13 +123,7 @@ namespace graphlab {
   }
 
   bool flex_dict_view::has_key(const flexible_type& key) const {
-    for(const auto& value : (*m_flex_dict_ptr)) {
-      if (value.first == key) {
-        return true;
-      }
-    }
-
-    return false;
+    return find(key) != flex_dict_key_set::npos;
   }
 
   size_t flex_dict_view::size() const {
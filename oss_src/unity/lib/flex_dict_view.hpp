@@ -9,11 +9,65 @@
 #ifndef GRAPHLAB_UNITY_FLEX_DICT_HPP
 #define GRAPHLAB_UNITY_FLEX_DICT_HPP
 
+#include <memory>
 #include <vector>
+#include <unordered_map>
 #include <flexible_type/flexible_type.hpp>
 
 namespace graphlab {
 
+  /**
+   * A set of keys for repeated lookups of flex_dict keys, with the same
+   * semantics as comparing the keys with ==.
+   *
+   * Each distinct key gets an id, in the order the keys are inserted.
+   * Integer, float, string and undefined keys are hashed, with integral
+   * floats hashed as integers since 1 == 1.0. Keys of other types (which
+   * may compare equal across types, like a datetime and an integer) are
+   * compared one by one.
+   */
+  class flex_dict_key_set {
+  public:
+    static const size_t npos = size_t(-1);
+
+    flex_dict_key_set() { }
+
+    /**
+     * Constructs the set of the given keys. Key ids follow the order of the
+     * first occurrence of each key.
+     */
+    explicit flex_dict_key_set(const std::vector<flexible_type>& keys);
+
+    /**
+     * Adds a key, returning its id. If an equal key was added before, its id
+     * is returned instead.
+     */
+    size_t insert(const flexible_type& key);
+
+    /**
+     * Returns the id of the first inserted key equal to key, or npos.
+     */
+    size_t find(const flexible_type& key) const;
+
+    /**
+     * Returns whether a key equal to key is in the set
+     */
+    bool contains(const flexible_type& key) const { return find(key) != npos; }
+
+    /**
+     * Returns the number of distinct keys
+     */
+    size_t size() const { return m_num_ids; }
+
+  private:
+    struct key_hash {
+      size_t operator()(const flexible_type& key) const;
+    };
+    std::unordered_map<flexible_type, size_t, key_hash> m_hashed;
+    std::vector<std::pair<flexible_type, size_t> > m_others;
+    size_t m_num_ids = 0;
+  };
+
   /**
    * A thin wrapper around flex_dict to facilitate access of the underneath
    * sparse vector.
@@ -23,7 +77,10 @@ namespace graphlab {
    *   flex_dict_view value = (*sa_iter);
    *
    * Internally, sparse vector points to a flex_dict structure. It will not make
-   * copy of the data to avoid memory allocation
+   * copy of the data to avoid memory allocation.
+   *
+   * Key lookups scan the dictionary, except on large dictionaries looked up
+   * repeatedly, where a hash index of the keys is built on the second lookup.
   **/
   class flex_dict_view {
   public:
@@ -78,9 +135,26 @@ namespace graphlab {
      */
     flex_dict::const_iterator end() const;
 
+    /**
+     * The smallest dictionary for which key lookups build a hash index
+     */
+    static const size_t INDEX_MIN_SIZE = 16;
+
   private:
+    /**
+     * Returns the position of the first entry with the given key, or
+     * flex_dict_key_set::npos
+     */
+    size_t find(const flexible_type& key) const;
+
     const flex_dict* m_flex_dict_ptr;
 
+    // the key index and the position of the first entry of each key id,
+    // built on demand
+    mutable std::shared_ptr<flex_dict_key_set> m_index;
+    mutable std::vector<size_t> m_index_positions;
+    mutable size_t m_num_lookups = 0;
+
     // keys and values are lazily materialized when queried
     std::vector<flexible_type> m_keys;
     std::vector<flexible_type> m_values;
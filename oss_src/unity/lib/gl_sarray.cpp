@@ -435,10 +435,13 @@ gl_sarray gl_sarray::filter(std::function<bool(const flexible_type&)> fn,
 }
 
 gl_sarray gl_sarray::sample(double fraction) const {
-  return get_proxy()->sample(fraction, time(NULL));
+  return get_proxy()->sample(fraction, time(NULL), "row");
 }
 gl_sarray gl_sarray::sample(double fraction, size_t seed) const {
-  return get_proxy()->sample(fraction, seed);
+  return get_proxy()->sample(fraction, seed, "row");
+}
+gl_sarray gl_sarray::sample_rows(size_t num_rows, size_t seed) const {
+  return get_proxy()->sample_rows(num_rows, seed);
 }
 bool gl_sarray::all() const {
   return get_proxy()->all();
@@ -1027,6 +1027,18 @@ class gl_sarray {
    */
   gl_sarray sample(double fraction, size_t seed) const;
 
+  /**
+   * Create an \ref gl_sarray which contains exactly min(num_rows, size())
+   * elements of the current \ref gl_sarray, sampled uniformly without
+   * replacement. The elements keep their original order.
+   *
+   * \param num_rows The number of elements to fetch.
+   *
+   * \param seed The random seed for the random number generator.
+   * Deterministic output is obtained if this is set to a constant.
+   */
+  gl_sarray sample_rows(size_t num_rows, size_t seed) const;
+
   /**
    * Return true if every element of the \ref gl_sarray evaluates to true. For
    * numeric \ref gl_sarray objects zeros and missing values ("None") evaluate
@@ -457,10 +457,13 @@ gl_sarray gl_sframe::apply(std::function<flexible_type(const sframe_rows::row&)>
 }
 
 gl_sframe gl_sframe::sample(double fraction) const {
-  return get_proxy()->sample(fraction, time(NULL));
+  return get_proxy()->sample(fraction, time(NULL), "row");
 }
 gl_sframe gl_sframe::sample(double fraction, size_t seed) const {
-  return get_proxy()->sample(fraction, seed);
+  return get_proxy()->sample(fraction, seed, "row");
+}
+gl_sframe gl_sframe::sample_rows(size_t num_rows, size_t seed) const {
+  return get_proxy()->sample_rows(num_rows, seed);
 }
 std::pair<gl_sframe, gl_sframe> gl_sframe::random_split(double fraction) const {
   return random_split(fraction, time(NULL));
@@ -1045,6 +1045,19 @@ class gl_sframe {
   gl_sframe sample(double fraction, size_t seed) const;
 
 
+  /**
+   * Create an \ref gl_sframe which contains exactly min(num_rows, size())
+   * rows of the current \ref gl_sframe, sampled uniformly without
+   * replacement. The rows keep their original order.
+   *
+   * \param num_rows The number of rows to fetch.
+   *
+   * \param seed The random seed for the random number generator.
+   * Deterministic output is obtained if this is set to a constant.
+   */
+  gl_sframe sample_rows(size_t num_rows, size_t seed) const;
+
+
   /**
    * Randomly split the rows of an \ref gl_sframe into two \ref gl_sframe
    * objects. The first \ref gl_sframe contains \b M rows, sampled uniformly
@@ -13,12 +13,28 @@
 #include <fileio/sanitize_url.hpp>
 #include <sframe_query_engine/util/aggregates.hpp>
 #include <unity/lib/toolkit_function_macros.hpp>
+#include <parallel/thread_local_object.hpp>
 
 
 namespace graphlab{
 
 namespace image_util{
 
+namespace {
+
+/*
+ * Per-thread buffer that encoded images are decoded into before they are
+ * resized, so that resizing an SArray of images does not allocate an
+ * intermediate decoded image per element. Buffers grown past
+ * MAX_RECYCLED_DECODE_BUFFER are released after use.
+ */
+const size_t MAX_RECYCLED_DECODE_BUFFER = 64 * 1024 * 1024;
+
+struct decode_buffer_tag;
+typedef thread_local_object<std::vector<char>, decode_buffer_tag> thread_decode_buffer;
+
+} // anonymous namespace
+
   /**
   * Return flex_vec flexible type that is sum of all images with data in vector form. 
   */
@@ -346,28 +362,39 @@ flexible_type resize_image(const flexible_type& image, size_t resized_width, siz
     log_and_throw(error);
   }
   const flex_image& src_image = image.get<flex_image>();
-  char* resized_data;
-  if (src_image.is_decoded()) {
-    // skip decoding
-    image_util_detail::resize_image_impl((const char*)src_image.get_image_data(),
-        src_image.m_width, src_image.m_height, src_image.m_channels, resized_width,
-        resized_height, resized_channels, &resized_data);
+  flex_image dst_img;
+  if (src_image.is_decoded() &&
+      src_image.m_width == resized_width &&
+      src_image.m_height == resized_height &&
+      src_image.m_channels == resized_channels) {
+    // nothing to resize. Image data is never modified in place, so the
+    // pixels can be shared.
+    dst_img = src_image;
   } else {
-    // make a copy and decode
-    flexible_type tmp = image;
-    flex_image& decoded_image = tmp.mutable_get<flex_image>();
-    image_util_detail::decode_image_impl(decoded_image);
-    image_util_detail::resize_image_impl((const char*)decoded_image.get_image_data(),
-        decoded_image.m_width, decoded_image.m_height, decoded_image.m_channels, resized_width,
-        resized_height, resized_channels, &resized_data);
+    char* resized_data;
+    if (src_image.is_decoded()) {
+      // skip decoding
+      image_util_detail::resize_image_impl((const char*)src_image.get_image_data(),
+          src_image.m_width, src_image.m_height, src_image.m_channels, resized_width,
+          resized_height, resized_channels, &resized_data);
+    } else {
+      // decode into the thread's scratch buffer
+      std::vector<char>& decoded = thread_decode_buffer::get();
+      image_util_detail::decode_image_impl(src_image, decoded);
+      image_util_detail::resize_image_impl(decoded.data(),
+          src_image.m_width, src_image.m_height, src_image.m_channels, resized_width,
+          resized_height, resized_channels, &resized_data);
+      if (decoded.capacity() > MAX_RECYCLED_DECODE_BUFFER) {
+        std::vector<char>().swap(decoded);
+      }
+    }
+    dst_img.m_width = resized_width;
+    dst_img.m_height = resized_height;
+    dst_img.m_channels = resized_channels;
+    dst_img.m_format = Format::RAW_ARRAY;
+    dst_img.m_image_data_size = resized_height * resized_width * resized_channels;
+    dst_img.m_image_data.reset(resized_data);
   }
-  flex_image dst_img;
-  dst_img.m_width = resized_width;
-  dst_img.m_height = resized_height;
-  dst_img.m_channels = resized_channels;
-  dst_img.m_format = Format::RAW_ARRAY;
-  dst_img.m_image_data_size = resized_height * resized_width * resized_channels;
-  dst_img.m_image_data.reset(resized_data);
   if (!decode) {
     image_util_detail::encode_image_impl(dst_img);
   }
@@ -8,6 +8,8 @@
 #ifndef IMAGE_UTIL_DETAIL_HPP
 #define IMAGE_UTIL_DETAIL_HPP
 
+#include <algorithm>
+#include <vector>
 #include <image/io.hpp>
 #ifndef png_infopp_NULL
 #define png_infopp_NULL (png_infopp)NULL
@@ -28,6 +30,68 @@ namespace image_util_detail {
 
 using namespace boost::gil;
 
+/**
+ * For each destination row (or column) of a resize from src_len to dst_len
+ * pixels, the source row (or column) picked by resize_view with a
+ * nearest_neighbor_sampler. The sampler skips pixels falling outside of the
+ * source; those are clamped to the last row (or column) instead.
+ */
+inline std::vector<size_t> nearest_neighbor_map(size_t src_width, size_t src_height,
+                                                size_t dst_width, size_t dst_height,
+                                                bool map_rows) {
+  // the transform of resample_subimage, with no rotation
+  double src_w = std::max<double>((double)src_width - 1, 1);
+  double src_h = std::max<double>((double)src_height - 1, 1);
+  double dst_w = std::max<double>((double)((std::ptrdiff_t)dst_width - 1), 1);
+  double dst_h = std::max<double>((double)((std::ptrdiff_t)dst_height - 1), 1);
+  matrix3x2<double> mat =
+      matrix3x2<double>::get_translate(-dst_w/2.0, -dst_h/2.0) *
+      matrix3x2<double>::get_scale(src_w / dst_w, src_h / dst_h) *
+      matrix3x2<double>::get_rotate(-0.0) *
+      matrix3x2<double>::get_translate(src_w/2.0, src_h/2.0);
+
+  size_t src_len = map_rows ? src_height : src_width;
+  size_t dst_len = map_rows ? dst_height : dst_width;
+  std::vector<size_t> ret(dst_len);
+  for (size_t i = 0; i < dst_len; ++i) {
+    // Without rotation the transform is separable: x only depends on the
+    // destination x, and y on the destination y.
+    point2<std::ptrdiff_t> dst_p(map_rows ? 0 : i, map_rows ? i : 0);
+    point2<double> src_p = transform(mat, dst_p);
+    std::ptrdiff_t center = iround(map_rows ? src_p.y : src_p.x);
+    ret[i] = std::min<size_t>(std::max<std::ptrdiff_t>(center, 0), src_len - 1);
+  }
+  return ret;
+}
+
+/**
+ * Nearest neighbor resize between two images with the same number of
+ * channels. Picks the same source pixels as resize_view, but from row and
+ * column tables computed once per image rather than by transforming every
+ * destination pixel, and copies repeated rows (when upsampling) whole.
+ */
+template <size_t channels>
+void resize_nearest_detail(const char* data, size_t width, size_t height,
+                           size_t resized_width, size_t resized_height, char* buf) {
+  std::vector<size_t> xmap = nearest_neighbor_map(width, height, resized_width, resized_height, false);
+  std::vector<size_t> ymap = nearest_neighbor_map(width, height, resized_width, resized_height, true);
+  for (auto& x : xmap) x *= channels;
+  size_t resized_stride = resized_width * channels;
+  for (size_t y = 0; y < resized_height; ++y) {
+    char* out = buf + y * resized_stride;
+    if (y > 0 && ymap[y] == ymap[y - 1]) {
+      memcpy(out, out - resized_stride, resized_stride);
+      continue;
+    }
+    const char* row = data + ymap[y] * width * channels;
+    for (size_t x = 0; x < resized_width; ++x) {
+      const char* pixel = row + xmap[x];
+      for (size_t c = 0; c < channels; ++c) out[c] = pixel[c];
+      out += channels;
+    }
+  }
+}
+
 template<typename current_pixel_type, typename new_pixel_type>
 void resize_image_detail(const char* data, size_t width, size_t height, size_t channels, size_t resized_width, size_t resized_height, size_t resized_channels, char** resized_data){
   if (data == NULL){
@@ -38,6 +102,12 @@ void resize_image_detail(const char* data, size_t width, size_t height, size_t c
   // Fast path when the sizes are equal.
   if ((width == resized_width) && (height == resized_height) && (channels == resized_channels)) {
     memcpy(buf, data, len);
+  } else if (channels == resized_channels && channels == 1) {
+    resize_nearest_detail<1>(data, width, height, resized_width, resized_height, buf);
+  } else if (channels == resized_channels && channels == 3) {
+    resize_nearest_detail<3>(data, width, height, resized_width, resized_height, buf);
+  } else if (channels == resized_channels && channels == 4) {
+    resize_nearest_detail<4>(data, width, height, resized_width, resized_height, buf);
   } else {
     auto view = interleaved_view(width, height, (current_pixel_type*)data, width * channels * sizeof(char));
     auto resized_view = interleaved_view(resized_width, resized_height, (new_pixel_type*)buf,
@@ -126,6 +196,23 @@ void decode_image_impl(image_type& image) {
   image.m_format = Format::RAW_ARRAY;
 }
 
+/**
+ * Decode the pixels of an encoded image into buf, which can be reused across
+ * images.
+ */
+void decode_image_impl(const image_type& image, std::vector<char>& buf) {
+  if (image.m_format == Format::JPG) {
+    decode_jpeg((const char*)image.get_image_data(), image.m_image_data_size, buf);
+  } else if (image.m_format == Format::PNG) {
+    decode_png((const char*)image.get_image_data(), image.m_image_data_size, buf);
+  } else {
+    log_and_throw(std::string("Cannot decode image. Unknown format."));
+  }
+  if (buf.size() != image.m_width * image.m_height * image.m_channels) {
+    log_and_throw(std::string("Decoded image size does not match its dimensions."));
+  }
+}
+
 void encode_image_impl(image_type& image) {
   if (image.m_format != Format::RAW_ARRAY){
     return;
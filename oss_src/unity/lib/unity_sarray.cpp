@@ -5,7 +5,6 @@
  * This software may be modified and distributed under the terms
  * of the BSD license. See the LICENSE file for details.
  */
-#include <boost/heap/priority_queue.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/local_time/local_time.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -22,6 +21,7 @@
 #include <graphlab/util/file_line_count_estimator.hpp>
 #include <util/cityhash_gl.hpp>
 #include <util/hash_value.hpp>
+#include <util/fast_top_k.hpp>
 #include <parallel/atomic.hpp>
 #include <parallel/lambda_omp.hpp>
 #include <unity/lib/unity_sarray_binary_operations.hpp>
@@ -30,6 +30,7 @@
 #include <sframe/generic_avro_reader.hpp>
 #include <flexible_type/flexible_type_spirit_parser.hpp>
 #include <sframe/sframe_constants.hpp>
+#include <sframe/sarray_statistics.hpp>
 #include <serialization/oarchive.hpp>
 #include <serialization/iarchive.hpp>
 #include <unity/lib/auto_close_sarray.hpp>
@@ -40,6 +41,8 @@
 #include <sframe_query_engine/planning/planner.hpp>
 #include <sframe_query_engine/planning/optimization_engine.hpp>
 #include <sframe_query_engine/util/aggregates.hpp>
+#include <sframe_query_engine/algorithm/sample.hpp>
+#include <sframe_query_engine/algorithm/expression.hpp>
 #include <sframe/rolling_aggregate.hpp>
 #include <unity/lib/gl_sarray.hpp>
 #include <cmath>
@@ -65,6 +68,24 @@ static std::shared_ptr<sarray<flexible_type>> get_empty_sarray() {
   return *empty_sarray;
 }
 
+/**
+ * If the planner node is a full, unmodified physical sarray, merges the
+ * statistics persisted with its segments. Returns false if the node is
+ * anything else or if the statistics are unavailable, in which case the
+ * caller must fall back to a scan.
+ */
+static bool get_persisted_statistics(std::shared_ptr<planner_node> node,
+                                     sarray_segment_statistics& stats) {
+  if (node->operator_type != planner_node_type::SARRAY_SOURCE_NODE) return false;
+  auto sa = node->any_operator_parameters.at("sarray")
+      .as<std::shared_ptr<sarray<flexible_type>>>();
+  if (node->operator_parameters.at("begin_index") != 0 ||
+      node->operator_parameters.at("end_index") != sa->size()) {
+    return false;
+  }
+  return sa->get_statistics(stats);
+}
+
 unity_sarray::unity_sarray() {
   // make empty sarray and keep it around, reusing it whenever
   // I need an empty sarray
@@ -369,36 +390,21 @@ flex_type_enum unity_sarray::dtype() {
 }
 
 std::shared_ptr<unity_sarray_base> unity_sarray::head(size_t nrows) {
-  auto sa_head = std::make_shared<sarray<flexible_type>>();
-  sa_head->open_for_write(1);
-  sa_head->set_type(dtype());
-  auto out = sa_head->get_output_iterator(0);
-  size_t row_counter = 0;
-  if (nrows > 0) {
-    auto callback = [&out, &row_counter, nrows](size_t segment_id,
-                                                const std::shared_ptr<sframe_rows>& data) {
-      for (const auto& row : (*data)) {
-        *out = row[0];
-        ++out;
-        ++row_counter;
-        if (row_counter == nrows) return true;
-      }
-      return false;
-    };
-    query_eval::planner().materialize(this->get_planner_node(),
-                                      callback, 
-                                      1 /* process in as 1 segment */);
-  }
-  sa_head->close();
+  // The optimizer pushes the limit down into the sources where it can.
+  // Otherwise (e.g. after a filter) the limit operator stops pulling rows
+  // from its input as soon as nrows rows have been produced.
+  auto limit_node = op_limit::make_planner_node(this->get_planner_node(), nrows);
   auto ret = std::make_shared<unity_sarray>();
-  ret->construct_from_sarray(sa_head);
+  ret->construct_from_planner_node(
+      query_eval::planner().materialize_as_planner_node(limit_node));
   return ret;
 }
 
 std::shared_ptr<unity_sarray_base> unity_sarray::transform(const std::string& lambda,
                                                            flex_type_enum type,
                                                            bool skip_undefined,
-                                                           int seed) {
+                                                           int seed,
+                                                           bool memoize) {
   log_func_entry();
 
   // create a le_transform operator to lazily evaluate this
@@ -409,7 +415,8 @@ std::shared_ptr<unity_sarray_base> unity_sarray::transform(const std::string& la
                                 type,
                                 std::vector<std::string>(),
                                 skip_undefined,
-                                seed);
+                                seed,
+                                memoize);
   auto ret_unity_sarray = std::make_shared<unity_sarray>();
   ret_unity_sarray->construct_from_planner_node(lambda_node);
   return ret_unity_sarray;
@@ -443,6 +450,30 @@ std::shared_ptr<unity_sarray_base> unity_sarray::transform_native(
   return ret_sarray;
 }
 
+std::shared_ptr<unity_sarray_base> unity_sarray::transform_expression(
+    const flexible_type& expr,
+    flex_type_enum type,
+    bool skip_undefined) {
+  log_func_entry();
+  auto compiled = query_eval::compile_expression(expr, {}, {dtype()});
+  if (type == flex_type_enum::UNDEFINED) type = compiled.output_type;
+  if (type == flex_type_enum::UNDEFINED) {
+    log_and_throw("Cannot infer the type of the expression. Please specify the type.");
+  }
+
+  auto expr_fn = compiled.fn;
+  auto fn = [expr_fn, skip_undefined](const sframe_rows::row& f)->flexible_type {
+    if (skip_undefined && f[0].get_type() == flex_type_enum::UNDEFINED) {
+      return flex_undefined();
+    }
+    return expr_fn(f);
+  };
+  auto ret_sarray = std::make_shared<unity_sarray>();
+  ret_sarray->construct_from_planner_node(
+      query_eval::op_transform::make_planner_node(m_planner_node, fn, type));
+  return ret_sarray;
+}
+
 std::shared_ptr<unity_sarray_base> unity_sarray::transform_lambda(
     std::function<flexible_type(const flexible_type&)> function,
     flex_type_enum type,
@@ -551,7 +582,8 @@ std::shared_ptr<unity_sarray_base> unity_sarray::filter(const std::string& lambd
      std::static_pointer_cast<unity_sarray>(transform(lambda, 
                                                       flex_type_enum::UNDEFINED, 
                                                       skip_undefined, 
-                                                      seed)));
+                                                      seed,
+                                                      false)));
 }
 
 
@@ -585,110 +617,71 @@ unity_sarray::logical_filter(std::shared_ptr<unity_sarray_base> index) {
 }
 
 
-struct pqueue_value_type {
-flexible_type val;
-size_t segment_id;
-size_t segment_offset;
-bool operator<(const pqueue_value_type& other) const {
-return val < other.val;
-}
-};
-typedef boost::heap::priority_queue<pqueue_value_type,
-  //  darn this is ugly this defines the comparator type
-  //  as a generic std::function
-  boost::heap::compare<
-      std::function<bool(const pqueue_value_type&,
-			 const pqueue_value_type&)> > > pqueue_type;
-
 std::shared_ptr<unity_sarray_base> unity_sarray::topk_index(size_t k, bool reverse) {
   log_func_entry();
 
   unity_sarray_binary_operations::
       check_operation_feasibility(dtype(), dtype(), "<");
 
-  auto sarray_ptr = get_underlying_sarray();
-  // check that I have less than comparable of this type
+  // this also materializes the array if its length is not known, which keeps
+  // the plan below parallel sliceable.
+  size_t array_size = size();
+
+  // Pair every value with its row number, and compute the top k of every
+  // segment in parallel. Each segment emits at most k (value, row) pairs.
+  auto indexed_node = op_union::make_planner_node(
+      m_planner_node, op_range::make_planner_node(0, array_size));
+  auto topk_node = op_topk::make_planner_node(indexed_node, k, 0, reverse);
+
+  size_t num_segments = thread::cpu_count();
+  std::vector<std::vector<std::vector<flexible_type>>> segment_topk(num_segments);
+  auto callback = [&segment_topk](size_t segment_id,
+                                  const std::shared_ptr<sframe_rows>& data) {
+    for (const auto& row : (*data)) {
+      segment_topk[segment_id].push_back(row);
+    }
+    return false;
+  };
+  query_eval::planner().materialize(topk_node, callback, num_segments);
 
-  // ok done. now we need to merge the values from all of the queues
-  pqueue_type::value_compare comparator;
-  if (reverse) {
-    comparator = std::less<pqueue_value_type>();
-  } else {
-    comparator =
-        [](const pqueue_value_type& a, const pqueue_value_type& b)->bool {
-          return !(a < b);
-        };
+  // merge the per segment results
+  std::vector<std::vector<flexible_type>> candidates;
+  for (auto& subvec: segment_topk) {
+    std::move(subvec.begin(), subvec.end(), std::back_inserter(candidates));
   }
+  extract_and_sort_top_k(candidates, k,
+                         [reverse](const std::vector<flexible_type>& a,
+                                   const std::vector<flexible_type>& b) {
+                           return reverse ? (b[0] < a[0]) : (a[0] < b[0]);
+                         });
 
-  auto sarray_reader = sarray_ptr->get_reader(thread::cpu_count());
-  std::vector<pqueue_type> queues(sarray_reader->num_segments(),
-                                  pqueue_type(comparator));
-
-  // parallel insert into num-segments of priority queues
-  parallel_for(0, sarray_reader->num_segments(),
-               [&](size_t idx) {
-                 auto begin = sarray_reader->begin(idx);
-                 auto end = sarray_reader->end(idx);
-                 size_t ctr = 0;
-                 while(begin != end) {
-                   if (!((*begin).is_na())) {
-                     queues[idx].push(pqueue_value_type{*begin, idx, ctr});
-                     if (queues[idx].size() > k) queues[idx].pop();
-                   }
-                   ++ctr;
-                   ++begin;
-                 }
-               });
-  pqueue_type master_queue(comparator);
-
-  for(auto& subqueue : queues) {
-    for (auto& pqueue_value: subqueue) {
-      master_queue.push(pqueue_value);
-      if (master_queue.size() > k) master_queue.pop();
-    }
-  }
-  // good. now... split this into the collection of segments as the
-  // values to flag as true
-  std::vector<std::vector<size_t> > values_to_flag(sarray_reader->num_segments());
-  for (auto& pqueue_value: master_queue) {
-    values_to_flag[pqueue_value.segment_id].push_back(pqueue_value.segment_offset);
-  }
-  // sort the subsequences
-  for (auto& subvec: values_to_flag) {
-    std::sort(subvec.begin(), subvec.end());
+  std::vector<size_t> values_to_flag;
+  values_to_flag.reserve(candidates.size());
+  for (const auto& candidate: candidates) {
+    values_to_flag.push_back(candidate[1].get<flex_int>());
   }
+  std::sort(values_to_flag.begin(), values_to_flag.end());
 
-  // now we need to write out the segments
+  // now we need to write out the segments; 1 for each flagged row, 0 otherwise
   auto out_sarray = std::make_shared<sarray<flexible_type>>();
-  out_sarray->open_for_write(sarray_reader->num_segments());
+  out_sarray->open_for_write(num_segments);
   out_sarray->set_type(flex_type_enum::INTEGER);
 
-  parallel_for(0, sarray_reader->num_segments(),
+  parallel_for(0, num_segments,
                [&](size_t idx) {
+                 size_t begin = (idx * array_size) / num_segments;
+                 size_t end = ((idx + 1) * array_size) / num_segments;
                  auto output = out_sarray->get_output_iterator(idx);
-                 size_t ctr = 0;
-                 size_t subvecidx = 0;
-                 size_t target_elements = sarray_reader->segment_length(idx);
-                 // write some mix of 0 and 1s. outputing 1s
-                 // for each time the ctr an entry in values_to_flag[idx]
-                 while(ctr < target_elements) {
-                   // when we run out of elements in subvec we break
-                   if (subvecidx >= values_to_flag[idx].size()) break;
-                   if (values_to_flag[idx][subvecidx] == ctr) {
-                       (*output) = 1;
-                       ++subvecidx;
-                    } else {
-                       (*output) = 0;
-                    }
-                    ++output;
-                    ++ctr;
-                 }
-                 // here we have ran out of elements in the sub vector
-                 // and we just output all zeros
-                 while(ctr < target_elements) {
-                   (*output) = 0;
-                    ++output;
-                    ++ctr;
+                 auto flag_iter = std::lower_bound(values_to_flag.begin(),
+                                                   values_to_flag.end(), begin);
+                 for (size_t i = begin; i < end; ++i) {
+                   if (flag_iter != values_to_flag.end() && *flag_iter == i) {
+                     (*output) = 1;
+                     ++flag_iter;
+                   } else {
+                     (*output) = 0;
+                   }
+                   ++output;
                  }
                });
 
@@ -702,6 +695,11 @@ std::shared_ptr<unity_sarray_base> unity_sarray::topk_index(size_t k, bool rever
 
 size_t unity_sarray::num_missing() {
   log_func_entry();
+  sarray_segment_statistics stats;
+  if (get_persisted_statistics(m_planner_node, stats)) {
+    return stats.num_missing;
+  }
+
   auto reductionfn = [](const flexible_type& f, size_t& n_missing)->void {
     if (f.get_type() == flex_type_enum::UNDEFINED) ++n_missing;
   };
@@ -766,6 +764,18 @@ flexible_type unity_sarray::max() {
       max_val = std::numeric_limits<flex_float>::lowest();
     }
 
+    sarray_segment_statistics stats;
+    if (cur_type != flex_type_enum::DATETIME &&
+        get_persisted_statistics(m_planner_node, stats)) {
+      if (cur_type == flex_type_enum::INTEGER && stats.num_float == 0 && stats.num_nan == 0) {
+        if (stats.num_int == 0) return flex_undefined();
+        return stats.int_max;
+      } else if (cur_type == flex_type_enum::FLOAT && stats.num_int == 0 && stats.num_nan == 0) {
+        if (stats.num_float == 0) return flex_undefined();
+        return stats.float_max;
+      }
+    }
+
     auto reductionfn = [&](const flexible_type& f, flexible_type& maxv)->void {
                           if (f.get_type() != flex_type_enum::UNDEFINED) {
                             if (maxv.get_type() == flex_type_enum::UNDEFINED) maxv = max_val;
@@ -800,6 +810,19 @@ flexible_type unity_sarray::min() {
     } else if(cur_type == flex_type_enum::FLOAT) {
       min_val = std::numeric_limits<flex_float>::max();
     }
+
+    sarray_segment_statistics stats;
+    if (cur_type != flex_type_enum::DATETIME &&
+        get_persisted_statistics(m_planner_node, stats)) {
+      if (cur_type == flex_type_enum::INTEGER && stats.num_float == 0 && stats.num_nan == 0) {
+        if (stats.num_int == 0) return flex_undefined();
+        return stats.int_min;
+      } else if (cur_type == flex_type_enum::FLOAT && stats.num_int == 0 && stats.num_nan == 0) {
+        if (stats.num_float == 0) return flex_undefined();
+        return stats.float_min;
+      }
+    }
+
     auto reductionfn = [&](const flexible_type& f, flexible_type& minv)->void {
                     if (f.get_type() != flex_type_enum::UNDEFINED) {
                       if (minv.get_type() == flex_type_enum::UNDEFINED) minv = min_val;
@@ -832,6 +855,15 @@ flexible_type unity_sarray::sum() {
       start_val = flex_float(0);
     }
 
+    sarray_segment_statistics stats;
+    if (get_persisted_statistics(m_planner_node, stats)) {
+      if (cur_type == flex_type_enum::INTEGER && stats.num_float == 0 && stats.num_nan == 0) {
+        return stats.int_sum;
+      } else if (cur_type == flex_type_enum::FLOAT && stats.num_int == 0 && stats.num_nan == 0) {
+        return stats.float_sum;
+      }
+    }
+
     auto reductionfn =
         [](const flexible_type& f, flexible_type& sum)->void {
           if (f.get_type() != flex_type_enum::UNDEFINED) {
@@ -911,6 +943,12 @@ flexible_type unity_sarray::mean() {
   if(cur_type == flex_type_enum::INTEGER ||
      cur_type == flex_type_enum::FLOAT ) {
 
+    sarray_segment_statistics stats;
+    if (get_persisted_statistics(m_planner_node, stats) && stats.num_nan == 0) {
+      if (stats.num_int + stats.num_float == 0) return flex_undefined();
+      return stats.mean;
+    }
+
     std::pair<double, size_t> start_val{0.0, 0.0}; // mean, and size
     auto reductionfn =
         [](const flexible_type& f,
@@ -1019,6 +1057,13 @@ flexible_type unity_sarray::var(size_t ddof) {
         log_and_throw("Cannot calculate with degrees of freedom <= 0");
       }
 
+      sarray_segment_statistics stats;
+      if (get_persisted_statistics(m_planner_node, stats) && stats.num_nan == 0) {
+        size_t n = stats.num_int + stats.num_float;
+        if (n == 0) return flex_undefined();
+        return stats.m2 / flex_float(n - ddof);
+      }
+
       // formula from
       // http://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Incremental_Algorithm
       struct incremental_var : public IS_POD_TYPE {
@@ -1413,6 +1458,12 @@ std::shared_ptr<unity_sarray_base> unity_sarray::clip(flexible_type lower,
 
 size_t unity_sarray::nnz() {
   log_func_entry();
+  sarray_segment_statistics stats;
+  if (dtype() != flex_type_enum::DATETIME &&
+      get_persisted_statistics(m_planner_node, stats)) {
+    return stats.num_nonzero;
+  }
+
   auto reductionfn = 
       [&](const flexible_type& f, size_t& ctr)->void {
         if(!f.is_zero()) ++ctr;
@@ -1622,10 +1673,22 @@ std::shared_ptr<unity_sarray_base> unity_sarray::make_uniform_boolean_array(size
 }
 
 std::shared_ptr<unity_sarray_base> unity_sarray::sample(float percent, 
-                                                        int random_seed) {
-  // create a sequential sarray
-  auto seq = make_uniform_boolean_array(size(), percent, random_seed);
-  return logical_filter(seq);
+                                                        int random_seed,
+                                                        const std::string& method) {
+  // with the block methods the filter skips the unselected blocks
+  auto mask = std::make_shared<unity_sarray>();
+  mask->construct_from_planner_node(
+      query_eval::make_sample_mask(get_planner_node(), percent, random_seed,
+                                   query_eval::sampling_method_from_string(method)));
+  return logical_filter(mask);
+}
+
+std::shared_ptr<unity_sarray_base> unity_sarray::sample_rows(size_t num_rows,
+                                                             int random_seed) {
+  auto mask = std::make_shared<unity_sarray>();
+  mask->construct_from_planner_node(
+      query_eval::make_exact_sample_mask(get_planner_node(), num_rows, random_seed));
+  return logical_filter(mask);
 }
 
 
@@ -1984,7 +2047,7 @@ unity_sarray::dict_trim_by_keys(const std::vector<flexible_type>& keys, bool exc
     log_and_throw("Only dictionary type is supported for trim by keys.");
   }
 
-  std::set<flexible_type> keyset(keys.begin(), keys.end());
+  auto keyset = std::make_shared<flex_dict_key_set>(keys);
 
   auto transformfn = [exclude, keyset](const flexible_type& f)->flexible_type {
     if (f.get_type() == flex_type_enum::UNDEFINED) return f;
@@ -1992,7 +2055,7 @@ unity_sarray::dict_trim_by_keys(const std::vector<flexible_type>& keys, bool exc
     flex_dict ret;
     const flex_dict& input = f.get<flex_dict>();
     for(auto& val : input) {
-      bool is_in_key = val.first.get_type() == flex_type_enum::UNDEFINED ? false : keyset.count(val.first);
+      bool is_in_key = val.first.get_type() == flex_type_enum::UNDEFINED ? false : keyset->contains(val.first);
       if (exclude != is_in_key) {
         ret.push_back(std::make_pair<flexible_type, flexible_type>(
           flexible_type(val.first), flexible_type(val.second)));
@@ -2090,13 +2153,13 @@ unity_sarray::dict_has_any_keys(const std::vector<flexible_type>& keys) {
     log_and_throw("Only dictionary type is supported for trim by keys.");
   }
 
-  std::set<flexible_type> keyset(keys.begin(), keys.end());
+  auto keyset = std::make_shared<flex_dict_key_set>(keys);
 
   auto transformfn = [keyset](const flexible_type& f)->int {
     if (f.get_type() == flex_type_enum::UNDEFINED) return f;
 
     for(auto& val : f.get<flex_dict>()) {
-      bool is_in_key = val.first.get_type() == flex_type_enum::UNDEFINED ? false : keyset.count(val.first);
+      bool is_in_key = val.first.get_type() == flex_type_enum::UNDEFINED ? false : keyset->contains(val.first);
       if (is_in_key) return 1;
     }
 
@@ -2113,16 +2176,26 @@ unity_sarray::dict_has_all_keys(const std::vector<flexible_type>& keys) {
     log_and_throw("Only dictionary type is supported for trim by keys.");
   }
 
-  auto transformfn = [keys](const flexible_type& f)->int {
+  auto keyset = std::make_shared<flex_dict_key_set>(keys);
+
+  auto transformfn = [keyset](const flexible_type& f)->int {
     if (f.get_type() == flex_type_enum::UNDEFINED) return f;
 
-    // make sure each key exists in the dictionary
-    const flex_dict_view& v(f);
-    for(auto& key: keys) {
-      if (!v.has_key(key)) return 0;
+    // make sure each key exists in the dictionary: count the distinct
+    // keys found in one pass over the entries
+    const flex_dict& input = f.get<flex_dict>();
+    if (input.size() < keyset->size()) return 0;
+    std::vector<bool> found(keyset->size(), false);
+    size_t num_found = 0;
+    for(auto& val : input) {
+      size_t id = keyset->find(val.first);
+      if (id != flex_dict_key_set::npos && !found[id]) {
+        found[id] = true;
+        ++num_found;
+      }
     }
 
-    return 1;
+    return num_found == keyset->size();
   };
 
   return transform_lambda(transformfn, flex_type_enum::INTEGER, true, 0);
@@ -2415,19 +2488,32 @@ std::shared_ptr<unity_sframe_base> unity_sarray::unpack(
     }
   }
   auto coltype = dtype();
-  auto transformfn = [coltype, unpacked_keys, na_value](const sframe_rows::row& row,
-                                                        sframe_rows::row& ret) {
+  // for dictionaries, the columns of each distinct key
+  auto keyset = std::make_shared<flex_dict_key_set>();
+  auto key_columns = std::make_shared<std::vector<std::vector<size_t>>>();
+  if (coltype == flex_type_enum::DICT) {
+    for (size_t i = 0; i < unpacked_keys.size(); ++i) {
+      size_t id = keyset->insert(unpacked_keys[i]);
+      key_columns->resize(keyset->size());
+      (*key_columns)[id].push_back(i);
+    }
+  }
+  auto transformfn = [coltype, unpacked_keys, na_value, keyset, key_columns](
+      const sframe_rows::row& row, sframe_rows::row& ret) {
     const auto& val = row[0];
     if (val.get_type() == flex_type_enum::UNDEFINED) {
       for(size_t i = 0; i < ret.size() ; i++) ret[i] = FLEX_UNDEFINED;
     } else {
       if (coltype == flex_type_enum::DICT) {
-        const flex_dict_view& dict_val(val);
-        for(size_t i = 0; i < ret.size() ; i++) {
-          if (dict_val.has_key(unpacked_keys[i]) && dict_val[unpacked_keys[i]] != na_value) {
-            ret[i] = dict_val[unpacked_keys[i]];
-          } else {
-            ret[i] = FLEX_UNDEFINED;
+        // one pass over the entries; the first entry of a key wins
+        std::vector<bool> found(keyset->size(), false);
+        for(size_t i = 0; i < ret.size() ; i++) ret[i] = FLEX_UNDEFINED;
+        for(const auto& entry : val.get<flex_dict>()) {
+          size_t id = keyset->find(entry.first);
+          if (id == flex_dict_key_set::npos || found[id]) continue;
+          found[id] = true;
+          if (entry.second != na_value) {
+            for (size_t column : (*key_columns)[id]) ret[column] = entry.second;
           }
         }
       } else if(coltype == flex_type_enum::LIST) {
@@ -191,12 +191,14 @@ class unity_sarray: public unity_sarray_base {
 
   /**
    * Returns a new sarray which is a transform of this using a Python lambda
-   * function pickled into a string.
+   * function pickled into a string. If memoize is true, results are cached
+   * by input value (see lambda::pylambda_function::set_memoize).
    */
   std::shared_ptr<unity_sarray_base> transform(const std::string& lambda,
                                                flex_type_enum type,
                                                bool skip_undefined,
-                                               int seed);
+                                               int seed,
+                                               bool memoize);
 
   /**
    * Returns a new sarray which is a transform of this using a registered
@@ -208,6 +210,16 @@ class unity_sarray: public unity_sarray_base {
       bool skip_undefined,
       int seed);
 
+  /**
+   * Returns a new sarray which is a transform of this using an expression
+   * (see \ref query_eval::compile_expression), evaluated natively instead of
+   * by the lambda workers. If type is UNDEFINED, the type inferred from the
+   * expression is used.
+   */
+  std::shared_ptr<unity_sarray_base> transform_expression(const flexible_type& expr,
+                                                          flex_type_enum type,
+                                                          bool skip_undefined);
+
   std::shared_ptr<unity_sarray_base> transform_lambda(std::function<flexible_type(const flexible_type&)> lambda,
                                                       flex_type_enum type,
                                                       bool skip_undefined,
@@ -512,8 +524,17 @@ class unity_sarray: public unity_sarray_base {
   /**
    * Returns a uniform random sample of the sarray, that contains percent of
    * the total elements, without replacement, using the random_seed.
+   * method is a name accepted by query_eval::sampling_method_from_string.
+   */
+  std::shared_ptr<unity_sarray_base> sample(float percent, int random_seed,
+                                            const std::string& method);
+
+  /**
+   * Returns a uniform random sample of the sarray with exactly
+   * min(num_rows, size()) elements, without replacement, using the
+   * random_seed.
    */
-  std::shared_ptr<unity_sarray_base> sample(float percent, int random_seed);
+  std::shared_ptr<unity_sarray_base> sample_rows(size_t num_rows, int random_seed);
 
   /**
    * Returns an SArray of type flex_int that contains the hash of each element.
@@ -31,6 +31,8 @@
 #include <sframe_query_engine/algorithm/sort.hpp>
 #include <sframe_query_engine/algorithm/ec_sort.hpp>
 #include <sframe_query_engine/algorithm/groupby_aggregate.hpp>
+#include <sframe_query_engine/algorithm/sample.hpp>
+#include <sframe_query_engine/algorithm/expression.hpp>
 #include <sframe_query_engine/operators/operator_properties.hpp>
 #include <lambda/pylambda_function.hpp>
 #include <exceptions/error_types.hpp>
@@ -565,12 +567,13 @@ void unity_sframe::set_sframe(const std::shared_ptr<sframe>& sf_ptr) {
 std::shared_ptr<unity_sarray_base> unity_sframe::transform(const std::string& lambda,
                                            flex_type_enum type,
                                            bool skip_undefined, // unused
-                                           int random_seed) {
+                                           int random_seed,
+                                           bool memoize) {
   log_func_entry();
   auto new_planner_node = op_lambda_transform::make_planner_node(
       this->get_planner_node(), lambda, type,
       this->column_names(),
-      skip_undefined, random_seed);
+      skip_undefined, random_seed, memoize);
 
   std::shared_ptr<unity_sarray> ret(new unity_sarray());
   ret->construct_from_planner_node(new_planner_node);
@@ -604,6 +607,19 @@ std::shared_ptr<unity_sarray_base> unity_sframe::transform_native(const function
   return this->transform_lambda(lambda, type, seed);
 }
 
+std::shared_ptr<unity_sarray_base> unity_sframe::transform_expression(
+    const flexible_type& expr,
+    flex_type_enum type,
+    bool skip_undefined /* unused, as for transform */) {
+  log_func_entry();
+  auto compiled = query_eval::compile_expression(expr, column_names(), dtype());
+  if (type == flex_type_enum::UNDEFINED) type = compiled.output_type;
+  if (type == flex_type_enum::UNDEFINED) {
+    log_and_throw("Cannot infer the type of the expression. Please specify the type.");
+  }
+  return this->transform_lambda(compiled.fn, type, -1);
+}
+
 std::shared_ptr<unity_sarray_base> unity_sframe::transform_lambda(
       std::function<flexible_type(const sframe_rows::row&)> lambda,
       flex_type_enum type,
@@ -691,31 +707,13 @@ std::vector<std::string> unity_sframe::column_names() {
 std::shared_ptr<unity_sframe_base> unity_sframe::head(size_t nrows) {
   log_func_entry();
 
-  // prepare for writing to the new sframe
-  sframe sf_head;
-  sf_head.open_for_write(column_names(), dtype(), "", 1);
-  auto out = sf_head.get_output_iterator(0);
-
-  size_t row_counter = 0;
-  if (nrows > 0)  {
-    auto callback = [&out, &row_counter, nrows](size_t segment_id,
-                                                const std::shared_ptr<sframe_rows>& data) {
-      for (const auto& row : (*data)) {
-        *out = row;
-        ++out;
-        ++row_counter;
-        if (row_counter == nrows) return true;
-      }
-      return false;
-    };
-
-    query_eval::planner().materialize(this->get_planner_node(),
-                                      callback,
-                                      1 /* process in as 1 segment */);
-  }
-  sf_head.close();
+  // The optimizer pushes the limit down into the sources where it can.
+  // Otherwise (e.g. after a filter) the limit operator stops pulling rows
+  // from its input as soon as nrows rows have been produced.
+  auto limit_node = op_limit::make_planner_node(this->get_planner_node(), nrows);
   std::shared_ptr<unity_sframe> ret(new unity_sframe());
-  ret->construct_from_sframe(sf_head);
+  ret->construct_from_planner_node(planner().materialize_as_planner_node(limit_node),
+                                   this->column_names());
   return ret;
 }
 
@@ -831,6 +829,11 @@ std::shared_ptr<unity_sframe_base> unity_sframe::append(
 void unity_sframe::begin_iterator() {
   log_func_entry();
 
+  // the read ahead uses the current reader
+  if (iterator_prefetch.valid()) iterator_prefetch.wait();
+  iterator_prefetch = decltype(iterator_prefetch)();
+  iterator_next_row = 0;
+
   // Empty sframe just return
   if (this->size() == 0)
     return;
@@ -873,6 +876,56 @@ std::vector< std::vector<flexible_type> > unity_sframe::iterator_get_next(size_t
   return ret;
 }
 
+/*
+ * Reads rows [row_start, row_end) of the reader by column.
+ */
+static std::vector<std::vector<flexible_type>> read_columns(sframe_reader* reader,
+                                                            size_t row_start,
+                                                            size_t row_end) {
+  sframe_rows rows;
+  reader->read_rows(row_start, row_end, rows);
+  auto& columns = rows.get_columns();
+  std::vector<std::vector<flexible_type>> ret(reader->num_columns());
+  for (size_t i = 0; i < columns.size(); ++i) ret[i] = std::move(*columns[i]);
+  return ret;
+}
+
+std::vector< std::vector<flexible_type> > unity_sframe::iterator_get_next_columns(size_t len) {
+  // Empty sframe just return
+  if (this->size() == 0) {
+    return std::vector<std::vector<flexible_type>>(this->num_columns());
+  }
+
+  size_t nrows = iterator_sframe_ptr->size();
+  size_t row_start = iterator_next_row;
+  size_t row_end = std::min(row_start + len, nrows);
+
+  std::vector<std::vector<flexible_type>> ret;
+  bool have_rows = false;
+  if (iterator_prefetch.valid()) {
+    auto prefetched = iterator_prefetch.get();
+    if (iterator_prefetch_range == std::make_pair(row_start, row_end)) {
+      ret = std::move(prefetched);
+      have_rows = true;
+    }
+  }
+  if (!have_rows) ret = read_columns(iterator_sframe_ptr.get(), row_start, row_end);
+  iterator_next_row = row_end;
+
+  // read the next block ahead, assuming it will have the same length
+  if (row_end < nrows && len > 0) {
+    sframe_reader* reader = iterator_sframe_ptr.get();
+    size_t next_end = std::min(row_end + len, nrows);
+    iterator_prefetch_range = {row_end, next_end};
+    iterator_prefetch = std::async(std::launch::async, [reader, row_end, next_end]() {
+      return read_columns(reader, row_end, next_end);
+    });
+  }
+  return ret;
+}
+
+static const size_t SAVE_AS_CSV_COPY_BUFFER_SIZE = 4 * 1024 * 1024;
+
 void unity_sframe::save_as_csv(const std::string& url,
                                std::map<std::string, flexible_type> writing_config) {
   log_func_entry();
@@ -963,27 +1016,84 @@ void unity_sframe::save_as_csv(const std::string& url,
 
   if (writer.header) writer.write_verbatim(fout, this->column_names());
   
-  bool first_value = true;
-  auto write_callback = [&writer, &fout, &line_prefix, 
-       &no_prefix_on_first_value, &first_value]
-      (size_t segment_id, const std::shared_ptr<sframe_rows>& data) {
+  /*
+   * Each segment is formatted by its own thread with its own copy of the
+   * writer (which is not thread safe). Segment 0 streams straight to the
+   * output and the other segments to temporary files, which are then
+   * appended in order.
+   *
+   * The line prefix of a row is skipped only for the very first row
+   * written when no_prefix_on_first_value is set. Whether the first row of
+   * a later segment is the first row written depends on whether all
+   * segments before it are empty, so that prefix is only written when the
+   * segment is appended.
+   */
+  size_t num_segments = SFRAME_DEFAULT_NUM_SEGMENTS;
+  int64_t length = infer_planner_node_length(this->get_planner_node());
+  if (length >= 0 && (size_t)length < SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS) num_segments = 1;
+
+  std::vector<csv_writer> writers(num_segments, writer);
+  std::vector<size_t> rows_written(num_segments, 0);
+  std::vector<std::string> segment_files(num_segments);
+  std::vector<std::unique_ptr<general_ofstream>> segment_outputs(num_segments);
+
+  auto write_callback = [&](size_t segment_id, const std::shared_ptr<sframe_rows>& data) {
+    std::ostream* out = &fout;
+    if (segment_id > 0) {
+      if (!segment_outputs[segment_id]) {
+        segment_files[segment_id] = get_temp_name();
+        segment_outputs[segment_id].reset(new general_ofstream(segment_files[segment_id]));
+      }
+      out = segment_outputs[segment_id].get();
+    }
+    csv_writer& segment_writer = writers[segment_id];
+    size_t& nrows = rows_written[segment_id];
     for (const auto& row : *(data)) {
-      if (!line_prefix.empty()) {
-        if ((!first_value) || // not the first value. write the line prefix
-            (!no_prefix_on_first_value) // first value, write line prefix if
-                                        // no_prefix_on_first_value == false
-                                        // (yes the double negative is annoying)
-            ) {
-          fout.write(line_prefix.c_str(), line_prefix.size());
-        } 
+      if (!line_prefix.empty() &&
+          (nrows > 0 || (segment_id == 0 && !no_prefix_on_first_value))) {
+        out->write(line_prefix.c_str(), line_prefix.size());
       }
-      first_value = false;
-      writer.write(fout, row);
+      ++nrows;
+      segment_writer.write(*out, row);
     }
+    if (!out->good()) log_and_throw_io_failure("Fail to write.");
     return false;
   };
 
-  query_eval::planner().materialize(this->get_planner_node(), write_callback, 1);
+  auto cleanup_segments = [&]() {
+    for (size_t i = 1; i < num_segments; ++i) {
+      segment_outputs[i].reset();
+      if (!segment_files[i].empty()) delete_temp_file(segment_files[i]);
+    }
+  };
+
+  try {
+    query_eval::planner().materialize(this->get_planner_node(),
+                                      write_callback, num_segments);
+    bool any_rows_written = rows_written[0] > 0;
+    std::vector<char> buffer(SAVE_AS_CSV_COPY_BUFFER_SIZE);
+    for (size_t i = 1; i < num_segments; ++i) {
+      if (!segment_outputs[i]) continue;
+      segment_outputs[i]->close();
+      segment_outputs[i].reset();
+      if (rows_written[i] == 0) continue;
+      if (!line_prefix.empty() && (any_rows_written || !no_prefix_on_first_value)) {
+        fout.write(line_prefix.c_str(), line_prefix.size());
+      }
+      any_rows_written = true;
+      general_ifstream fin(segment_files[i]);
+      while (fin.good()) {
+        fin.read(buffer.data(), buffer.size());
+        fout.write(buffer.data(), fin.gcount());
+      }
+      if (!fin.eof()) log_and_throw_io_failure("Fail to read " + segment_files[i]);
+    }
+  } catch (...) {
+    cleanup_segments();
+    throw;
+  }
+  cleanup_segments();
+
   if (!fout.good()) {
     log_and_throw_io_failure("Fail to write.");
   }
@@ -992,10 +1102,23 @@ void unity_sframe::save_as_csv(const std::string& url,
 }
 
 std::shared_ptr<unity_sframe_base> unity_sframe::sample(float percent,
-                                                        int random_seed) {
-  logstream(LOG_INFO) << "Args: " << percent << ", " << random_seed << std::endl;
-  auto logical_filter_array = std::static_pointer_cast<unity_sarray>(
-    unity_sarray::make_uniform_boolean_array(size(), percent, random_seed));
+                                                        int random_seed,
+                                                        const std::string& method) {
+  logstream(LOG_INFO) << "Args: " << percent << ", " << random_seed << ", "
+                      << method << std::endl;
+  auto logical_filter_array = std::make_shared<unity_sarray>();
+  logical_filter_array->construct_from_planner_node(
+      query_eval::make_sample_mask(get_planner_node(), percent, random_seed,
+                                   query_eval::sampling_method_from_string(method)));
+  return logical_filter(logical_filter_array);
+}
+
+std::shared_ptr<unity_sframe_base> unity_sframe::sample_rows(size_t num_rows,
+                                                             int random_seed) {
+  logstream(LOG_INFO) << "Args: " << num_rows << ", " << random_seed << std::endl;
+  auto logical_filter_array = std::make_shared<unity_sarray>();
+  logical_filter_array->construct_from_planner_node(
+      query_eval::make_exact_sample_mask(get_planner_node(), num_rows, random_seed));
   return logical_filter(logical_filter_array);
 }
 
@@ -1029,8 +1152,12 @@ unity_sframe::random_split(float percent, int random_seed) {
   log_func_entry();
   logstream(LOG_INFO) << "Args: " << percent << ", " << random_seed << std::endl;
 
-  auto logical_filter_array = std::static_pointer_cast<unity_sarray>(
-    unity_sarray::make_uniform_boolean_array(size(), percent, random_seed));
+  // both halves are read in full, so there is nothing to gain from
+  // sampling whole blocks
+  auto logical_filter_array = std::make_shared<unity_sarray>();
+  logical_filter_array->construct_from_planner_node(
+      query_eval::make_sample_mask(get_planner_node(), percent, random_seed,
+                                   query_eval::sampling_method::ROW_BERNOULLI));
   return logical_filter_split(logical_filter_array);
 }
 
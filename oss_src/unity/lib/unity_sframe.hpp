@@ -9,6 +9,7 @@
 #define GRAPHLAB_UNITY_SFRAME_HPP
 
 #include <memory>
+#include <future>
 #include <string>
 #include <vector>
 #include <unity/lib/api/unity_sframe_interface.hpp>
@@ -254,12 +255,15 @@ class unity_sframe : public unity_sframe_base {
 
   /**
    * Returns a new sarray which is a transform of each row in the sframe
-   * using a Python lambda function pickled into a string.
+   * using a Python lambda function pickled into a string. If memoize is
+   * true, results are cached by input row (see
+   * lambda::pylambda_function::set_memoize).
    */
   std::shared_ptr<unity_sarray_base> transform(const std::string& lambda,
                                                flex_type_enum type,
                                                bool skip_undefined,
-                                               int seed);
+                                               int seed,
+                                               bool memoize);
 
 
   /**
@@ -271,6 +275,16 @@ class unity_sframe : public unity_sframe_base {
                                                       bool skip_undefined,
                                                       int seed);
 
+  /**
+   * Returns a new sarray which is a transform of each row in the sframe
+   * using an expression (see \ref query_eval::compile_expression), evaluated
+   * natively instead of by the lambda workers. If type is UNDEFINED, the
+   * type inferred from the expression is used.
+   */
+  std::shared_ptr<unity_sarray_base> transform_expression(const flexible_type& expr,
+                                                          flex_type_enum type,
+                                                          bool skip_undefined);
+
   /**
    * Returns a new sarray which is a transform of each row in the sframe
    * using a Python lambda function pickled into a string.
@@ -358,6 +372,22 @@ class unity_sframe : public unity_sframe_base {
    */
   std::vector< std::vector<flexible_type> > iterator_get_next(size_t len);
 
+  /**
+   * Obtains the next block of up to len rows from the SFrame, by column:
+   * the result holds one vector per column, each of the same length.
+   * Works together with \ref begin_iterator(), but keeps its own position:
+   * do not mix it with \ref iterator_get_next() in one iteration.
+   *
+   * The rows are read a column at a time, without building a vector per
+   * row. While the caller consumes a block, the next block of the same
+   * length is read ahead on a background thread.
+   *
+   * \param len The number of rows to return
+   * \returns The columns of the next rows. The columns are shorter than len
+   * only at the end of the SFrame.
+   */
+  std::vector< std::vector<flexible_type> > iterator_get_next_columns(size_t len);
+
   /**
    * Save the sframe to url in csv format.
    * To keep the interface stable, the CSV parsing configuration read from a
@@ -393,10 +423,22 @@ class unity_sframe : public unity_sframe_base {
 
   /**
    * Sample the rows of sframe uniformly with ratio = percent, and seed = random_seed.
+   * method is a name accepted by query_eval::sampling_method_from_string;
+   * "row" selects every row independently, the block methods keep or drop
+   * whole storage blocks.
    *
    * Returns unity_sframe* containing the sampled rows.
    */
-  std::shared_ptr<unity_sframe_base> sample(float percent, int random_seed);
+  std::shared_ptr<unity_sframe_base> sample(float percent, int random_seed,
+                                            const std::string& method);
+
+  /**
+   * Sample exactly min(num_rows, size()) rows of the sframe uniformly
+   * without replacement, with seed = random_seed.
+   *
+   * Returns unity_sframe* containing the sampled rows.
+   */
+  std::shared_ptr<unity_sframe_base> sample_rows(size_t num_rows, int random_seed);
 
   /**
    * materialize the sframe, this is different from save() as this is a temporary persist of
@@ -587,6 +629,21 @@ class unity_sframe : public unity_sframe_base {
    */
   std::unique_ptr<sframe_iterator> iterator_current_segment_enditer;
 
+  /**
+   * Supports \ref begin_iterator() and \ref iterator_get_next_columns().
+   * The next row to read.
+   */
+  size_t iterator_next_row = 0;
+
+  /**
+   * Supports \ref iterator_get_next_columns(). The rows [first, second)
+   * being read ahead by iterator_prefetch. Declared after
+   * iterator_sframe_ptr so that the read ahead finishes before the reader
+   * is destroyed.
+   */
+  std::pair<size_t, size_t> iterator_prefetch_range;
+  std::future<std::vector<std::vector<flexible_type>>> iterator_prefetch;
+
 
  private:
   // Helper functions
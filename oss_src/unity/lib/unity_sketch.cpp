@@ -57,9 +57,7 @@ void unity_sketch::construct_from_sarray(
                  reader->read_rows(row_start, last_row, data);
                  std::unique_lock<graphlab::mutex> thrlocal_lock(m_thrlocks[thr]);
 
-                 for (const flexible_type& val: data) {
-                    accumulate_one_value(thr, val, key_set);
-                 }
+                 accumulate_values(thr, data, key_set);
 
                  m_thrlocal[thr].num_elements_processed += data.size();
                  m_rows_processed_by_threads.inc(data.size());
@@ -142,6 +140,28 @@ void unity_sketch::accumulate_one_value(size_t thr, const flexible_type& val, co
   }
 }
 
+void unity_sketch::accumulate_values(size_t thr, const std::vector<flexible_type>& vals, const std::unordered_set<flexible_type>& keys) {
+  if (m_is_list) {
+    for (const flexible_type& val: vals) {
+      accumulate_one_value(thr, val, keys);
+    }
+    return;
+  }
+
+  // scalar columns go through the batched sketch updates
+  size_t undefined_count = 0;
+  for (const flexible_type& val: vals) {
+    undefined_count += (val.get_type() == flex_type_enum::UNDEFINED);
+  }
+  m_thrlocal[thr].undefined_count += undefined_count;
+  if (undefined_count == vals.size()) return;
+
+  if (m_is_numeric) {
+    m_thrlocal[thr].numeric_sketch.accumulate_many(vals);
+  }
+  m_thrlocal[thr].discrete_sketch.accumulate_many(vals);
+}
+
 void unity_sketch::accumulate_list_value(const flexible_type& val, size_t thr) {
   increase_nested_element_count(*m_element_sketch, thr, val.size());
 
@@ -592,6 +612,46 @@ void unity_sketch::numeric_sketch_struct::accumulate(double dval) {
   m2 += delta * (dval - mean);
 }
 
+void unity_sketch::numeric_sketch_struct::accumulate_many(const std::vector<flexible_type>& vals) {
+  // Gather the block into a dense buffer first; min/max/sum/mean/m2 of the
+  // block are then plain loops over doubles, and the block is folded into
+  // the running moments with the same pairwise update used by combine().
+  std::vector<double> dvals;
+  dvals.reserve(vals.size());
+  for (const flexible_type& val: vals) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) continue;
+    double dval = (double)val;
+    if (std::isnan(dval)) continue;
+    dvals.push_back(dval);
+  }
+  if (dvals.empty()) return;
+
+  for (double dval: dvals) quantiles->add(dval);
+
+  double block_min = dvals[0], block_max = dvals[0], block_sum = 0;
+  for (double dval: dvals) {
+    block_min = std::min(block_min, dval);
+    block_max = std::max(block_max, dval);
+    block_sum += dval;
+  }
+  double block_mean = block_sum / dvals.size();
+  double block_m2 = 0;
+  for (double dval: dvals) {
+    block_m2 += (dval - block_mean) * (dval - block_mean);
+  }
+
+  min = std::min(min, block_min);
+  max = std::max(max, block_max);
+  sum += block_sum;
+
+  size_t block_items = dvals.size();
+  double delta = block_mean - mean;
+  double total = (double)(num_items + block_items);
+  mean = mean * ((double)num_items / total) + block_mean * ((double)block_items / total);
+  m2 += block_m2 + delta * num_items * delta * block_items / total;
+  num_items += block_items;
+}
+
 void unity_sketch::numeric_sketch_struct::finalize() {
   quantiles->combine_finalize();
 }
@@ -617,6 +677,22 @@ void unity_sketch::discrete_sketch_struct::accumulate(const flexible_type& val)
   unique->add(val);
 }
 
+void unity_sketch::discrete_sketch_struct::accumulate_many(const std::vector<flexible_type>& vals) {
+  // The flexible_type hash is the expensive part; compute it once per value
+  // and share it between the count and unique sketches.
+  std::vector<size_t> hashes;
+  hashes.reserve(vals.size());
+  for (const flexible_type& val: vals) {
+    if (val.get_type() == flex_type_enum::UNDEFINED) continue;
+    if (val.get_type() == flex_type_enum::FLOAT && std::isnan(val.get<flex_float>())) continue;
+    hashes.push_back(std::hash<flexible_type>()(val));
+  }
+  count->add_hashes(hashes.data(), hashes.size());
+  unique->add_hashes(hashes.data(), hashes.size());
+  // space_saving_flextype already skips missing values and NaNs
+  frequent->add_many(vals.begin(), vals.end());
+}
+
 void unity_sketch::discrete_sketch_struct::combine(const discrete_sketch_struct& other) {
   count->combine(*(other.count));
   frequent->combine(*(other.frequent));
@@ -339,6 +339,9 @@ class unity_sketch: public unity_sketch_base {
 
     void accumulate(double dval);
 
+    /// Accumulates a block of values, skipping missing values and NaNs
+    void accumulate_many(const std::vector<flexible_type>& vals);
+
     void finalize();
   };
 
@@ -351,6 +354,9 @@ class unity_sketch: public unity_sketch_base {
 
     void accumulate(const flexible_type& val);
 
+    /// Accumulates a block of values, skipping missing values and NaNs
+    void accumulate_many(const std::vector<flexible_type>& vals);
+
     void combine(const discrete_sketch_struct& other);
   };
 
@@ -439,6 +445,7 @@ class unity_sketch: public unity_sketch_base {
   inline void accumulate_vector_value(const flexible_type& vect_val, size_t thr, const std::unordered_set<flexible_type>& keys);
   inline void accumulate_list_value(const flexible_type& rec_val, size_t thr);
   inline void accumulate_one_value(size_t thr, const flexible_type& val, const std::unordered_set<flexible_type>& keys = std::unordered_set<flexible_type>());
+  inline void accumulate_values(size_t thr, const std::vector<flexible_type>& vals, const std::unordered_set<flexible_type>& keys);
   inline void accumulate_discrete_sketch(size_t thr, const flexible_type& val) {
       m_thrlocal[thr].discrete_sketch.accumulate(val);
   }
@@ -54,15 +54,19 @@ cdef inline string unsafe_unicode_to_cpp(py_s) except *:
 
 cpdef disable_cpp_str_decode()
 cpdef enable_cpp_str_decode()
-cdef _cpp_to_str_py3_decode(const string& cpp_s)
+cdef _chars_to_str_py3_decode(const char* c_s, size_t n)
 
-cdef inline cpp_to_str(const string& cpp_s):
-    cdef const char* c_s = cpp_s.data()
-    
+cdef inline chars_to_str(const char* c_s, size_t n):
+    """
+    Same as cpp_to_str, on the n characters starting at c_s.
+    """
     if PY_MAJOR_VERSION >= 3:
-        return _cpp_to_str_py3_decode(cpp_s)
+        return _chars_to_str_py3_decode(c_s, n)
     else:
-        return str(c_s[:cpp_s.size()])
+        return str(c_s[:n])
+
+cdef inline cpp_to_str(const string& cpp_s):
+    return chars_to_str(cpp_s.data(), cpp_s.size())
 
 
 cdef inline vector[string] to_vector_of_strings(object v) except *:
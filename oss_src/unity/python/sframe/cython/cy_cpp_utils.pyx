@@ -66,14 +66,12 @@ cpdef enable_cpp_str_decode():
     assert _cpp_to_str_py3_decode_enabled == False
     _cpp_to_str_py3_decode_enabled = True
 
-cdef _cpp_to_str_py3_decode(const string& cpp_s):
+cdef _chars_to_str_py3_decode(const char* c_s, size_t n):
     """
     Decodes a c++ string into bytes if disable_cpp_str_decode() has
     been called, or str otherwise.
     """
-    cdef const char* c_s = cpp_s.data()
-
     if _cpp_to_str_py3_decode_enabled:
-        return c_s[:cpp_s.size()].decode()
+        return c_s[:n].decode()
     else:
-        return (<bytes>c_s[:cpp_s.size()])
+        return (<bytes>c_s[:n])
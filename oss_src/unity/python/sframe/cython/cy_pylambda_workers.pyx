@@ -1,6 +1,7 @@
 #cython: boundscheck=False, wraparound=False
 
 from cy_flexible_type cimport flexible_type, flex_type_enum, UNDEFINED, flex_int
+from cy_flexible_type cimport INTEGER, FLOAT, STRING
 from cy_flexible_type cimport flexible_type_from_pyobject
 from cy_flexible_type cimport process_common_typed_list
 from cy_flexible_type cimport pyobject_from_flexible_type
@@ -10,6 +11,7 @@ from .._gl_pickle import GLUnpickler
 from copy import deepcopy
 from libcpp.string cimport string
 from libcpp.vector cimport vector
+from libc.stdint cimport uint64_t
 import ctypes
 import os
 import traceback
@@ -17,7 +19,7 @@ import sys
 cimport cython
 
 from random import seed as set_random_seed
-from cy_cpp_utils cimport str_to_cpp, cpp_to_str
+from cy_cpp_utils cimport str_to_cpp, cpp_to_str, chars_to_str
 
 from cpython.version cimport PY_MAJOR_VERSION
 
@@ -41,6 +43,17 @@ cdef extern from "<sframe/sframe_rows.hpp>" namespace "graphlab":
         size_t num_rows()
 
 
+cdef extern from "<lambda/columnar_batch.hpp>" namespace "graphlab::lambda":
+
+    cdef struct columnar_column_view:
+        flex_type_enum type
+        const unsigned char* validity
+        const flex_int* int_values
+        const double* float_values
+        const uint64_t* string_offsets
+        const char* string_data
+        const flexible_type* generic_values
+
 cdef extern from "<lambda/pylambda.hpp>" namespace "graphlab::lambda":
 
     cdef struct lambda_call_data:
@@ -69,6 +82,17 @@ cdef extern from "<lambda/pylambda.hpp>" namespace "graphlab::lambda":
 
         flexible_type* output_values
         
+    cdef struct lambda_call_by_columnar_data:
+        flex_type_enum output_enum_type
+        bint skip_undefined
+
+        const vector[string]* input_keys
+        const columnar_column_view* input_columns
+        size_t n_columns
+        size_t n_rows
+
+        flexible_type* output_values
+
     ################################################################################
     # Graph Pylambda stuff
     cdef struct lambda_graph_triple_apply_data:
@@ -92,11 +116,34 @@ cdef extern from "<lambda/pylambda.hpp>" namespace "graphlab::lambda":
         void (*eval_lambda_by_dict)(size_t, lambda_call_by_dict_data*)
         void (*eval_lambda_by_sframe_rows)(size_t, lambda_call_by_sframe_rows_data*)
         void (*eval_graph_triple_apply)(size_t, lambda_graph_triple_apply_data*)
+        void (*eval_lambda_by_columns)(size_t, lambda_call_by_columnar_data*)
 
     # The function to call to set everything up.
     void set_pylambda_evaluation_functions(pylambda_evaluation_functions* eval_function_struct)
 
     
+cdef inline bint _column_value_present(const columnar_column_view& c, long i):
+    if c.type == UNDEFINED:
+        return c.generic_values[i].get_type() != UNDEFINED
+    return (c.validity[i >> 3] & (1 << (i & 7))) != 0
+
+cdef inline object _column_value(const columnar_column_view& c, long i):
+    """
+    Reads a value of a columnar batch column directly as a python object.
+    """
+    if c.type == UNDEFINED:
+        return pyobject_from_flexible_type(c.generic_values[i])
+    if not (c.validity[i >> 3] & (1 << (i & 7))):
+        return None
+    if c.type == INTEGER:
+        return c.int_values[i]
+    elif c.type == FLOAT:
+        return c.float_values[i]
+    else:
+        # decoded the same way as strings converted from flexible_type
+        return chars_to_str(c.string_data + c.string_offsets[i],
+                            c.string_offsets[i + 1] - c.string_offsets[i])
+
 ################################################################################
 # Lambda evaluation class. 
 
@@ -222,6 +269,40 @@ cdef class lambda_evaluator(object):
 
         process_common_typed_list(lcd.output_values, self.output_buffer, lcd.output_enum_type)
 
+    @cython.boundscheck(False)
+    cdef eval_columns(self, lambda_call_by_columnar_data* lcd):
+
+        cdef dict arg_dict = {}
+        cdef long i, j
+        cdef long n = lcd.n_rows
+        cdef long n_keys
+        cdef const columnar_column_view* columns = lcd.input_columns
+
+        if len(self.output_buffer) != n:
+            self.output_buffer = [None]*n
+
+        if lcd.input_keys == NULL:
+            for i in range(n):
+                if lcd.skip_undefined and not _column_value_present(columns[0], i):
+                    self.output_buffer[i] = None
+                    continue
+                self.output_buffer[i] = self.lambda_function(_column_value(columns[0], i))
+        else:
+            n_keys = lcd.input_keys[0].size()
+            assert lcd.n_columns == n_keys
+
+            self._set_dict_keys(lcd.input_keys)
+
+            for i in range(n):
+                arg_dict = self.arg_dict_base.copy()
+
+                for j in range(n_keys):
+                    arg_dict[self.keys[j]] = _column_value(columns[j], i)
+
+                self.output_buffer[i] = self.lambda_function(arg_dict)
+
+        process_common_typed_list(lcd.output_values, self.output_buffer, lcd.output_enum_type)
+
     @cython.boundscheck(False)
     cdef process_output_dict(self, flexible_type* output_values, list mut_keys, dict ref_dict, dict ret_dict):
         """
@@ -453,6 +534,17 @@ cdef void _eval_lambda_by_sframe_rows(size_t lmfunc_id, lambda_call_by_sframe_ro
 
 eval_functions.eval_lambda_by_sframe_rows = _eval_lambda_by_sframe_rows
 
+########################################
+# Columnar batch evaluation
+
+cdef void _eval_lambda_by_columns(size_t lmfunc_id, lambda_call_by_columnar_data* lcd):
+    try:
+        _get_lambda_class(lmfunc_id).eval_columns(lcd)
+    except Exception, e:
+        register_exception(e)
+
+eval_functions.eval_lambda_by_columns = _eval_lambda_by_columns
+
 ########################################
 # Triple Apply stuff
 
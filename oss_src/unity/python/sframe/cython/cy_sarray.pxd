@@ -33,8 +33,9 @@ cdef extern from "<unity/lib/api/unity_sarray_interface.hpp>" namespace 'graphla
         unity_sarray_base_ptr head(size_t) except +
         flex_type_enum dtype() except +
         unity_sarray_base_ptr vector_slice(size_t, size_t) except +
-        unity_sarray_base_ptr transform(const string&, flex_type_enum, bint, int) except +
+        unity_sarray_base_ptr transform(const string&, flex_type_enum, bint, int, bint) except +
         unity_sarray_base_ptr transform_native(const function_closure_info&, flex_type_enum, bint, int) except +
+        unity_sarray_base_ptr transform_expression(const flexible_type&, flex_type_enum, bint) except +
         unity_sarray_base_ptr filter(const string&, bint, int) except +
         unity_sarray_base_ptr logical_filter(unity_sarray_base_ptr) except +
         unity_sarray_base_ptr topk_index(size_t, bint) except +
@@ -63,7 +64,8 @@ cdef extern from "<unity/lib/api/unity_sarray_interface.hpp>" namespace 'graphla
         unity_sarray_base_ptr vector_operator(unity_sarray_base_ptr, string) except +
         unity_sarray_base_ptr drop_missing_values() except +
         unity_sarray_base_ptr fill_missing_values(flexible_type) except +
-        unity_sarray_base_ptr sample(float, int) except +
+        unity_sarray_base_ptr sample(float, int, const string&) except +
+        unity_sarray_base_ptr sample_rows(size_t, int) except +
         unity_sarray_base_ptr hash(int) except +
         void materialize() except +
         bint is_materialized() except +
@@ -122,10 +124,12 @@ cdef class UnitySArrayProxy:
 
     cpdef vector_slice(self, size_t start, size_t end)
 
-    cpdef transform(self, fn, t, bint skip_undefined, int seed)
+    cpdef transform(self, fn, t, bint skip_undefined, int seed, bint memoize=*)
 
     cpdef transform_native(self, fn, t, bint skip_undefined, int seed)
 
+    cpdef transform_expression(self, expr, t, bint skip_undefined)
+
     cpdef filter(self, fn, bint skip_undefined, int seed)
 
     cpdef logical_filter(self, UnitySArrayProxy other)
@@ -176,7 +180,9 @@ cdef class UnitySArrayProxy:
 
     cpdef fill_missing_values(self, default_value)
 
-    cpdef sample(self, float percent, int seed)
+    cpdef sample(self, float percent, int seed, method=*)
+
+    cpdef sample_rows(self, size_t num_rows, int seed)
 
     cpdef hash(self, int seed)
 
@@ -129,7 +129,7 @@ cdef class UnitySArrayProxy:
             proxy = self.thisptr.vector_slice(start, end)
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
-    cpdef transform(self, fn, t, bint skip_undefined, int seed):
+    cpdef transform(self, fn, t, bint skip_undefined, int seed, bint memoize=False):
         cdef flex_type_enum datatype = flex_type_enum_from_pytype(t)
         cdef string lambda_str
         if type(fn) == str or type(fn) == bytes:
@@ -140,7 +140,7 @@ cdef class UnitySArrayProxy:
 
         cdef unity_sarray_base_ptr proxy
         with nogil:
-            proxy = (self.thisptr.transform(lambda_str, datatype, skip_undefined, seed))
+            proxy = (self.thisptr.transform(lambda_str, datatype, skip_undefined, seed, memoize))
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
     cpdef transform_native(self, closure, t, bint skip_undefined, int seed):
@@ -152,6 +152,15 @@ cdef class UnitySArrayProxy:
             proxy = (self.thisptr.transform_native(cl, datatype, skip_undefined, seed))
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
+    cpdef transform_expression(self, expr, t, bint skip_undefined):
+        # t is None to use the type inferred from the expression
+        cdef flex_type_enum datatype = flex_type_enum_from_pytype(t if t is not None else type(None))
+        cdef flexible_type expr_ft = flexible_type_from_pyobject(expr)
+        cdef unity_sarray_base_ptr proxy
+        with nogil:
+            proxy = (self.thisptr.transform_expression(expr_ft, datatype, skip_undefined))
+        return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
+
     cpdef filter(self, fn, bint skip_undefined, int seed):
         cdef string lambda_str 
         if type(fn) == str or type(fn) == bytes:
@@ -314,10 +323,17 @@ cdef class UnitySArrayProxy:
             proxy = (self.thisptr.fill_missing_values(val))
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
-    cpdef sample(self, float percent, int seed):
+    cpdef sample(self, float percent, int seed, method='row'):
+        cdef string c_method = str_to_cpp(method)
+        cdef unity_sarray_base_ptr proxy
+        with nogil:
+            proxy = (self.thisptr.sample(percent, seed, c_method))
+        return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
+
+    cpdef sample_rows(self, size_t num_rows, int seed):
         cdef unity_sarray_base_ptr proxy
         with nogil:
-            proxy = (self.thisptr.sample(percent, seed))
+            proxy = (self.thisptr.sample_rows(num_rows, seed))
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
     cpdef hash(self, int seed):
@@ -40,8 +40,9 @@ cdef extern from "<unity/lib/api/unity_sframe_interface.hpp>" namespace 'graphla
         vector[string] column_names() except +
         unity_sframe_base_ptr head(size_t) except +
         unity_sframe_base_ptr tail(size_t) except +
-        unity_sarray_base_ptr transform(const string&, flex_type_enum, bint, int) except +
+        unity_sarray_base_ptr transform(const string&, flex_type_enum, bint, int, bint) except +
         unity_sarray_base_ptr transform_native(const function_closure_info&, flex_type_enum, bint, int) except +
+        unity_sarray_base_ptr transform_expression(const flexible_type&, flex_type_enum, bint) except +
         unity_sframe_base_ptr flat_map(const string&, vector[string], vector[flex_type_enum], bint, int) except +
         unity_sframe_base_ptr logical_filter(unity_sarray_base_ptr) except +
         unity_sframe_base_ptr select_columns(const vector[string]&) except +
@@ -53,8 +54,10 @@ cdef extern from "<unity/lib/api/unity_sframe_interface.hpp>" namespace 'graphla
         void swap_columns(size_t, size_t) except +
         void begin_iterator() except +
         vector[vector[flexible_type]] iterator_get_next(size_t) except +
+        vector[vector[flexible_type]] iterator_get_next_columns(size_t) except +
         void save_as_csv(const string&, gl_options_map) except +
-        unity_sframe_base_ptr sample(float, int) except +
+        unity_sframe_base_ptr sample(float, int, const string&) except +
+        unity_sframe_base_ptr sample_rows(size_t, int) except +
         cpplist[unity_sframe_base_ptr] random_split(float, int) except +
         unity_sframe_base_ptr groupby_aggregate(const vector[string]&, const vector[vector[string]]&, const vector[string]&, const vector[string]&) except +
         unity_sframe_base_ptr append(unity_sframe_base_ptr) except +
@@ -100,10 +103,12 @@ cdef class UnitySFrameProxy:
 
     cpdef tail(self, size_t n)
 
-    cpdef transform(self, fn, t, int seed)
+    cpdef transform(self, fn, t, int seed, bint memoize=*)
 
     cpdef transform_native(self, fn, t, int seed)
 
+    cpdef transform_expression(self, expr, t)
+
     cpdef flat_map(self, object fn, column_names, object column_types, int seed)
         
     cpdef logical_filter(self, UnitySArrayProxy other)
@@ -126,9 +131,13 @@ cdef class UnitySFrameProxy:
 
     cpdef iterator_get_next(self, size_t length)
 
+    cpdef iterator_get_next_columns(self, size_t length)
+
     cpdef save_as_csv(self, url, object csv_config)
 
-    cpdef sample(self, float percent, int random_seed)
+    cpdef sample(self, float percent, int random_seed, method=*)
+
+    cpdef sample_rows(self, size_t num_rows, int random_seed)
 
     cpdef random_split(self, float percent, int random_seed)
 
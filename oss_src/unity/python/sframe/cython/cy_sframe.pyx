@@ -121,7 +121,7 @@ cdef class UnitySFrameProxy:
             proxy = (self.thisptr.tail(n))
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
-    cpdef transform(self, fn, t, int seed):
+    cpdef transform(self, fn, t, int seed, bint memoize=False):
         cdef flex_type_enum flex_type_en = flex_type_enum_from_pytype(t)
         cdef string lambda_str
         if type(fn) == str:
@@ -133,7 +133,7 @@ cdef class UnitySFrameProxy:
         skip_undefined = 0
         cdef unity_sarray_base_ptr proxy
         with nogil:
-            proxy = (self.thisptr.transform(lambda_str, flex_type_en, skip_undefined, seed))
+            proxy = (self.thisptr.transform(lambda_str, flex_type_en, skip_undefined, seed, memoize))
         return sarray_proxy(self._cli, proxy)
 
     cpdef transform_native(self, closure, t, int seed):
@@ -146,6 +146,15 @@ cdef class UnitySFrameProxy:
             proxy = (self.thisptr.transform_native(cl, flex_type_en, skip_undefined, seed))
         return sarray_proxy(self._cli, proxy)
 
+    cpdef transform_expression(self, expr, t):
+        # t is None to use the type inferred from the expression
+        cdef flex_type_enum flex_type_en = flex_type_enum_from_pytype(t if t is not None else type(None))
+        cdef flexible_type expr_ft = flexible_type_from_pyobject(expr)
+        cdef unity_sarray_base_ptr proxy
+        with nogil:
+            proxy = (self.thisptr.transform_expression(expr_ft, flex_type_en, 0))
+        return sarray_proxy(self._cli, proxy)
+
     cpdef flat_map(self, object fn, _column_names, object py_column_types, int seed):
         cdef vector[string] column_names = to_vector_of_strings(_column_names)
         cdef vector[flex_type_enum] column_types
@@ -220,16 +229,29 @@ cdef class UnitySFrameProxy:
         tmp = self.thisptr.iterator_get_next(length)
         return [pylist_from_flex_list(x) for x in tmp]
 
+    cpdef iterator_get_next_columns(self, size_t length):
+        cdef vector[vector[flexible_type]] tmp
+        with nogil:
+            tmp = self.thisptr.iterator_get_next_columns(length)
+        return [pylist_from_flex_list(x) for x in tmp]
+
     cpdef save_as_csv(self, _url, object csv_config):
         cdef string url = str_to_cpp(_url)
         cdef gl_options_map csv_options = gl_options_map_from_pydict(csv_config)
         with nogil:
             self.thisptr.save_as_csv(url, csv_options)
 
-    cpdef sample(self, float percent, int random_seed):
+    cpdef sample(self, float percent, int random_seed, method='row'):
+        cdef string c_method = str_to_cpp(method)
+        cdef unity_sframe_base_ptr proxy
+        with nogil:
+            proxy = self.thisptr.sample(percent, random_seed, c_method)
+        return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
+
+    cpdef sample_rows(self, size_t num_rows, int random_seed):
         cdef unity_sframe_base_ptr proxy
         with nogil:
-            proxy = self.thisptr.sample(percent, random_seed)
+            proxy = self.thisptr.sample_rows(num_rows, random_seed)
         return create_proxy_wrapper_from_existing_proxy(self._cli, proxy)
 
     cpdef random_split(self, float percent, int random_seed):
@@ -14,7 +14,7 @@ class GroupedSFrame(object):
     """
     Left undocumented intentionally.
     """
-    def __init__(self, sframe, key_columns):
+    def __init__(self, sframe, key_columns, sort=True):
         from .. import extensions
         self._sf_group = extensions.grouped_sframe()
         if isinstance(key_columns, str):
@@ -22,7 +22,11 @@ class GroupedSFrame(object):
 
         if not isinstance(key_columns, list):
             raise TypeError("Must give key columns as str or list.")
-        self._sf_group.group(sframe, key_columns, False)
+        if sort:
+            self._sf_group.group(sframe, key_columns, False)
+        else:
+            # groups in order of first appearance, without a full sort
+            self._sf_group.group_by_hash(sframe, key_columns)
 
     def get_group(self, name):
         if not isinstance(name, list):
@@ -1792,9 +1792,9 @@ class SArray(object):
         with cython_context():
             return SArray(_proxy=self.__proxy__.dict_has_all_keys(keys))
 
-    def apply(self, fn, dtype=None, skip_undefined=True, seed=None):
+    def apply(self, fn, dtype=None, skip_undefined=True, seed=None, memoize=False):
         """
-        apply(fn, dtype=None, skip_undefined=True, seed=None)
+        apply(fn, dtype=None, skip_undefined=True, seed=None, memoize=False)
 
         Transform each element of the SArray by a given function. The result
         SArray is of type ``dtype``. ``fn`` should be a function that returns
@@ -1821,6 +1821,13 @@ class SArray(object):
         seed : int, optional
             Used as the seed if a random number generator is included in ``fn``.
 
+        memoize : bool, optional
+            If True, the result of ``fn`` is cached for each distinct value,
+            and ``fn`` is called only once per distinct value (as long as the
+            cache is large enough). Only use this if ``fn`` always returns the
+            same result for the same input, and the SArray has many repeated
+            values. The cache turns itself off if few values repeat.
+
         Returns
         -------
         out : SArray
@@ -1891,7 +1898,7 @@ class SArray(object):
                 return SArray(_proxy=self.__proxy__.transform_native(nativefn, dtype, skip_undefined, seed))
 
         with cython_context():
-            return SArray(_proxy=self.__proxy__.transform(fn, dtype, skip_undefined, seed))
+            return SArray(_proxy=self.__proxy__.transform(fn, dtype, skip_undefined, seed, memoize))
 
 
     def filter(self, fn, skip_undefined=True, seed=None):
@@ -1937,7 +1944,7 @@ class SArray(object):
             return SArray(_proxy=self.__proxy__.filter(fn, skip_undefined, seed))
 
 
-    def sample(self, fraction, seed=None):
+    def sample(self, fraction, seed=None, method='row'):
         """
         Create an SArray which contains a subsample of the current SArray.
 
@@ -1949,6 +1956,9 @@ class SArray(object):
         seed : int
             The random seed for the random number generator.
 
+        method : {'row', 'block', 'block_systematic', 'auto'}, optional
+            How the rows are selected. See :py:func:`~sframe.SFrame.sample`.
+
         Returns
         -------
         out : SArray
@@ -1971,7 +1981,43 @@ class SArray(object):
 
 
         with cython_context():
-            return SArray(_proxy=self.__proxy__.sample(fraction, seed))
+            return SArray(_proxy=self.__proxy__.sample(fraction, seed, method))
+
+    def sample_rows(self, num_rows, seed=None):
+        """
+        Create an SArray which contains exactly ``num_rows`` elements of the
+        current SArray, sampled uniformly and without replacement. The
+        elements keep their original order.
+
+        Parameters
+        ----------
+        num_rows : int
+            The number of elements to fetch. If the SArray is shorter, all
+            of its elements are returned.
+
+        seed : int
+            The random seed for the random number generator.
+
+        Returns
+        -------
+        out : SArray
+            The new SArray which contains the subsampled rows.
+
+        Examples
+        --------
+        >>> sa = graphlab.SArray(range(10))
+        >>> len(sa.sample_rows(3))
+        3
+        """
+        if num_rows < 0:
+            raise ValueError('Invalid number of rows: ' + str(num_rows))
+        if (self.size() == 0):
+            return SArray()
+        if seed is None:
+            seed = abs(hash("%0.20f" % time.time())) % (2 ** 31)
+
+        with cython_context():
+            return SArray(_proxy=self.__proxy__.sample_rows(num_rows, seed))
 
     def hash(self, seed=0):
         """
@@ -1670,7 +1670,12 @@ class SFrame(object):
 
         If orient="lines", the JSON file is expected to contain a JSON element
         per line. If each line contains a dictionary, it is automatically
-        unpacked.
+        unpacked: each key becomes a column, and rows missing a key get None.
+        Files of strict JSON are parsed in parallel, and the type of each
+        column is inferred from the first block of lines containing the key.
+        Other files (for instance with single quoted strings) are read with
+        the more lenient, but slower, :py:func:`~sframe.SFrame.read_csv`
+        parser. In both cases lists of numbers are read as arrays of floats.
 
         >>> !cat input.json
         {'a':1,'b':1}
@@ -1718,6 +1723,15 @@ class SFrame(object):
                 raise RuntimeError("Input JSON not of expected format")
             return g.stack('X1').unpack('X1','')
         elif orient == "lines":
+            from .. import extensions
+            try:
+                return extensions.json.read_json_lines(_make_internal_url(url))
+            except RuntimeError as e:
+                # only lines which are not strict JSON are retried; other
+                # errors (e.g. I/O failures) would fail the same way again
+                if not str(e).startswith("JSON syntax error"):
+                    raise
+                __LOGGER__.warning("Falling back to the CSV parser: " + str(e))
             g = cls.read_csv(url, header=False)
             if g.num_cols() != 1:
                 raise RuntimeError("Input JSON not of expected format")
@@ -2916,9 +2930,23 @@ class SFrame(object):
         """
         assert HAS_PANDAS, 'pandas is not installed.'
         df = pandas.DataFrame()
-        for i in range(self.num_columns()):
-            column_name = self.column_names()[i]
-            df[column_name] = list(self[column_name])
+        column_names = self.column_names()
+        columns = [[] for _ in column_names]
+        # fetch the rows a block of columns at a time. The iterator of
+        # self.__proxy__ is shared with __iter__, so iterate on a copy.
+        elems_at_a_time = 262144
+        if len(column_names) > 0:
+            proxy = self.copy().__proxy__
+            proxy.begin_iterator()
+            while True:
+                ret = proxy.iterator_get_next_columns(elems_at_a_time)
+                for column, values in zip(columns, ret):
+                    column.extend(values)
+                if len(ret) == 0 or len(ret[0]) < elems_at_a_time:
+                    break
+        for i in range(len(column_names)):
+            column_name = column_names[i]
+            df[column_name] = columns[i]
             if len(df[column_name]) == 0:
                 df[column_name] = df[column_name].astype(self.column_types()[i])
         return df
@@ -2960,7 +2988,7 @@ class SFrame(object):
         """
         return SFrame(_proxy=self.__proxy__.tail(n))
 
-    def apply(self, fn, dtype=None, seed=None):
+    def apply(self, fn, dtype=None, seed=None, memoize=False):
         """
         Transform each row to an :class:`~graphlab.SArray` according to a
         specified function. Returns a new SArray of ``dtype`` where each element
@@ -2986,6 +3014,13 @@ class SFrame(object):
         seed : int, optional
             Used as the seed if a random number generator is included in `fn`.
 
+        memoize : bool, optional
+            If True, the result of `fn` is cached for each distinct row, and
+            `fn` is called only once per distinct row (as long as the cache
+            is large enough). Only use this if `fn` always returns the same
+            result for the same row, and the SFrame has many repeated rows.
+            The cache turns itself off if few rows repeat.
+
         Returns
         -------
         out : SArray
@@ -3052,7 +3087,7 @@ class SFrame(object):
                 return SArray(_proxy=self.__proxy__.transform_native(nativefn, dtype, seed))
 
         with cython_context():
-            return SArray(_proxy=self.__proxy__.transform(fn, dtype, seed))
+            return SArray(_proxy=self.__proxy__.transform(fn, dtype, seed, memoize))
 
     def flat_map(self, column_names, fn, column_types='auto', seed=None):
         """
@@ -3153,7 +3188,7 @@ class SFrame(object):
         with cython_context():
             return SFrame(_proxy=self.__proxy__.flat_map(fn, column_names, column_types, seed))
 
-    def sample(self, fraction, seed=None):
+    def sample(self, fraction, seed=None, method='row'):
         """
         Sample the current SFrame's rows.
 
@@ -3167,11 +3202,24 @@ class SFrame(object):
         seed : int, optional
             Seed for the random number generator used to sample.
 
+        method : {'row', 'block', 'block_systematic', 'auto'}, optional
+            How the rows are selected. 'row' (the default) keeps every row
+            independently with probability ``fraction``. 'block' keeps every
+            storage block of the SFrame with probability ``fraction``, and
+            'block_systematic' keeps every (1/fraction)-th block; all rows of
+            a kept block are returned, so the blocks which are not kept are
+            never read. 'auto' uses 'block' for fractions below the
+            GRAPHLAB_SFRAME_BLOCK_SAMPLING_THRESHOLD configuration value.
+
         Returns
         -------
         out : SFrame
             A new SFrame containing sampled rows of the current SFrame.
 
+        See Also
+        --------
+        sample_rows
+
         Examples
         --------
         Suppose we have an SFrame with 6,145 rows.
@@ -3196,7 +3244,44 @@ class SFrame(object):
             return self
         else:
             with cython_context():
-                return SFrame(_proxy=self.__proxy__.sample(fraction, seed))
+                return SFrame(_proxy=self.__proxy__.sample(fraction, seed, method))
+
+    def sample_rows(self, num_rows, seed=None):
+        """
+        Sample exactly ``num_rows`` rows of the current SFrame, uniformly and
+        without replacement. The rows keep their original order.
+
+        Parameters
+        ----------
+        num_rows : int
+            The number of rows to fetch. If the SFrame has fewer rows, all
+            of them are returned.
+
+        seed : int, optional
+            Seed for the random number generator used to sample.
+
+        Returns
+        -------
+        out : SFrame
+            A new SFrame containing sampled rows of the current SFrame.
+
+        Examples
+        --------
+        >>> sf = SFrame({'id': range(0, 6145)})
+        >>> len(sf.sample_rows(100, seed=5))
+        100
+        """
+        if seed is None:
+            seed = abs(hash("%0.20f" % time.time())) % (2 ** 31)
+
+        if num_rows < 0:
+            raise ValueError('Invalid number of rows: ' + str(num_rows))
+
+        if (self.num_rows() == 0 or self.num_cols() == 0):
+            return self
+        else:
+            with cython_context():
+                return SFrame(_proxy=self.__proxy__.sample_rows(num_rows, seed))
 
     def random_split(self, fraction, seed=None):
         """
@@ -295,6 +295,35 @@ class SArrayTest(unittest.TestCase):
         sa1 = sa.apply(lambda x : x + 1)
         self.__test_equal(sa1, [2,3,4,None,5,6], int)
 
+    def test_transform_memoize(self):
+        # fn appends a line to a file on every call, in whichever process
+        # evaluates it
+        f = tempfile.NamedTemporaryFile(delete=False)
+        f.close()
+        def fn(x, path=f.name):
+            with open(path, 'a') as calls:
+                calls.write('.\n')
+            return x * 2 if x is not None else None
+
+        sa = SArray([i % 5 for i in range(20000)] + [None], int)
+        expected = [x * 2 for x in range(5)] * 4000 + [None]
+        sa_memo = sa.apply(fn, int, memoize=True)
+        sa_memo.materialize()
+        self.__test_equal(sa_memo, expected, int)
+        with open(f.name) as calls:
+            num_memo_calls = len(calls.readlines())
+        # at most one miss per distinct value and thread, plus the dry run
+        self.assertLess(num_memo_calls, 2000)
+
+        # the same values without the cache
+        os.unlink(f.name)
+        sa_plain = sa.apply(fn, int)
+        sa_plain.materialize()
+        self.__test_equal(sa_plain, expected, int)
+        with open(f.name) as calls:
+            self.assertGreaterEqual(len(calls.readlines()), 20000)
+        os.unlink(f.name)
+
     def test_transform_with_multiple_lambda(self):
         sa_char = SArray(self.url, str)
         sa_int = sa_char.apply(lambda char: ord(char), int)
@@ -1130,6 +1159,22 @@ class SArrayTest(unittest.TestCase):
         sa_sample = SArray().sample(.5, 9)
         self.assertEqual(len(sa_sample), 0)
 
+        sa = SArray(range(1000))
+        self.assertEqual(list(sa.sample(.3, 9, method='row')), list(sa.sample(.3, 9)))
+        for method in ['block', 'block_systematic']:
+            values = list(sa.sample(.3, 9, method=method))
+            self.assertEqual(values, sorted(set(values)))
+        with self.assertRaises(RuntimeError):
+            sa.sample(.3, 9, method='nope')
+
+    def test_sample_rows(self):
+        sa = SArray(range(1000))
+        values = list(sa.sample_rows(100, 9))
+        self.assertEqual(len(values), 100)
+        self.assertEqual(values, sorted(set(values)))
+        self.assertEqual(list(sa.sample_rows(2000, 9)), list(range(1000)))
+        self.assertEqual(len(SArray().sample_rows(10, 9)), 0)
+
     def test_hash(self):
         a = SArray([0,1,0,1,0,1,0,1], int)
         b = a.hash()
@@ -1140,9 +1185,9 @@ class SArrayTest(unittest.TestCase):
 
         # I can hash other stuff too
         # does not throw
-        a.astype(str).hash().__materialize__()
+        a.astype(str).hash().materialize()
 
-        a.apply(lambda x: [x], list).hash().__materialize__()
+        a.apply(lambda x: [x], list).hash().materialize()
 
         # Nones hash too!
         a = SArray([None, None, None], int).hash()
@@ -158,6 +158,16 @@ class SFrameTest(unittest.TestCase):
         assert_frame_equal(result.to_dataframe(), expected.to_dataframe())
 
 
+    def test_to_dataframe_while_iterating(self):
+        sf = SFrame({'a': range(10), 'b': [str(i) for i in range(10)]})
+        rows = []
+        for row in sf:
+            # must not reset the iteration over sf
+            df = sf.to_dataframe()
+            self.assertEqual(len(df), 10)
+            rows.append(row['a'])
+        self.assertEqual(rows, list(range(10)))
+
     def __test_equal(self, sf, df):
         self.assertEquals(sf.num_rows(), df.shape[0])
         self.assertEquals(sf.num_cols(), df.shape[1])
@@ -470,6 +480,49 @@ class SFrameTest(unittest.TestCase):
         f.close()
         os.unlink(f.name)
 
+    def test_read_json_lines(self):
+        f = tempfile.NamedTemporaryFile(mode='w', suffix='.json', delete=False)
+        f.write('{"b": 1, "a": "x\\u00e9"}\n')
+        f.write('\n')
+        f.write('{"a": "y", "c": {"d": [1, 2.5]}, "b": 2.5}\n')
+        f.write('{"b": null, "e": true}\n')
+        f.close()
+        sf = SFrame.read_json(f.name, orient='lines')
+        self.assertEqual(sf.column_names(), ['a', 'b', 'c', 'e'])
+        self.assertEqual(sf.column_types(), [str, float, dict, int])
+        self.assertEqual(list(sf['a']), [u'x\xe9', 'y', None])
+        self.assertEqual(list(sf['b']), [1.0, 2.5, None])
+        self.assertEqual(list(sf['c']), [None, {'d': array.array('d', [1, 2.5])}, None])
+        self.assertEqual(list(sf['e']), [None, None, 1])
+
+        with open(f.name, 'w') as fout:
+            fout.write('["a", "b"]\n[1, 2]\n')
+        sf = SFrame.read_json(f.name, orient='lines')
+        self.assertEqual(sf.column_names(), ['X1'])
+        self.assertEqual(list(sf['X1']), [['a', 'b'], [1, 2]])
+
+        with open(f.name, 'w') as fout:
+            fout.write('[1, 2, 3]\n[4, 5]\n')
+        sf = SFrame.read_json(f.name, orient='lines')
+        self.assertEqual(sf['X1'].dtype(), array.array)
+        self.assertEqual(list(sf['X1']), [array.array('d', [1, 2, 3]), array.array('d', [4, 5])])
+
+        # not strict JSON: read through the CSV parser as before
+        with open(f.name, 'w') as fout:
+            fout.write("{'a': 1, 'b': 'x'}\n{'a': 2, 'b': 'y'}\n")
+        sf = SFrame.read_json(f.name, orient='lines')
+        self.assertEqual(sf.column_names(), ['a', 'b'])
+        self.assertEqual(list(sf['a']), [1, 2])
+        self.assertEqual(list(sf['b']), ['x', 'y'])
+
+        # other errors are not retried with the CSV parser
+        with open(f.name, 'w') as fout:
+            fout.write('\n\n')
+        with self.assertRaises(RuntimeError) as context:
+            SFrame.read_json(f.name, orient='lines')
+        self.assertTrue('No JSON values found' in str(context.exception))
+        os.unlink(f.name)
+
     def _remove_sframe_files(self, prefix):
         filelist = [ f for f in os.listdir(".") if f.startswith(prefix) ]
         for f in filelist:
@@ -695,6 +748,13 @@ class SFrameTest(unittest.TestCase):
         sa = sf.apply(lambda x: x['int_data'] + x['float_data'], float)
         self.__assert_sarray_equal(sf['int_data'] + sf['float_data'], sa)
 
+    def test_transform_memoize(self):
+        sf = SFrame({'a': [i % 3 for i in range(3000)],
+                     'b': [str(i % 2) for i in range(3000)]})
+        expected = sf.apply(lambda x: str(x['a']) + x['b'], str)
+        sa = sf.apply(lambda x: str(x['a']) + x['b'], str, memoize=True)
+        self.__assert_sarray_equal(sa, expected)
+
     def test_transform_with_recursion(self):
         sf = SFrame(data={'a':[0,1,2,3,4], 'b':['0','1','2','3','4']})
         # this should be the equivalent to sf.apply(lambda x:x since a is
@@ -913,6 +973,29 @@ class SFrameTest(unittest.TestCase):
             sf.random_split(3)
 
         self.assertEqual(len(SFrame().random_split(.4)[0]), 0)
+
+    def test_sample_methods(self):
+        sf = SFrame({'a': range(1000)})
+        row_sample = sf.sample(.3, 9)
+        self.assertEqual(list(sf.sample(.3, 9, method='row')['a']),
+                         list(row_sample['a']))
+        for method in ['block', 'block_systematic', 'auto']:
+            values = list(sf.sample(.3, 9, method=method)['a'])
+            self.assertEqual(values, sorted(set(values)))
+            self.assertTrue(set(values) <= set(range(1000)))
+        with self.assertRaises(RuntimeError):
+            sf.sample(.3, 9, method='nope')
+
+    def test_sample_rows(self):
+        sf = SFrame({'a': range(1000)})
+        values = list(sf.sample_rows(100, 9)['a'])
+        self.assertEqual(len(values), 100)
+        self.assertEqual(values, sorted(set(values)))
+        self.assertEqual(values, list(sf.sample_rows(100, 9)['a']))
+        self.assertEqual(list(sf.sample_rows(2000, 9)['a']), list(range(1000)))
+        self.assertEqual(len(SFrame().sample_rows(10, 9)), 0)
+        with self.assertRaises(ValueError):
+            sf.sample_rows(-1)
         self.assertEqual(len(SFrame().random_split(.4)[1]), 0)
 
     # tests add_column, rename
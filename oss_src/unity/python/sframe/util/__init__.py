@@ -462,6 +462,12 @@ def set_runtime_config(name, value):
     in memory. Increasing this will increase performance with increased memory
     consumption. Defaults to 1048576.
 
+    **Sampling Configuration**
+
+    *GRAPHLAB_SFRAME_BLOCK_SAMPLING_THRESHOLD*: Sampling fractions below this
+    use block sampling when ``SFrame.sample`` or ``SArray.sample`` is called
+    with ``method='auto'``. Defaults to 0.
+
     **Advanced Configuration Variables**
 
     *GRAPHLAB_SFRAME_FILE_HANDLE_POOL_SIZE*: The maximum number of file handles
@@ -11,6 +11,8 @@
 #include <vector> 
 #include <array> 
 #include <algorithm> 
+#include <util/code_optimization.hpp>
+#include <logger/assertions.hpp>
 
 namespace graphlab {
 
@@ -89,6 +89,35 @@ class new_flexible_type_test : public CxxTest::TestSuite {
       TS_ASSERT_EQUALS(f2.get<flex_int>(), 1);
     }
 
+    void test_recycled_storage() {
+      // Cells of small strings and vectors are recycled. Make sure that
+      // recycled values start out empty and that copies stay independent.
+      for (size_t iter = 0; iter < 3; ++iter) {
+        std::vector<flexible_type> values;
+        for (size_t i = 0; i < 2000; ++i) {
+          if (i % 3 == 0) values.push_back(std::to_string(i));
+          else if (i % 3 == 1) values.push_back(flex_vec{double(i), 1.0});
+          else values.push_back(std::string(200, 'a' + (i % 26)));
+        }
+        for (size_t i = 0; i < values.size(); ++i) {
+          flexible_type copy = values[i];
+          if (i % 3 == 1) {
+            copy.mutable_get<flex_vec>().push_back(2.0);
+            TS_ASSERT_EQUALS(values[i].get<flex_vec>().size(), 2);
+            TS_ASSERT_EQUALS(copy.get<flex_vec>().size(), 3);
+          } else {
+            copy.mutable_get<flex_string>() += "x";
+            TS_ASSERT_EQUALS(copy.get<flex_string>(), values[i].get<flex_string>() + "x");
+          }
+        }
+        values.clear();
+        flexible_type s(flex_type_enum::STRING);
+        TS_ASSERT_EQUALS(s.get<flex_string>(), "");
+        flexible_type v(flex_type_enum::VECTOR);
+        TS_ASSERT_EQUALS(v.get<flex_vec>().size(), 0);
+      }
+    }
+
     void test_comparison_stability() {
       flex_float f = 0.1;
       flexible_type g = 0.1;
@@ -0,0 +1,155 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <map>
+#include <vector>
+#include <boost/bind.hpp>
+#include <cxxtest/TestSuite.h>
+#include <graphlab/engine/mirror_gather_cache.hpp>
+
+using namespace graphlab;
+
+class mirror_gather_cache_test : public CxxTest::TestSuite {
+ public:
+  void test_update() {
+    mirror_gather_cache<double> cache;
+    TS_ASSERT_EQUALS(cache.size(), 0);
+    TS_ASSERT(cache.get(1) == NULL);
+
+    cache.update(1, CACHE_SET, 1.0);
+    cache.update(2, CACHE_SET, 10.0);
+    TS_ASSERT_EQUALS(cache.size(), 2);
+    TS_ASSERT_EQUALS(*cache.get(1), 1.0);
+
+    // deltas accumulate on the machine's contribution
+    cache.update(1, CACHE_DELTA, 0.5);
+    cache.update(1, CACHE_DELTA, 0.25);
+    TS_ASSERT_EQUALS(*cache.get(1), 1.75);
+    TS_ASSERT_EQUALS(*cache.get(2), 10.0);
+
+    // a set replaces the contribution
+    cache.update(2, CACHE_SET, 3.0);
+    TS_ASSERT_EQUALS(cache.size(), 2);
+    TS_ASSERT_EQUALS(*cache.get(2), 3.0);
+
+    // a clear drops it, and clearing an absent machine does nothing
+    cache.update(1, CACHE_CLEAR, 0.0);
+    cache.update(5, CACHE_CLEAR, 0.0);
+    TS_ASSERT_EQUALS(cache.size(), 1);
+    TS_ASSERT(cache.get(1) == NULL);
+    TS_ASSERT_EQUALS(*cache.get(2), 3.0);
+
+    cache.update(1, CACHE_SET, 4.0);
+    TS_ASSERT_EQUALS(*cache.get(1), 4.0);
+    cache.clear();
+    TS_ASSERT_EQUALS(cache.size(), 0);
+  }
+
+  void test_add_to() {
+    mirror_gather_cache<double> cache;
+    double accum = 0;
+    bool accum_is_set = false;
+    cache.add_to(accum, accum_is_set);
+    TS_ASSERT(!accum_is_set);
+
+    cache.update(3, CACHE_SET, 2.0);
+    cache.update(4, CACHE_SET, 5.0);
+    // an unset accumulator is assigned, not added to
+    accum = 100;
+    cache.add_to(accum, accum_is_set);
+    TS_ASSERT(accum_is_set);
+    TS_ASSERT_EQUALS(accum, 7.0);
+
+    accum = 1;
+    cache.add_to(accum, accum_is_set);
+    TS_ASSERT_EQUALS(accum, 8.0);
+  }
+
+  /*
+   * Replays a mirror's cache on the master: the master's copy must
+   * always equal the mirror's cache.
+   */
+  void test_mirror_protocol() {
+    mirror_gather_cache<double> master;
+    double mirror_cache = 0, delta = 0;
+    bool synced = false, has_delta = false;
+    for (size_t iter = 0; iter < 100; ++iter) {
+      if (iter % 7 == 0) {
+        // full gather
+        mirror_cache = iter;
+        master.update(0, CACHE_SET, mirror_cache);
+        synced = true;
+        has_delta = false;
+        delta = 0;
+      } else {
+        // post_delta, then a gather from the cache
+        mirror_cache += 0.5;
+        if (synced) {
+          delta += 0.5;
+          has_delta = true;
+        }
+        if (has_delta && iter % 3 != 0) {
+          master.update(0, CACHE_DELTA, delta);
+          delta = 0;
+          has_delta = false;
+        }
+      }
+      if (!has_delta) {
+        TS_ASSERT_EQUALS(*master.get(0), mirror_cache);
+      }
+    }
+  }
+
+  void test_striped_message_combiner() {
+    striped_message_combiner<size_t, size_t> combiner(8);
+    TS_ASSERT_EQUALS(combiner.num_stripes(), 8);
+    const size_t nthreads = 4, nkeys = 100, nrepeats = 1000;
+    thread_group group;
+    for (size_t t = 0; t < nthreads; ++t) {
+      group.launch(boost::bind(&mirror_gather_cache_test::add_messages,
+                               this, &combiner, nkeys, nrepeats));
+    }
+    group.join();
+
+    std::map<size_t, size_t> received;
+    for (size_t stripe = 0; stripe < combiner.num_stripes(); ++stripe) {
+      combiner.drain(stripe, boost::bind(&mirror_gather_cache_test::receive,
+                                         this, &received, _1, _2));
+    }
+    TS_ASSERT_EQUALS(received.size(), nkeys);
+    for (size_t key = 0; key < nkeys; ++key) {
+      TS_ASSERT_EQUALS(received[key], nthreads * nrepeats * key);
+    }
+
+    // draining empties the buffer
+    received.clear();
+    for (size_t stripe = 0; stripe < combiner.num_stripes(); ++stripe) {
+      combiner.drain(stripe, boost::bind(&mirror_gather_cache_test::receive,
+                                         this, &received, _1, _2));
+    }
+    TS_ASSERT_EQUALS(received.size(), 0);
+
+    combiner.add(3, 1);
+    combiner.clear();
+    combiner.drain(3, boost::bind(&mirror_gather_cache_test::receive,
+                                  this, &received, _1, _2));
+    TS_ASSERT_EQUALS(received.size(), 0);
+  }
+
+  void add_messages(striped_message_combiner<size_t, size_t>* combiner,
+                    size_t nkeys, size_t nrepeats) {
+    for (size_t i = 0; i < nrepeats; ++i) {
+      for (size_t key = 0; key < nkeys; ++key) combiner->add(key, key);
+    }
+  }
+
+  void receive(std::map<size_t, size_t>* received, size_t key, size_t message) {
+    // each key is delivered once per drain
+    TS_ASSERT_EQUALS(received->count(key), 0);
+    (*received)[key] = message;
+  }
+};
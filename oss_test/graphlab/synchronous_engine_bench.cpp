@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2009 Carnegie Mellon University.
+ *     All rights reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing,
+ *  software distributed under the License is distributed on an "AS
+ *  IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied.  See the License for the specific language
+ *  governing permissions and limitations under the License.
+ *
+ * For more about this software visit:
+ *
+ *      http://www.graphlab.ml.cmu.edu
+ *
+ */
+
+/*
+ * Measures the network volume per super-step of the synchronous engine,
+ * with and without gather caching, and with messages sent by vertex id.
+ *
+ * Run a loopback cluster of N processes with, for i in 0 .. N-1:
+ *
+ *   SPAWNNODES=127.0.0.1,127.0.0.1,... SPAWNID=i ./synchronous_engine_bench
+ */
+
+#include <vector>
+#include <cmath>
+#include <iostream>
+
+#include <graphlab.hpp>
+
+typedef graphlab::distributed_graph<double, graphlab::empty> graph_type;
+
+const double RESET_PROB = 0.15;
+const double TOLERANCE = 1e-3;
+
+/*
+ * Pagerank which posts the change of each rank to the cached gathers of
+ * its out neighbors, so that only the vertices whose cache was cleared
+ * recompute their gather.
+ */
+class delta_pagerank :
+  public graphlab::ivertex_program<graph_type, double>,
+  public graphlab::IS_POD_TYPE {
+  double last_change;
+public:
+  delta_pagerank() : last_change(0) { }
+  edge_dir_type
+  gather_edges(icontext_type& context, const vertex_type& vertex) const {
+    return graphlab::IN_EDGES;
+  }
+  gather_type
+  gather(icontext_type& context, const vertex_type& vertex,
+         edge_type& edge) const {
+    return edge.source().data() / edge.source().num_out_edges();
+  }
+  void apply(icontext_type& context, vertex_type& vertex,
+             const gather_type& total) {
+    const double new_rank = RESET_PROB + (1 - RESET_PROB) * total;
+    last_change = new_rank - vertex.data();
+    vertex.data() = new_rank;
+  }
+  edge_dir_type
+  scatter_edges(icontext_type& context, const vertex_type& vertex) const {
+    return std::fabs(last_change) > TOLERANCE ? graphlab::OUT_EDGES
+                                              : graphlab::NO_EDGES;
+  }
+  void scatter(icontext_type& context, const vertex_type& vertex,
+               edge_type& edge) const {
+    context.post_delta(edge.target(), last_change / vertex.num_out_edges());
+    context.signal(edge.target());
+  }
+}; // end of delta pagerank
+
+
+/*
+ * Every vertex signals a few arbitrary vertices by id, most of which have
+ * no instance on the sending machine.
+ */
+class signal_by_id :
+  public graphlab::ivertex_program<graph_type, graphlab::empty, int>,
+  public graphlab::IS_POD_TYPE {
+public:
+  edge_dir_type
+  gather_edges(icontext_type& context, const vertex_type& vertex) const {
+    return graphlab::NO_EDGES;
+  }
+  void apply(icontext_type& context, vertex_type& vertex,
+             const gather_type& total) {
+    const size_t nverts = context.num_vertices();
+    for (size_t i = 1; i <= 4; ++i) {
+      context.signal_vid((vertex.id() * 7919 + i * 104729) % nverts, 1);
+    }
+  }
+  edge_dir_type
+  scatter_edges(icontext_type& context, const vertex_type& vertex) const {
+    return graphlab::NO_EDGES;
+  }
+}; // end of signal by id
+
+
+double rank_of(const graph_type::vertex_type& vertex) { return vertex.data(); }
+void reset_rank(graph_type::vertex_type& vertex) { vertex.data() = 1.0; }
+
+
+template <typename EngineType>
+double run_engine(graphlab::distributed_control& dc,
+                  graphlab::command_line_options& clopts,
+                  graph_type& graph,
+                  const std::string& name) {
+  graph.transform_vertices(reset_rank);
+  EngineType engine(dc, graph, clopts);
+  engine.signal_all();
+  dc.barrier();
+  const size_t bytes_before = dc.network_bytes_sent();
+  graphlab::timer ti;
+  engine.start();
+  const double runtime = ti.current_time();
+  size_t bytes = dc.network_bytes_sent() - bytes_before;
+  dc.all_reduce(bytes);
+  if (dc.procid() == 0) {
+    const size_t iterations = std::max(engine.iteration(), 1);
+    std::cout << name << ": " << engine.iteration() << " iterations, "
+              << runtime << " secs, "
+              << bytes / iterations << " bytes per iteration" << std::endl;
+  }
+  return graph.map_reduce_vertices<double>(rank_of);
+}
+
+
+int main(int argc, char** argv) {
+  global_logger().set_log_level(LOG_WARNING);
+  graphlab::distributed_control dc;
+
+  graphlab::command_line_options clopts("Synchronous engine network benchmark.");
+  size_t nverts = 100000;
+  clopts.attach_option("nverts", nverts, "The number of vertices");
+  if (!clopts.parse(argc, argv)) return EXIT_FAILURE;
+  clopts.get_engine_args().set_option("max_iterations", 20);
+
+  graph_type graph(dc, clopts);
+  graph.load_synthetic_powerlaw(nverts);
+  graph.finalize();
+  if (dc.procid() == 0) {
+    std::cout << dc.numprocs() << " processes, " << graph.num_vertices()
+              << " vertices, " << graph.num_edges() << " edges, replication "
+              << graph.num_replicas() / double(graph.num_vertices()) << std::endl;
+  }
+
+  typedef graphlab::synchronous_engine<delta_pagerank> pagerank_engine;
+  clopts.get_engine_args().set_option("use_cache", false);
+  const double total = run_engine<pagerank_engine>(dc, clopts, graph, "pagerank");
+  clopts.get_engine_args().set_option("use_cache", true);
+  const double cached_total =
+      run_engine<pagerank_engine>(dc, clopts, graph, "pagerank (use_cache)");
+  ASSERT_LT(std::fabs(total - cached_total), TOLERANCE * graph.num_vertices());
+
+  clopts.get_engine_args().set_option("use_cache", false);
+  clopts.get_engine_args().set_option("max_iterations", 5);
+  run_engine<graphlab::synchronous_engine<signal_by_id> >(dc, clopts, graph,
+                                                          "signal_vid");
+} // end of main
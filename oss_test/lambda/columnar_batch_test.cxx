@@ -0,0 +1,87 @@
+/*
+* Copyright (C) 2016 Turi
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Affero General Public License as
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cxxtest/TestSuite.h>
+#include <lambda/columnar_batch.hpp>
+
+using namespace graphlab;
+using namespace graphlab::lambda;
+
+class columnar_batch_test: public CxxTest::TestSuite {
+ public:
+  void test_round_trip() {
+    std::vector<std::vector<flexible_type>> columns{
+      {1, FLEX_UNDEFINED, 3, -4, 5, 6, 7, 8, 9},
+      {1.5, 2.5, FLEX_UNDEFINED, 4.5, 5.5, 6.5, 7.5, 8.5, 9.5},
+      {"a", "", FLEX_UNDEFINED, "hello", "world", "x", "yy", "zzz", "w"},
+      {flex_vec{1, 2}, FLEX_UNDEFINED, flex_vec{}, flex_vec{3}, flex_vec{4},
+       flex_vec{5}, flex_vec{6}, flex_vec{7}, flex_vec{8}},
+      {1, 2.5, "mixed", FLEX_UNDEFINED, 5, 6, 7, 8, 9},
+      std::vector<flexible_type>(9, FLEX_UNDEFINED)};
+
+    sframe_rows rows;
+    for (const auto& column: columns) {
+      rows.add_decoded_column(std::make_shared<std::vector<flexible_type>>(column));
+    }
+
+    oarchive oarc;
+    // an odd sized prefix, so that the batch needs padding
+    oarc << (char)(1) << std::string("abc");
+    write_columnar_batch(oarc, rows);
+
+    iarchive iarc(oarc.buf, oarc.off);
+    char c;
+    std::string s;
+    iarc >> c >> s;
+    columnar_batch batch;
+    batch.load(iarc);
+    TS_ASSERT_EQUALS(iarc.off, oarc.off);
+
+    TS_ASSERT_EQUALS(batch.num_rows(), 9);
+    TS_ASSERT_EQUALS(batch.num_columns(), columns.size());
+    TS_ASSERT_EQUALS(batch.column(0).type, flex_type_enum::INTEGER);
+    TS_ASSERT_EQUALS(batch.column(1).type, flex_type_enum::FLOAT);
+    TS_ASSERT_EQUALS(batch.column(2).type, flex_type_enum::STRING);
+    TS_ASSERT_EQUALS(batch.column(3).type, flex_type_enum::UNDEFINED);
+    TS_ASSERT_EQUALS(batch.column(4).type, flex_type_enum::UNDEFINED);
+    TS_ASSERT_EQUALS(batch.column(0).int_values[3], -4);
+    TS_ASSERT(!batch.column(1).is_valid(2));
+
+    for (size_t j = 0; j < columns.size(); ++j) {
+      for (size_t i = 0; i < 9; ++i) {
+        TS_ASSERT_EQUALS(batch.value(j, i).get_type(), columns[j][i].get_type());
+        TS_ASSERT(batch.value(j, i) == columns[j][i] ||
+                  columns[j][i].get_type() == flex_type_enum::UNDEFINED);
+      }
+    }
+
+    std::vector<flexible_type> values{"p", FLEX_UNDEFINED, "q"};
+    oarchive oarc2;
+    write_columnar_batch(oarc2, values);
+    iarchive iarc2(oarc2.buf, oarc2.off);
+    columnar_batch batch2;
+    batch2.load(iarc2);
+    std::vector<flexible_type> out;
+    batch2.to_values(out);
+    TS_ASSERT_EQUALS(out.size(), 3);
+    TS_ASSERT_EQUALS(out[0], values[0]);
+    TS_ASSERT_EQUALS(out[1].get_type(), flex_type_enum::UNDEFINED);
+    TS_ASSERT_EQUALS(out[2], values[2]);
+
+    free(oarc.buf);
+    free(oarc2.buf);
+  }
+};
@@ -0,0 +1,70 @@
+/*
+* Copyright (C) 2016 Turi
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Affero General Public License as
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cxxtest/TestSuite.h>
+#include <lambda/lambda_memo_cache.hpp>
+
+using namespace graphlab;
+using namespace graphlab::lambda;
+
+class lambda_memo_cache_test: public CxxTest::TestSuite {
+ public:
+  void test_lookup_and_insert() {
+    lambda_memo_cache cache(1024 * 1024, 0.1);
+    flexible_type out;
+    TS_ASSERT(!cache.lookup(hash128(1), out));
+    cache.insert(hash128(1), "one");
+    cache.insert(hash128(2), flex_vec{1, 2});
+    TS_ASSERT(cache.lookup(hash128(1), out));
+    TS_ASSERT_EQUALS(out, "one");
+    TS_ASSERT(cache.lookup(hash128(2), out));
+    TS_ASSERT(out == flex_vec({1, 2}));
+    TS_ASSERT_EQUALS(cache.num_lookups(), 3);
+    TS_ASSERT_EQUALS(cache.num_hits(), 2);
+    TS_ASSERT(cache.size_in_bytes() > 0);
+  }
+
+  void test_byte_budget() {
+    lambda_memo_cache cache(4096, 0);
+    for (size_t i = 0; i < 1000; ++i) cache.insert(hash128(i), flex_string(100, 'a'));
+    TS_ASSERT(cache.size_in_bytes() <= 4096);
+    flexible_type out;
+    TS_ASSERT(cache.lookup(hash128(0), out));
+    TS_ASSERT(!cache.lookup(hash128(999), out));
+    TS_ASSERT(cache.enabled());
+  }
+
+  void test_disable_on_low_hit_rate() {
+    lambda_memo_cache cache(1024 * 1024, 0.5);
+    flexible_type out;
+    // all distinct inputs: nothing is ever found
+    for (size_t i = 0; i < 10000 && cache.enabled(); ++i) {
+      TS_ASSERT(!cache.lookup(hash128(i), out));
+      cache.insert(hash128(i), i);
+    }
+    TS_ASSERT(!cache.enabled());
+    TS_ASSERT_EQUALS(cache.size_in_bytes(), 0);
+    TS_ASSERT(!cache.lookup(hash128(0), out));
+
+    // highly repetitive inputs stay cached
+    lambda_memo_cache cache2(1024 * 1024, 0.5);
+    for (size_t i = 0; i < 10000; ++i) {
+      if (!cache2.lookup(hash128(i % 10), out)) cache2.insert(hash128(i % 10), i % 10);
+    }
+    TS_ASSERT(cache2.enabled());
+    TS_ASSERT_EQUALS(cache2.num_hits(), 9990);
+  }
+};
@@ -130,6 +130,45 @@ class worker_pool_test: public CxxTest::TestSuite {
     TS_ASSERT_EQUALS(wk_pool->call_all_workers<int>(good_fun).size(), nworkers);
   }
 
+  void test_elastic_pool() {
+    std::shared_ptr<lambda::worker_pool<dummy_worker_proxy>> wk_pool(
+        new lambda::worker_pool<dummy_worker_proxy>(1, {worker_binary}, 1, nworkers));
+    TS_ASSERT_EQUALS(wk_pool->num_workers(), 1);
+    TS_ASSERT_EQUALS(wk_pool->max_workers(), nworkers);
+
+    // holding all workers at once grows the pool to its maximum
+    {
+      std::vector<std::unique_ptr<lambda::worker_process<dummy_worker_proxy>>> workers;
+      for (size_t i = 0; i < nworkers; ++i) {
+        workers.push_back(wk_pool->get_worker());
+        std::string message = std::to_string(i);
+        TS_ASSERT(workers.back()->proxy->echo(message).compare(message) == 0);
+      }
+      TS_ASSERT_EQUALS(wk_pool->num_workers(), nworkers);
+      for (auto& worker: workers) wk_pool->release_worker(worker);
+    }
+    TS_ASSERT_EQUALS(wk_pool->num_available_workers(), nworkers);
+    auto ret = wk_pool->call_all_workers<int>(
+        [](std::unique_ptr<dummy_worker_proxy>& proxy) { proxy->echo(""); return 0; });
+    TS_ASSERT_EQUALS(ret.size(), nworkers);
+
+    // idle workers are shut down, down to the initial size
+    double old_timeout = LAMBDA_WORKER_IDLE_TIMEOUT;
+    LAMBDA_WORKER_IDLE_TIMEOUT = 0;
+    std::atomic<size_t> removed(0);
+    wk_pool->set_worker_removed_callback(
+        [&](lambda::worker_process<dummy_worker_proxy>&) { ++removed; });
+    for (size_t i = 0; i < 50 && removed.load() < nworkers - 1; ++i) timer::sleep_ms(100);
+    LAMBDA_WORKER_IDLE_TIMEOUT = old_timeout;
+    wk_pool->set_worker_removed_callback(nullptr);
+    TS_ASSERT_EQUALS(wk_pool->num_workers(), 1);
+    TS_ASSERT_EQUALS(removed.load(), nworkers - 1);
+
+    auto worker = wk_pool->get_worker();
+    auto guard = wk_pool->get_worker_guard(worker);
+    TS_ASSERT(worker->proxy->echo("x").compare("x") == 0);
+  }
+
  private:
   std::shared_ptr<lambda::worker_pool<dummy_worker_proxy>> get_worker_pool(size_t poolsize) {
     int timeout = 1;
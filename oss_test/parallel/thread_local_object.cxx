@@ -0,0 +1,59 @@
+/*
+* Copyright (C) 2016 Turi
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Affero General Public License as
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <thread>
+#include <vector>
+#include <parallel/atomic.hpp>
+#include <parallel/thread_local_object.hpp>
+#include <cxxtest/TestSuite.h>
+
+using namespace graphlab;
+
+atomic<int> num_alive;
+atomic<int> num_created;
+
+struct counted {
+  counted() { num_alive.inc(); num_created.inc(); }
+  ~counted() { num_alive.dec(); }
+  int value = 0;
+};
+
+struct other_tag;
+
+class thread_local_object_test : public CxxTest::TestSuite {
+ public:
+  void test_per_thread() {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 8; ++i) {
+      threads.emplace_back([]() {
+          TS_ASSERT(thread_local_object<counted>::get_if_exists() == NULL);
+          // the same object within a thread
+          thread_local_object<counted>::get().value += 1;
+          thread_local_object<counted>::get().value += 1;
+          TS_ASSERT_EQUALS(thread_local_object<counted>::get().value, 2);
+          TS_ASSERT(thread_local_object<counted>::get_if_exists() ==
+                    &thread_local_object<counted>::get());
+          // a different tag gives a different object
+          TS_ASSERT_EQUALS((thread_local_object<counted, other_tag>::get().value), 0);
+        });
+    }
+    for (auto& t: threads) t.join();
+    TS_ASSERT_EQUALS(num_created.value, 16);
+    // deleted when the threads exit
+    TS_ASSERT_EQUALS(num_alive.value, 0);
+    TS_ASSERT(thread_local_object<counted>::get_if_exists() == NULL);
+  }
+};
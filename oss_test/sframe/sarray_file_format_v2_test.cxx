@@ -19,6 +19,8 @@
 #include <sframe/sarray_v2_block_manager.hpp>
 #include <sframe/sarray_file_format_v2.hpp>
 #include <sframe/sarray_index_file.hpp>
+#include <sframe/sframe_constants.hpp>
+#include <parallel/lambda_omp.hpp>
 #include <timer/timer.hpp>
 #include <random/random.hpp>
 
@@ -186,6 +188,58 @@ class sarray_file_format_v2_test: public CxxTest::TestSuite {
   }
 
 
+  /*
+   * Writes a wide group of columns from all segments at once, with blocks
+   * written by the thread filling them or by the thread pool, and checks
+   * that both read back identically.
+   */
+  void test_async_flush(void) {
+    const size_t ncolumns = 64, nsegments = 4, nrows_per_segment = 20000;
+    auto value = [](size_t column, size_t row)->flexible_type {
+      if (column % 2) return flex_int(row * column);
+      return std::to_string(row) + ":" + std::to_string(column);
+    };
+    size_t old_async_flush = SFRAME_WRITER_ASYNC_FLUSH;
+    size_t old_max_buffered_cells = SFRAME_WRITER_MAX_BUFFERED_CELLS;
+    // small enough for the writers to wait on the pool
+    SFRAME_WRITER_MAX_BUFFERED_CELLS = 64 * 1024;
+    for (size_t async_flush = 0; async_flush <= 1; ++async_flush) {
+      SFRAME_WRITER_ASYNC_FLUSH = async_flush;
+      sarray_group_format_writer_v2<flexible_type> group_writer;
+      std::string test_file_name = get_temp_name() + ".sidx";
+      group_writer.open(test_file_name, nsegments, ncolumns);
+      parallel_for(0, nsegments, [&](size_t segment) {
+        for (size_t j = 0; j < nrows_per_segment; ++j) {
+          size_t row = segment * nrows_per_segment + j;
+          for (size_t c = 0; c < ncolumns; ++c) {
+            group_writer.write_segment(c, segment, value(c, row));
+          }
+        }
+      });
+      group_writer.close();
+      group_writer.write_index_file();
+
+      for (size_t c = 0; c < ncolumns; ++c) {
+        sarray_format_reader_v2<flexible_type> reader;
+        reader.open(test_file_name + ":" + std::to_string(c));
+        std::vector<flexible_type> vals;
+        reader.read_rows(0, nsegments * nrows_per_segment, vals);
+        TS_ASSERT_EQUALS(vals.size(), nsegments * nrows_per_segment);
+        for (size_t row = 0; row < vals.size(); ++row) {
+          if (vals[row] != value(c, row)) {
+            TS_FAIL("Mismatch at column " + std::to_string(c) +
+                    " row " + std::to_string(row));
+            break;
+          }
+        }
+        reader.close();
+      }
+    }
+    SFRAME_WRITER_ASYNC_FLUSH = old_async_flush;
+    SFRAME_WRITER_MAX_BUFFERED_CELLS = old_max_buffered_cells;
+  }
+
+
   static const size_t VERY_LARGE_SIZE = 4*1024*1024;
   void test_random_access(void) {
     // write a file
@@ -515,6 +515,82 @@ class sarray_test: public CxxTest::TestSuite {
     TS_ASSERT_EQUALS(rval[1], data[0]);
   }
 
+  void test_sarray_segment_statistics(void) {
+    std::vector<flexible_type> data;
+    for (size_t i = 0;i < 100; ++i) {
+      if (i % 10 == 0) data.push_back(FLEX_UNDEFINED);
+      else data.push_back(flex_int(i) - 20);
+    }
+    sarray<flexible_type> array;
+    array.open_for_write(4);
+    array.set_type(flex_type_enum::INTEGER);
+    graphlab::copy(data.begin(), data.end(), array);
+    array.close();
+
+    sarray_segment_statistics stats;
+    TS_ASSERT(array.get_statistics(stats));
+    TS_ASSERT_EQUALS(stats.num_elements, 100);
+    TS_ASSERT_EQUALS(stats.num_missing, 10);
+    TS_ASSERT_EQUALS(stats.num_int, 90);
+    TS_ASSERT_EQUALS(stats.num_float, 0);
+    TS_ASSERT_EQUALS(stats.int_min, -19);
+    TS_ASSERT_EQUALS(stats.int_max, 79);
+
+    flex_int expected_sum = 0;
+    size_t expected_nnz = 0;
+    for (const auto& val: data) {
+      if (val.get_type() == flex_type_enum::INTEGER) expected_sum += val.get<flex_int>();
+      if (!val.is_zero()) ++expected_nnz;
+    }
+    TS_ASSERT_EQUALS(stats.int_sum, expected_sum);
+    TS_ASSERT_EQUALS(stats.num_nonzero, expected_nnz);
+    TS_ASSERT_DELTA(stats.mean, double(expected_sum) / 90, 1e-9);
+
+    // appending concatenates the segment statistics
+    sarray<flexible_type> array2 = array.append(array);
+    sarray_segment_statistics stats2;
+    TS_ASSERT(array2.get_statistics(stats2));
+    TS_ASSERT_EQUALS(stats2.num_elements, 200);
+    TS_ASSERT_EQUALS(stats2.num_missing, 20);
+    TS_ASSERT_EQUALS(stats2.int_sum, 2 * expected_sum);
+    TS_ASSERT_EQUALS(stats2.int_min, -19);
+    TS_ASSERT_EQUALS(stats2.int_max, 79);
+    TS_ASSERT_DELTA(stats2.m2, 2 * stats.m2, 1e-6);
+
+    // the encoding round trips exactly
+    std::vector<sarray_segment_statistics> decoded;
+    TS_ASSERT(decode_segment_statistics(encode_segment_statistics({stats}), decoded));
+    TS_ASSERT_EQUALS(decoded.size(), 1);
+    TS_ASSERT_EQUALS(decoded[0].m2, stats.m2);
+    TS_ASSERT_EQUALS(decoded[0].int_sum, stats.int_sum);
+  }
+
+  void test_sarray_segment_statistics_datetime(void) {
+    std::vector<flexible_type> data;
+    for (size_t i = 0;i < 100; ++i) {
+      if (i % 10 == 0) data.push_back(FLEX_UNDEFINED);
+      else data.push_back(flex_date_time(i * 3600, 0));
+    }
+    sarray<flexible_type> array;
+    array.open_for_write(4);
+    array.set_type(flex_type_enum::DATETIME);
+    graphlab::copy(data.begin(), data.end(), array);
+    array.close();
+
+    sarray_segment_statistics stats;
+    TS_ASSERT(array.get_statistics(stats));
+    TS_ASSERT_EQUALS(stats.num_elements, 100);
+    TS_ASSERT_EQUALS(stats.num_missing, 10);
+    TS_ASSERT_EQUALS(stats.num_nonzero, 0);
+    TS_ASSERT_EQUALS(stats.num_int, 0);
+    TS_ASSERT_EQUALS(stats.num_float, 0);
+
+    std::vector<flexible_type> rval;
+    array.get_reader()->read_rows(0, 100, rval);
+    TS_ASSERT_EQUALS(rval.size(), 100);
+    TS_ASSERT(rval[1] == data[1]);
+  }
+
   void validate_test_sarray_logical_segments(std::unique_ptr<sarray_reader<size_t> > reader,
                                              size_t nsegments) {
     TS_ASSERT_EQUALS(reader->num_segments(), nsegments);
@@ -16,6 +16,7 @@
 */
 #include <iostream>
 #include <typeinfo>
+#include <limits>
 #include <boost/filesystem.hpp>
 #include <sframe/sframe.hpp>
 #include <sframe/algorithm.hpp>
@@ -848,4 +849,27 @@ class sframe_test : public CxxTest::TestSuite {
    void test_alternate_line_endings() {
      evaluate(alternate_endline_test());
    }
+
+   void test_write_numbers() {
+     // numbers are formatted without a stringstream, but must print just
+     // as std::string(flexible_type) does.
+     std::vector<flexible_type> row{flex_int(0), flex_int(-7), flex_int(1234567890123),
+                                    flex_int(std::numeric_limits<int64_t>::min()),
+                                    flex_int(std::numeric_limits<int64_t>::max()),
+                                    0.0, -1.5, 1.0/3, 1e20, 123456789.0, 1e-7};
+     std::string expected;
+     for (size_t i = 0; i < row.size(); ++i) {
+       if (i > 0) expected += ",";
+       expected += std::string(row[i]);
+     }
+     csv_writer writer;
+     std::stringstream strm;
+     writer.write(strm, row);
+     TS_ASSERT_EQUALS(strm.str(), expected + "\n");
+
+     writer.quote_level = csv_writer::csv_quote_level::QUOTE_ALL;
+     strm.str("");
+     writer.write(strm, std::vector<flexible_type>{flex_int(-12), 2.5});
+     TS_ASSERT_EQUALS(strm.str(), "\"-12\",\"2.5\"\n");
+   }
 };
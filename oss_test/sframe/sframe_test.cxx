@@ -289,6 +289,49 @@ class sframe_test : public CxxTest::TestSuite {
     }
 
 
+    void test_sframe_save_by_linking() {
+      std::vector<std::vector<flexible_type>> data_rows;
+      for(size_t i = 0; i < 10000; ++i) {
+        data_rows.push_back({i, std::to_string(i)});
+      }
+      sframe frame;
+      frame.open_for_write({"nums", "words"},
+                           {flex_type_enum::INTEGER, flex_type_enum::STRING},
+                           "", 4);
+      graphlab::copy(data_rows.begin(), data_rows.end(), frame);
+      frame.close();
+
+      auto check_rows = [&](const sframe& sf, bool swapped) {
+        std::vector<std::vector<flexible_type> > rows;
+        graphlab::copy(sf, std::inserter(rows, rows.end()));
+        TS_ASSERT_EQUALS(rows.size(), data_rows.size());
+        for (size_t i = 0;i < rows.size(); ++i) {
+          TS_ASSERT_EQUALS(rows[i][swapped ? 1 : 0], data_rows[i][0]);
+          TS_ASSERT_EQUALS(rows[i][swapped ? 0 : 1], data_rows[i][1]);
+        }
+      };
+
+      // all the columns of the group, in order: segment files are linked
+      std::string linked_index = get_temp_name() + ".frame_idx";
+      TS_ASSERT(sframe_save_by_linking(frame, linked_index));
+      sframe linked(linked_index);
+      TS_ASSERT_EQUALS(linked.num_segments(), 4);
+      TS_ASSERT_EQUALS(linked.column_name(1), "words");
+      auto segment_file = parse_v2_segment_filename(
+          linked.select_column(0)->get_index_info().segment_files[0]).first;
+      TS_ASSERT_EQUALS(boost::filesystem::hard_link_count(segment_file), 2);
+      check_rows(linked, false);
+
+      // reordered columns: the blocks are copied
+      sframe reordered = frame.select_columns({"words", "nums"});
+      std::string copied_index = get_temp_name() + ".frame_idx";
+      TS_ASSERT(!sframe_save_by_linking(reordered, copied_index));
+      reordered.save(copied_index);
+      sframe copied(copied_index);
+      TS_ASSERT_EQUALS(copied.num_segments(), 1);
+      check_rows(copied, true);
+    }
+
     void test_sframe_save_reference_no_copy() {
       // Create an sarray from on-disk representation
       auto tmp_ptr = new sarray<flexible_type>(test_writer_prefix);
@@ -1663,4 +1706,41 @@ class sframe_test : public CxxTest::TestSuite {
        ++i;
      }
    }
+
+   void test_sframe_rows_recycled_columns() {
+     // a released column is handed out again, empty
+     auto col = sframe_rows::make_column();
+     col->resize(100, flexible_type("hello world, this is a long string"));
+     auto storage = col->data();
+     col.reset();
+     auto col2 = sframe_rows::make_column();
+     TS_ASSERT_EQUALS(col2->size(), 0);
+     TS_ASSERT_EQUALS(col2->data(), storage);
+
+     // reset() does not copy columns shared with another sframe_rows
+     sframe_rows rows;
+     rows.resize(2, 10);
+     for (size_t i = 0; i < 10; ++i) {
+       rows[i][0] = flexible_type(flex_int(i));
+       rows[i][1] = flexible_type(std::to_string(i));
+     }
+     sframe_rows downstream = rows;
+     rows.reset(2);
+     TS_ASSERT_EQUALS(rows.num_columns(), 2);
+     TS_ASSERT_EQUALS(rows.num_rows(), 0);
+     TS_ASSERT_EQUALS(downstream.num_rows(), 10);
+     TS_ASSERT(rows.cget_columns()[0] != downstream.cget_columns()[0]);
+     rows.resize(2, 5);
+     for (size_t i = 0; i < 5; ++i) rows[i][0] = flexible_type(flex_int(100 + i));
+     for (size_t i = 0; i < 10; ++i) {
+       TS_ASSERT_EQUALS(downstream[i][0], flexible_type(flex_int(i)));
+       TS_ASSERT_EQUALS(downstream[i][1], flexible_type(std::to_string(i)));
+     }
+
+     // columns owned by the sframe_rows only are emptied in place
+     auto owned = rows.cget_columns()[1].get();
+     rows.reset(2);
+     TS_ASSERT_EQUALS(rows.cget_columns()[1].get(), owned);
+     TS_ASSERT_EQUALS(rows.num_rows(), 0);
+   }
 };
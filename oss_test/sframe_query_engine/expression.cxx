@@ -0,0 +1,171 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <cmath>
+#include <limits>
+#include <sframe_query_engine/algorithm/expression.hpp>
+#include <cxxtest/TestSuite.h>
+
+using namespace graphlab;
+using namespace graphlab::query_eval;
+
+class expression_test: public CxxTest::TestSuite {
+ public:
+  void test_sframe_row_expression() {
+    // lambda x: x['a'] * 2 if x['b'] else 0
+    flexible_type expr = flex_list{"if", flex_list{"getitem", flex_list{"input"}, flex_list{"const", "b"}},
+                                         flex_list{"*", flex_list{"getitem", flex_list{"input"}, flex_list{"const", "a"}},
+                                                        flex_list{"const", 2}},
+                                         flex_list{"const", 0}};
+    auto compiled = compile_expression(expr, {"a", "b"},
+                                       {flex_type_enum::INTEGER, flex_type_enum::STRING});
+    TS_ASSERT_EQUALS(compiled.output_type, flex_type_enum::INTEGER);
+    auto out = evaluate(compiled, {{1, 2, 3, FLEX_UNDEFINED}, {"x", "", "y", ""}});
+    TS_ASSERT_EQUALS(out[0], 2);
+    TS_ASSERT_EQUALS(out[1], 0);
+    TS_ASSERT_EQUALS(out[2], 6);
+    TS_ASSERT_EQUALS(out[3], 0);
+
+    // the whole row as a dictionary
+    auto row_dict = compile_expression(flex_list{"input"}, {"a", "b"},
+                                       {flex_type_enum::INTEGER, flex_type_enum::STRING});
+    out = evaluate(row_dict, {{1}, {"x"}});
+    TS_ASSERT_EQUALS(out[0].get_type(), flex_type_enum::DICT);
+    TS_ASSERT_EQUALS(out[0].get<flex_dict>().size(), 2);
+
+    TS_ASSERT_THROWS_ANYTHING(compile_expression(
+        flex_list{"getitem", flex_list{"input"}, flex_list{"const", "c"}}, {"a"},
+        {flex_type_enum::INTEGER}));
+  }
+
+  void test_arithmetic() {
+    auto x = flex_list{"input"};
+    auto c = [](flexible_type v) { return flex_list{"const", v}; };
+    TS_ASSERT_EQUALS(eval_one(flex_list{"+", x, c(1.5)}, 2), 3.5);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"/", x, c(4)}, 2), 0.5);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"//", x, c(2)}, -3), -2);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"%", x, c(3)}, -1), 2);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"%", x, c(3.0)}, -1.0), 2.0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"neg", x}, 2), -2);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"abs", x}, -2.5), 2.5);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"<", x, c(3)}, 2.5), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{">=", x, c("b")}, "a"), 0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"==", x, c(FLEX_UNDEFINED)}, FLEX_UNDEFINED), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"!=", x, c("a")}, 1), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"+", x, c("b")}, "a"), "ab");
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"+", x, c("b")}, 1));
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"/", x, c(0)}, 1));
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"*", x, c(2)}, FLEX_UNDEFINED));
+
+    // constant folding
+    auto folded = compile_expression(flex_list{"*", c(3), c(4)}, {}, {flex_type_enum::STRING});
+    TS_ASSERT_EQUALS(folded.output_type, flex_type_enum::INTEGER);
+    TS_ASSERT_EQUALS(evaluate(folded, {{"x"}})[0], 12);
+  }
+
+  void test_fold_errors() {
+    auto x = flex_list{"input"};
+    auto c = [](flexible_type v) { return flex_list{"const", v}; };
+    // errors in branches which are not taken are not raised
+    auto expr = flex_list{"if", x, flex_list{"/", c(1), c(0)}, c(2)};
+    auto compiled = compile_expression(expr, {}, {flex_type_enum::INTEGER});
+    TS_ASSERT_EQUALS(evaluate(compiled, {{0}})[0], 2);
+    TS_ASSERT_THROWS_ANYTHING(evaluate(compiled, {{1}}));
+
+    auto never = compile_expression(
+        flex_list{"if", c(0), flex_list{"getitem", c(flex_list{}), c(3)}, x},
+        {}, {flex_type_enum::INTEGER});
+    TS_ASSERT_EQUALS(evaluate(never, {{5}})[0], 5);
+
+    // and an expression which always fails compiles, failing on every row
+    auto always = compile_expression(flex_list{"neg", c("a")}, {}, {flex_type_enum::INTEGER});
+    TS_ASSERT_THROWS_ANYTHING(evaluate(always, {{1}}));
+  }
+
+  void test_integer_overflow() {
+    auto x = flex_list{"input"};
+    auto c = [](flexible_type v) { return flex_list{"const", v}; };
+    const flex_int max = std::numeric_limits<flex_int>::max();
+    const flex_int min = std::numeric_limits<flex_int>::min();
+    // wraps around, when folded and when evaluated
+    TS_ASSERT_EQUALS(eval_one(flex_list{"+", c(max), c(1)}, 0), min);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"+", x, c(1)}, max), min);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"-", x, c(1)}, min), max);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"*", x, c(2)}, max), -2);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"neg", x}, min), min);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"abs", x}, min), min);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"//", x, c(-1)}, min), min);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"%", x, c(-1)}, min), 0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"//", x, c(-1)}, 7), -7);
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"int", x}, 1e30));
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"int", x}, std::nan("")));
+  }
+
+  void test_logic_and_strings() {
+    auto x = flex_list{"input"};
+    auto c = [](flexible_type v) { return flex_list{"const", v}; };
+    TS_ASSERT_EQUALS(eval_one(flex_list{"and", x, c("yes")}, 1), "yes");
+    TS_ASSERT_EQUALS(eval_one(flex_list{"and", x, c("yes")}, 0), 0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"or", x, c("no")}, ""), "no");
+    TS_ASSERT_EQUALS(eval_one(flex_list{"not", x}, flex_list()), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"is_none", x}, FLEX_UNDEFINED), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"lower", x}, "AbC"), "abc");
+    TS_ASSERT_EQUALS(eval_one(flex_list{"upper", x}, "AbC"), "ABC");
+    TS_ASSERT_EQUALS(eval_one(flex_list{"strip", x}, "  a b "), "a b");
+    TS_ASSERT_EQUALS(eval_one(flex_list{"len", x}, "abc"), 3);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"in", c("b"), x}, "abc"), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"startswith", x, c("ab")}, "abc"), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"endswith", x, c("ab")}, "abc"), 0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"int", x}, "42"), 42);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"int", x}, " -7 "), -7);
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"int", x}, "3.5"));
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"int", x}, "12abc"));
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"int", x}, ""));
+    TS_ASSERT_EQUALS(eval_one(flex_list{"float", x}, 2), 2.0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"float", x}, "2.5"), 2.5);
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"float", x}, "2.5x"));
+    // bytes outside ASCII are left alone
+    TS_ASSERT_EQUALS(eval_one(flex_list{"lower", x}, "A\xc3\x89"), "a\xc3\x89");
+    TS_ASSERT_EQUALS(eval_one(flex_list{"upper", x}, "a\xc3\xa9"), "A\xc3\xa9");
+    flexible_type parts = eval_one(flex_list{"split", x, c("/")}, "a/b//c");
+    TS_ASSERT_EQUALS(parts.get<flex_list>().size(), 4);
+    TS_ASSERT_EQUALS(parts.get<flex_list>()[3], "c");
+  }
+
+  void test_containers() {
+    auto x = flex_list{"input"};
+    auto c = [](flexible_type v) { return flex_list{"const", v}; };
+    flexible_type d = flex_dict{{"a", 1}, {"b", 2}};
+    TS_ASSERT_EQUALS(eval_one(flex_list{"getitem", x, c("b")}, d), 2);
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"getitem", x, c("c")}, d));
+    TS_ASSERT_EQUALS(eval_one(flex_list{"get", x, c("c"), c(7)}, d), 7);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"in", c("a"), x}, d), 1);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"getitem", x, c(-1)}, flex_vec{1, 2, 3}), 3.0);
+    TS_ASSERT_EQUALS(eval_one(flex_list{"getitem", x, c(0)}, flex_list{"p", 2}), "p");
+    TS_ASSERT_THROWS_ANYTHING(eval_one(flex_list{"getitem", x, c(5)}, flex_list{"p", 2}));
+    TS_ASSERT_THROWS_ANYTHING(compile_expression(flex_list{"nope", x}, {}, {flex_type_enum::INTEGER}));
+  }
+
+ private:
+  std::vector<flexible_type> evaluate(const compiled_expression& compiled,
+                                      const std::vector<std::vector<flexible_type>>& columns) {
+    sframe_rows rows;
+    for (const auto& column: columns) {
+      rows.add_decoded_column(std::make_shared<std::vector<flexible_type>>(column));
+    }
+    std::vector<flexible_type> ret;
+    for (auto iter = rows.cbegin(); iter != rows.cend(); ++iter) {
+      ret.push_back(compiled.fn(*iter));
+    }
+    return ret;
+  }
+
+  flexible_type eval_one(const flexible_type& expr, const flexible_type& value) {
+    auto compiled = compile_expression(expr, {}, {value.get_type()});
+    return evaluate(compiled, {{value}})[0];
+  }
+};
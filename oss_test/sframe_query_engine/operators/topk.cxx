@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <sframe_query_engine/execution/execution_node.hpp>
+#include <sframe_query_engine/operators/sarray_source.hpp>
+#include <sframe_query_engine/operators/limit.hpp>
+#include <sframe_query_engine/operators/topk.hpp>
+#include <sframe/sarray.hpp>
+#include <sframe/algorithm.hpp>
+#include <cxxtest/TestSuite.h>
+
+#include "check_node.hpp"
+
+using namespace graphlab;
+using namespace graphlab::query_eval;
+
+class topk_test: public CxxTest::TestSuite {
+ public:
+
+  void test_topk() {
+    std::vector<flexible_type> data;
+    for (size_t i = 0; i < 5000; ++i) data.push_back((i * 7919) % 5000);
+    data.push_back(FLEX_UNDEFINED);
+    auto data_sa = make_sarray(data);
+
+    for (size_t k : {0, 1, 5, 100, 6000}) {
+      std::vector<flexible_type> expected;
+      for (size_t i = 0; i < std::min<size_t>(k, 5000); ++i) expected.push_back(4999 - i);
+      check_node(make_topk_node(data_sa, k, false), expected);
+
+      expected.clear();
+      for (size_t i = 0; i < std::min<size_t>(k, 5000); ++i) expected.push_back(i);
+      check_node(make_topk_node(data_sa, k, true), expected);
+    }
+  }
+
+  void test_limit() {
+    std::vector<flexible_type> data;
+    for (size_t i = 0; i < 5000; ++i) data.push_back(i);
+    auto data_sa = make_sarray(data);
+
+    for (size_t limit : {0, 1, 100, 1000, 5000, 6000}) {
+      std::vector<flexible_type> expected(data.begin(),
+                                          data.begin() + std::min<size_t>(limit, 5000));
+      auto source_node = std::make_shared<execution_node>(
+          std::make_shared<op_sarray_source>(data_sa));
+      auto node = std::make_shared<execution_node>(
+          std::make_shared<op_limit>(limit),
+          std::vector<std::shared_ptr<execution_node>>({source_node}));
+      check_node(node, expected);
+    }
+  }
+
+ private:
+  std::shared_ptr<sarray<flexible_type>> make_sarray(const std::vector<flexible_type>& data) {
+    auto sa = std::make_shared<sarray<flexible_type>>();
+    sa->open_for_write();
+    graphlab::copy(data.begin(), data.end(), *sa);
+    sa->close();
+    return sa;
+  }
+
+  std::shared_ptr<execution_node> make_topk_node(
+      std::shared_ptr<sarray<flexible_type>> sa, size_t k, bool reverse) {
+    auto source_node = std::make_shared<execution_node>(
+        std::make_shared<op_sarray_source>(sa));
+    return std::make_shared<execution_node>(
+        std::make_shared<op_topk>(k, 0, reverse),
+        std::vector<std::shared_ptr<execution_node>>({source_node}));
+  }
+};
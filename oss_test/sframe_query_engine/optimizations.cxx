@@ -411,6 +411,18 @@ static node make_append(node n1, node n2) {
   return ret;
 }
 
+static node make_limit(node n1, size_t limit) {
+
+  node ret;
+
+  for(size_t i = 0; i < n1.v.size(); ++i)
+    ret.v[i] = op_limit::make_planner_node(n1.v[i], limit);
+
+  ret.pull_history({n1});
+
+  return ret;
+}
+
 static void check_sframes(sframe sf1, sframe sf2, std::string tag) {
   
   std::vector<std::vector<std::vector<flexible_type> > > results(2);
@@ -984,6 +996,38 @@ class opts : public CxxTest::TestSuite {
     _RUN(n);
   }
 
+  void test_limit_on_source() {
+    _RUN(make_limit(source_sframe(5), 5));
+    _RUN(make_limit(source_sframe(5), 0));
+    _RUN(make_limit(source_sframe(5), 2 * n));
+  }
+
+  void test_limit_linear_transform_exchange() {
+    node n1 = source_sframe(3);
+    node n2 = source_sframe(2);
+
+    node u = make_union(make_transform(n1), make_project(n2, {1, 0}));
+
+    _RUN(make_limit(u, n / 2));
+  }
+
+  void test_limit_logical_filter() {
+    node n1 = make_transform(source_sframe(5));
+    node mask = binary_source_sarray();
+
+    _RUN(make_limit(make_logical_filter(n1, mask), 3));
+    _RUN(make_union(make_limit(make_logical_filter(n1, mask), 3),
+                    make_limit(make_logical_filter(n1, mask), 3)));
+  }
+
+  void test_limit_append_exchange() {
+    node a = make_append(source_sframe(5), source_sframe(5));
+
+    _RUN(make_limit(a, n / 2));
+    _RUN(make_limit(a, n + n / 2));
+    _RUN(make_limit(make_limit(a, n + 1), n / 2));
+  }
+
   void test_empty_sframe() {
     node n = empty_sframe(5);
     _RUN(n);
@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2016 Turi
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license. See the LICENSE file for details.
+ */
+#include <sframe_query_engine/planning/planner.hpp>
+#include <sframe_query_engine/planning/planner_node.hpp>
+#include <sframe_query_engine/operators/all_operators.hpp>
+#include <sframe_query_engine/algorithm/sample.hpp>
+#include <util/cityhash_gl.hpp>
+#include <sframe/sarray.hpp>
+#include <sframe/algorithm.hpp>
+#include <cxxtest/TestSuite.h>
+
+using namespace graphlab;
+using namespace graphlab::query_eval;
+
+class sample_test: public CxxTest::TestSuite {
+ public:
+
+  void test_row_bernoulli() {
+    auto root = op_sarray_source::make_planner_node(make_data(100000));
+    auto mask = read_all(make_sample_mask(root, 0.3, 12345,
+                                          sampling_method::ROW_BERNOULLI));
+    TS_ASSERT_EQUALS(mask.size(), 100000);
+
+    // the same rows as the hash based selection used elsewhere
+    uint64_t seed_hash = flexible_type((flex_int)(12345)).hash();
+    uint64_t sample_limit = hash64_proportion_cutoff(0.3);
+    for (size_t i = 0; i < mask.size(); ++i) {
+      TS_ASSERT_EQUALS((flex_int)mask[i], flex_int(hash64(i ^ seed_hash) <= sample_limit));
+    }
+  }
+
+  void test_block_sampling() {
+    auto root = op_sarray_source::make_planner_node(make_data(1000000));
+    auto boundaries = get_source_block_boundaries(root);
+    TS_ASSERT(boundaries.size() >= 2);
+    TS_ASSERT_EQUALS(boundaries.front(), 0);
+    TS_ASSERT_EQUALS(boundaries.back(), 1000000);
+
+    for (auto method : {sampling_method::BLOCK_BERNOULLI,
+                        sampling_method::BLOCK_SYSTEMATIC}) {
+      auto mask = read_all(make_sample_mask(root, 0.5, 12345, method));
+      TS_ASSERT_EQUALS(mask.size(), 1000000);
+      // every block is either entirely in the sample or entirely out of it
+      for (size_t b = 0; b + 1 < boundaries.size(); ++b) {
+        for (size_t i = boundaries[b]; i < boundaries[b + 1]; ++i) {
+          TS_ASSERT_EQUALS(mask[i], mask[boundaries[b]]);
+        }
+      }
+    }
+
+    // block boundaries of a slice are relative to the slice
+    auto sliced = op_sarray_source::make_planner_node(make_data(1000000), 1000, 900000);
+    auto sliced_boundaries = get_source_block_boundaries(sliced);
+    TS_ASSERT_EQUALS(sliced_boundaries.front(), 0);
+    TS_ASSERT_EQUALS(sliced_boundaries.back(), 899000);
+
+    // no block layout through a non-linear node: falls back to rows
+    auto filtered = op_logical_filter::make_planner_node(root, root);
+    TS_ASSERT(get_source_block_boundaries(filtered).empty());
+  }
+
+  void test_auto_sampling() {
+    auto root = op_sarray_source::make_planner_node(make_data(1000000));
+    auto row_mask = read_all(make_sample_mask(root, 0.001, 12345,
+                                              sampling_method::ROW_BERNOULLI));
+    // block sampling is opt-in
+    TS_ASSERT(read_all(make_sample_mask(root, 0.001, 12345)) == row_mask);
+    TS_ASSERT(read_all(make_sample_mask(root, 0.001, 12345,
+                                        sampling_method::AUTO)) == row_mask);
+
+    double old_threshold = SFRAME_BLOCK_SAMPLING_THRESHOLD;
+    SFRAME_BLOCK_SAMPLING_THRESHOLD = 1;
+    // too few blocks would be selected: stays with rows
+    TS_ASSERT(read_all(make_sample_mask(root, 0.001, 12345,
+                                        sampling_method::AUTO)) == row_mask);
+    auto boundaries = get_source_block_boundaries(root);
+    size_t num_blocks = boundaries.size() - 1;
+    if (num_blocks * 0.5 >= 16) {
+      TS_ASSERT(read_all(make_sample_mask(root, 0.5, 12345, sampling_method::AUTO)) ==
+                read_all(make_sample_mask(root, 0.5, 12345,
+                                          sampling_method::BLOCK_BERNOULLI)));
+    }
+    SFRAME_BLOCK_SAMPLING_THRESHOLD = old_threshold;
+  }
+
+  void test_sampling_method_names() {
+    TS_ASSERT(sampling_method_from_string("row") == sampling_method::ROW_BERNOULLI);
+    TS_ASSERT(sampling_method_from_string("block") == sampling_method::BLOCK_BERNOULLI);
+    TS_ASSERT(sampling_method_from_string("block_systematic") ==
+              sampling_method::BLOCK_SYSTEMATIC);
+    TS_ASSERT(sampling_method_from_string("auto") == sampling_method::AUTO);
+    TS_ASSERT_THROWS_ANYTHING(sampling_method_from_string("rows"));
+  }
+
+  void test_exact_sample() {
+    auto root = op_sarray_source::make_planner_node(make_data(100000));
+    for (size_t num_rows : {0, 1, 500, 50000, 100000, 200000}) {
+      auto mask = read_all(make_exact_sample_mask(root, num_rows, 12345));
+      TS_ASSERT_EQUALS(mask.size(), 100000);
+      size_t count = 0;
+      for (const auto& v: mask) count += (flex_int)v;
+      TS_ASSERT_EQUALS(count, std::min<size_t>(num_rows, 100000));
+    }
+    // deterministic for a given seed
+    TS_ASSERT(read_all(make_exact_sample_mask(root, 500, 1)) ==
+              read_all(make_exact_sample_mask(root, 500, 1)));
+    TS_ASSERT(read_all(make_exact_sample_mask(root, 500, 1)) !=
+              read_all(make_exact_sample_mask(root, 500, 2)));
+  }
+
+ private:
+  std::shared_ptr<sarray<flexible_type>> make_data(size_t length) {
+    std::vector<flexible_type> data;
+    for (size_t i = 0; i < length; ++i) data.push_back(i);
+    auto sa = std::make_shared<sarray<flexible_type>>();
+    sa->open_for_write();
+    graphlab::copy(data.begin(), data.end(), *sa);
+    sa->close();
+    return sa;
+  }
+
+  std::vector<flexible_type> read_all(std::shared_ptr<planner_node> node) {
+    auto res = planner().materialize(node);
+    std::vector<flexible_type> ret;
+    res.select_column(0)->get_reader()->read_rows(0, res.size(), ret);
+    return ret;
+  }
+};
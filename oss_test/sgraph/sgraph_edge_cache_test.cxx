@@ -0,0 +1,154 @@
+/*
+* Copyright (C) 2016 Turi
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Affero General Public License as
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <sgraph/sgraph.hpp>
+#include <sgraph/sgraph_engine.hpp>
+#include <sgraph/sgraph_edge_cache.hpp>
+#include <sgraph/sgraph_constants.hpp>
+#include <cxxtest/TestSuite.h>
+
+#include "sgraph_test_util.hpp"
+
+using namespace graphlab;
+using namespace graphlab::sgraph_compute;
+
+/**
+ * A ring with a star centered at vertex 0, without edge data.
+ */
+sgraph create_ring_star_graph(size_t nverts, size_t npartition) {
+  std::vector<flexible_type> sources, targets;
+  for (size_t i = 0; i < nverts; ++i) {
+    sources.push_back(i);
+    targets.push_back((i + 1) % nverts);
+    if (i > 0 && i < nverts - 1) {
+      sources.push_back(i);
+      targets.push_back(0);
+    }
+  }
+  sgraph g(npartition);
+  g.add_edges(create_sframe({{"source", flex_type_enum::INTEGER, sources},
+                             {"target", flex_type_enum::INTEGER, targets}}),
+              "source", "target");
+  return g;
+}
+
+std::map<flexible_type, flexible_type> in_degree(sgraph& g) {
+  typedef sgraph_engine<flexible_type>::graph_data_type graph_data_type;
+  sgraph_engine<flexible_type> ga;
+  auto result = ga.gather(g,
+                          [](const graph_data_type& center,
+                             const graph_data_type& edge,
+                             const graph_data_type& other,
+                             sgraph::edge_direction edgedir,
+                             flexible_type& combiner) {
+                            combiner = combiner + 1;
+                          },
+                          flexible_type(0),
+                          sgraph::edge_direction::IN_EDGE);
+  auto vertex_ids = g.fetch_vertex_data_field(sgraph::VID_COLUMN_NAME);
+  std::map<flexible_type, flexible_type> ret;
+  for (size_t i = 0; i < result.size(); ++i) {
+    std::vector<flexible_type> degrees, ids;
+    result[i]->get_reader()->read_rows(0, g.num_vertices(), degrees);
+    vertex_ids[i]->get_reader()->read_rows(0, g.num_vertices(), ids);
+    for (size_t j = 0; j < ids.size(); ++j) ret[ids[j]] = degrees[j];
+  }
+  return ret;
+}
+
+class sgraph_edge_cache_test: public CxxTest::TestSuite {
+ public:
+  void test_csr_structure() {
+    sgraph_edge_cache::get_instance().clear();
+    size_t npartition = 4;
+    sgraph g = create_ring_star_graph(1000, npartition);
+    for (size_t i = 0; i < npartition; ++i) {
+      for (size_t j = 0; j < npartition; ++j) {
+        const sframe& edges = g.edge_partition(i, j);
+        size_t num_src = g.vertex_partition(i).size();
+        size_t num_dst = g.vertex_partition(j).size();
+        auto csr = sgraph_edge_cache::get_instance().get(edges, num_src, num_dst);
+        TS_ASSERT(csr != nullptr);
+        TS_ASSERT_EQUALS(csr->num_edges(), edges.num_rows());
+        TS_ASSERT_EQUALS(csr->num_src_vertices(), num_src);
+        TS_ASSERT_EQUALS(csr->num_dst_vertices(), num_dst);
+
+        std::vector<flexible_type> src, dst;
+        edges.select_column(sgraph::SRC_COLUMN_NAME)->get_reader()->read_rows(0, edges.num_rows(), src);
+        edges.select_column(sgraph::DST_COLUMN_NAME)->get_reader()->read_rows(0, edges.num_rows(), dst);
+        for (size_t e = 0; e < edges.num_rows(); ++e) {
+          TS_ASSERT_EQUALS(csr->src(e), (size_t)src[e]);
+          TS_ASSERT_EQUALS(csr->dst(e), (size_t)dst[e]);
+        }
+        size_t num_in = 0;
+        for (size_t v = 0; v < num_dst; ++v) {
+          for (size_t k = csr->in_begin(v); k < csr->in_end(v); ++k, ++num_in) {
+            TS_ASSERT_EQUALS(csr->dst(csr->in_edge(k)), v);
+            if (k > csr->in_begin(v)) TS_ASSERT_LESS_THAN(csr->in_edge(k - 1), csr->in_edge(k));
+          }
+        }
+        size_t num_out = 0;
+        for (size_t v = 0; v < num_src; ++v) {
+          for (size_t k = csr->out_begin(v); k < csr->out_end(v); ++k, ++num_out) {
+            TS_ASSERT_EQUALS(csr->src(csr->out_edge(k)), v);
+          }
+        }
+        TS_ASSERT_EQUALS(num_in, edges.num_rows());
+        TS_ASSERT_EQUALS(num_out, edges.num_rows());
+
+        // cached
+        TS_ASSERT_EQUALS(csr.get(), sgraph_edge_cache::get_instance().get(edges, num_src, num_dst).get());
+      }
+    }
+    TS_ASSERT_EQUALS(sgraph_edge_cache::get_instance().num_entries(), npartition * npartition);
+    TS_ASSERT_LESS_THAN(0, sgraph_edge_cache::get_instance().memory_usage());
+  }
+
+  void test_capacity() {
+    sgraph_edge_cache::get_instance().clear();
+    sgraph g = create_ring_star_graph(1000, 2);
+    size_t old_capacity = SGRAPH_EDGE_CACHE_CAPACITY;
+
+    // a partition which does not fit is not cached
+    SGRAPH_EDGE_CACHE_CAPACITY = 0;
+    auto uncached = in_degree(g);
+    TS_ASSERT(sgraph_edge_cache::get_instance().get(
+        g.edge_partition(0, 0),
+        g.vertex_partition(0).size(),
+        g.vertex_partition(0).size()) == nullptr);
+    TS_ASSERT_EQUALS(sgraph_edge_cache::get_instance().num_entries(), 0);
+
+    // room for about one partition: older entries are evicted
+    SGRAPH_EDGE_CACHE_CAPACITY = edge_partition_csr::estimate_memory_usage(
+        g.edge_partition(0, 0).num_rows(),
+        g.vertex_partition(0).size(),
+        g.vertex_partition(0).size()) + 1024;
+    auto cached = in_degree(g);
+    TS_ASSERT_LESS_THAN_EQUALS(sgraph_edge_cache::get_instance().memory_usage(),
+                               SGRAPH_EDGE_CACHE_CAPACITY);
+
+    SGRAPH_EDGE_CACHE_CAPACITY = old_capacity;
+    auto cached_again = in_degree(g);
+    auto cached_twice = in_degree(g);
+
+    TS_ASSERT_EQUALS(uncached.size(), 1000);
+    TS_ASSERT_EQUALS((size_t)uncached[0], 999);
+    TS_ASSERT_EQUALS((size_t)uncached[1], 1);
+    TS_ASSERT(uncached == cached);
+    TS_ASSERT(uncached == cached_again);
+    TS_ASSERT(uncached == cached_twice);
+  }
+};
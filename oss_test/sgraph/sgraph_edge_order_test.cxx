@@ -0,0 +1,149 @@
+/*
+* Copyright (C) 2016 Turi
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Affero General Public License as
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <sgraph/sgraph.hpp>
+#include <sgraph/sgraph_edge_order.hpp>
+#include <sgraph/sgraph_constants.hpp>
+#include <cxxtest/TestSuite.h>
+
+#include "sgraph_test_util.hpp"
+
+using namespace graphlab;
+
+/**
+ * A ring with extra edges into vertex 0. The edge data of edge u -> v is
+ * the string u + v.
+ */
+sgraph create_test_graph(size_t nverts, size_t npartition) {
+  sgraph g = create_ring_graph(nverts, npartition);
+  std::vector<flexible_type> sources, targets, edata;
+  for (size_t i = 2; i < nverts; ++i) {
+    sources.push_back(i);
+    targets.push_back(0);
+    edata.push_back(std::to_string(i) + "0");
+  }
+  g.add_edges(create_sframe({{"source", flex_type_enum::INTEGER, sources},
+                             {"target", flex_type_enum::INTEGER, targets},
+                             {"edata", flex_type_enum::STRING, edata}}),
+              "source", "target");
+  return g;
+}
+
+class sgraph_edge_order_test: public CxxTest::TestSuite {
+ public:
+  void test_reorder_edges() {
+    size_t nverts = 1000;
+    sgraph g = create_test_graph(nverts, 4);
+    size_t num_edges = g.num_edges();
+    TS_ASSERT_EQUALS((int)get_edge_order(g, 0, 0), (int)edge_order::INSERTION);
+
+    reorder_edges(g, edge_order::SOURCE_TARGET);
+    check_edges(g, num_edges);
+    for_each_edge_partition(g, [&](size_t i, size_t j,
+                                   const std::vector<std::vector<flexible_type>>& rows,
+                                   size_t src_column, size_t dst_column) {
+      TS_ASSERT_EQUALS((int)get_edge_order(g, i, j), (int)edge_order::SOURCE_TARGET);
+      for (size_t k = 1; k < rows.size(); ++k) {
+        const auto& a = rows[k - 1];
+        const auto& b = rows[k];
+        TS_ASSERT(a[src_column] < b[src_column] ||
+                  (a[src_column] == b[src_column] && !(b[dst_column] < a[dst_column])));
+      }
+    });
+
+    reorder_edges(g, edge_order::HILBERT);
+    check_edges(g, num_edges);
+    TS_ASSERT_EQUALS((int)get_edge_order(g, 1, 2), (int)edge_order::HILBERT);
+
+    // appending edges invalidates the recorded order
+    g.add_edges(create_sframe({{"source", flex_type_enum::INTEGER, {1}},
+                               {"target", flex_type_enum::INTEGER, {1}},
+                               {"edata", flex_type_enum::STRING, {"11"}}}),
+                "source", "target");
+    size_t p = flexible_type(1).hash() % g.get_num_partitions();
+    TS_ASSERT_EQUALS((int)get_edge_order(g, p, p), (int)edge_order::INSERTION);
+
+    // unless edges are sorted on ingress
+    size_t old_order = SGRAPH_INGRESS_EDGE_ORDER;
+    SGRAPH_INGRESS_EDGE_ORDER = (size_t)edge_order::SOURCE_TARGET;
+    g.add_edges(create_sframe({{"source", flex_type_enum::INTEGER, {2}},
+                               {"target", flex_type_enum::INTEGER, {2}},
+                               {"edata", flex_type_enum::STRING, {"22"}}}),
+                "source", "target");
+    SGRAPH_INGRESS_EDGE_ORDER = old_order;
+    check_edges(g, num_edges + 2);
+    p = flexible_type(2).hash() % g.get_num_partitions();
+    TS_ASSERT_EQUALS((int)get_edge_order(g, p, p), (int)edge_order::SOURCE_TARGET);
+  }
+
+  void test_relabel_vertices_by_degree() {
+    size_t nverts = 1000;
+    sgraph g = create_test_graph(nverts, 4);
+    size_t num_edges = g.num_edges();
+    reorder_edges(g, edge_order::SOURCE_TARGET);
+    relabel_vertices_by_degree(g);
+    check_edges(g, num_edges);
+    TS_ASSERT_EQUALS(g.num_vertices(), nverts);
+
+    // vertex 0 has the highest degree, and comes first in its partition
+    size_t p = flexible_type(0).hash() % g.get_num_partitions();
+    std::vector<flexible_type> ids;
+    g.vertex_partition(p).select_column(sgraph::VID_COLUMN_NAME)->get_reader()->read_rows(0, 1, ids);
+    TS_ASSERT_EQUALS(ids[0], 0);
+    TS_ASSERT_EQUALS((int)get_edge_order(g, p, p), (int)edge_order::INSERTION);
+  }
+
+ private:
+  typedef std::function<void(size_t, size_t,
+                             const std::vector<std::vector<flexible_type>>&,
+                             size_t, size_t)> partition_fn;
+
+  void for_each_edge_partition(sgraph& g, partition_fn fn) {
+    for (size_t i = 0; i < g.get_num_partitions(); ++i) {
+      for (size_t j = 0; j < g.get_num_partitions(); ++j) {
+        const sframe& edges = g.edge_partition(i, j);
+        std::vector<std::vector<flexible_type>> rows;
+        edges.get_reader()->read_rows(0, edges.num_rows(), rows);
+        fn(i, j, rows, edges.column_index(sgraph::SRC_COLUMN_NAME),
+           edges.column_index(sgraph::DST_COLUMN_NAME));
+      }
+    }
+  }
+
+  /**
+   * Checks that the graph has num_edges edges, and that the edge data of
+   * every edge still matches its end points.
+   */
+  void check_edges(sgraph& g, size_t num_edges) {
+    std::vector<std::vector<flexible_type>> vids(g.get_num_partitions());
+    for (size_t i = 0; i < g.get_num_partitions(); ++i) {
+      g.vertex_partition(i).select_column(sgraph::VID_COLUMN_NAME)->get_reader()->read_rows(
+          0, g.vertex_partition(i).num_rows(), vids[i]);
+    }
+    size_t count = 0;
+    for_each_edge_partition(g, [&](size_t i, size_t j,
+                                   const std::vector<std::vector<flexible_type>>& rows,
+                                   size_t src_column, size_t dst_column) {
+      size_t edata_column = g.edge_partition(i, j).column_index("edata");
+      for (const auto& row: rows) {
+        std::string expected = std::string(vids[i][row[src_column]]) + std::string(vids[j][row[dst_column]]);
+        TS_ASSERT_EQUALS(row[edata_column], expected);
+        ++count;
+      }
+    });
+    TS_ASSERT_EQUALS(count, num_edges);
+  }
+};
@@ -16,6 +16,7 @@
 */
 #include <sgraph/sgraph.hpp>
 #include <sgraph/sgraph_engine.hpp>
+#include <sgraph/sgraph_constants.hpp>
 #include <cxxtest/TestSuite.h>
 
 #include "sgraph_test_util.hpp"
@@ -107,6 +108,41 @@ void pagerank_fn(sgraph& g,  size_t num_iterations) {
   }
 }
 
+// Counts the active neighbors of each vertex with a frontier gather.
+// active_ids are the ids of the active vertices.
+std::map<flexible_type, flexible_type> frontier_count_fn(sgraph& g,
+                                                         sgraph::edge_direction dir,
+                                                         const std::set<flexible_type>& active_ids) {
+  typedef sgraph_compute::sgraph_engine<flexible_type>::graph_data_type graph_data_type;
+  sgraph_compute::sgraph_engine<flexible_type> ga;
+  auto vertex_ids = g.fetch_vertex_data_field(sgraph::VID_COLUMN_NAME);
+  std::vector<std::vector<flexible_type>> ids(vertex_ids.size());
+  auto active = ga.make_active_set(g);
+  for (size_t i = 0; i < vertex_ids.size(); ++i) {
+    vertex_ids[i]->get_reader()->read_rows(0, g.num_vertices(), ids[i]);
+    for (size_t j = 0; j < ids[i].size(); ++j) {
+      if (active_ids.count(ids[i][j])) active[i].set_bit(j);
+    }
+  }
+  auto result = ga.gather(g,
+                          [](const graph_data_type& center,
+                             const graph_data_type& edge,
+                             const graph_data_type& other,
+                             sgraph::edge_direction edgedir,
+                             flexible_type& combiner) {
+                            combiner = combiner + 1;
+                          },
+                          flexible_type(0), dir, active);
+  std::map<flexible_type, flexible_type> ret;
+  for (size_t i = 0; i < result.size(); ++i) {
+    std::vector<flexible_type> counts;
+    result[i]->get_reader()->read_rows(0, g.num_vertices(), counts);
+    TS_ASSERT_EQUALS(counts.size(), ids[i].size());
+    for (size_t j = 0; j < counts.size(); ++j) ret[ids[i][j]] = counts[j];
+  }
+  return ret;
+}
+
 class sgraph_engine_test: public CxxTest::TestSuite {
 
 public:
@@ -118,4 +154,33 @@ public:
    check_pagerank(pagerank_fn);
  }
 
+ void test_frontier_gather() {
+   typedef sgraph::edge_direction edge_direction;
+   size_t n_vertex = 1000;
+   sgraph g = create_ring_graph(n_vertex, 4, false /* one direction */);
+   double old_fraction = SGRAPH_SPARSE_GATHER_FRACTION;
+   // with edge data (streaming), then without (cached structure), both with
+   // dense sweeps and with sparse pushes
+   for (bool has_edge_data: {true, false}) {
+     if (!has_edge_data) g.remove_edge_field("edata");
+     for (double fraction: {0.0, 1.0}) {
+       SGRAPH_SPARSE_GATHER_FRACTION = fraction;
+       auto in_count = frontier_count_fn(g, edge_direction::IN_EDGE, {5, 500});
+       auto out_count = frontier_count_fn(g, edge_direction::OUT_EDGE, {5, 500});
+       auto any_count = frontier_count_fn(g, edge_direction::ANY_EDGE, {5, 500});
+       auto none = frontier_count_fn(g, edge_direction::ANY_EDGE, {});
+       TS_ASSERT_EQUALS(in_count.size(), n_vertex);
+       for (size_t i = 0; i < n_vertex; ++i) {
+         int expected_in = (i == 6 || i == 501);
+         int expected_out = (i == 4 || i == 499);
+         TS_ASSERT_EQUALS((int)in_count[i], expected_in);
+         TS_ASSERT_EQUALS((int)out_count[i], expected_out);
+         TS_ASSERT_EQUALS((int)any_count[i], expected_in + expected_out);
+         TS_ASSERT_EQUALS((int)none[i], 0);
+       }
+     }
+   }
+   SGRAPH_SPARSE_GATHER_FRACTION = old_fraction;
+ }
+
 };
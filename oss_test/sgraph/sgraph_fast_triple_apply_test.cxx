@@ -14,6 +14,7 @@
 * You should have received a copy of the GNU Affero General Public License
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <atomic>
 #include <sgraph/sgraph.hpp>
 #include <sgraph/sgraph_fast_triple_apply.hpp>
 #include <cxxtest/TestSuite.h>
@@ -69,6 +70,43 @@ std::vector<std::pair<flexible_type, flexible_type>> triple_apply_degree_count(
   return ret;
 }
 
+// Implement degree count function using typed_fast_triple_apply
+struct typed_degree_count_fn {
+  std::vector<std::vector<std::atomic<size_t>>>* degree;
+  bool count_in, count_out;
+  void operator()(sgraph_compute::typed_edge_scope& scope) const {
+    if (count_in) {
+      auto target_addr = scope.target_vertex_address();
+      (*degree)[target_addr.partition_id][target_addr.local_id]++;
+    }
+    if (count_out) {
+      auto source_addr = scope.source_vertex_address();
+      (*degree)[source_addr.partition_id][source_addr.local_id]++;
+    }
+  }
+};
+
+std::vector<std::pair<flexible_type, flexible_type>> typed_triple_apply_degree_count(
+  sgraph& g, sgraph::edge_direction dir) {
+  auto vertex_degree_data = sgraph_compute::create_vertex_data<std::atomic<size_t>>(g);
+  typed_degree_count_fn fn{&vertex_degree_data,
+                           dir != sgraph::edge_direction::OUT_EDGE,
+                           dir != sgraph::edge_direction::IN_EDGE};
+  sgraph_compute::typed_fast_triple_apply(g, fn);
+
+  std::vector<std::pair<flexible_type, flexible_type>> ret;
+  auto vertex_ids = g.fetch_vertex_data_field("__id");
+  for (size_t i = 0; i < vertex_degree_data.size(); ++i) {
+    std::vector<flexible_type> id_vec;
+    vertex_ids[i]->get_reader()->read_rows(0, vertex_ids[i]->size(), id_vec);
+    TS_ASSERT_EQUALS(id_vec.size(), vertex_degree_data[i].size());
+    for (size_t j = 0; j < id_vec.size(); ++j) {
+      ret.push_back({id_vec[j], (size_t)vertex_degree_data[i][j]});
+    }
+  }
+  return ret;
+}
+
 class sgraph_triple_apply_test : public CxxTest::TestSuite {
 
 public:
@@ -109,4 +147,50 @@ void test_triple_apply_edge_data_modification() {
   g.remove_edge_field("id_sum");
 }
 
+void test_typed_triple_apply_degree_count() {
+  check_degree_count(typed_triple_apply_degree_count);
+}
+
+void test_typed_triple_apply_edge_data_modification() {
+  size_t n_vertex = 10;
+  size_t n_partition = 4;
+  sgraph g = create_ring_graph(n_vertex, n_partition, false /* one direction */);
+
+  g.init_edge_field("weight", flex_float(0.5));
+  g.init_edge_field("id_sum", flex_int(0));
+  auto vdata = sgraph_compute::load_vertex_field<flex_int>(g, "__id");
+
+  std::atomic<size_t> num_visited(0);
+  sgraph_compute::typed_fast_triple_apply(g,
+      [&](sgraph_compute::typed_edge_scope& scope) {
+        ++num_visited;
+        auto src_addr = scope.source_vertex_address();
+        auto dst_addr = scope.target_vertex_address();
+        scope.int_field(1) = vdata[src_addr.partition_id][src_addr.local_id] +
+                             vdata[dst_addr.partition_id][dst_addr.local_id];
+        scope.float_field(0) *= 2;
+      }, {"weight", "id_sum"}, {"id_sum"});
+  // every edge partition is visited exactly once
+  TS_ASSERT_EQUALS(num_visited.load(), n_vertex);
+
+  sframe edge_sframe = g.get_edges();
+  std::vector<std::vector<flexible_type>> edge_data_rows;
+  edge_sframe.get_reader()->read_rows(0, edge_sframe.size(), edge_data_rows);
+  TS_ASSERT_EQUALS(edge_data_rows.size(), n_vertex);
+  size_t weight_id = edge_sframe.column_index("weight");
+  size_t sum_id = edge_sframe.column_index("id_sum");
+  for (auto& row : edge_data_rows) {
+    TS_ASSERT_EQUALS(int(row[0] + row[1]), int(row[sum_id]));
+    // weight is not in the mutated fields
+    TS_ASSERT_EQUALS(row[weight_id], 0.5);
+  }
+
+  // only numeric fields without missing values are supported
+  TS_ASSERT_THROWS_ANYTHING(sgraph_compute::typed_fast_triple_apply(g,
+      [](sgraph_compute::typed_edge_scope& scope) { }, {"edata"}));
+  g.init_edge_field("missing", FLEX_UNDEFINED);
+  TS_ASSERT_THROWS_ANYTHING(sgraph_compute::typed_fast_triple_apply(g,
+      [](sgraph_compute::typed_edge_scope& scope) { }, {"missing"}));
+}
+
 };
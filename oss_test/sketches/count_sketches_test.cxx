@@ -136,6 +136,28 @@ class countsketch_test: public CxxTest::TestSuite {
 
  public:
 
+  /**
+   * add_many must produce the same counts as repeated calls to add.
+   */
+  void test_add_many() {
+    std::vector<size_t> v(50000);
+    for (auto& x: v) x = graphlab::random::fast_uniform<size_t>(0, 999);
+
+    graphlab::sketches::countmin<size_t> cm(10, 4), cm_batched(10, 4);
+    graphlab::sketches::countsketch<size_t> cs(10, 5), cs_batched(10, 5);
+    for (auto x: v) {
+      cm.add(x);
+      cs.add(x);
+    }
+    cm_batched.add_many(v.begin(), v.end());
+    cs_batched.add_many(v.begin(), v.end());
+
+    for (size_t i = 0; i < 1000; ++i) {
+      TS_ASSERT_EQUALS(cm.estimate(i), cm_batched.estimate(i));
+      TS_ASSERT_EQUALS(cs.estimate(i), cs_batched.estimate(i));
+    }
+  }
+
   /**
    * Small example to use for debugging.
    */
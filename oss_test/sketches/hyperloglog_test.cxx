@@ -77,6 +77,24 @@ class hyperloglog_test: public CxxTest::TestSuite {
     TS_ASSERT_EQUALS(hll.estimate(), sequential_hll.estimate());
   }
  public:
+  void test_add_many() {
+    // the batched path must produce exactly the same registers as add()
+    using graphlab::sketches::hyperloglog;
+    graphlab::random::seed(1001);
+    std::vector<size_t> v(100000);
+    for (auto& x: v) x = graphlab::random::fast_uniform<size_t>(0, 65535);
+    for (size_t bits: {8, 12, 16}) {
+      hyperloglog single(bits), batched(bits), hashed(bits);
+      for (auto x: v) single.add(x);
+      batched.add_many(v.begin(), v.end());
+      std::vector<size_t> hashes;
+      for (auto x: v) hashes.push_back(std::hash<size_t>()(x));
+      hashed.add_hashes(hashes.data(), hashes.size());
+      TS_ASSERT_EQUALS(single.estimate(), batched.estimate());
+      TS_ASSERT_EQUALS(single.estimate(), hashed.estimate());
+    }
+  }
+
   void test_stuff() {
     graphlab::random::seed(1001);
     std::vector<size_t> lens{1024, 65536, 1024*1024};
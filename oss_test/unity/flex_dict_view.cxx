@@ -94,4 +94,74 @@ class flex_dict_test: public CxxTest::TestSuite {
     }
   }
 
+  void test_key_set() {
+    flex_dict_key_set keyset({"a", 1, 2.5, FLEX_UNDEFINED, "a", 1.0,
+                              flex_date_time(7, 0)});
+    // "a" and 1 == 1.0 are repeated
+    TS_ASSERT_EQUALS(keyset.size(), 5);
+    TS_ASSERT_EQUALS(keyset.find("a"), 0);
+    TS_ASSERT_EQUALS(keyset.find(1.0), 1);
+    TS_ASSERT_EQUALS(keyset.find(1), 1);
+    TS_ASSERT_EQUALS(keyset.find(2.5), 2);
+    TS_ASSERT_EQUALS(keyset.find(FLEX_UNDEFINED), 3);
+    TS_ASSERT_EQUALS(keyset.find(7), 4);
+    TS_ASSERT_EQUALS(keyset.find(flex_date_time(7, 0)), 4);
+    TS_ASSERT(!keyset.contains("1"));
+    TS_ASSERT(!keyset.contains(2));
+    TS_ASSERT(!keyset.contains(flex_vec{1.0}));
+  }
+
+  void test_indexed_lookup() {
+    // large enough to build the index
+    flex_dict dict;
+    for (size_t i = 0; i < 4 * flex_dict_view::INDEX_MIN_SIZE; ++i) {
+      dict.push_back({std::to_string(i), i});
+      dict.push_back({i, -flex_int(i)});
+    }
+    // the first entry of a key wins
+    dict.push_back({"0", 100});
+    flexible_type f(dict);
+    flex_dict_view fdv(f);
+    for (size_t repeat = 0; repeat < 2; ++repeat) {
+      for (size_t i = 0; i < 4 * flex_dict_view::INDEX_MIN_SIZE; ++i) {
+        TS_ASSERT(fdv.has_key(std::to_string(i)));
+        TS_ASSERT_EQUALS(fdv[std::to_string(i)], i);
+        TS_ASSERT_EQUALS(fdv[double(i)], -flex_int(i));
+      }
+      TS_ASSERT(!fdv.has_key("some random value"));
+      TS_ASSERT(!fdv.has_key(0.5));
+      TS_ASSERT_THROWS_ANYTHING(fdv[FLEX_UNDEFINED]);
+    }
+  }
+
+  void test_dict_key_operations() {
+    std::vector<flexible_type> v;
+    v.push_back(flex_dict{{"a", 1}, {"b", 2}, {1, 3}});
+    v.push_back(flex_dict{{"b", 4}, {2.0, 5}, {"b", 6}});
+    v.push_back(FLEX_UNDEFINED);
+    v.push_back(flex_dict{{FLEX_UNDEFINED, 7}, {"a", 8}});
+    auto sa = std::make_shared<unity_sarray>();
+    sa->construct_from_vector(v, flex_type_enum::DICT);
+
+    auto head = [](std::shared_ptr<unity_sarray_base> result) {
+      return std::static_pointer_cast<unity_sarray>(result)->_head(10);
+    };
+    auto trimmed = head(sa->dict_trim_by_keys({"a", 1.0}, true));
+    TS_ASSERT_EQUALS(trimmed[0], (flex_dict{{"b", 2}}));
+    TS_ASSERT_EQUALS(trimmed[1], (flex_dict{{"b", 4}, {2.0, 5}, {"b", 6}}));
+    TS_ASSERT_EQUALS(trimmed[2], FLEX_UNDEFINED);
+    TS_ASSERT_EQUALS(trimmed[3], (flex_dict{{FLEX_UNDEFINED, 7}}));
+
+    auto any = head(sa->dict_has_any_keys({2, "z"}));
+    TS_ASSERT_EQUALS(any, (std::vector<flexible_type>{0, 1, FLEX_UNDEFINED, 0}));
+
+    auto all = head(sa->dict_has_all_keys({"a", "b", "a"}));
+    TS_ASSERT_EQUALS(all, (std::vector<flexible_type>{1, 0, FLEX_UNDEFINED, 0}));
+
+    auto unpacked = sa->unpack_dict("", {"b", "a"}, FLEX_UNDEFINED);
+    auto unpacked_b = head(unpacked->select_column("b"));
+    auto unpacked_a = head(unpacked->select_column("a"));
+    TS_ASSERT_EQUALS(unpacked_b, (std::vector<flexible_type>{2, 4, FLEX_UNDEFINED, FLEX_UNDEFINED}));
+    TS_ASSERT_EQUALS(unpacked_a, (std::vector<flexible_type>{1, FLEX_UNDEFINED, FLEX_UNDEFINED, 8}));
+  }
 };
\ No newline at end of file
@@ -447,6 +447,37 @@ class gl_sarray_test: public CxxTest::TestSuite {
       _assert_sarray_equals(result,{flex_undefined(),
         flex_undefined(),flex_undefined(),1.5,2.5,3.5,4.5,5.5,6.5,7.5});
     }
+
+    void test_rolling_apply_matches_full_window() {
+      std::vector<flexible_type> vals;
+      for (size_t i = 0; i < 3000; ++i) {
+        if (i % 17 == 0) vals.push_back(FLEX_UNDEFINED);
+        else vals.push_back(double((i * 7919) % 1000) / 7.0);
+      }
+      gl_sarray a(vals);
+      std::vector<std::pair<ssize_t, ssize_t>> windows{{-50, 0}, {-3, 10}, {5, 20}, {-20, -5}};
+      for (std::string fn : {"__builtin__sum__", "__builtin__avg__", "__builtin__var__",
+                             "__builtin__stdv__", "__builtin__min__", "__builtin__max__",
+                             "__builtin__nonnull__count__"}) {
+        for (auto window : windows) {
+          auto result = a.builtin_rolling_apply(fn, window.first, window.second, 0);
+          TS_ASSERT_EQUALS(result.size(), vals.size());
+          for (ssize_t i = 0; i < ssize_t(vals.size()); ++i) {
+            auto agg = get_builtin_group_aggregator(fn);
+            agg->set_input_type(flex_type_enum::FLOAT);
+            for (ssize_t j = i + window.first; j <= i + window.second; ++j) {
+              if (j >= 0 && j < ssize_t(vals.size())) agg->add_element_simple(vals[j]);
+            }
+            flexible_type expected = agg->emit();
+            if (expected.get_type() == flex_type_enum::UNDEFINED) {
+              TS_ASSERT_EQUALS(result[i].get_type(), flex_type_enum::UNDEFINED);
+            } else {
+              TS_ASSERT_DELTA((double)result[i], (double)expected, 1e-6);
+            }
+          }
+        }
+      }
+    }
    
     void test_sarray() {
       gl_sarray sa{1,2,3,4,5,6};
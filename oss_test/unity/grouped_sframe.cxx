@@ -0,0 +1,152 @@
+/*
+* Copyright (C) 2016 Turi
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Affero General Public License as
+* published by the Free Software Foundation, either version 3 of the
+* License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Affero General Public License for more details.
+*
+* You should have received a copy of the GNU Affero General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cxxtest/TestSuite.h>
+#include <unity/extensions/grouped_sframe.hpp>
+#include <unity/lib/gl_sarray.hpp>
+#include <unity/lib/gl_sframe.hpp>
+#include <serialization/dir_archive.hpp>
+#include <serialization/serialization_includes.hpp>
+
+using namespace graphlab;
+
+class grouped_sframe_test: public CxxTest::TestSuite {
+  public:
+    gl_sframe make_sframe() {
+      return gl_sframe{{"key", {3, 1, 3, 2, 1, 3}},
+                       {"key2", {"a", "b", "a", "a", "c", "a"}},
+                       {"value", {0, 1, 2, 3, 4, 5}}};
+    }
+
+    void test_group_by_hash() {
+      grouped_sframe g;
+      g.group_by_hash(make_sframe(), {"key"});
+      TS_ASSERT_EQUALS(g.num_groups(), 3);
+
+      // groups are in order of first appearance
+      _assert_sarray_equals(g.groups(), {3, 1, 2});
+      // rows keep their relative order within a group
+      _assert_sarray_equals(g.get_group({3})["value"], {0, 2, 5});
+      _assert_sarray_equals(g.get_group({1})["value"], {1, 4});
+      _assert_sarray_equals(g.get_group({2})["value"], {3});
+      TS_ASSERT_THROWS_ANYTHING(g.get_group({4}));
+
+      // the grouped SFrame holds the groups one after the other
+      _assert_sarray_equals(g.get_sframe()["value"], {0, 2, 5, 1, 4, 3});
+
+      g.begin_iterator();
+      auto groups = g.iterator_get_next(10);
+      TS_ASSERT_EQUALS(groups.size(), 3);
+      TS_ASSERT(groups[1].first == flexible_type(1));
+      _assert_sarray_equals(groups[1].second["value"], {1, 4});
+    }
+
+    void test_group_by_hash_multiple_columns() {
+      grouped_sframe g;
+      g.group_by_hash(make_sframe(), {"key", "key2"});
+      TS_ASSERT_EQUALS(g.num_groups(), 4);
+      gl_sarray names = g.groups();
+      TS_ASSERT_EQUALS((int)names.dtype(), (int)flex_type_enum::LIST);
+      TS_ASSERT(names[0] == flexible_type(flex_list{3, "a"}));
+      TS_ASSERT(names[1] == flexible_type(flex_list{1, "b"}));
+      TS_ASSERT(names[2] == flexible_type(flex_list{2, "a"}));
+      TS_ASSERT(names[3] == flexible_type(flex_list{1, "c"}));
+      _assert_sarray_equals(g.get_group({3, "a"})["value"], {0, 2, 5});
+      _assert_sarray_equals(g.get_group({1, "c"})["value"], {4});
+      // the trailing None added by the python side is ignored
+      _assert_sarray_equals(g.get_group({1, "b", FLEX_UNDEFINED})["value"], {1});
+      TS_ASSERT_THROWS_ANYTHING(g.get_group({2, "b"}));
+    }
+
+    void test_group_by_hash_empty() {
+      gl_sframe sf{{"key", gl_sarray(std::vector<flexible_type>(), flex_type_enum::INTEGER)},
+                   {"value", gl_sarray(std::vector<flexible_type>(), flex_type_enum::FLOAT)}};
+      grouped_sframe g;
+      g.group_by_hash(sf, {"key"});
+      TS_ASSERT_EQUALS(g.num_groups(), 0);
+      TS_ASSERT_EQUALS(g.groups().size(), 0);
+      TS_ASSERT_EQUALS(g.get_sframe().size(), 0);
+      TS_ASSERT_THROWS_ANYTHING(g.get_group({1}));
+
+      g.begin_iterator();
+      TS_ASSERT_EQUALS(g.iterator_get_next(10).size(), 0);
+    }
+
+    void test_group_by_hash_invalid_columns() {
+      grouped_sframe g;
+      TS_ASSERT_THROWS_ANYTHING(g.group_by_hash(make_sframe(), {"key", "key"}));
+      TS_ASSERT_THROWS_ANYTHING(g.group_by_hash(make_sframe(), {"missing"}));
+      g.group_by_hash(make_sframe(), {"key"});
+      TS_ASSERT_THROWS_ANYTHING(g.group_by_hash(make_sframe(), {"key"}));
+    }
+
+    void test_save_load() {
+      grouped_sframe g;
+      g.group_by_hash(make_sframe(), {"key", "key2"});
+
+      dir_archive write_arc;
+      write_arc.open_directory_for_write("cache://grouped_sframe_test");
+      oarchive oarc(write_arc);
+      g.save_impl(oarc);
+      write_arc.close();
+
+      grouped_sframe g2;
+      dir_archive read_arc;
+      read_arc.open_directory_for_read("cache://grouped_sframe_test");
+      iarchive iarc(read_arc);
+      g2.load_version(iarc, g.get_version());
+      read_arc.close();
+
+      // the loaded object answers from the saved index, without regrouping
+      TS_ASSERT_EQUALS(g2.num_groups(), 4);
+      TS_ASSERT(g2.groups()[3] == flexible_type(flex_list{1, "c"}));
+      _assert_sarray_equals(g2.get_group({3, "a"})["value"], {0, 2, 5});
+      _assert_sarray_equals(g2.get_group({2, "a"})["value"], {3});
+      _assert_sarray_equals(g2.get_sframe()["value"], {0, 2, 5, 1, 3, 4});
+      // and can not be grouped again
+      TS_ASSERT_THROWS_ANYTHING(g2.group(make_sframe(), {"key"}, false));
+    }
+
+    void test_save_load_sorted() {
+      grouped_sframe g;
+      g.group(make_sframe(), {"key"}, false);
+      _assert_sarray_equals(g.groups(), {1, 2, 3});
+
+      dir_archive write_arc;
+      write_arc.open_directory_for_write("cache://grouped_sframe_sorted_test");
+      oarchive oarc(write_arc);
+      g.save_impl(oarc);
+      write_arc.close();
+
+      grouped_sframe g2;
+      dir_archive read_arc;
+      read_arc.open_directory_for_read("cache://grouped_sframe_sorted_test");
+      iarchive iarc(read_arc);
+      g2.load_version(iarc, g.get_version());
+      read_arc.close();
+
+      _assert_sarray_equals(g2.groups(), {1, 2, 3});
+      TS_ASSERT_EQUALS(g2.get_group({3}).size(), 3);
+      TS_ASSERT_EQUALS(g2.get_group({1}).size(), 2);
+    }
+
+    void _assert_sarray_equals(gl_sarray sa, const std::vector<flexible_type>& data) {
+      TS_ASSERT_EQUALS(sa.size(), data.size());
+      for (size_t i = 0; i < data.size(); ++i) {
+        TS_ASSERT_EQUALS(sa[i], data[i]);
+      }
+    }
+};
@@ -99,7 +99,56 @@ class image_util_test: public CxxTest::TestSuite {
     _test_resize_impl(image_wrapped, height, width, channels, false);
   }
 
+  void test_resize_pixels() {
+    for (size_t channels : {1, 3, 4}) {
+      // a 4x4 image whose bytes are all distinct
+      image_type small = make_raw_image(2, 2, channels);
+      image_type large = make_raw_image(4, 4, channels);
+      fill_image(small);
+      fill_image(large);
+
+      // upsampling 2x2 to 4x4 duplicates each pixel
+      for (bool encoded : {false, true}) {
+        flexible_type input(small);
+        if (encoded) input = encode_image(input);
+        flexible_type resized = resize_image(input, 4, 4, channels, true);
+        const image_type& img = resized.get<flex_image>();
+        for (size_t y = 0; y < 4; ++y) {
+          for (size_t x = 0; x < 4; ++x) {
+            for (size_t c = 0; c < channels; ++c) {
+              TS_ASSERT_EQUALS(pixel(img, x, y, c), pixel(small, x / 2, y / 2, c));
+            }
+          }
+        }
+      }
+
+      // downsampling 4x4 to 2x2 picks the corners
+      flexible_type resized = resize_image(flexible_type(large), 2, 2, channels, true);
+      const image_type& img = resized.get<flex_image>();
+      for (size_t y = 0; y < 2; ++y) {
+        for (size_t x = 0; x < 2; ++x) {
+          for (size_t c = 0; c < channels; ++c) {
+            TS_ASSERT_EQUALS(pixel(img, x, y, c), pixel(large, 3 * x, 3 * y, c));
+          }
+        }
+      }
+
+      // resizing a decoded image to its own size shares its pixels
+      flexible_type same = resize_image(flexible_type(large), 4, 4, channels, true);
+      TS_ASSERT(same.get<flex_image>().get_image_data() == large.get_image_data());
+    }
+  }
+
  private:
+  void fill_image(image_type& image) {
+    char* data = image.m_image_data.get();
+    for (size_t i = 0; i < image.m_image_data_size; ++i) data[i] = (char)(i * 7 + 1);
+  }
+
+  unsigned char pixel(const image_type& image, size_t x, size_t y, size_t c) {
+    return image.get_image_data()[(y * image.m_width + x) * image.m_channels + c];
+  }
+
   image_type make_raw_image(size_t height, size_t width, size_t channels) {
     int format = (int)(Format::RAW_ARRAY);
     int version = IMAGE_TYPE_CURRENT_VERSION;
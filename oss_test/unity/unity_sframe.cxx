@@ -17,7 +17,10 @@
 #include <cstdio>
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <boost/filesystem.hpp>
 #include <fileio/temp_files.hpp>
+#include <fileio/general_fstream.hpp>
 #include <unity/lib/unity_sframe.hpp>
 #include <sframe/dataframe.hpp>
 #include <sframe/algorithm.hpp>
@@ -699,6 +702,39 @@ class unity_sframe_test: public CxxTest::TestSuite {
     TS_ASSERT_THROWS_ANYTHING(sf->sort(std::vector<std::string>({"b"}), std::vector<int>({0})));
   }
 
+  void test_iterator_get_next_columns() {
+    dataframe_t testdf = _create_test_dataframe();
+    auto sf = std::make_shared<unity_sframe>();
+    sf->construct_from_dataframe(testdf);
+
+    // blocks of varying length, so some of the read ahead is discarded
+    std::vector<size_t> lengths{7, 7, 7, 30, 1, 1, 100};
+    std::vector<std::vector<flexible_type>> columns(3);
+    sf->begin_iterator();
+    for (size_t len: lengths) {
+      auto ret = sf->iterator_get_next_columns(len);
+      TS_ASSERT_EQUALS(ret.size(), 3);
+      for (size_t i = 0; i < 3; ++i) {
+        TS_ASSERT_EQUALS(ret[i].size(), ret[0].size());
+        columns[i].insert(columns[i].end(), ret[i].begin(), ret[i].end());
+      }
+    }
+    TS_ASSERT_EQUALS(columns[0].size(), 100);
+    TS_ASSERT(columns[0] == testdf.values["a"]);
+    TS_ASSERT(columns[1] == testdf.values["b"]);
+    TS_ASSERT(columns[2] == testdf.values["c"]);
+
+    // past the end
+    auto ret = sf->iterator_get_next_columns(10);
+    TS_ASSERT_EQUALS(ret.size(), 3);
+    TS_ASSERT_EQUALS(ret[0].size(), 0);
+
+    // restarting the iteration starts from the first row
+    sf->begin_iterator();
+    ret = sf->iterator_get_next_columns(2);
+    TS_ASSERT_EQUALS(ret[0][1], 1);
+  }
+
   void test_save_load() {
     dataframe_t testdf = _create_test_dataframe();
     auto sf = std::make_shared<unity_sframe>();
@@ -720,4 +756,133 @@ class unity_sframe_test: public CxxTest::TestSuite {
     TS_ASSERT_EQUALS(sf->size(), sf2->size());
     TS_ASSERT_EQUALS(sf->num_columns(), sf2->num_columns());
   }
+
+  void test_save_as_csv_parallel() {
+    size_t old_num_segments = SFRAME_DEFAULT_NUM_SEGMENTS;
+    SFRAME_DEFAULT_NUM_SEGMENTS = 4;
+    const size_t n = 2 * SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS;
+    auto sf = _create_large_sframe(n);
+    std::map<std::string, flexible_type> csv_config{{"line_prefix", "> "}};
+    // the options export_json(orient="records") writes with
+    std::map<std::string, flexible_type> json_config{
+      {"file_header", "["}, {"file_footer", "]"}, {"header", 0},
+      {"double_quote", 0}, {"quote_level", 3}, {"line_prefix", ","},
+      {"_no_prefix_on_first_value", 1}};
+
+    // all segments written
+    _check_save_as_csv(sf, csv_config);
+    _check_save_as_csv(sf, json_config);
+
+    // only the last segments have rows: the first row written is not in
+    // segment 0
+    auto tail = _filter_rows(sf, [n](size_t i) { return i >= n - 1000; });
+    _check_save_as_csv(tail, csv_config);
+    _check_save_as_csv(tail, json_config);
+
+    // empty segments in the middle
+    auto ends = _filter_rows(sf, [n](size_t i) { return i < 10 || i >= n - 10; });
+    _check_save_as_csv(ends, csv_config);
+    _check_save_as_csv(ends, json_config);
+
+    // no rows at all
+    auto none = _filter_rows(sf, [](size_t i) { return false; });
+    _check_save_as_csv(none, json_config);
+
+    SFRAME_DEFAULT_NUM_SEGMENTS = old_num_segments;
+  }
+
+  void test_save_as_csv_parallel_error() {
+    size_t old_num_segments = SFRAME_DEFAULT_NUM_SEGMENTS;
+    SFRAME_DEFAULT_NUM_SEGMENTS = 4;
+    const size_t n = 2 * SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS;
+    auto sf = _create_large_sframe(n);
+    auto column = std::static_pointer_cast<unity_sarray>(sf->select_column("a"));
+    // fails in the last segment, after the others wrote their temporary files
+    auto failing = column->transform_lambda([n](const flexible_type& val)->flexible_type {
+        if (val == flex_int(n - 10)) log_and_throw("injected failure");
+        return val;
+      }, flex_type_enum::INTEGER, false, 0);
+    auto bad = std::make_shared<unity_sframe>();
+    bad->add_column(failing, "a");
+
+    std::string url = get_temp_name() + ".csv";
+    size_t num_temp_files = _count_temp_files(url);
+    TS_ASSERT_THROWS_ANYTHING(bad->save_as_csv(url, {{"line_prefix", "> "}}));
+    // the segment files are removed
+    TS_ASSERT_EQUALS(_count_temp_files(url), num_temp_files);
+
+    SFRAME_DEFAULT_NUM_SEGMENTS = old_num_segments;
+  }
+
+ private:
+  std::shared_ptr<unity_sframe> _create_large_sframe(size_t n) {
+    dataframe_t df;
+    std::vector<flexible_type> a;
+    std::vector<flexible_type> c;
+    for (size_t i = 0; i < n; ++i) {
+      a.push_back(i);
+      c.push_back("v\"" + std::to_string(i));
+    }
+    df.set_column("a", a, flex_type_enum::INTEGER);
+    df.set_column("c", c, flex_type_enum::STRING);
+    auto sf = std::make_shared<unity_sframe>();
+    sf->construct_from_dataframe(df);
+    return sf;
+  }
+
+  /*
+   * Rows of sf for which keep(row number) is true. The length of the
+   * result is not known up front, so it is always written in parallel.
+   */
+  std::shared_ptr<unity_sframe> _filter_rows(std::shared_ptr<unity_sframe> sf,
+                                             std::function<bool(size_t)> keep) {
+    std::vector<flexible_type> mask;
+    for (size_t i = 0; i < sf->size(); ++i) mask.push_back(keep(i));
+    auto mask_sa = std::make_shared<unity_sarray>();
+    mask_sa->construct_from_vector(mask, flex_type_enum::INTEGER);
+    return std::static_pointer_cast<unity_sframe>(sf->logical_filter(mask_sa));
+  }
+
+  std::string _save_as_csv(std::shared_ptr<unity_sframe> sf,
+                           const std::map<std::string, flexible_type>& config) {
+    std::string url = get_temp_name() + ".csv";
+    sf->save_as_csv(url, config);
+    general_ifstream fin(url);
+    std::string ret((std::istreambuf_iterator<char>(fin)),
+                    std::istreambuf_iterator<char>());
+    delete_temp_file(url);
+    return ret;
+  }
+
+  /*
+   * Checks that the parallel output is identical to the output of a
+   * single segment.
+   */
+  void _check_save_as_csv(std::shared_ptr<unity_sframe> sf,
+                          const std::map<std::string, flexible_type>& config) {
+    std::string parallel = _save_as_csv(sf, config);
+    size_t old_min_rows = SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS;
+    SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS = std::numeric_limits<int64_t>::max();
+    // the length of a filtered frame is not known: materialize it first
+    sf->materialize();
+    std::string serial = _save_as_csv(sf, config);
+    SFRAME_SAVE_AS_CSV_PARALLEL_MIN_ROWS = old_min_rows;
+    TS_ASSERT(!serial.empty());
+    TS_ASSERT(parallel == serial);
+  }
+
+  size_t _count_temp_files(const std::string& exclude) {
+    namespace fs = boost::filesystem;
+    size_t count = 0;
+    for (const auto& dir: get_temp_directories()) {
+      if (!fs::exists(dir)) continue;
+      for (fs::recursive_directory_iterator iter(dir), end; iter != end; ++iter) {
+        if (fs::is_regular_file(iter->path()) &&
+            iter->path().generic_string() != exclude) {
+          ++count;
+        }
+      }
+    }
+    return count;
+  }
 };